@@ -91,6 +91,9 @@ namespace dbasic {
 
         void Clear();
 
+        // Takes over everything in data, leaving it empty
+        void MoveFrom(AnimationExportData *data);
+
         // Construction Utilities
 
         ObjectKeyframeDataExport *AddObjectKeyData(char *object);
@@ -13,23 +13,72 @@
 
 namespace dbasic {
 
-    struct CompiledHeader {
-        int ObjectCount;
-    };
-
     class DeltaEngine;
 
     class AssetManager : public ysObject {
+    public:
+        // Totals over all geometry in the last compiled scene, before and
+        // after the vertex cache optimization stage. Objects copied from
+        // the compile cache aren't included in the cache statistics.
+        struct CompileStatistics {
+            ysGeometryPreprocessing::VertexCacheStatistics CacheBefore;
+            ysGeometryPreprocessing::VertexCacheStatistics CacheAfter;
+
+            int ObjectCount;
+            int CachedObjectCount;
+        };
+
+        // Part of every compile cache key, bump it whenever a change to the
+        // preprocessing stages changes their output
+        static const unsigned int CompilerVersion = 1;
+
     public:
         AssetManager();
         ~AssetManager();
 
-        ysError CompileSceneFile(const char *fname, float scale = 1.0f, bool force = false);
+        // Preprocessing runs on workerCount threads while objects are read
+        // and written in order on the calling thread. A negative count uses
+        // one worker per spare hardware thread, 0 compiles on the calling
+        // thread only.
+        //
+        // A compile cache index (.ysci) is kept next to the compiled file.
+        // Objects whose source, material and compile options haven't
+        // changed are copied from the previous output instead of being
+        // processed again, and a scene where nothing changed isn't read at
+        // all. Force ignores the cache.
+        ysError CompileSceneFile(const char *fname, float scale = 1.0f, bool force = false, int workerCount = -1);
         ysError LoadSceneFile(const char *fname);
 
+        // --
+        // Same as LoadSceneFile() except that the file is read and prepared
+        // on the loader's threads. The GPU buffers and scene objects are
+        // created during a later ysAsyncLoader::Update(), in the order the
+        // loads finish. Call ResolveNodeHierarchy() once they are complete.
+        //
+        // Returns a null handle if there is no loader. The asset manager has
+        // to outlive the request.
+        // --
+        ysLoadHandle LoadSceneFileAsync(const char *fname, int priority = 0);
+        const CompileStatistics &GetCompileStatistics() const { return m_compileStatistics; }
+
+        // Store vertices in quantized formats in scenes compiled from now on,
+        // roughly a third of the size of full precision vertices. Such scenes
+        // fail to load with YDS_UNSUPPORTED_TYPE on devices without the
+        // compressed shaders, see DeltaEngine::SupportsCompressedVertices()
+        void SetVertexCompression(bool compress) { m_compressVertices = compress; }
+        bool GetVertexCompression() const { return m_compressVertices; }
+
+        // Split geometry into meshlets of at most 64 vertices and 124 faces
+        // with their own bounds, so that large meshes can be culled in parts
+        void SetMeshletGeneration(bool build) { m_buildMeshlets = build; }
+        bool GetMeshletGeneration() const { return m_buildMeshlets; }
+
         ysError CompileAnimationFile(const char *fname);
         ysError LoadAnimationFile(const char *fname);
 
+        // The file is read on an I/O thread, see LoadSceneFileAsync()
+        ysLoadHandle LoadAnimationFileAsync(const char *fname, int priority = 0);
+
         Material *NewMaterial();
         Material *FindMaterial(const char *name);
         Material *GetMaterial(int index) { return m_materials.Get(index); }
@@ -53,9 +102,31 @@ namespace dbasic {
 
         void SetEngine(DeltaEngine *engine) { m_engine = engine; }
 
+        // Device that GPU buffers are created on, defaults to the engine's
+        // device. Set a null device to load scenes headless.
+        void SetDevice(ysDevice *device) { m_device = device; }
+        ysDevice *GetDevice();
+
+        // Loader used for asynchronous loads, defaults to the engine's loader
+        void SetLoader(ysAsyncLoader *loader) { m_loader = loader; }
+        ysAsyncLoader *GetLoader();
+
         ysError ResolveNodeHierarchy();
 
     protected:
+        // Compiled scene on its way from the file to the scene objects
+        struct SceneLoad;
+
+        ysError OpenScene(SceneLoad *load, const char *fname);
+        ysError PrepareScene(SceneLoad *load);
+        ysError FinalizeScene(SceneLoad *load);
+
+        ysError ReadAnimationFile(const char *fname, AnimationExportData *data);
+
+    protected:
+        // Assets are only ever added and scene objects refer to their parents
+        // and children by index, so these stay index-addressed rather than
+        // going through a ysHandleArray.
         ysDynamicArray<ModelAsset, 4>				m_modelAssets;
         ysDynamicArray<SceneObjectAsset, 4>		m_sceneObjects;
         ysDynamicArray<Material, 4>				m_materials;
@@ -65,6 +136,12 @@ namespace dbasic {
         ysDynamicArray<AnimationExportData, 4>	m_animationExportData;
 
         DeltaEngine *m_engine;
+        ysDevice *m_device;
+        ysAsyncLoader *m_loader;
+
+        CompileStatistics m_compileStatistics;
+        bool m_compressVertices;
+        bool m_buildMeshlets;
     };
 
 } /* namespace dbasic */
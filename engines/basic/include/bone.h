@@ -30,6 +30,7 @@ namespace dbasic {
         void LocalSpace(ysMatrix &m);
 
         ysMatrix GetSkinMatrix();
+        ysAffineMatrix GetAffineSkinMatrix();
 
         void SetAssetID(int assetID) { m_assetID = assetID; }
         int GetAssetID() const { return m_assetID; }
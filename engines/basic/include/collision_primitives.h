@@ -64,4 +64,8 @@ namespace dbasic {
 
 } /* namespace dbasic */
 
+// Collisions only refer to other objects through pointers
+template<>
+struct ysIsTriviallyRelocatable<dbasic::Collision> : std::true_type { /* void */ };
+
 #endif /* DELTA_BASIC_COLLISION_PRIMITIVES_H */
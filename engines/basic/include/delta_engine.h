@@ -19,12 +19,17 @@ namespace dbasic {
         ysTexture *Texture;
         ShaderObjectVariables ObjectVariables;
         ModelAsset *Model;
+
+        DrawCall *Next;
     };
 
     class DeltaEngine : public ysObject {
     public:
         static const int MAX_LAYERS = 256;
 
+        // Seconds per frame spent on finishing asynchronous loads
+        static constexpr double DefaultLoadBudget = 0.002;
+
         enum DRAW_TARGET {
             DRAW_TARGET_GUI,
             DRAW_TARGET_MAIN
@@ -49,6 +54,26 @@ namespace dbasic {
         ysError LoadTexture(ysTexture **image, const char *fname);
         ysError LoadAnimation(Animation **animation, const char *path, int start, int end);
 
+        // --
+        // Asynchronous versions of the above. The files are read on the asset
+        // loader's I/O threads and the textures are created on the device
+        // during a later StartFrame(), one per finalize step.
+        //
+        // The output is written from the finalize step, so the pointer passed
+        // in has to stay valid until the request has completed or failed, or
+        // has been cancelled or released. Textures of an animation that
+        // doesn't complete are destroyed.
+        // --
+        ysLoadHandle LoadTextureAsync(ysTexture **image, const char *fname, int priority = 0);
+        ysLoadHandle LoadAnimationAsync(Animation **animation, const char *path, int start, int end, int priority = 0);
+
+        // Finalizes asynchronous loads at the start of every frame
+        ysAsyncLoader *GetAssetLoader() { return &m_assetLoader; }
+
+        // Time spent finalizing asynchronous loads per frame, in seconds
+        void SetLoadBudget(double budget) { m_loadBudget = budget; }
+        double GetLoadBudget() const { return m_loadBudget; }
+
         void SubmitSkeleton(Skeleton *skeleton);
 
         bool IsOpen() { return m_gameWindow->IsOpen(); }
@@ -75,11 +100,18 @@ namespace dbasic {
 
         float GetFrameLength();
 
+        // Peak memory used by per-frame data (draw calls) during the last frame
+        int GetFrameMemoryPeak() const { return m_frameArena.GetLastFramePeak(); }
+
         void SetMultiplyColor(ysVector4 color);
         void ResetMultiplyColor();
 
         ysDevice *GetDevice() { return m_device; }
 
+        // Scenes compiled with vertex compression can only be drawn if the
+        // device has the compressed shaders (not available on OpenGL)
+        bool SupportsCompressedVertices() const { return m_compressedShaderProgram != NULL; }
+
         void SetDrawTarget(DRAW_TARGET target) { m_currentTarget = target; }
 
         int GetScreenWidth();
@@ -141,6 +173,17 @@ namespace dbasic {
         ysInputLayout *m_skinnedInputLayout;
         ysInputLayout *m_inputLayout;
 
+        // Models compiled with quantized vertices (DirectX only)
+        ysShader *m_vertexCompressedShader;
+        ysShader *m_vertexSkinnedCompressedShader;
+        ysShaderProgram *m_compressedShaderProgram;
+        ysShaderProgram *m_skinnedCompressedShaderProgram;
+
+        ysRenderGeometryFormat m_compressedFormat;
+        ysRenderGeometryFormat m_skinnedCompressedFormat;
+        ysInputLayout *m_compressedInputLayout;
+        ysInputLayout *m_skinnedCompressedInputLayout;
+
         // Text Support
         Console m_console;
 
@@ -162,10 +205,23 @@ namespace dbasic {
         ysError InitializeRendering();
 
     protected:
-        // Drawing queues
-        ysExpandingArray<DrawCall, 256> m_drawQueue[MAX_LAYERS];
-        ysExpandingArray<DrawCall, 256> m_drawQueueGui[MAX_LAYERS];
+        // Drawing queues, stored as a list of draw calls for each layer
+        struct DrawQueue {
+            DrawCall *First;
+            DrawCall *Last;
+        };
+
+        DrawQueue m_drawQueue[MAX_LAYERS];
+        DrawQueue m_drawQueueGui[MAX_LAYERS];
+        DrawCall *NewDrawCall(int layer);
         ysError ExecuteDrawQueue(DRAW_TARGET target);
+
+        // Per-frame data, reclaimed at the end of each frame
+        ysFrameArena m_frameArena;
+
+        // Background asset loading
+        ysAsyncLoader m_assetLoader;
+        double m_loadBudget;
     };
 
 } /* namesapce dbasic */
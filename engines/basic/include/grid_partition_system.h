@@ -31,7 +31,7 @@ namespace dbasic {
         bool m_valid;
         bool m_active;
 
-        ysExpandingArray<RigidBody *, 4> m_objects;
+        ysSmallVector<RigidBody *, 4> m_objects;
     };
 
     class GridPartitionSystem : public ysObject {
@@ -162,8 +162,8 @@ namespace dbasic {
         ysVector m_PTemp;
         ysVector m_VTemp;
 
-        ysExpandingArray<MSSSpring *, 4> m_adjacentSprings;
-        ysExpandingArray<MSSParticle *, 4> m_collidingParticles;
+        ysSmallVector<MSSSpring *, 4> m_adjacentSprings;
+        ysSmallVector<MSSParticle *, 4> m_collidingParticles;
 
     protected:
         void *m_owner;
@@ -26,9 +26,20 @@ namespace dbasic {
         int GetBaseVertex() { return m_baseVertex; }
         int GetBaseIndex() { return m_baseIndex; }
         int GetVertexSize() const { return m_vertexSize; }
+        int GetIndexSize() const { return m_indexSize; }
         int GetBoneMap(int boneIndex) const { return m_boneMap[boneIndex]; }
         int GetBoneCount() const { return m_boneMap.GetNumObjects(); }
 
+        bool HasCompressedVertices() const { return m_compressedVertices; }
+        const ysVector4 &GetPositionOffset() const { return m_positionOffset; }
+        const ysVector4 &GetPositionScale() const { return m_positionScale; }
+
+        // Faces are ordered by meshlet, a meshlet's first index is
+        // GetBaseIndex() + 3 * FirstFace. Empty unless the scene was compiled
+        // with meshlets enabled.
+        int GetMeshletCount() const { return m_meshlets.GetNumObjects(); }
+        const ysObjectData::Meshlet &GetMeshlet(int index) const { return m_meshlets[index]; }
+
     protected:
         char m_name[64];
 
@@ -47,6 +58,14 @@ namespace dbasic {
         int m_UVChannelCount;
 
         int m_vertexSize;
+        int m_indexSize;
+
+        ysExpandingArray<ysObjectData::Meshlet, 0> m_meshlets;
+
+        // Quantized positions are decoded as offset + scale * value
+        bool m_compressedVertices;
+        ysVector4 m_positionOffset;
+        ysVector4 m_positionScale;
 
         AssetManager *m_manager;
     };
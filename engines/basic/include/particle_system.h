@@ -14,7 +14,7 @@ namespace dbasic {
         ParticleSystem();
         ~ParticleSystem();
 
-        ysDynamicArray<Particle, 512> m_particles;
+        ysDynamicArray<Particle, 512, true> m_particles;
 
         void Update();
         void Render();
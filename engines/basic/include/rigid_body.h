@@ -80,10 +80,15 @@ namespace dbasic {
         void SetOwner(void *owner) { m_owner = owner; }
 
         bool IsRegistered() const { return m_registered; }
+        ysHandle GetHandle() const { return m_handle; }
 
         void SetHint(RIGID_BODY_HINT hint) { m_hint = hint; }
         RIGID_BODY_HINT GetHint() const { return m_hint; }
 
+        // Use the approximate (rsqrt/polynomial) math functions when integrating
+        void SetFastMath(bool fastMath) { m_fastMath = fastMath; }
+        bool GetFastMath() const { return m_fastMath; }
+
         void AddGridCell(int x, int y);
         void ClearGridCells() { m_gridCells.Clear(); }
         int GetGridCellCount() { return m_gridCells.GetNumObjects(); }
@@ -106,6 +111,7 @@ namespace dbasic {
     protected:
         // Properties
         bool m_registered;
+        ysHandle m_handle;
 
         float m_inverseMass;
         float m_linearDamping;
@@ -131,15 +137,16 @@ namespace dbasic {
         ysMatrix m_inverseInertiaTensorWorld;
         ysQuaternion m_finalOrientation;
 
-        ysExpandingArray<RigidBody *, 4> m_children;
+        ysSmallVector<RigidBody *, 4> m_children;
         RigidBody *m_parent;
         RigidBodySystem *m_system;
 
-        ysExpandingArray<Collision *, 4> m_collisions;
+        ysSmallVector<Collision *, 4> m_collisions;
 
-        ysExpandingArray<GridCell, 4> m_gridCells;
+        ysSmallVector<GridCell, 4> m_gridCells;
 
         RIGID_BODY_HINT m_hint;
+        bool m_fastMath;
 
         void *m_owner;
     };
@@ -40,6 +40,10 @@ namespace dbasic {
         void RegisterRigidBody(RigidBody *body);
         void RemoveRigidBody(RigidBody *body);
 
+        // Returns nullptr if the body has been removed since the handle was issued
+        RigidBody *GetRigidBody(const ysHandle &handle) const { return m_rigidBodyRegistry.Get(handle); }
+        int GetRigidBodyCount() const { return m_rigidBodyRegistry.GetNumObjects(); }
+
         void Update(float timeStep);
 
         void DrawCollisionDebug(int layer);
@@ -59,6 +63,9 @@ namespace dbasic {
 
         void ProcessGridCell(int x, int y);
 
+        // Peak memory used by collisions generated on demand during the last update
+        int GetCollisionMemoryPeak() const { return m_collisionArena.GetLastFramePeak(); }
+
     protected:
         void GenerateCollisions();
         void GenerateCollisions(RigidBody *body1, RigidBody *body2, int threadID);
@@ -78,11 +85,12 @@ namespace dbasic {
     public:
         DeltaEngine *m_engine;
 
-        ysRegistry<RigidBody, 512> m_rigidBodyRegistry;
+        ysHandleArray<RigidBody, 512> m_rigidBodyRegistry;
 
         ysDynamicArray<RigidBodyLink, 512> m_rigidBodyLinks;
 
-        ysDynamicArray<Collision, 4> m_dynamicCollisions;
+        // Collisions generated outside of the worker threads, reclaimed every update
+        ysFrameArena m_collisionArena;
         ysExpandingArray<Collision, N_THREADS, 16> m_threadCollisionAccumulator[N_THREADS + 1];
         ysExpandingArray<Collision *, 8192> m_collisionAccumulator;
         HANDLE m_startEvents[N_THREADS];
@@ -20,6 +20,10 @@ struct ShaderObjectVariables {
     int Lit = 1;
 
     int Pad[3] = { 0, 0, 0 };
+
+    // Only used to decode compressed vertex positions
+    ysVector4 PositionOffset = { 0.0f, 0.0f, 0.0f, 0.0f };
+    ysVector4 PositionScale = { 1.0f, 1.0f, 1.0f, 1.0f };
 };
 
 struct ShaderScreenVariables {
@@ -29,8 +33,9 @@ struct ShaderScreenVariables {
     float Eye[3] = { 0.0f, 0.0f, 0.0f };
 };
 
+// Bone transforms are uploaded as 3x4 affine matrices (rows, translation in w)
 struct ShaderSkinningControls {
-    ysMatrix BoneTransforms[256];
+    ysAffineMatrix BoneTransforms[256];
 };
 
 #endif /* DELTA_BASIC_SHADER_CONTROLS_H */
@@ -24,6 +24,22 @@ struct VS_INPUT_STANDARD {
 	float4 Normal : NORMAL;
 };
 
+// Quantized vertices, see ysGeometryExportFile::MDF_COMPRESSED
+struct VS_INPUT_SKINNED_COMPRESSED {
+	float4 Pos : POSITION;
+	float2 TexCoord : TEXCOORD0;
+	float2 Normal : NORMAL;
+
+	uint4 BoneIndices : BONE_INDICES;
+	float4 BoneWeights : BONE_WEIGHTS;
+};
+
+struct VS_INPUT_STANDARD_COMPRESSED {
+	float4 Pos : POSITION;
+	float2 TexCoord : TEXCOORD0;
+	float2 Normal : NORMAL;
+};
+
 cbuffer ScreenVariables : register(b0) {
 	matrix CameraView;
 	matrix Projection;
@@ -36,10 +52,17 @@ cbuffer ObjectVariables : register(b1) {
 	float2 TexScale;
 	float3 Scale;
 	int ColorReplace;
+	int Lit;
+	int3 Pad;
+
+	// Maps compressed positions from [0, 1] back to model space
+	float4 PositionOffset;
+	float4 PositionScale;
 };
 
 cbuffer SkinningVariables : register(b2) {
-	matrix BoneTransform[256];
+	// Affine transforms, the bottom row is always (0, 0, 0, 1)
+	row_major float3x4 BoneTransform[256];
 };
 
 VS_OUTPUT VS_SKINNED(VS_INPUT_SKINNED input) {
@@ -47,29 +70,30 @@ VS_OUTPUT VS_SKINNED(VS_INPUT_SKINNED input) {
 
 	float4 inputPos = float4(input.Pos.xyz, 1.0);
 
-	float4 final = float4(0.0f, 0.0f, 0.0f, 0.0f);
-	float4 finalNormal = float4(0.0f, 0.0f, 0.0f, 0.0f);
+	float3 final = float3(0.0f, 0.0f, 0.0f);
+	float3 finalNormal = float3(0.0f, 0.0f, 0.0f);
 
 	output.Normal = mul(input.Normal, Transform);
+	float4 inputNormal = float4(output.Normal, 0.0);
 	inputPos = mul(inputPos, Transform);
 
 	if (input.BoneIndices.x >= 0) {
 		final += mul(BoneTransform[input.BoneIndices.x], inputPos) * input.BoneWeights.x;
-		finalNormal += mul(BoneTransform[input.BoneIndices.x], output.Normal) * input.BoneWeights.x;
+		finalNormal += mul(BoneTransform[input.BoneIndices.x], inputNormal) * input.BoneWeights.x;
 
 		if (input.BoneIndices.y >= 0) {
 			final += mul(BoneTransform[input.BoneIndices.y], inputPos) * input.BoneWeights.y;
-			finalNormal += mul(BoneTransform[input.BoneIndices.y], output.Normal) * input.BoneWeights.y;
+			finalNormal += mul(BoneTransform[input.BoneIndices.y], inputNormal) * input.BoneWeights.y;
 
 			if (input.BoneIndices.z >= 0) {
 				final += mul(BoneTransform[input.BoneIndices.z], inputPos) * input.BoneWeights.z;
-				finalNormal += mul(BoneTransform[input.BoneIndices.z], output.Normal) * input.BoneWeights.z;
+				finalNormal += mul(BoneTransform[input.BoneIndices.z], inputNormal) * input.BoneWeights.z;
 			}
 		}
 	}
 	else {
-		final = inputPos;
-		finalNormal = float4(output.Normal, 1.0);
+		final = inputPos.xyz;
+		finalNormal = output.Normal;
 	}
 
 	output.BoneWeight = 0.0;
@@ -126,6 +150,38 @@ VS_OUTPUT VS_STANDARD(VS_INPUT_STANDARD input) {
 	return output;
 }
 
+float3 DecodeOctahedral(float2 e) {
+	float3 n = float3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	float t = saturate(-n.z);
+	n.xy += (n.xy >= 0.0) ? -t : t;
+
+	return normalize(n);
+}
+
+float4 DecodePosition(float4 pos) {
+	return float4(pos.xyz * PositionScale.xyz + PositionOffset.xyz, 1.0);
+}
+
+VS_OUTPUT VS_SKINNED_COMPRESSED(VS_INPUT_SKINNED_COMPRESSED input) {
+	VS_INPUT_SKINNED decoded;
+	decoded.Pos = DecodePosition(input.Pos);
+	decoded.TexCoord = input.TexCoord;
+	decoded.Normal = float4(DecodeOctahedral(input.Normal), 0.0);
+	decoded.BoneIndices = (input.BoneIndices == 255) ? -1 : (int4)input.BoneIndices;
+	decoded.BoneWeights = input.BoneWeights;
+
+	return VS_SKINNED(decoded);
+}
+
+VS_OUTPUT VS_STANDARD_COMPRESSED(VS_INPUT_STANDARD_COMPRESSED input) {
+	VS_INPUT_STANDARD decoded;
+	decoded.Pos = DecodePosition(input.Pos);
+	decoded.TexCoord = input.TexCoord;
+	decoded.Normal = float4(DecodeOctahedral(input.Normal), 0.0);
+
+	return VS_STANDARD(decoded);
+}
+
 float4 PS(VS_OUTPUT input) : SV_Target {
 	//return float4((input.Normal + float3(1.0, 1.0, 1.0))/2.0, 1.0);
 	//return float4(input.BoneWeight, 0.0, 0.0, 1.0);
@@ -18,6 +18,16 @@ void dbasic::AnimationExportData::Clear() {
 
 }
 
+void dbasic::AnimationExportData::MoveFrom(AnimationExportData *data) {
+    m_referenceFrame = data->m_referenceFrame;
+
+    m_keyframes = std::move(data->m_keyframes);
+    m_poses = std::move(data->m_poses);
+    m_motions = std::move(data->m_motions);
+
+    data->Clear();
+}
+
 dbasic::ObjectKeyframeDataExport *dbasic::AnimationExportData::AddObjectKeyData(char *object) {
     ObjectKeyframeDataExport *keyframeData = &m_keyframes.New();
 
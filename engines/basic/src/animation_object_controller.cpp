@@ -42,13 +42,10 @@ void dbasic::AnimationObjectController::Update() {
 
         float interp = interpDistance / totalDistance;
 
-        ysVector vInterpLow = ysMath::LoadScalar(1.0f - interp);
-        ysVector vInterpHigh = ysMath::LoadScalar(interp);
-
         ysQuaternion lowRot = m_timeline[low].GetRotationKey();
         ysQuaternion highRot = m_timeline[high].GetRotationKey();
 
-        targetRotation = ysMath::Add(ysMath::Mul(vInterpLow, lowRot), ysMath::Mul(vInterpHigh, highRot));
+        targetRotation = ysMath::QuatSlerp(lowRot, highRot, interp);
     }
 
     m_target->SetOrientation(targetRotation);
@@ -3,16 +3,250 @@
 #include "../include/animation_export_file.h"
 #include "../include/delta_engine.h"
 
-#include <sys/stat.h>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+namespace {
+
+    void AddStatistics(ysGeometryPreprocessing::VertexCacheStatistics *total, const ysGeometryPreprocessing::VertexCacheStatistics &statistics) {
+        total->FaceCount += statistics.FaceCount;
+        total->VertexCount += statistics.VertexCount;
+        total->CacheMisses += statistics.CacheMisses;
+    }
+
+    void PreprocessObject(ysObjectData *object, dbasic::Material *material, float scale, bool meshlets, dbasic::AssetManager::CompileStatistics *statistics) {
+        if (object->m_objectInformation.ObjectType == ysObjectData::TYPE_GEOMETRY) {
+            ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(object);
+            ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(object);
+            ysGeometryPreprocessing::SeparateBySmoothingGroups(object);
+            ysGeometryPreprocessing::CalculateNormals(object);
+
+            if ((material != NULL) && material->UsesNormalMap())
+                ysGeometryPreprocessing::CalculateTangents(object, 0);
+
+            if ((material != NULL) && (material->UsesNormalMap() || material->UsesSpecularMap() || material->UsesDiffuseMap())) {
+                for (int ii = 0; ii < object->m_objectStatistics.NumUVChannels; ii++) {
+                    ysGeometryPreprocessing::SeparateByUVGroups(object, ii);
+                }
+            }
+
+            ysGeometryPreprocessing::SortBoneWeights(object);
+        }
+
+        ysGeometryPreprocessing::CalculateNormals(object);
+        ysGeometryPreprocessing::UniformScale(object, scale);
+
+        memset(statistics, 0, sizeof(dbasic::AssetManager::CompileStatistics));
+
+        // Final order of faces and vertices, the geometry itself is done
+        if (object->m_objectInformation.ObjectType == ysObjectData::TYPE_GEOMETRY) {
+            statistics->CacheBefore = ysGeometryPreprocessing::AnalyzeVertexCache(object);
+
+            ysGeometryPreprocessing::OptimizeVertexCache(object);
+            ysGeometryPreprocessing::OptimizeOverdraw(object);
+            ysGeometryPreprocessing::OptimizeVertexFetch(object);
+
+            if (meshlets) ysGeometryPreprocessing::BuildMeshlets(object);
+
+            statistics->CacheAfter = ysGeometryPreprocessing::AnalyzeVertexCache(object);
+        }
+    }
+
+    // Everything besides the source and material that changes the output
+    struct CompileOptions {
+        float Scale;
+        int CompressVertices;
+        int BuildMeshlets;
+        unsigned int CompilerVersion;
+        unsigned int OutputVersion;
+    };
+
+    struct ObjectKey {
+        uint64_t SourceHash;
+        uint64_t OptionsHash;
+        unsigned int MaterialFlags;
+        unsigned int Padding;
+    };
+
+    // Material properties that PreprocessObject() depends on
+    unsigned int GetMaterialFlags(dbasic::Material *material) {
+        if (material == NULL) return 0x0;
+
+        unsigned int flags = 0x0;
+        if (material->UsesNormalMap()) flags |= 0x1;
+        if (material->UsesSpecularMap()) flags |= 0x2;
+        if (material->UsesDiffuseMap()) flags |= 0x4;
+
+        return flags;
+    }
+
+    uint64_t GetObjectKey(uint64_t sourceHash, uint64_t optionsHash, unsigned int materialFlags) {
+        ObjectKey key;
+        memset(&key, 0, sizeof(ObjectKey));
+        key.SourceHash = sourceHash;
+        key.OptionsHash = optionsHash;
+        key.MaterialFlags = materialFlags;
+
+        return ysHash::XXH64(&key, sizeof(ObjectKey));
+    }
+
+    uint64_t GetFileLength(const char *fname) {
+        std::ifstream file(fname, std::ios::in | std::ios::binary | std::ios::ate);
+        return file.is_open() ? (uint64_t)file.tellg() : 0;
+    }
+
+    // --
+    // Hands objects from the reading thread to the preprocessing workers.
+    //
+    // Objects are claimed in the order they were read. The preprocessing
+    // stages only touch the object itself (and read its material) so any
+    // number of objects can be processed at once. Objects found in the
+    // compile cache are published as null and only passed through.
+    // --
+    class CompilePipeline {
+    public:
+        CompilePipeline() {
+            Objects = nullptr;
+            Materials = nullptr;
+            Statistics = nullptr;
+            Processed = nullptr;
+            CachedObjects = nullptr;
+            ObjectCount = 0;
+            ReadCount = 0;
+            Scale = 1.0f;
+
+            m_nextToProcess = 0;
+            m_stop = false;
+        }
+
+        ~CompilePipeline() {
+            Stop();
+        }
+
+        void Start(int workerCount) {
+            m_workers.Reserve(workerCount);
+            for (int i = 0; i < workerCount; i++) {
+                m_workers.New() = std::thread(&CompilePipeline::Work, this);
+            }
+        }
+
+        // Stops the workers once their current object is done
+        void Stop() {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_stop = true;
+            }
+
+            m_objectRead.notify_all();
+
+            for (int i = 0; i < m_workers.GetNumObjects(); i++) {
+                if (m_workers[i].joinable()) m_workers[i].join();
+            }
+
+            m_workers.Clear();
+        }
+
+        void Publish(int index, ysObjectData *object, dbasic::Material *material) {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                Objects[index] = object;
+                Materials[index] = material;
+                ReadCount = index + 1;
+            }
+
+            // Workers waiting for more objects also have to see the last one
+            if (ReadCount == ObjectCount) m_objectRead.notify_all();
+            else m_objectRead.notify_one();
+        }
+
+        bool IsProcessed(int index) {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return Processed[index];
+        }
+
+        void WaitProcessed(int index) {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_objectProcessed.wait(lock, [this, index] { return Processed[index]; });
+        }
+
+        ysObjectData **Objects;
+        dbasic::Material **Materials;
+        dbasic::AssetManager::CompileStatistics *Statistics;
+        bool *Processed;
+
+        // Index in the previous output, -1 if the object has to be compiled
+        int *CachedObjects;
+
+        int ObjectCount;
+        int ReadCount;
+        float Scale;
+        bool Meshlets;
+
+    protected:
+        void Work() {
+            std::unique_lock<std::mutex> lock(m_lock);
+
+            while (true) {
+                m_objectRead.wait(lock, [this] {
+                    return m_stop || m_nextToProcess < ReadCount || m_nextToProcess >= ObjectCount;
+                });
+
+                if (m_stop || m_nextToProcess >= ObjectCount) return;
+
+                const int index = m_nextToProcess++;
+
+                lock.unlock();
+                if (Objects[index] != nullptr) {
+                    PreprocessObject(Objects[index], Materials[index], Scale, Meshlets, &Statistics[index]);
+                }
+                lock.lock();
+
+                Processed[index] = true;
+                m_objectProcessed.notify_all();
+            }
+        }
+
+        std::mutex m_lock;
+        std::condition_variable m_objectRead;
+        std::condition_variable m_objectProcessed;
+
+        ysExpandingArray<std::thread> m_workers;
+
+        int m_nextToProcess;
+        bool m_stop;
+    };
+
+} /* namespace */
 
 dbasic::AssetManager::AssetManager() : ysObject("ASSET_MANAGER") {
     m_engine = NULL;
+    m_device = NULL;
+    m_loader = NULL;
+
+    memset(&m_compileStatistics, 0, sizeof(CompileStatistics));
+    m_compressVertices = false;
+    m_buildMeshlets = false;
 }
 
 dbasic::AssetManager::~AssetManager() {
     /* void */
 }
 
+ysDevice *dbasic::AssetManager::GetDevice() {
+    if (m_device != NULL) return m_device;
+    return (m_engine != NULL) ? m_engine->GetDevice() : NULL;
+}
+
+ysAsyncLoader *dbasic::AssetManager::GetLoader() {
+    if (m_loader != NULL) return m_loader;
+    return (m_engine != NULL) ? m_engine->GetAssetLoader() : NULL;
+}
+
 dbasic::Material *dbasic::AssetManager::NewMaterial() {
     Material *newMaterial = m_materials.NewGeneric<Material>();
     return newMaterial;
@@ -70,121 +304,360 @@ dbasic::ModelAsset *dbasic::AssetManager::GetModelAsset(const char *name) {
     return NULL;
 }
 
-ysError dbasic::AssetManager::CompileSceneFile(const char *fname, float scale, bool force) {
+ysError dbasic::AssetManager::CompileSceneFile(const char *fname, float scale, bool force, int workerCount) {
     YDS_ERROR_DECLARE("CompileSceneFile");
 
-    char total_path[512];
-    strcpy_s(total_path, 512, fname);
-
-    ysToolGeometryFile toolFile;
-    strcat_s(total_path, 512, ".ysc");
-    YDS_NESTED_ERROR_CALL(toolFile.Open(total_path));
+    memset(&m_compileStatistics, 0, sizeof(CompileStatistics));
+
+    char sourcePath[512], outputPath[512], indexPath[512], temporaryPath[512];
+    strcpy_s(sourcePath, 512, fname);
+    strcat_s(sourcePath, 512, ".ysc");
+    strcpy_s(outputPath, 512, fname);
+    strcat_s(outputPath, 512, ".ysce");
+    strcpy_s(indexPath, 512, fname);
+    strcat_s(indexPath, 512, ".ysci");
+    strcpy_s(temporaryPath, 512, fname);
+    strcat_s(temporaryPath, 512, ".ysce.tmp");
+
+    CompileOptions options;
+    memset(&options, 0, sizeof(CompileOptions));
+    options.Scale = scale;
+    options.CompressVertices = m_compressVertices ? 1 : 0;
+    options.BuildMeshlets = m_buildMeshlets ? 1 : 0;
+    options.CompilerVersion = CompilerVersion;
+    options.OutputVersion = ysGeometryExportFile::FileVersion;
+
+    const uint64_t optionsHash = ysHash::XXH64(&options, sizeof(CompileOptions));
+
+    uint64_t sourceHash = 0;
+    const bool sourceHashed = ysToolGeometryFile::HashFile(sourcePath, &sourceHash);
+
+    // The previous output can only be copied from if the index describes it
+    ysCompileCache cache;
+    ysCompiledSceneFile previous;
+
+    bool cacheValid = !force && cache.Load(indexPath) &&
+        cache.GetOptionsHash() == optionsHash &&
+        ysCompiledSceneFile::IsCurrentVersion(outputPath);
+
+    if (cacheValid) {
+        cacheValid = previous.Open(outputPath) == ysError::YDS_NO_ERROR &&
+            previous.GetObjectCount() == cache.GetEntryCount() &&
+            previous.GetFileSize() == cache.GetOutputSize();
+    }
 
-    strcpy_s(total_path, 512, fname);
-    strcat_s(total_path, 512, ".ysce");
+    if (!cacheValid) {
+        previous.Close();
+        cache.Clear();
+    }
+    else if (sourceHashed && cache.GetSourceHash() == sourceHash) {
+        bool materialsChanged = false;
+        for (int i = 0; i < cache.GetEntryCount() && !materialsChanged; i++) {
+            const ysCompileCache::Entry &entry = cache.GetEntry(i);
+            materialsChanged = GetMaterialFlags(FindMaterial(entry.MaterialName)) != entry.MaterialFlags;
+        }
 
-    if (toolFile.GetCompilationStatus() == ysToolGeometryFile::CompilationStatus::Compiled && !force) {
-        // Check if the file actually exists
-        struct stat buffer;
-        if (stat(total_path, &buffer) == 0) {
-            YDS_NESTED_ERROR_CALL(toolFile.Close());
+        // Nothing changed, no compilation required
+        if (!materialsChanged) {
+            m_compileStatistics.ObjectCount = cache.GetEntryCount();
+            m_compileStatistics.CachedObjectCount = cache.GetEntryCount();
 
-            // File already exists, no compilation required
             return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
         }
     }
 
+    ysToolGeometryFile toolFile;
+    YDS_NESTED_ERROR_CALL(toolFile.Open(sourcePath));
+
+    // Written next to the previous output since objects are still copied
+    // from it, it's only replaced once the new file is complete
     ysGeometryExportFile exportFile;
-    exportFile.Open(total_path);
+    YDS_NESTED_ERROR_CALL(exportFile.Open(temporaryPath));
 
-    ysObjectData **objects = new ysObjectData * [toolFile.GetObjectCount()];
-    int objectCount = toolFile.GetObjectCount();
+    const int objectCount = toolFile.GetObjectCount();
 
-    CompiledHeader header;
-    header.ObjectCount = objectCount;
+    if (workerCount < 0) {
+        const int hardwareThreads = (int)std::thread::hardware_concurrency();
+        workerCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+    }
 
-    YDS_NESTED_ERROR_CALL(exportFile.WriteCustomData(&header, sizeof(CompiledHeader)));
+    if (workerCount > objectCount) workerCount = objectCount;
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+
+    CompilePipeline pipeline;
+    pipeline.Objects = arena->AllocateArray<ysObjectData *>(objectCount);
+    pipeline.Materials = arena->AllocateArray<Material *>(objectCount);
+    pipeline.Statistics = arena->AllocateArray<CompileStatistics>(objectCount);
+    pipeline.Processed = arena->AllocateArray<bool>(objectCount);
+    pipeline.CachedObjects = arena->AllocateArray<int>(objectCount);
+    pipeline.ObjectCount = objectCount;
+    pipeline.Scale = scale;
+    pipeline.Meshlets = m_buildMeshlets;
+
+    for (int i = 0; i < objectCount; i++) pipeline.Processed[i] = false;
+
+    pipeline.Start(workerCount);
+
+    ysCompileCache newCache;
+    newCache.SetSourceHash(sourceHash);
+    newCache.SetOptionsHash(optionsHash);
+
+    auto writeObject = [&](int index) {
+        if (pipeline.CachedObjects[index] >= 0) return exportFile.WriteCompiledObject(previous, pipeline.CachedObjects[index]);
+        else return exportFile.WriteObject(pipeline.Objects[index], m_compressVertices);
+    };
+
+    // Objects are read and written on this thread in file order, the
+    // file classes and the error system aren't thread safe
+    ysError result = ysError::YDS_NO_ERROR;
+    int written = 0;
+
+    for (int i = 0; i < objectCount && result == ysError::YDS_NO_ERROR; i++) {
+        ysObjectData *object = nullptr;
+        uint64_t objectHash = 0;
+        result = toolFile.ReadObject(&object, &objectHash);
+        if (result != ysError::YDS_NO_ERROR) break;
+
+        Material *material = FindMaterial(object->m_materialName);
+
+        ysCompileCache::Entry entry;
+        memset(&entry, 0, sizeof(ysCompileCache::Entry));
+        entry.MaterialFlags = GetMaterialFlags(material);
+        entry.Key = GetObjectKey(objectHash, optionsHash, entry.MaterialFlags);
+        strcpy_s(entry.MaterialName, 64, object->m_materialName);
+        newCache.AddEntry(entry);
+
+        // Unchanged objects are copied from the previous output
+        pipeline.CachedObjects[i] = cache.Find(entry.Key);
+        if (pipeline.CachedObjects[i] >= 0) {
+            memset(&pipeline.Statistics[i], 0, sizeof(CompileStatistics));
+            m_compileStatistics.CachedObjectCount++;
+
+            delete object;
+            object = nullptr;
+        }
 
-    for (int i = 0; i < objectCount; i++) {
-        YDS_NESTED_ERROR_CALL(toolFile.ReadObject(&objects[i]));
-        Material *material = FindMaterial(objects[i]->m_materialName);
+        if (workerCount == 0) {
+            if (object != nullptr) PreprocessObject(object, material, scale, m_buildMeshlets, &pipeline.Statistics[i]);
 
-        if (objects[i]->m_objectInformation.ObjectType == ysObjectData::TYPE_GEOMETRY) {
-            ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(objects[i]);
-            ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(objects[i]);
-            ysGeometryPreprocessing::SeparateBySmoothingGroups(objects[i]);
-            ysGeometryPreprocessing::CalculateNormals(objects[i]);
+            pipeline.Objects[i] = object;
+            result = writeObject(i);
 
-            if ((material != NULL) && material->UsesNormalMap())
-                ysGeometryPreprocessing::CalculateTangents(objects[i], 0);
+            delete object;
+            pipeline.Objects[i] = nullptr;
+            written++;
 
-            if ((material != NULL) && (material->UsesNormalMap() || material->UsesSpecularMap() || material->UsesDiffuseMap())) {
-                int startingVerts = objects[i]->m_objectStatistics.NumVertices;
-                for (int ii = 0; ii < objects[i]->m_objectStatistics.NumUVChannels; ii++) {
-                    ysGeometryPreprocessing::SeparateByUVGroups(objects[i], ii);
-                }
-            }
+            continue;
+        }
+
+        pipeline.Publish(i, object, material);
 
-            ysGeometryPreprocessing::SortBoneWeights(objects[i]);
+        // Write whatever is already finished while the workers catch up
+        while (result == ysError::YDS_NO_ERROR && written <= i && pipeline.IsProcessed(written)) {
+            result = writeObject(written);
+
+            delete pipeline.Objects[written];
+            pipeline.Objects[written++] = nullptr;
         }
+    }
 
-        ysGeometryPreprocessing::CalculateNormals(objects[i]);
-        ysGeometryPreprocessing::UniformScale(objects[i], scale);
+    while (result == ysError::YDS_NO_ERROR && written < objectCount) {
+        pipeline.WaitProcessed(written);
+        result = writeObject(written);
 
-        YDS_NESTED_ERROR_CALL(exportFile.WriteObject(objects[i]));
+        delete pipeline.Objects[written];
+        pipeline.Objects[written++] = nullptr;
     }
 
-    // Clear memory
+    // Objects that were read but never written are only left over on failure
+    pipeline.Stop();
+    for (int i = written; i < pipeline.ReadCount; i++) {
+        delete pipeline.Objects[i];
+    }
+
+    // The previous output is left as it was, along with its index
+    if (result != ysError::YDS_NO_ERROR) {
+        exportFile.Close();
+        remove(temporaryPath);
+
+        toolFile.Close();
+
+        YDS_ERROR_RETURN_MANUAL();
+        return result;
+    }
+
+    m_compileStatistics.ObjectCount = objectCount;
     for (int i = 0; i < objectCount; i++) {
-        delete objects[i];
+        AddStatistics(&m_compileStatistics.CacheBefore, pipeline.Statistics[i].CacheBefore);
+        AddStatistics(&m_compileStatistics.CacheAfter, pipeline.Statistics[i].CacheAfter);
     }
 
-    delete[] objects;
+    // Write the compiled file
+    YDS_NESTED_ERROR_CALL(exportFile.Close());
+    previous.Close();
+
+    // The index is removed first so that it never sits next to an output
+    // that it doesn't describe
+    remove(indexPath);
+    remove(outputPath);
+    if (rename(temporaryPath, outputPath) != 0) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+
+    newCache.SetOutputSize(GetFileLength(outputPath));
+    YDS_NESTED_ERROR_CALL(newCache.Save(indexPath));
 
     // Update compilation status
     YDS_NESTED_ERROR_CALL(toolFile.UpdateCompilationStatus(ysToolGeometryFile::CompilationStatus::Compiled));
 
-    // Close files
-    exportFile.Close();
     toolFile.Close();
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
+struct dbasic::AssetManager::SceneLoad {
+    char Name[512];
+    ysCompiledSceneFile File;
+
+    // Local transform of every object, worked out ahead of FinalizeScene()
+    ysExpandingArray<ysMatrix, 0, 16> Transforms;
+};
+
 ysError dbasic::AssetManager::LoadSceneFile(const char *fname) {
+    YDS_ERROR_DECLARE("LoadSceneFile");
+
+    SceneLoad load;
+    YDS_NESTED_ERROR_CALL(OpenScene(&load, fname));
+    YDS_NESTED_ERROR_CALL(PrepareScene(&load));
+    YDS_NESTED_ERROR_CALL(FinalizeScene(&load));
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysLoadHandle dbasic::AssetManager::LoadSceneFileAsync(const char *fname, int priority) {
+    ysAsyncLoader *loader = GetLoader();
+    if (loader == NULL) return ysLoadHandle::Null();
+
+    std::shared_ptr<SceneLoad> load = std::make_shared<SceneLoad>();
+    strcpy_s(load->Name, 512, fname);
+
+    // The mapping is faulted in on the I/O thread so that the upload
+    // doesn't wait on the disk
+    ysAsyncLoader::Request request;
+    request.Priority = priority;
+    request.Read = [this, load] {
+        const ysError result = OpenScene(load.get(), load->Name);
+        if (result == ysError::YDS_NO_ERROR) load->File.Prefetch();
+
+        return result;
+    };
+
+    request.Process = [this, load] { return PrepareScene(load.get()); };
+    request.Finalize = [this, load](bool *) { return FinalizeScene(load.get()); };
+
+    return loader->Submit(request);
+}
+
+ysError dbasic::AssetManager::OpenScene(SceneLoad *load, const char *fname) {
+    YDS_ERROR_DECLARE("OpenScene");
+
     char fullPath[512];
     strcpy_s(fullPath, 512, fname);
     strcat_s(fullPath, 512, ".ysce");
 
-    std::fstream file(fullPath, std::ios::in | std::ios::binary);
+    YDS_NESTED_ERROR_CALL(load->File.Open(fullPath));
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError dbasic::AssetManager::PrepareScene(SceneLoad *load) {
+    YDS_ERROR_DECLARE("PrepareScene");
+
+    const ysCompiledSceneFile &file = load->File;
+    const int objectCount = file.GetObjectCount();
+
+    load->Transforms.Clear();
+    load->Transforms.Preallocate(objectCount);
+
+    for (int i = 0; i < objectCount; i++) {
+        const ysGeometryExportFile::ObjectOutputHeader &header = file.GetObject(i)->Header;
+
+        if (header.ObjectType == ysObjectData::TYPE_PLANE) {
+            return YDS_ERROR_RETURN_MSG(ysError::YDS_UNSUPPORTED_TYPE, "Planes not supported.");
+        }
+
+        // Load Object Transformation
+        ysVector translation = (header.ObjectType == ysObjectData::TYPE_GEOMETRY)
+            ? ysMath::LoadVector(header.Position)
+            : ysMath::LoadVector(header.Position, 1.0f);
+        ysVector scale = ysMath::LoadVector(header.Scale);
+
+        ysMatrix translationMatrix = ysMath::TranslationTransform(translation);
+        ysMatrix scaleMatrix = ysMath::ScaleTransform(scale);
+
+        ysVector x = ysMath::Constants::XAxis;
+        ysVector y = ysMath::Constants::YAxis;
+        ysVector z = ysMath::Constants::ZAxis;
 
-    CompiledHeader fileHeader;
-    file.read((char *)&fileHeader, sizeof(CompiledHeader));
+        ysMatrix rotx = ysMath::RotationTransform(x, header.OrientationEuler.x * ysMath::Constants::PI / 180.0f);
+        ysMatrix roty = ysMath::RotationTransform(y, header.OrientationEuler.y * ysMath::Constants::PI / 180.0f);
+        ysMatrix rotz = ysMath::RotationTransform(z, header.OrientationEuler.z * ysMath::Constants::PI / 180.0f);
 
-    unsigned short *indicesFile = new unsigned short[2 * 1024 * 1024 / 2]; // 4 MB
-    char *verticesFile = (char *)malloc(4 * 1024 * 1024); // 16 MB
+        ysMatrix &transform = load->Transforms.New();
+        transform = ysMath::LoadIdentity();
+        transform = ysMath::MatMult(transform, translationMatrix);
 
-    int currentIndexOffset = 0;
-    int currentVertexByteOffset = 0;
+        transform = ysMath::MatMult(transform, rotz);
+        transform = ysMath::MatMult(transform, roty);
+        transform = ysMath::MatMult(transform, rotx);
+
+        transform = ysMath::MatMult(transform, scaleMatrix);
+    }
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError dbasic::AssetManager::FinalizeScene(SceneLoad *load) {
+    YDS_ERROR_DECLARE("FinalizeScene");
+
+    ysDevice *device = GetDevice();
+    if (device == NULL) return YDS_ERROR_RETURN(ysError::YDS_NO_DEVICE);
+
+    ysCompiledSceneFile &file = load->File;
+
+    // Checked before anything is created so that a scene can't be half loaded
+    if (m_engine != NULL && !m_engine->SupportsCompressedVertices()) {
+        for (int i = 0; i < file.GetObjectCount(); i++) {
+            if ((file.GetObject(i)->Header.Flags & ysGeometryExportFile::MDF_COMPRESSED) != 0) {
+                return YDS_ERROR_RETURN_MSG(ysError::YDS_UNSUPPORTED_TYPE, "Compressed vertices not supported by the device.");
+            }
+        }
+    }
 
     int initialIndex = m_sceneObjects.GetNumObjects();
 
-    ysGPUBuffer *indexBuffer;
-    ysGPUBuffer *vertexBuffer;
+    // The vertex and index blocks of the whole scene are uploaded straight
+    // from the mapped file
+    ysGPUBuffer *indexBuffer = NULL;
+    ysGPUBuffer *vertexBuffer = NULL;
 
-    m_engine->GetDevice()->CreateIndexBuffer(&indexBuffer, 1 * 1024 * 1024, NULL, false);
-    m_engine->GetDevice()->CreateVertexBuffer(&vertexBuffer, 4 * 1024 * 1024, NULL, false);
+    if (file.GetIndexDataSize() > 0) {
+        YDS_NESTED_ERROR_CALL(device->CreateIndexBuffer(&indexBuffer, file.GetIndexDataSize(), (char *)file.GetIndexData(), false));
+    }
 
-    for (int i = 0; i < fileHeader.ObjectCount; i++) {
+    if (file.GetVertexDataSize() > 0) {
+        YDS_NESTED_ERROR_CALL(device->CreateVertexBuffer(&vertexBuffer, file.GetVertexDataSize(), (char *)file.GetVertexData(), false));
+    }
 
-        ysGeometryExportFile::ObjectOutputHeader header;
-        file.read((char *)&header, sizeof(ysGeometryExportFile::ObjectOutputHeader));
+    const int objectCount = file.GetObjectCount();
+    for (int i = 0; i < objectCount; i++) {
+        const ysCompiledSceneFile::ObjectTableEntry *entry = file.GetObject(i);
+        const ysGeometryExportFile::ObjectOutputHeader &header = entry->Header;
 
         SceneObjectAsset *newObject = NewSceneObject();
 
         if (header.ObjectType == ysObjectData::TYPE_BONE ||
             header.ObjectType == ysObjectData::TYPE_GROUP ||
-            header.ObjectType == ysObjectData::TYPE_PLANE ||
             header.ObjectType == ysObjectData::TYPE_INSTANCE) {
 
             newObject->m_type = header.ObjectType;
@@ -194,35 +667,9 @@ ysError dbasic::AssetManager::LoadSceneFile(const char *fname) {
 
             newObject->m_material = FindMaterial(header.ObjectMaterial);
 
-            // Load Object Transformation
-            ysVector translation = ysMath::LoadVector(header.Position, 1.0f);
-            ysVector scale = ysMath::LoadVector(header.Scale);
-
-            ysMatrix translationMatrix = ysMath::TranslationTransform(translation);
-            ysMatrix scaleMatrix = ysMath::ScaleTransform(scale);
-
-            ysVector x = ysMath::Constants::XAxis;
-            ysVector y = ysMath::Constants::YAxis;
-            ysVector z = ysMath::Constants::ZAxis;
-
-            ysMatrix rotx = ysMath::RotationTransform(x, header.OrientationEuler.x * ysMath::Constants::PI / 180.0f);
-            ysMatrix roty = ysMath::RotationTransform(y, header.OrientationEuler.y * ysMath::Constants::PI / 180.0f);
-            ysMatrix rotz = ysMath::RotationTransform(z, header.OrientationEuler.z * ysMath::Constants::PI / 180.0f);
-
-            newObject->ApplyTransformation(translationMatrix);
-
-            newObject->ApplyTransformation(rotz);
-            newObject->ApplyTransformation(roty);
-            newObject->ApplyTransformation(rotx);
-
-            newObject->ApplyTransformation(scaleMatrix);
-
+            newObject->ApplyTransformation(load->Transforms[i]);
             newObject->m_localOrientation = ysMath::LoadVector(header.Orientation);
-            newObject->m_localPosition = translation;
-
-            if (header.ObjectType == ysObjectData::TYPE_PLANE) {
-                return YDS_ERROR_RETURN_MSG(ysError::YDS_UNSUPPORTED_TYPE, "Planes not supported.");
-            }
+            newObject->m_localPosition = ysMath::LoadVector(header.Position, 1.0f);
 
             if (header.ObjectType == ysObjectData::TYPE_INSTANCE) {
                 newObject->m_geometry = GetModelAsset(header.ParentInstanceIndex);
@@ -232,24 +679,15 @@ ysError dbasic::AssetManager::LoadSceneFile(const char *fname) {
             // New model asset
             ModelAsset *newModelAsset = NewModelAsset();
 
-            int vertexDataSize = header.VertexDataSize;
-            int stride = header.VertexDataSize / header.NumVertices;
-
-            if ((currentVertexByteOffset % stride) != 0) {
-                currentVertexByteOffset += (stride - (currentVertexByteOffset % stride));
-            }
-
-            file.read((char *)(verticesFile + currentVertexByteOffset), vertexDataSize);
-            file.read((char *)(indicesFile + currentIndexOffset), sizeof(unsigned short) * header.NumFaces * 3);
+            // Empty meshes have no vertex data
+            int stride = (header.NumVertices > 0) ? header.VertexDataSize / header.NumVertices : 0;
 
             if (header.NumBones > 0) {
+                const int *boneMap = file.GetBoneMap(entry);
                 newModelAsset->m_boneMap.Preallocate(header.NumBones);
 
                 for (int bone = 0; bone < header.NumBones; bone++) {
-                    int &newBone = newModelAsset->m_boneMap.New();
-
-                    file.read((char *)(&newBone), sizeof(int));
-                    newBone += initialIndex;
+                    newModelAsset->m_boneMap.New() = boneMap[bone] + initialIndex;
                 }
             }
 
@@ -257,14 +695,34 @@ ysError dbasic::AssetManager::LoadSceneFile(const char *fname) {
             newObject->m_type = ysObjectData::TYPE_GEOMETRY;
 
             newModelAsset->m_vertexSize = stride;
+            newModelAsset->m_indexSize = ysGeometryExportFile::GetIndexSize(header);
             newModelAsset->m_UVChannelCount = header.NumUVChannels;
             newModelAsset->m_vertexCount = header.NumVertices;
             newModelAsset->m_faceCount = header.NumFaces;
-            newModelAsset->m_baseIndex = currentIndexOffset;
-            newModelAsset->m_baseVertex = currentVertexByteOffset / stride;
+            newModelAsset->m_baseIndex = entry->IndexOffset;
+            newModelAsset->m_baseVertex = (stride > 0) ? entry->VertexOffset / stride : 0;
             newModelAsset->m_vertexBuffer = vertexBuffer;
             newModelAsset->m_indexBuffer = indexBuffer;
 
+            if (header.NumMeshlets > 0) {
+                const ysObjectData::Meshlet *meshlets = file.GetMeshlets(entry);
+                newModelAsset->m_meshlets.Preallocate(header.NumMeshlets);
+
+                for (int meshlet = 0; meshlet < header.NumMeshlets; meshlet++) {
+                    newModelAsset->m_meshlets.New() = meshlets[meshlet];
+                }
+            }
+
+            if ((header.Flags & ysGeometryExportFile::MDF_COMPRESSED) != 0) {
+                const ysVector3 &minimum = header.MinExtreme;
+                const ysVector3 &maximum = header.MaxExtreme;
+
+                newModelAsset->m_compressedVertices = true;
+                newModelAsset->m_positionOffset = ysVector4(minimum.x, minimum.y, minimum.z, 0.0f);
+                newModelAsset->m_positionScale =
+                    ysVector4(maximum.x - minimum.x, maximum.y - minimum.y, maximum.z - minimum.z, 1.0f);
+            }
+
             strcpy_s(newObject->m_name, 64, header.ObjectName);
             strcpy_s(newModelAsset->m_name, 64, header.ObjectName);
 
@@ -272,44 +730,13 @@ ysError dbasic::AssetManager::LoadSceneFile(const char *fname) {
             newModelAsset->m_defaultMaterial = FindMaterial(header.ObjectMaterial);
             newObject->m_geometry = newModelAsset;
 
-            currentIndexOffset += header.NumFaces * 3;
-            currentVertexByteOffset += header.VertexDataSize;
-
-            // Load Object Transformation
-            ysVector translation = ysMath::LoadVector(header.Position);
-            ysVector scale = ysMath::LoadVector(header.Scale);
-
-            ysMatrix translationMatrix = ysMath::TranslationTransform(translation);
-            ysMatrix scaleMatrix = ysMath::ScaleTransform(scale);
-
-            ysVector x = ysMath::Constants::XAxis;
-            ysVector y = ysMath::Constants::YAxis;
-            ysVector z = ysMath::Constants::ZAxis;
-
-            ysMatrix rotx = ysMath::RotationTransform(x, header.OrientationEuler.x * ysMath::Constants::PI / 180.0f);
-            ysMatrix roty = ysMath::RotationTransform(y, header.OrientationEuler.y * ysMath::Constants::PI / 180.0f);
-            ysMatrix rotz = ysMath::RotationTransform(z, header.OrientationEuler.z * ysMath::Constants::PI / 180.0f);
-
-            newObject->ApplyTransformation(translationMatrix);
-
-            newObject->ApplyTransformation(rotz);
-            newObject->ApplyTransformation(roty);
-            newObject->ApplyTransformation(rotx);
-
-            newObject->ApplyTransformation(scaleMatrix);
-
+            newObject->ApplyTransformation(load->Transforms[i]);
             newObject->m_localOrientation = ysMath::LoadVector(header.Orientation);
-            newObject->m_localPosition = translation;
+            newObject->m_localPosition = ysMath::LoadVector(header.Position);
         }
     }
 
-    m_engine->GetDevice()->EditBufferData(indexBuffer, (char *)indicesFile);
-    m_engine->GetDevice()->EditBufferData(vertexBuffer, (char *)verticesFile);
-
-    delete[] indicesFile;
-    free(verticesFile);
-
-    file.close();
+    file.Close();
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
@@ -354,13 +781,41 @@ ysError dbasic::AssetManager::LoadAnimationFile(const char *fname) {
     YDS_ERROR_DECLARE("LoadAnimationFile");
 
     AnimationExportData *exportAnimationRead = m_animationExportData.New();
+    YDS_NESTED_ERROR_CALL(ReadAnimationFile(fname, exportAnimationRead));
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysLoadHandle dbasic::AssetManager::LoadAnimationFileAsync(const char *fname, int priority) {
+    ysAsyncLoader *loader = GetLoader();
+    if (loader == NULL) return ysLoadHandle::Null();
+
+    // Read into data of its own, the animation is only added to the
+    // manager once it's complete
+    std::shared_ptr<AnimationExportData> data = std::make_shared<AnimationExportData>();
+    const std::string path = fname;
+
+    ysAsyncLoader::Request request;
+    request.Priority = priority;
+    request.Read = [this, data, path] { return ReadAnimationFile(path.c_str(), data.get()); };
+    request.Finalize = [this, data](bool *) {
+        m_animationExportData.New()->MoveFrom(data.get());
+        return ysError::YDS_NO_ERROR;
+    };
+
+    return loader->Submit(request);
+}
+
+ysError dbasic::AssetManager::ReadAnimationFile(const char *fname, AnimationExportData *data) {
+    YDS_ERROR_DECLARE("ReadAnimationFile");
+
     AnimationExportFile animationExportFile;
 
     char buffer[1024];
     sprintf_s(buffer, 1024, "%s.dafc", fname);
 
-    animationExportFile.Open(buffer, AnimationExportFile::OPEN_MODE_READ);
-    animationExportFile.ReadObjectAnimationData(exportAnimationRead);
+    YDS_NESTED_ERROR_CALL(animationExportFile.Open(buffer, AnimationExportFile::OPEN_MODE_READ));
+    YDS_NESTED_ERROR_CALL(animationExportFile.ReadObjectAnimationData(data));
     animationExportFile.Close();
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -37,3 +37,10 @@ ysMatrix dbasic::Bone::GetSkinMatrix() {
 
     return skin;
 }
+
+ysAffineMatrix dbasic::Bone::GetAffineSkinMatrix() {
+    ysAffineMatrix trans = ysMath::LoadAffine(RigidBody.GetTransform());
+    ysAffineMatrix invRef = ysMath::LoadAffine(m_inverseReferenceTransform);
+
+    return ysMath::MatMult(trans, invRef);
+}
@@ -2,6 +2,54 @@
 
 #include "../include/skeleton.h"
 
+#include <memory>
+#include <string>
+
+namespace {
+
+    void GetAnimationFramePath(char *buffer, int size, const char *path, int frame) {
+        sprintf_s(buffer, size, "%s/%.4i.png", path, frame);
+    }
+
+    // Devices only create textures straight from files, so the most that can
+    // be done off the main thread is to have the file read into memory
+    ysError PrefetchFile(const char *fname) {
+        ysMappedFile file;
+
+        const ysError result = file.Open(fname);
+        if (result == ysError::YDS_NO_ERROR) file.Prefetch();
+
+        return result;
+    }
+
+    struct AnimationLoad {
+        AnimationLoad() : Device(nullptr), Start(0), End(-1), Next(0), Textures(nullptr) { /* void */ }
+
+        // Frees whatever was created if the request failed or was cancelled
+        // before the textures were handed over
+        ~AnimationLoad() {
+            if (Textures == nullptr) return;
+
+            for (int i = Start; i < Next; i++) {
+                Device->DestroyTexture(Textures[i - Start]);
+            }
+
+            delete[] Textures;
+        }
+
+        ysDevice *Device;
+        std::string Path;
+        int Start;
+        int End;
+
+        // Next frame to create, textures are handed over to the animation
+        // once they're all created
+        int Next;
+        ysTexture **Textures;
+    };
+
+} /* namespace */
+
 dbasic::DeltaEngine::DeltaEngine() {
     m_device = NULL;
 
@@ -22,6 +70,13 @@ dbasic::DeltaEngine::DeltaEngine() {
 
     m_inputLayout = NULL;
 
+    m_vertexCompressedShader = NULL;
+    m_vertexSkinnedCompressedShader = NULL;
+    m_compressedShaderProgram = NULL;
+    m_skinnedCompressedShaderProgram = NULL;
+    m_compressedInputLayout = NULL;
+    m_skinnedCompressedInputLayout = NULL;
+
     m_initialized = false;
 
     m_clearColor[0] = 0.0F;
@@ -53,6 +108,18 @@ dbasic::DeltaEngine::DeltaEngine() {
     PhysicsSystem.SetEngine(this);
 
     m_currentTarget = DRAW_TARGET_MAIN;
+
+    // Draw queues
+    for (int i = 0; i < MAX_LAYERS; i++) {
+        m_drawQueue[i].First = m_drawQueue[i].Last = nullptr;
+        m_drawQueueGui[i].First = m_drawQueueGui[i].Last = nullptr;
+    }
+
+    m_frameArena.SetMemoryTag(ysMemoryTag::Render);
+    m_frameArena.Initialize(256 * KB);
+
+    // Asset loading
+    m_loadBudget = DefaultLoadBudget;
 }
 
 dbasic::DeltaEngine::~DeltaEngine() {
@@ -111,6 +178,9 @@ ysError dbasic::DeltaEngine::CreateGameWindow(const char *title, void *instance,
     m_timingSystem = ysTimingSystem::Get();
     m_timingSystem->Initialize();
 
+    // Asset loading
+    YDS_NESTED_ERROR_CALL(m_assetLoader.Initialize());
+
     m_initialized = true;
 
     SetWindowSize(m_gameWindow->GetScreenWidth(), m_gameWindow->GetScreenHeight());
@@ -124,6 +194,9 @@ ysError dbasic::DeltaEngine::StartFrame() {
     m_windowSystem->ProcessMessages();
     m_timingSystem->Update();
 
+    // Device uploads for assets that finished loading in the background
+    m_assetLoader.Update(m_loadBudget);
+
     if (IsOpen()) {
         m_device->SetRenderTarget(m_mainRenderTarget);
         m_device->ClearBuffers(m_clearColor);
@@ -140,6 +213,16 @@ ysError dbasic::DeltaEngine::EndFrame() {
         ExecuteDrawQueue(DRAW_TARGET_GUI);
         m_device->Present();
     }
+    else {
+        // Nothing was drawn, the queued draw calls are discarded
+        for (int i = 0; i < MAX_LAYERS; i++) {
+            m_drawQueue[i].First = m_drawQueue[i].Last = nullptr;
+            m_drawQueueGui[i].First = m_drawQueueGui[i].Last = nullptr;
+        }
+    }
+
+    m_frameArena.Reset();
+    ysMemoryTracker::ResetInterval();
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
@@ -147,6 +230,9 @@ ysError dbasic::DeltaEngine::EndFrame() {
 ysError dbasic::DeltaEngine::Destroy() {
     YDS_ERROR_DECLARE("Destroy");
 
+    // Nothing may be uploaded once the device is gone
+    m_assetLoader.Shutdown();
+
     YDS_NESTED_ERROR_CALL(m_device->DestroyRenderTarget(m_mainRenderTarget));
     YDS_NESTED_ERROR_CALL(m_device->DestroyRenderingContext(m_renderingContext));
 
@@ -218,6 +304,36 @@ ysError dbasic::DeltaEngine::InitializeShaders(const char *shaderDirectory) {
     YDS_NESTED_ERROR_CALL(m_device->AttachShader(m_skinnedShaderProgram, m_pixelShader));
     YDS_NESTED_ERROR_CALL(m_device->LinkProgram(m_skinnedShaderProgram));
 
+    if (m_device->GetAPI() == ysContextObject::DIRECTX11 || m_device->GetAPI() == ysContextObject::DIRECTX10) {
+        sprintf_s(buffer, "%s%s", shaderDirectory, "delta_engine_shader.fx");
+        YDS_NESTED_ERROR_CALL(m_device->CreateVertexShader(&m_vertexCompressedShader, buffer, "VS_STANDARD_COMPRESSED"));
+        YDS_NESTED_ERROR_CALL(m_device->CreateVertexShader(&m_vertexSkinnedCompressedShader, buffer, "VS_SKINNED_COMPRESSED"));
+
+        // See ysGeometryExportFile::MDF_COMPRESSED for the layout
+        m_compressedFormat.AddChannel("POSITION", 0, ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16B16A16_UNORM);
+        m_compressedFormat.AddChannel("TEXCOORD", sizeof(short) * 4, ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_FLOAT);
+        m_compressedFormat.AddChannel("NORMAL", sizeof(short) * (4 + 2), ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_SNORM);
+
+        m_skinnedCompressedFormat.AddChannel("POSITION", 0, ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16B16A16_UNORM);
+        m_skinnedCompressedFormat.AddChannel("TEXCOORD", sizeof(short) * 4, ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_FLOAT);
+        m_skinnedCompressedFormat.AddChannel("NORMAL", sizeof(short) * (4 + 2), ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_SNORM);
+        m_skinnedCompressedFormat.AddChannel("BONE_INDICES", sizeof(short) * (4 + 2 + 2), ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UINT);
+        m_skinnedCompressedFormat.AddChannel("BONE_WEIGHTS", sizeof(short) * (4 + 2 + 2) + 4, ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UNORM);
+
+        YDS_NESTED_ERROR_CALL(m_device->CreateInputLayout(&m_compressedInputLayout, m_vertexCompressedShader, &m_compressedFormat));
+        YDS_NESTED_ERROR_CALL(m_device->CreateInputLayout(&m_skinnedCompressedInputLayout, m_vertexSkinnedCompressedShader, &m_skinnedCompressedFormat));
+
+        YDS_NESTED_ERROR_CALL(m_device->CreateShaderProgram(&m_compressedShaderProgram));
+        YDS_NESTED_ERROR_CALL(m_device->AttachShader(m_compressedShaderProgram, m_vertexCompressedShader));
+        YDS_NESTED_ERROR_CALL(m_device->AttachShader(m_compressedShaderProgram, m_pixelShader));
+        YDS_NESTED_ERROR_CALL(m_device->LinkProgram(m_compressedShaderProgram));
+
+        YDS_NESTED_ERROR_CALL(m_device->CreateShaderProgram(&m_skinnedCompressedShaderProgram));
+        YDS_NESTED_ERROR_CALL(m_device->AttachShader(m_skinnedCompressedShaderProgram, m_vertexSkinnedCompressedShader));
+        YDS_NESTED_ERROR_CALL(m_device->AttachShader(m_skinnedCompressedShaderProgram, m_pixelShader));
+        YDS_NESTED_ERROR_CALL(m_device->LinkProgram(m_skinnedCompressedShaderProgram));
+    }
+
     // Create shader controls
     YDS_NESTED_ERROR_CALL(m_device->CreateConstantBuffer(&m_shaderObjectVariablesBuffer, sizeof(ShaderObjectVariables), NULL));
     YDS_NESTED_ERROR_CALL(m_device->CreateConstantBuffer(&m_shaderScreenVariablesBuffer, sizeof(ShaderScreenVariables), NULL));
@@ -240,7 +356,7 @@ ysError dbasic::DeltaEngine::LoadAnimation(Animation **animation, const char *pa
     ysTexture **list = new ysTexture * [end - start + 1];
     char buffer[256];
     for (int i = start; i <= end; i++) {
-        sprintf_s(buffer, 256, "%s/%.4i.png", path, i);
+        GetAnimationFramePath(buffer, 256, path, i);
 
         YDS_NESTED_ERROR_CALL(m_device->CreateTexture(&list[i - start], buffer));
     }
@@ -255,12 +371,80 @@ ysError dbasic::DeltaEngine::LoadAnimation(Animation **animation, const char *pa
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
+ysLoadHandle dbasic::DeltaEngine::LoadTextureAsync(ysTexture **image, const char *fname, int priority) {
+    *image = NULL;
+    const std::string path = fname;
+
+    ysAsyncLoader::Request request;
+    request.Priority = priority;
+    request.Read = [path] { return PrefetchFile(path.c_str()); };
+    request.Finalize = [this, image, path](bool *) { return m_device->CreateTexture(image, path.c_str()); };
+
+    return m_assetLoader.Submit(request);
+}
+
+ysLoadHandle dbasic::DeltaEngine::LoadAnimationAsync(Animation **animation, const char *path, int start, int end, int priority) {
+    *animation = NULL;
+
+    std::shared_ptr<AnimationLoad> load = std::make_shared<AnimationLoad>();
+    load->Device = m_device;
+    load->Path = path;
+    load->Start = start;
+    load->End = end;
+    load->Next = start;
+    load->Textures = new ysTexture * [(end >= start) ? end - start + 1 : 1];
+
+    ysAsyncLoader::Request request;
+    request.Priority = priority;
+    request.Read = [load] {
+        char buffer[256];
+        for (int i = load->Start; i <= load->End; i++) {
+            GetAnimationFramePath(buffer, 256, load->Path.c_str(), i);
+
+            const ysError result = PrefetchFile(buffer);
+            if (result != ysError::YDS_NO_ERROR) return result;
+        }
+
+        return ysError::YDS_NO_ERROR;
+    };
+
+    // One texture per step so that long animations are spread over frames
+    request.Finalize = [this, animation, load](bool *done) {
+        if (load->Next <= load->End) {
+            char buffer[256];
+            GetAnimationFramePath(buffer, 256, load->Path.c_str(), load->Next);
+
+            // Textures created so far are destroyed along with the load
+            const ysError result = m_device->CreateTexture(&load->Textures[load->Next - load->Start], buffer);
+            if (result != ysError::YDS_NO_ERROR) return result;
+
+            load->Next++;
+        }
+
+        if (load->Next <= load->End) {
+            *done = false;
+            return ysError::YDS_NO_ERROR;
+        }
+
+        Animation *newAnimation = new Animation;
+        newAnimation->m_nFrames = load->End - load->Start + 1;
+        newAnimation->m_textures = load->Textures;
+        load->Textures = nullptr;
+
+        *animation = newAnimation;
+
+        return ysError::YDS_NO_ERROR;
+    };
+
+    return m_assetLoader.Submit(request);
+}
+
 void dbasic::DeltaEngine::SubmitSkeleton(Skeleton *skeleton) {
     int nBones = skeleton->GetBoneCount();
 
     for (int i = 0; i < nBones; i++) {
         Bone *bone = skeleton->GetBone(i);
-        m_shaderSkinningControls.BoneTransforms[i] = ysMath::Transpose(skeleton->GetBone(i)->GetSkinMatrix());
+        m_shaderSkinningControls.BoneTransforms[i] = bone->GetAffineSkinMatrix();
     }
 }
 
@@ -399,13 +583,7 @@ ysError dbasic::DeltaEngine::DrawImage(ysTexture *image, int layer, float scaleX
         m_shaderObjectVariables.Lit = 0;
     }
 
-    DrawCall *newCall = nullptr;
-    if (m_currentTarget == DRAW_TARGET_MAIN) {
-        newCall = &m_drawQueue[layer].New();
-    }
-    else if (m_currentTarget == DRAW_TARGET_GUI) {
-        newCall = &m_drawQueueGui[layer].New();
-    }
+    DrawCall *newCall = NewDrawCall(layer);
 
     if (newCall != nullptr) {
         newCall->ObjectVariables = m_shaderObjectVariables;
@@ -439,13 +617,7 @@ ysError dbasic::DeltaEngine::DrawBox(const int color[3], float width, float heig
         m_shaderObjectVariables.Lit = 0;
     }
 
-    DrawCall *newCall = nullptr;
-    if (m_currentTarget == DRAW_TARGET_MAIN) {
-        newCall = &m_drawQueue[layer].New();
-    }
-    else if (m_currentTarget == DRAW_TARGET_GUI) {
-        newCall = &m_drawQueueGui[layer].New();
-    }
+    DrawCall *newCall = NewDrawCall(layer);
 
     if (newCall != nullptr) {
         newCall->ObjectVariables = m_shaderObjectVariables;
@@ -500,16 +672,12 @@ ysError dbasic::DeltaEngine::DrawModel(ModelAsset *model, const ysMatrix &transf
         //m_shaderObjectVariables.MulCol.w = 1.0f;
     }
 
-    DrawCall *newCall = nullptr;
-    if (m_currentTarget == DRAW_TARGET_MAIN) {
-        newCall = &m_drawQueue[layer].New();
-    }
-    else if (m_currentTarget == DRAW_TARGET_GUI) {
-        newCall = &m_drawQueueGui[layer].New();
-    }
+    DrawCall *newCall = NewDrawCall(layer);
 
     if (newCall != nullptr) {
         newCall->ObjectVariables = m_shaderObjectVariables;
+        newCall->ObjectVariables.PositionOffset = model->GetPositionOffset();
+        newCall->ObjectVariables.PositionScale = model->GetPositionScale();
         newCall->Texture = texture;
         newCall->Model = model;
     }
@@ -517,6 +685,24 @@ ysError dbasic::DeltaEngine::DrawModel(ModelAsset *model, const ysMatrix &transf
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
+dbasic::DrawCall *dbasic::DeltaEngine::NewDrawCall(int layer) {
+    DrawQueue *queue = nullptr;
+    if (m_currentTarget == DRAW_TARGET_MAIN) queue = &m_drawQueue[layer];
+    else if (m_currentTarget == DRAW_TARGET_GUI) queue = &m_drawQueueGui[layer];
+
+    if (queue == nullptr) return nullptr;
+
+    DrawCall *newCall = m_frameArena.Allocate<DrawCall>();
+    if (newCall == nullptr) return nullptr;
+
+    newCall->Next = nullptr;
+    if (queue->Last != nullptr) queue->Last->Next = newCall;
+    else queue->First = newCall;
+    queue->Last = newCall;
+
+    return newCall;
+}
+
 ysError dbasic::DeltaEngine::ExecuteDrawQueue(DRAW_TARGET target) {
     YDS_ERROR_DECLARE("ExecuteDrawQueue");
 
@@ -573,28 +759,25 @@ ysError dbasic::DeltaEngine::ExecuteDrawQueue(DRAW_TARGET target) {
     }
 
     for (int i = 0; i < MAX_LAYERS; i++) {
-        int objectsAtLayer = 0;
-
-        if (target == DRAW_TARGET_MAIN) objectsAtLayer = m_drawQueue[i].GetNumObjects();
-        else if (target == DRAW_TARGET_GUI) objectsAtLayer = m_drawQueueGui[i].GetNumObjects();
+        DrawQueue *queue = nullptr;
+        if (target == DRAW_TARGET_MAIN) queue = &m_drawQueue[i];
+        else if (target == DRAW_TARGET_GUI) queue = &m_drawQueueGui[i];
 
-        for (int j = 0; j < objectsAtLayer; j++) {
-            DrawCall *call = nullptr;
-            if (target == DRAW_TARGET_MAIN) call = &m_drawQueue[i][j];
-            else if (target == DRAW_TARGET_GUI) call = &m_drawQueueGui[i][j];
-
-            if (call == nullptr) continue;
+        if (queue == nullptr) continue;
 
+        for (DrawCall *call = queue->First; call != nullptr; call = call->Next) {
             m_device->EditBufferData(m_shaderObjectVariablesBuffer, (char *)(&call->ObjectVariables));
 
             if (call->Model != NULL) {
+                const bool compressed = call->Model->HasCompressedVertices();
+
                 if (call->Model->GetBoneCount() <= 0) {
-                    m_device->UseInputLayout(m_inputLayout);
-                    m_device->UseShaderProgram(m_shaderProgram);
+                    m_device->UseInputLayout(compressed ? m_compressedInputLayout : m_inputLayout);
+                    m_device->UseShaderProgram(compressed ? m_compressedShaderProgram : m_shaderProgram);
                 }
                 else {
-                    m_device->UseInputLayout(m_skinnedInputLayout);
-                    m_device->UseShaderProgram(m_skinnedShaderProgram);
+                    m_device->UseInputLayout(compressed ? m_skinnedCompressedInputLayout : m_skinnedInputLayout);
+                    m_device->UseShaderProgram(compressed ? m_skinnedCompressedShaderProgram : m_skinnedShaderProgram);
                 }
 
                 m_device->UseConstantBuffer(m_shaderScreenVariablesBuffer, 0);
@@ -603,7 +786,7 @@ ysError dbasic::DeltaEngine::ExecuteDrawQueue(DRAW_TARGET target) {
 
                 m_device->UseTexture(call->Texture, 0);
 
-                m_device->UseIndexBuffer(call->Model->GetIndexBuffer(), 0);
+                m_device->UseIndexBuffer(call->Model->GetIndexBuffer(), 0, call->Model->GetIndexSize());
                 m_device->UseVertexBuffer(call->Model->GetVertexBuffer(), call->Model->GetVertexSize(), 0);
 
                 m_device->Draw(call->Model->GetFaceCount(), call->Model->GetBaseIndex(), call->Model->GetBaseVertex());
@@ -625,12 +808,8 @@ ysError dbasic::DeltaEngine::ExecuteDrawQueue(DRAW_TARGET target) {
             }
         }
 
-        if (target == DRAW_TARGET_GUI) {
-            m_drawQueueGui[i].Clear();
-        }
-        else if (target == DRAW_TARGET_MAIN) {
-            m_drawQueue[i].Clear();
-        }
+        // The draw calls themselves are reclaimed with the frame arena
+        queue->First = queue->Last = nullptr;
     }
 
     if (target == DRAW_TARGET_GUI) {
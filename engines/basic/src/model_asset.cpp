@@ -14,6 +14,11 @@ dbasic::ModelAsset::ModelAsset() : ysObject("MODEL_ASSET") {
     m_UVChannelCount = 0;
 
     m_vertexSize = 0;
+    m_indexSize = sizeof(unsigned short);
+
+    m_compressedVertices = false;
+    m_positionOffset = ysVector4(0.0f, 0.0f, 0.0f, 0.0f);
+    m_positionScale = ysVector4(1.0f, 1.0f, 1.0f, 1.0f);
 
     m_manager = NULL;
 }
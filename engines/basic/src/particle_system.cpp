@@ -46,9 +46,8 @@ void dbasic::ParticleSystem::Update() {
     }
 
     // Phase III: Update all particles
-    for (int i = 0; i < n_particles; i++) {
-        m_particles.Get(i)->Update(m_engine->GetFrameLength());
-    }
+    const float dt = m_engine->GetFrameLength();
+    m_particles.ForEachLinear([dt](Particle *particle) { particle->Update(dt); });
 }
 
 void dbasic::ParticleSystem::Render() {
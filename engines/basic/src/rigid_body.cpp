@@ -20,9 +20,11 @@ dbasic::RigidBody::RigidBody() {
 
     m_derivedValid = false;
     m_registered = false;
+    m_handle = ysHandle::Null();
 
     m_owner = NULL;
     m_hint = HINT_STATIC;
+    m_fastMath = false;
 
     ClearAccumulators();
     m_acceleration = ysMath::Constants::Zero;
@@ -45,24 +47,41 @@ void dbasic::RigidBody::Integrate(float timeStep) {
     m_velocity = ysMath::Add(m_velocity, ysMath::Mul(acceleration, vTimeStep));
     m_angularVelocity = ysMath::Add(m_angularVelocity, ysMath::Mul(angularAcceleration, vTimeStep));
 
-    m_orientation = ysMath::QuatAddScaled(m_orientation, m_angularVelocity, timeStep);
     m_position = ysMath::Add(m_position, ysMath::Mul(m_velocity, vTimeStep));
 
-    m_angularVelocity = ysMath::Mul(m_angularVelocity, ysMath::LoadScalar(pow(m_angularDamping, timeStep)));
-    m_velocity = ysMath::Mul(m_velocity, ysMath::LoadScalar(pow(m_linearDamping, timeStep)));
+    if (m_fastMath) {
+        m_orientation = ysMath::QuatAddScaledFast(m_orientation, m_angularVelocity, timeStep);
+
+        // Both damping factors with a single call
+        ysVector damping = ysMath::Pow(ysMath::LoadVector(m_angularDamping, m_linearDamping), vTimeStep);
+        m_angularVelocity = ysMath::Mul(m_angularVelocity, _mm_replicate_x_ps(damping));
+        m_velocity = ysMath::Mul(m_velocity, _mm_replicate_y_ps(damping));
+    }
+    else {
+        m_orientation = ysMath::QuatAddScaled(m_orientation, m_angularVelocity, timeStep);
+
+        m_angularVelocity = ysMath::Mul(m_angularVelocity, ysMath::LoadScalar(pow(m_angularDamping, timeStep)));
+        m_velocity = ysMath::Mul(m_velocity, ysMath::LoadScalar(pow(m_linearDamping, timeStep)));
+    }
 }
 
 void dbasic::RigidBody::UpdateDerivedData() {
     if (!m_derivedValid) {
-        m_orientation = ysMath::Normalize(m_orientation);
+        m_orientation = m_fastMath
+            ? ysMath::NormalizeFast(m_orientation)
+            : ysMath::Normalize(m_orientation);
 
         if (m_parent == NULL) {
             m_worldPosition = m_position;
             m_finalOrientation = m_orientation;
         }
         else {
+            ysQuaternion finalOrientation = ysMath::QuatMultiply(m_orientation, m_parent->m_finalOrientation);
+
             m_worldPosition = ysMath::MatMult(m_parent->m_transform, ysMath::ExtendVector(m_position));
-            m_finalOrientation = ysMath::Normalize(ysMath::QuatMultiply(m_orientation, m_parent->m_finalOrientation));
+            m_finalOrientation = m_fastMath
+                ? ysMath::NormalizeFast(finalOrientation)
+                : ysMath::Normalize(finalOrientation);
         }
 
         ysMath::LoadMatrix(m_finalOrientation, m_worldPosition, &m_transform, &m_orientationOnly);
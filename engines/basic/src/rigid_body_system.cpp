@@ -41,6 +41,9 @@ dbasic::RigidBodySystem::RigidBodySystem() : ysObject("RigidBodySystem") {
             &threadIdArray[i]);
     }
 
+    m_collisionArena.SetMemoryTag(ysMemoryTag::Physics);
+    m_collisionArena.Initialize(64 * KB);
+
     m_loggingOutput.open("object_count_load.txt");
 
     m_currentStep = 0.1f;
@@ -55,12 +58,13 @@ dbasic::RigidBodySystem::~RigidBodySystem() {
 void dbasic::RigidBodySystem::RegisterRigidBody(RigidBody *body) {
     body->m_registered = true;
     body->m_system = this;
-    m_rigidBodyRegistry.Register(body);
+    body->m_handle = m_rigidBodyRegistry.Add(body);
 }
 
 void dbasic::RigidBodySystem::RemoveRigidBody(RigidBody *body) {
-    if (body->m_registered) m_rigidBodyRegistry.Remove(body->GetIndex());
+    if (body->m_registered) m_rigidBodyRegistry.Remove(body->m_handle);
     body->m_registered = false;
+    body->m_handle = ysHandle::Null();
 }
 
 void dbasic::RigidBodySystem::DeleteLink(RigidBodyLink *link) {
@@ -196,7 +200,7 @@ void dbasic::RigidBodySystem::GenerateCollisions(RigidBody *body1, RigidBody *bo
                             if (collisionValid) {
                                 Collision *newCollisionEntry;
                                 if (threadID == -1) {
-                                    newCollisionEntry = m_dynamicCollisions.NewGeneric<Collision, 16>();
+                                    newCollisionEntry = m_collisionArena.Allocate<Collision>();
                                     m_collisionAccumulator.New() = newCollisionEntry;
 
                                     body1->AddCollision(newCollisionEntry);
@@ -221,7 +225,7 @@ void dbasic::RigidBodySystem::GenerateCollisions(RigidBody *body1, RigidBody *bo
                             Collision *newCollisionEntry;
 
                             if (threadID == -1) {
-                                newCollisionEntry = m_dynamicCollisions.NewGeneric<Collision, 16>();
+                                newCollisionEntry = m_collisionArena.Allocate<Collision>();
                                 m_collisionAccumulator.New() = newCollisionEntry;
 
                                 body1->AddCollision(newCollisionEntry);
@@ -249,7 +253,7 @@ void dbasic::RigidBodySystem::GenerateCollisions(RigidBody *body1, RigidBody *bo
                                 if (sensorTest) {
                                     Collision *newCollisionEntry;
                                     if (threadID == -1) {
-                                        newCollisionEntry = m_dynamicCollisions.NewGeneric<Collision, 16>();
+                                        newCollisionEntry = m_collisionArena.Allocate<Collision>();
                                         m_collisionAccumulator.New() = newCollisionEntry;
                                         body1->AddCollision(newCollisionEntry);
                                         body2->AddCollision(newCollisionEntry);
@@ -330,7 +334,7 @@ void dbasic::RigidBodySystem::GenerateCollisions() {
     std::clock_t a = std::clock();
     WaitForMultipleObjects(N_THREADS, m_doneEvents, TRUE, INFINITE);
 
-    m_dynamicCollisions.Clear();
+    m_collisionArena.Reset();
 
     std::clock_t b = std::clock();
     double duration = ((double)b - a) / (double)CLOCKS_PER_SEC;
@@ -1,35 +1,92 @@
 #ifndef YDS_ALLOCATOR_H
 #define YDS_ALLOCATOR_H
 
+#include <new>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+
+#if defined(_WIN32)
 #include <malloc.h>
+#endif
 
 class ysAllocator {
+public:
+    // Pages of at least this size are requested for huge page backed blocks
+    static const size_t HugePageSize = 2 * 1024 * 1024;
+
 public:
     template <int Alignment>
     static void *BlockAllocate(int size) {
-        return ::_aligned_malloc(size, Alignment);
+        return BlockAllocate(size, Alignment);
     }
 
-    template <>
-    static void *BlockAllocate<1>(int size) {
-        return ::malloc(size);
+    static void *BlockAllocate(int size, int alignment) {
+        if (alignment == 1) {
+            return ::malloc(size);
+        }
+
+#if defined(_WIN32)
+        return ::_aligned_malloc(size, alignment);
+#else
+        // posix_memalign() requires a multiple of sizeof(void *)
+        if (alignment < (int)sizeof(void *)) alignment = (int)sizeof(void *);
+
+        void *block = nullptr;
+        if (::posix_memalign(&block, alignment, size) != 0) return nullptr;
+
+        return block;
+#endif
+    }
+
+    // Resize a block, the contents up to the smaller of the two sizes are kept.
+    // If the allocation fails the old block is left untouched.
+    static void *BlockReallocate(void *block, int oldSize, int newSize, int alignment) {
+        if (alignment == 1) {
+            return ::realloc(block, newSize);
+        }
+
+        void *newBlock = BlockAllocate(newSize, alignment);
+        if (newBlock != nullptr && block != nullptr) {
+            ::memcpy(newBlock, block, (oldSize < newSize) ? oldSize : newSize);
+            BlockFree(block, alignment);
+        }
+
+        return newBlock;
     }
 
     static void BlockFree(void *block, int alignment) {
+#if defined(_WIN32)
         if (alignment != 1) {
             ::_aligned_free(block);
+            return;
         }
-        else {
-            ::free(block);
-        }
+#endif
+
+        ::free(block);
     }
 
+    // --
+    // Allocate whole pages directly from the operating system, for large
+    // arenas which live for a long time. Blocks are page aligned and zero
+    // filled, and must be released with PageFree() with the same size.
+    //
+    // If hugePages is set the block is aligned to HugePageSize and
+    // transparent huge pages are requested for it where the platform
+    // supports them.
+    // --
+    static void *PageAllocate(size_t size, bool hugePages = false);
+    static void PageFree(void *block, size_t size);
+
     template <typename T_Create, int Alignment>
     static T_Create *TypeAllocate(int n = 1, bool construct = true) {
         void *block = BlockAllocate<Alignment>(sizeof(T_Create) * n);
+        if (block == nullptr) return nullptr;
+
         T_Create *typedArray = reinterpret_cast<T_Create *>(block);
 
-        if (construct) {
+        if (construct && !std::is_trivially_default_constructible<T_Create>::value) {
             for (int i = 0; i < n; i++) {
                 new(typedArray + i) T_Create;
             }
@@ -42,7 +99,7 @@ public:
     static void TypeFree(T_Free *data, int n = 1, bool destroy = true, int alignment = 1) {
         void *block = reinterpret_cast<void *>(data);
 
-        if (destroy) {
+        if (destroy && !std::is_trivially_destructible<T_Free>::value) {
             for (int i = 0; i < n; i++) {
                 data[i].~T_Free();
             }
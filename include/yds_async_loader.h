@@ -0,0 +1,173 @@
+#ifndef YDS_ASYNC_LOADER_H
+#define YDS_ASYNC_LOADER_H
+
+#include "yds_base.h"
+
+#include "yds_expanding_array.h"
+#include "yds_handle_array.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdint.h>
+#include <thread>
+
+typedef ysHandle ysLoadHandle;
+
+// --
+// Loads assets in the background while the frame loop keeps running.
+//
+// Every request passes through up to three stages:
+//  1. Read, on one of the I/O threads. Requests are started in priority
+//     order (highest first, then in the order they were submitted).
+//  2. Process, on the worker pool (decompression, preprocessing). Also
+//     ordered by priority.
+//  3. Finalize, on the thread that calls Update(), for anything that has
+//     to happen on the main thread such as device uploads. Update() only
+//     runs finalize steps until its time budget is spent.
+//
+// Any stage can be left empty. A stage that returns an error fails the
+// request and the remaining stages are skipped. State shared between the
+// stages should be owned by the callbacks (ie. captured by shared_ptr) so
+// that it's freed along with them whatever happens to the request.
+//
+// Handles stay valid until Release() is called, whatever the status.
+// Everything besides the stages themselves must be called from the
+// thread that calls Update().
+// --
+class ysAsyncLoader : public ysObject {
+public:
+    enum class Status {
+        Invalid,
+        Queued,
+        Reading,
+        Processing,
+        Finalizing,
+        Complete,
+        Failed,
+        Cancelled
+    };
+
+    typedef std::function<ysError()> Stage;
+
+    // Called again on a later step as long as it clears *done (which is
+    // set on entry), so that large uploads can be spread over frames
+    typedef std::function<ysError(bool *done)> FinalizeStage;
+
+    struct Request {
+        int Priority;
+
+        Stage Read;
+        Stage Process;
+        FinalizeStage Finalize;
+    };
+
+    static const int DefaultIoThreadCount = 1;
+
+public:
+    ysAsyncLoader();
+    ~ysAsyncLoader();
+
+    // A negative worker count uses one worker per spare hardware thread,
+    // 0 processes requests on the I/O threads
+    ysError Initialize(int ioThreadCount = DefaultIoThreadCount, int workerCount = -1);
+
+    // Stops all threads once their current stage is done, requests that
+    // haven't completed are cancelled
+    void Shutdown();
+
+    bool IsInitialized() const { return m_threads.GetNumObjects() > 0; }
+
+    // Returns a null handle if the loader isn't initialized
+    ysLoadHandle Submit(const Request &request);
+
+    // --
+    // Runs finalize steps until budget (in seconds) is spent. At least one
+    // step is run if any request is waiting so loading always progresses.
+    // Returns the number of steps that were run.
+    // --
+    int Update(double budget);
+
+    // Blocks until every submitted request has completed, failed or been
+    // cancelled, finalizing them without a budget
+    void Flush();
+
+    Status GetStatus(ysLoadHandle handle);
+    ysError GetError(ysLoadHandle handle);
+
+    // Only requests that are waiting for a stage can be cancelled, returns
+    // false if the request is running or has already finished
+    bool Cancel(ysLoadHandle handle);
+
+    // Changes the order of a request that is waiting for a stage
+    void SetPriority(ysLoadHandle handle, int priority);
+
+    // Frees the request, it's cancelled first if it hasn't finished yet
+    void Release(ysLoadHandle handle);
+
+    // Requests that haven't finished yet
+    int GetPendingCount();
+
+protected:
+    struct Job {
+        Request Stages;
+        Status State;
+        ysError Error;
+
+        // Only the newest queue entry of a job is live, older ones were
+        // invalidated by a priority change or cancellation
+        uint64_t Ticket;
+
+        // Released while running, the job is no longer in the handle
+        // array and is deleted once its stage returns
+        bool Running;
+        bool Released;
+    };
+
+    struct QueueEntry {
+        int Priority;
+        uint64_t Ticket;
+        ysLoadHandle Handle;
+
+        bool operator<(const QueueEntry &entry) const {
+            if (Priority != entry.Priority) return Priority < entry.Priority;
+            else return Ticket > entry.Ticket;
+        }
+    };
+
+    typedef std::priority_queue<QueueEntry> StageQueue;
+
+protected:
+    void IoThread();
+    void WorkerThread();
+
+    // Runs the stage with the lock released and passes the job on
+    void RunStage(std::unique_lock<std::mutex> &lock, ysLoadHandle handle, Job *job, Status stage);
+
+    Job *PopJob(StageQueue &queue, ysLoadHandle *handle);
+    void Enqueue(ysLoadHandle handle, Job *job, Status state);
+
+    void Finish(Job *job, Status status, ysError error);
+    void Free(ysLoadHandle handle);
+    void Delete(Job *job);
+
+    std::mutex m_lock;
+    std::condition_variable m_readAvailable;
+    std::condition_variable m_processAvailable;
+    std::condition_variable m_stateChanged;
+
+    StageQueue m_readQueue;
+    StageQueue m_processQueue;
+    StageQueue m_finalizeQueue;
+
+    ysHandleArray<Job> m_jobs;
+    uint64_t m_nextTicket;
+    int m_pendingCount;
+
+    ysExpandingArray<std::thread> m_threads;
+    bool m_processOnIoThreads;
+    bool m_stop;
+};
+
+#endif /* YDS_ASYNC_LOADER_H */
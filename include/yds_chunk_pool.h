@@ -0,0 +1,116 @@
+#ifndef YDS_CHUNK_POOL_H
+#define YDS_CHUNK_POOL_H
+
+#include <stdint.h>
+
+// --
+// Pool of fixed size slots stored in chunks of (at least) 64 slots.
+//
+// Chunks are allocated with an alignment equal to their size so that the
+// chunk, and pool, owning any slot can be found from the slot's address.
+// Chunks are never moved so slot addresses remain stable for their
+// entire lifetime. Freed slots are kept on a free list and reused first.
+// --
+class ysChunkPool {
+public:
+    static const int MinChunkSlots = 64;
+    static const int MaxChunkSlots = 256;
+
+protected:
+    struct Chunk {
+        ysChunkPool *Pool;
+        Chunk *Next;
+        char *Slots;
+        int SlotCount;
+
+        // Bit i is set if slot i is in use
+        uint64_t Occupied[MaxChunkSlots / 64];
+    };
+
+    struct FreeSlot {
+        FreeSlot *Next;
+    };
+
+public:
+    ysChunkPool();
+    ~ysChunkPool();
+
+    // --
+    // Set the slot layout. Must be called before the first allocation.
+    //
+    //   slotSize: Size of each slot (bytes)
+    //   alignment: Alignment of each slot (bytes, power of two)
+    //
+    // --
+    void Initialize(int slotSize, int alignment);
+
+    bool IsInitialized() const { return m_slotSize != 0; }
+
+    // Returns an uninitialized slot
+    void *Allocate();
+
+    // --
+    // Return a slot to the pool, nothing is destroyed.
+    //
+    //   address: Any address within the slot (ie. a base class pointer
+    //            to an object stored in the slot)
+    //
+    // --
+    void Free(void *address);
+
+    // Returns true if the address lies within a slot of this pool
+    bool Owns(void *address) const;
+
+    // Release all chunks, any slots still in use become invalid
+    void Destroy();
+
+    int GetSlotSize() const { return m_slotSize; }
+    int GetAlignment() const { return m_alignment; }
+    int GetCount() const { return m_count; }
+    int GetChunkCount() const { return m_chunkCount; }
+    int GetChunkSize() const { return m_chunkSize; }
+
+    // --
+    // Call a function for each slot in use. Chunks are visited one
+    // after the other and slots in address order.
+    // --
+    template<typename T_Function>
+    void ForEach(T_Function function) const {
+        for (Chunk *chunk = m_chunks; chunk != nullptr; chunk = chunk->Next) {
+            for (int word = 0; word < MaxChunkSlots / 64; word++) {
+                uint64_t occupied = chunk->Occupied[word];
+                while (occupied != 0) {
+                    const int slot = word * 64 + LowestBit(occupied);
+                    occupied &= occupied - 1;
+
+                    function(reinterpret_cast<void *>(chunk->Slots + slot * m_slotSize));
+                }
+            }
+        }
+    }
+
+protected:
+    Chunk *NewChunk();
+    Chunk *GetChunk(void *address) const;
+
+    static int LowestBit(uint64_t v);
+
+protected:
+    Chunk *m_chunks;
+    FreeSlot *m_freeList;
+
+    // Next slot in the newest chunk that has never been used
+    Chunk *m_lastChunk;
+    int m_nextUnused;
+
+    int m_slotSize;
+    int m_alignment;
+    int m_chunkSize;
+    int m_slotsPerChunk;
+    int m_headerSize;
+
+    int m_count;
+    int m_chunkCount;
+};
+
+#endif /* YDS_CHUNK_POOL_H */
@@ -0,0 +1,87 @@
+#ifndef YDS_COMPILE_CACHE_H
+#define YDS_COMPILE_CACHE_H
+
+#include "yds_base.h"
+
+#include "yds_expanding_array.h"
+
+#include <stdint.h>
+#include <unordered_map>
+
+// --
+// Side-car index (.ysci) that is kept next to a compiled scene file.
+//
+// There is one entry per object in the compiled file, in the same order,
+// holding a key that the compiler derives from everything that affects
+// the object's output (its source bytes, compile options, material and
+// compiler version). A later compile can copy any object whose key is
+// still present instead of processing it again.
+//
+// The source hash and options hash cover the whole scene so that an
+// unchanged scene can be recognized without reading any of its objects.
+// --
+class ysCompileCache : public ysObject {
+public:
+    static const unsigned int FileMagic = 0x49435359; // 'YSCI'
+    static const unsigned int FileVersion = 1;
+
+    struct Entry {
+        uint64_t Key;
+
+        // Material state the object was compiled with, materials are set
+        // up at runtime so they aren't covered by the source hash
+        unsigned int MaterialFlags;
+        char MaterialName[64];
+    };
+
+    struct FileHeader {
+        unsigned int Magic;
+        unsigned int Version;
+
+        int EntryCount;
+        int Reserved;
+
+        uint64_t SourceHash;
+        uint64_t OptionsHash;
+
+        // Size of the compiled file the entries describe
+        uint64_t OutputSize;
+    };
+
+public:
+    ysCompileCache();
+    ~ysCompileCache();
+
+    // Returns false, without raising an error, if the file doesn't exist or
+    // isn't a valid index. The cache is left empty in that case.
+    bool Load(const char *fname);
+    ysError Save(const char *fname);
+
+    void Clear();
+
+    void AddEntry(const Entry &entry);
+    int GetEntryCount() const { return m_entries.GetNumObjects(); }
+    const Entry &GetEntry(int index) const { return m_entries[index]; }
+
+    // Index of the first entry with the key, -1 if there is none
+    int Find(uint64_t key) const;
+
+    uint64_t GetSourceHash() const { return m_sourceHash; }
+    void SetSourceHash(uint64_t hash) { m_sourceHash = hash; }
+
+    uint64_t GetOptionsHash() const { return m_optionsHash; }
+    void SetOptionsHash(uint64_t hash) { m_optionsHash = hash; }
+
+    uint64_t GetOutputSize() const { return m_outputSize; }
+    void SetOutputSize(uint64_t size) { m_outputSize = size; }
+
+protected:
+    ysExpandingArray<Entry> m_entries;
+    std::unordered_map<uint64_t, int> m_lookup;
+
+    uint64_t m_sourceHash;
+    uint64_t m_optionsHash;
+    uint64_t m_outputSize;
+};
+
+#endif /* YDS_COMPILE_CACHE_H */
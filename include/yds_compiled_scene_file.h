@@ -0,0 +1,77 @@
+#ifndef YDS_COMPILED_SCENE_FILE_H
+#define YDS_COMPILED_SCENE_FILE_H
+
+#include "yds_base.h"
+
+#include "yds_geometry_export_file.h"
+#include "yds_mapped_file.h"
+
+#include <stdint.h>
+
+// --
+// Reader for compiled scene files written by ysGeometryExportFile.
+//
+// The file is memory mapped and validated once when it is opened, after
+// which every accessor returns a pointer straight into the mapping. The
+// vertex and index blocks cover the entire scene and can be passed to the
+// device as is. Pointers are invalidated by Close().
+// --
+class ysCompiledSceneFile : public ysObject {
+public:
+    typedef ysGeometryExportFile::FileHeader FileHeader;
+    typedef ysGeometryExportFile::ObjectTableEntry ObjectTableEntry;
+    typedef ysGeometryExportFile::ObjectOutputHeader ObjectOutputHeader;
+
+public:
+    ysCompiledSceneFile();
+    ~ysCompiledSceneFile();
+
+    ysError Open(const char *fname);
+    void Close();
+
+    // Check whether a file exists and was written with the current layout
+    // version, without raising an error if it isn't
+    static bool IsCurrentVersion(const char *fname);
+
+    size_t GetFileSize() const { return m_file.GetSize(); }
+
+    // Read the whole file in now, see ysMappedFile::Prefetch()
+    void Prefetch() const { m_file.Prefetch(); }
+
+    int GetObjectCount() const { return m_header->ObjectCount; }
+    const ObjectTableEntry *GetObject(int index) const { return &m_objects[index]; }
+
+    const char *GetVertexData() const { return m_file.GetData() + m_header->VertexDataOffset; }
+    int GetVertexDataSize() const { return m_header->VertexDataSize; }
+
+    const char *GetIndexData() const { return m_file.GetData() + m_header->IndexDataOffset; }
+    int GetIndexDataSize() const { return m_header->IndexDataSize; }
+
+    // First of the object's indices, see ysGeometryExportFile::GetIndexSize()
+    // for their width
+    const void *GetIndices(const ObjectTableEntry *entry) const;
+
+    const void *GetCustomData() const { return m_file.GetData() + m_header->CustomDataOffset; }
+    int GetCustomDataSize() const { return m_header->CustomDataSize; }
+
+    // NumBones entries, nullptr if the object doesn't have a bone map
+    const int *GetBoneMap(const ObjectTableEntry *entry) const;
+
+    // Length and width of a plane, nullptr for all other objects
+    const float *GetPrimitiveData(const ObjectTableEntry *entry) const;
+
+    // NumMeshlets entries, nullptr if the object wasn't split into meshlets
+    const ysObjectData::Meshlet *GetMeshlets(const ObjectTableEntry *entry) const;
+
+protected:
+    bool Validate() const;
+    bool InBounds(int64_t offset, int64_t size) const;
+
+protected:
+    ysMappedFile m_file;
+
+    const FileHeader *m_header;
+    const ObjectTableEntry *m_objects;
+};
+
+#endif /* YDS_COMPILED_SCENE_FILE_H */
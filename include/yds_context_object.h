@@ -2,10 +2,15 @@
 #define YDS_CONTEXT_OBJECT_H
 
 #include "yds_base.h"
+#include "yds_handle_array.h"
+
+class ysDevice;
 
 class ysContextObject : public ysObject
 {
 
+	friend ysDevice;
+
 public:
 
 	enum DEVICE_API
@@ -14,7 +19,10 @@ public:
 		API_UNKNOWN,
 		DIRECTX10,
 		DIRECTX11,
-		OPENGL4_0
+		OPENGL4_0,
+
+		// No graphics API, used when running headless
+		NULL_DEVICE
 
 	};
 
@@ -28,9 +36,13 @@ public:
 
 	bool CheckCompatibility(ysContextObject *object) const { return (object) ? object->m_api == m_api : true; }
 
+	// Handle of the object in the device that created it
+	ysHandle GetHandle() const { return m_handle; }
+
 private:
 
 	DEVICE_API m_api;
+	ysHandle m_handle;
 
 };
 
@@ -26,6 +26,9 @@
 
 // Memory management
 #include "yds_expanding_array.h"
+#include "yds_small_vector.h"
+#include "yds_frame_arena.h"
+#include "yds_memory_tracker.h"
 
 // Textures
 #include "yds_texture.h"
@@ -35,14 +38,22 @@
 
 // Utilities
 #include "yds_registry.h"
+#include "yds_handle_array.h"
+
+// Asset loading
+#include "yds_async_loader.h"
 
 // Geometry
 #include "yds_tool_geometry_file.h"
 #include "yds_geometry_preprocessing.h"
 #include "yds_geometry_export_file.h"
+#include "yds_compiled_scene_file.h"
+#include "yds_compile_cache.h"
+#include "yds_hash.h"
 
 // Graphics API
 #include "yds_device.h"
+#include "yds_null_device.h"
 
 // OS
 #include "yds_window_event_handler.h"
@@ -46,7 +46,7 @@ public:
     virtual ysError CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
     virtual ysError CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
     virtual ysError UseVertexBuffer(ysGPUBuffer *buffer, int stride, int offset);
-    virtual ysError UseIndexBuffer(ysGPUBuffer *buffer, int offset);
+    virtual ysError UseIndexBuffer(ysGPUBuffer *buffer, int offset, int indexSize = sizeof(unsigned short));
     virtual ysError UseConstantBuffer(ysGPUBuffer *buffer, int slot);
     virtual ysError EditBufferDataRange(ysGPUBuffer *buffer, char *data, int size, int offset);
     virtual ysError EditBufferData(ysGPUBuffer *buffer, char *data);
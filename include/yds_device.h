@@ -101,8 +101,8 @@ public:
     // Enable a vertex buffer
     virtual ysError UseVertexBuffer(ysGPUBuffer *buffer, int stride, int offset);
 
-    // Enable an index buffer
-    virtual ysError UseIndexBuffer(ysGPUBuffer *buffer, int offset);
+    // Enable an index buffer, indexSize is 2 or 4 bytes
+    virtual ysError UseIndexBuffer(ysGPUBuffer *buffer, int offset, int indexSize = sizeof(unsigned short));
 
     // Enable a constant buffer
     virtual ysError UseConstantBuffer(ysGPUBuffer *buffer, int slot);
@@ -185,15 +185,46 @@ public:
 protected:
     ysRenderTarget *GetActualRenderTarget();
 
+    // Create an object of a concrete API type and register it with a holder
+    template<typename T_Create, typename TYPE, int START_SIZE>
+    T_Create *NewObject(ysHandleArray<TYPE, START_SIZE> &holder) {
+        T_Create *newObject = new T_Create;
+        newObject->m_handle = holder.Add(newObject);
+
+        return newObject;
+    }
+
+    // Remove an object from its holder and destroy it. Objects that are
+    // already destroyed or belong to another device are rejected.
+    template<typename TYPE, int START_SIZE, typename T_Object>
+    ysError DeleteObject(ysHandleArray<TYPE, START_SIZE> &holder, T_Object *object) {
+        if (holder.Get(object->m_handle) != static_cast<TYPE *>(object)) return ysError::YDS_INVALID_PARAMETER;
+
+        holder.Remove(object->m_handle);
+
+        object->m_handle = ysHandle::Null();
+        delete object;
+
+        return ysError::YDS_NO_ERROR;
+    }
+
+    template<typename TYPE, int START_SIZE>
+    void DeleteAllObjects(ysHandleArray<TYPE, START_SIZE> &holder) {
+        const int nObjects = holder.GetNumObjects();
+        for (int i = 0; i < nObjects; i++) delete holder.Get(i);
+
+        holder.Clear();
+    }
+
 protected:
     // Object Holders
-    ysDynamicArray<ysRenderingContext, 4>	m_renderingContexts;
-    ysDynamicArray<ysRenderTarget, 4>		m_renderTargets;
-    ysDynamicArray<ysGPUBuffer, 16>			m_gpuBuffers;
-    ysDynamicArray<ysShader, 16>			m_shaders;
-    ysDynamicArray<ysShaderProgram, 8>		m_shaderPrograms;
-    ysDynamicArray<ysInputLayout, 16>		m_inputLayouts;
-    ysDynamicArray<ysTexture, 32>			m_textures;
+    ysHandleArray<ysRenderingContext, 4>	m_renderingContexts;
+    ysHandleArray<ysRenderTarget, 4>		m_renderTargets;
+    ysHandleArray<ysGPUBuffer, 16>			m_gpuBuffers;
+    ysHandleArray<ysShader, 16>				m_shaders;
+    ysHandleArray<ysShaderProgram, 8>		m_shaderPrograms;
+    ysHandleArray<ysInputLayout, 16>		m_inputLayouts;
+    ysHandleArray<ysTexture, 32>			m_textures;
 
     // Active Objects
     ysRenderTarget *m_activeRenderTarget;
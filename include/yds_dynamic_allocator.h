@@ -2,6 +2,7 @@
 #define YDS_DYNAMIC_ALLOCATOR_H
 
 #include "yds_memory_base.h"
+#include "yds_allocator.h"
 
 typedef unsigned short int BlockIndex;
 
@@ -3,7 +3,9 @@
 
 #include "yds_error_codes.h"
 #include "yds_allocator.h"
+#include "yds_chunk_pool.h"
 
+#include <assert.h>
 #include <memory>
 
 class ysDynamicArrayElement {
@@ -11,6 +13,7 @@ public:
     ysDynamicArrayElement() {
         m_index = -1;
         m_alignment = 0;
+        m_pool = nullptr;
     }
 
     ~ysDynamicArrayElement() {
@@ -33,19 +36,51 @@ public:
         m_alignment = alignment;
     }
 
+    inline ysChunkPool *GetPool() const {
+        return m_pool;
+    }
+
+    inline void SetPool(ysChunkPool *pool) {
+        m_pool = pool;
+    }
+
 protected:
     int m_index;
     int m_alignment;
+
+    // Pool that the element's storage came from (if any)
+    ysChunkPool *m_pool;
 };
 
-template<typename TYPE, int START_SIZE = 0>
+// --
+// Array of pointers to objects that are owned by the array.
+//
+// If POOLED is set, objects created with New() or NewGeneric() are stored in
+// a chunk pool per concrete type (up to MaxPools types) so that objects of
+// the same type are packed together in memory. Pools allocate whole chunks
+// so this is only worth it for arrays that hold many objects. Pooled objects
+// live in memory owned by the array and can't be detached from it.
+//
+// Objects are never moved so pointers to them remain valid until they are
+// deleted.
+// --
+template<typename TYPE, int START_SIZE = 0, bool POOLED = false>
 class ysDynamicArray {
+public:
+    static const int MaxPools = POOLED ? 4 : 1;
+
 public:
     ysDynamicArray() {
         m_maxSize = START_SIZE;
         m_nObjects = 0;
+        m_pooledObjects = 0;
         m_array = NULL;
 
+        for (int i = 0; i < MaxPools; i++) {
+            m_poolKeys[i] = nullptr;
+            m_poolCasts[i] = nullptr;
+        }
+
         Preallocate(m_maxSize);
     }
 
@@ -62,16 +97,7 @@ public:
     }
 
     TYPE *New() {
-        if (m_nObjects >= m_maxSize) Extend();
-
-        m_array[m_nObjects] = ysAllocator::TypeAllocate<TYPE, 1>();
-
-        // Cast to a standard array element
-        ysDynamicArrayElement *sElement = static_cast<ysDynamicArrayElement *>(m_array[m_nObjects]);
-        sElement->SetAlignment(1);
-        sElement->SetIndex(m_nObjects);
-
-        return m_array[m_nObjects++];
+        return NewGeneric<TYPE, 1>();
     }
 
     void Add(TYPE *type) {
@@ -82,6 +108,7 @@ public:
         // Cast to a standard array element
         ysDynamicArrayElement *sElement = static_cast<ysDynamicArrayElement *>(m_array[m_nObjects]);
         sElement->SetIndex(m_nObjects);
+        if (IsOwnPool(sElement->GetPool())) m_pooledObjects++;
 
         m_nObjects++;
     }
@@ -99,6 +126,7 @@ public:
         // Cast to a standard array element
         ysDynamicArrayElement *sElement = static_cast<ysDynamicArrayElement *>(m_array[offset]);
         sElement->SetIndex(offset);
+        if (IsOwnPool(sElement->GetPool())) m_pooledObjects++;
 
         m_nObjects++;
     }
@@ -120,11 +148,20 @@ public:
     T_Create *NewGeneric() {
         if (m_nObjects >= m_maxSize) Extend();
 
-        T_Create *newObject = ysAllocator::TypeAllocate<T_Create, Alignment>();
+        T_Create *newObject;
+        ysChunkPool *pool = GetPool<T_Create, Alignment>();
+        if (pool != nullptr) {
+            newObject = new (pool->Allocate()) T_Create;
+            m_pooledObjects++;
+        }
+        else {
+            newObject = ysAllocator::TypeAllocate<T_Create, Alignment>();
+        }
 
         // Cast to a standard array element
         ysDynamicArrayElement *sElement = static_cast<ysDynamicArrayElement *>(newObject);
         sElement->SetAlignment(Alignment);
+        sElement->SetPool(pool);
         sElement->SetIndex(m_nObjects);
 
         m_array[m_nObjects++] = newObject;
@@ -139,8 +176,20 @@ public:
 
         ysDynamicArrayElement *target = static_cast<ysDynamicArrayElement *>(m_array[index]);
 
+        // A detached object would outlive the pool that holds it
+        assert(destroy || !IsOwnPool(target->GetPool()));
+        if (IsOwnPool(target->GetPool())) m_pooledObjects--;
+
         if (destroy) {
-            ysAllocator::TypeFree<TYPE>(m_array[index], 1, true, target->GetAlignment());
+            ysChunkPool *pool = target->GetPool();
+            if (pool != nullptr) {
+                TYPE *object = m_array[index];
+                object->~TYPE();
+                pool->Free(object);
+            }
+            else {
+                ysAllocator::TypeFree<TYPE>(m_array[index], 1, true, target->GetAlignment());
+            }
         }
 
         if (replacement == NULL) {
@@ -162,6 +211,9 @@ public:
         }
         else {
             m_array[index] = replacement;
+
+            ysDynamicArrayElement *sElement = static_cast<ysDynamicArrayElement *>(replacement);
+            if (IsOwnPool(sElement->GetPool())) m_pooledObjects++;
         }
 
         // Cast to a standard array element
@@ -189,7 +241,30 @@ public:
         return m_nObjects;
     }
 
+    // --
+    // Call a function for every object in the array. Pooled objects are
+    // visited in memory order rather than index order which is much kinder
+    // to the cache. Objects must not be created or deleted while iterating.
+    // --
+    template<typename T_Function>
+    void ForEachLinear(T_Function function) {
+        // Fall back to index order if the array holds objects from elsewhere.
+        // Pooled objects can't be detached so the pools then hold exactly
+        // the objects in the array.
+        if (m_pooledObjects != m_nObjects) {
+            for (int i = 0; i < m_nObjects; i++) function(m_array[i]);
+            return;
+        }
+
+        for (int i = 0; i < MaxPools && m_poolKeys[i] != nullptr; i++) {
+            TYPE *(*cast)(void *) = m_poolCasts[i];
+            m_pools[i].ForEach([&function, cast](void *slot) { function(cast(slot)); });
+        }
+    }
+
     void Clear(bool destroy = true) {
+        assert(destroy || m_pooledObjects == 0);
+
         if (destroy) {
             int nObjects = m_nObjects;
             for (int i = nObjects - 1; i >= 0; i--) {
@@ -198,9 +273,57 @@ public:
         }
 
         m_nObjects = 0;
+        m_pooledObjects = 0;
     }
 
 protected:
+    template<typename T_Create, int Alignment>
+    static const void *GetPoolKey() {
+        // Not const so that identical constants can't be folded together
+        static char key = 0;
+        return &key;
+    }
+
+    template<typename T_Create>
+    static TYPE *PoolCast(void *slot) {
+        return static_cast<TYPE *>(reinterpret_cast<T_Create *>(slot));
+    }
+
+    // Returns the pool for the given type, or nullptr if the array isn't
+    // pooled or all pools are taken
+    template<typename T_Create, int Alignment>
+    ysChunkPool *GetPool() {
+        if (!POOLED) return nullptr;
+
+        const void *key = GetPoolKey<T_Create, Alignment>();
+        for (int i = 0; i < MaxPools; i++) {
+            if (m_poolKeys[i] == key) return &m_pools[i];
+            else if (m_poolKeys[i] == nullptr) {
+                const int alignment = (Alignment > (int)alignof(T_Create))
+                    ? Alignment
+                    : (int)alignof(T_Create);
+
+                m_pools[i].Initialize((int)sizeof(T_Create), alignment);
+                m_poolKeys[i] = key;
+                m_poolCasts[i] = &PoolCast<T_Create>;
+
+                return &m_pools[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool IsOwnPool(const ysChunkPool *pool) const {
+        if (pool == nullptr) return false;
+
+        for (int i = 0; i < MaxPools; i++) {
+            if (pool == &m_pools[i]) return true;
+        }
+
+        return false;
+    }
+
     void Extend() {
         TYPE **newArray = new TYPE * [m_maxSize * 2 + 1];
         memcpy(newArray, m_array, sizeof(TYPE *) * m_nObjects);
@@ -227,6 +350,13 @@ protected:
     TYPE **m_array;
     int m_maxSize;
     int m_nObjects;
+
+    // Number of objects in the array that are stored in its own pools
+    int m_pooledObjects;
+
+    ysChunkPool m_pools[MaxPools];
+    const void *m_poolKeys[MaxPools];
+    TYPE *(*m_poolCasts[MaxPools])(void *);
 };
 
 #endif /* YDS_DYNAMIC_ARRAY_H */
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "yds_error_codes.h"
+#include "yds_allocator.h"
 
 class ysDynamicArrayElement
 {
@@ -155,7 +156,7 @@ public:
 		if (alignment != 0)
 		{
 
-			void *memory = _aligned_malloc(sizeof(DYN_TYPE), alignment);
+			void *memory = ysAllocator::BlockAllocate((int)sizeof(DYN_TYPE), alignment);
 			m_array[m_nObjects] = static_cast<TYPE *>(new (memory) DYN_TYPE);
 
 		}
@@ -194,7 +195,7 @@ public:
 			{
 
 				m_array[index]->~TYPE();
-				_aligned_free(m_array[index]);
+				ysAllocator::BlockFree(m_array[index], target->GetAlignment());
 
 			}
 
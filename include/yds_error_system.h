@@ -4,6 +4,8 @@
 #include "yds_base.h"
 #include "yds_error_codes.h"
 
+#include <mutex>
+
 class ysErrorHandler;
 
 class ysErrorSystem : public ysObject {
@@ -24,7 +26,9 @@ public:
     void StackRaise(const char *callName);
     void StackDescend();
 
-    const char *GetCall() const { return (m_stackLevel > 0) ? m_callStack[m_stackLevel - 1] : "<NO CALL>"; }
+    // Call stacks are kept per thread so that errors can also be raised
+    // from worker threads
+    const char *GetCall() const;
 
     template<typename ERROR_HANDLER_TYPE>
     ysError AttachErrorHandler(ERROR_HANDLER_TYPE **handler) {
@@ -41,8 +45,8 @@ public:
 protected:
     ysDynamicArray<ysErrorHandler, 4> m_errorHandlers;
 
-    int m_stackLevel;
-    const char *m_callStack[MAX_STACK_LEVEL];
+    // Handlers are called one error at a time
+    std::mutex m_handlerLock;
 };
 
 #define _YDS_WIDE(_String) L ## _String
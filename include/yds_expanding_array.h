@@ -3,33 +3,94 @@
 
 #include "yds_allocator.h"
 
+#include <assert.h>
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 #include <new>
-
+#include <type_traits>
+#include <utility>
+
+// --
+// Types that can be moved to a new address with a plain memcpy (and without
+// destroying the original). Specialize for types that own their storage
+// through a pointer but are not trivially copyable.
+// --
+template<typename TYPE>
+struct ysIsTriviallyRelocatable
+    : std::integral_constant<bool, std::is_trivially_copyable<TYPE>::value> { /* void */ };
+
+// --
+// Types whose objects can be left unconstructed and filled in with memcpy
+// or a file read instead. The default constructor may still do work (ie.
+// zeroing a vector), it is just not needed.
+// --
+template<typename TYPE>
+struct ysIsBulkReadable
+    : std::integral_constant<bool,
+        std::is_trivially_copyable<TYPE>::value && std::is_trivially_destructible<TYPE>::value> { /* void */ };
+
+// --
+// Contiguous array of objects that grows as objects are added.
+//
+// Objects [0, GetNumObjects()) are constructed, the remaining capacity is
+// raw storage. Growing an array of trivially relocatable objects is a
+// single realloc, anything else is moved into the new storage.
+//
+// If storage can't be allocated the array is left as it was. Functions
+// that can report it return false (or nullptr), New() and Insert() stop
+// the program instead since they have to return an object.
+// --
 template<typename TYPE, int START_SIZE = 0, int ALIGNMENT = 1>
 class ysExpandingArray {
 public:
     ysExpandingArray() {
-        m_maxSize = START_SIZE;
+        m_maxSize = 0;
         m_nObjects = 0;
         m_array = NULL;
 
-        Preallocate(m_maxSize);
+        Preallocate(START_SIZE);
     }
 
     ysExpandingArray(const ysExpandingArray &ref) {
-        /* void */
+        m_maxSize = 0;
+        m_nObjects = 0;
+        m_array = NULL;
+
+        Append(ref.m_array, ref.m_nObjects);
+    }
+
+    ysExpandingArray(ysExpandingArray &&ref) noexcept {
+        m_maxSize = ref.m_maxSize;
+        m_nObjects = ref.m_nObjects;
+        m_array = ref.m_array;
+
+        ref.m_maxSize = 0;
+        ref.m_nObjects = 0;
+        ref.m_array = NULL;
     }
 
     ysExpandingArray &operator=(const ysExpandingArray &ref) {
-        Preallocate(ref.m_maxSize);
+        if (this == &ref) return *this;
 
-        for (int i = 0; i < ref.m_nObjects; i++) {
-            m_array[i] = ref.m_array[i];
-        }
+        Clear();
+        Append(ref.m_array, ref.m_nObjects);
+
+        return *this;
+    }
+
+    ysExpandingArray &operator=(ysExpandingArray &&ref) noexcept {
+        if (this == &ref) return *this;
+
+        Destroy();
 
-        m_nObjects = ref.m_nObjects;
         m_maxSize = ref.m_maxSize;
+        m_nObjects = ref.m_nObjects;
+        m_array = ref.m_array;
+
+        ref.m_maxSize = 0;
+        ref.m_nObjects = 0;
+        ref.m_array = NULL;
 
         return *this;
     }
@@ -38,10 +99,13 @@ public:
         Destroy();
     }
 
+    // Destroys all objects but keeps the storage
     void Clear() {
+        DestroyRange(0, m_nObjects);
         m_nObjects = 0;
     }
 
+    // Destroys all objects and releases the storage
     void Destroy() {
         DestroyArray(m_array);
 
@@ -55,67 +119,130 @@ public:
     }
 
     void DestroyArray(TYPE *arr) {
-        /*if (ALIGNMENT == 1) {
-            delete[] arr;
+        if (arr == NULL) return;
+
+        if (arr == m_array) DestroyRange(0, m_nObjects);
+        ysAllocator::BlockFree(reinterpret_cast<void *>(arr), ALIGNMENT);
+    }
+
+    // Resize the array to exactly nObjects default constructed objects,
+    // existing contents are only kept if there is already enough room
+    bool Allocate(int nObjects) {
+        if (nObjects == 0) return true;
+        if (nObjects > m_maxSize) {
+            Destroy();
+            if (!Reserve(nObjects)) return false;
         }
-        else {
-            for (int i = 0; i < m_maxSize; i++) {
-                arr[i].~TYPE();
-            }
 
-            _aligned_free(arr);
-        }*/
-        ysAllocator::TypeFree(arr, m_nObjects, true, ALIGNMENT);
+        return Resize(nObjects);
     }
 
-    void Allocate(int nObjects) {
-        if (nObjects == 0) return;
-        if (m_array != NULL) {
-            if (m_maxSize < nObjects) {
-                Destroy();
-            }
-            else {
-                // Already allocated, no sense in wasting time
-                m_nObjects = nObjects;
-                return;
-            }
+    // --
+    // Same as Allocate() except that the objects are not constructed. Every
+    // object must be written (ie. with a bulk file read) before it is used.
+    // --
+    bool AllocateUninitialized(int nObjects) {
+        if (nObjects == 0) return true;
+        if (nObjects > m_maxSize) {
+            Destroy();
+            if (!Reserve(nObjects)) return false;
         }
 
-        m_array = CreateArray(nObjects, true);
-        m_maxSize = nObjects;
-        m_nObjects = nObjects;
+        return ResizeUninitialized(nObjects);
     }
 
-    void Preallocate(int nObjects) {
-        if (nObjects == 0) return;
-        if (m_array != NULL) {
-            if (m_maxSize < nObjects) {
-                Destroy();
-            }
-            else {
-                // Already allocated, no sense in wasting time
-                m_nObjects = 0;
-                return;
+    // Remove all objects and make sure there is room for at least nObjects
+    bool Preallocate(int nObjects) {
+        if (nObjects == 0) return true;
+        if (nObjects > m_maxSize) {
+            Destroy();
+            return Reserve(nObjects);
+        }
+
+        Clear();
+        return true;
+    }
+
+    // Make sure there is room for at least nObjects without reallocating
+    bool Reserve(int nObjects) {
+        if (nObjects > m_maxSize) return Relocate(nObjects);
+        return true;
+    }
+
+    // Construct or destroy objects at the end of the array so that exactly
+    // nObjects remain
+    bool Resize(int nObjects) {
+        if (nObjects > m_nObjects) {
+            if (!Reserve(nObjects)) return false;
+            if (!std::is_trivially_default_constructible<TYPE>::value) {
+                for (int i = m_nObjects; i < nObjects; i++) {
+                    new ((void *)&m_array[i]) TYPE;
+                }
             }
         }
+        else {
+            DestroyRange(nObjects, m_nObjects);
+        }
 
-        m_array = CreateArray(nObjects, false);
-        m_maxSize = nObjects;
-        m_nObjects = 0;
+        m_nObjects = nObjects;
+        return true;
+    }
+
+    // Resize() without constructing any new objects, see AllocateUninitialized()
+    bool ResizeUninitialized(int nObjects) {
+        static_assert(ysIsBulkReadable<TYPE>::value, "Type can't be left uninitialized");
+
+        if (!Reserve(nObjects)) return false;
+
+        m_nObjects = nObjects;
+        return true;
+    }
+
+    // --
+    // Add n unconstructed objects to the end of the array and return the
+    // first of them, see AllocateUninitialized().
+    // --
+    TYPE *AppendUninitialized(int n) {
+        static_assert(ysIsBulkReadable<TYPE>::value, "Type can't be left uninitialized");
+
+        if (!MakeRoom(n)) return nullptr;
+
+        TYPE *first = m_array + m_nObjects;
+        m_nObjects += n;
+
+        return first;
+    }
+
+    // Copy n objects onto the end of the array
+    bool Append(const TYPE *data, int n) {
+        if (n <= 0) return true;
+
+        // The source may be part of this array
+        const bool internal = (data >= m_array && data < m_array + m_nObjects);
+        const int offset = internal ? (int)(data - m_array) : 0;
+
+        if (!MakeRoom(n)) return false;
+        if (internal) data = m_array + offset;
+
+        CopyConstruct(m_array + m_nObjects, data, n, std::is_trivially_copyable<TYPE>());
+        m_nObjects += n;
+
+        return true;
     }
 
     inline TYPE &New() {
-        if (m_nObjects >= m_maxSize) Extend();
+        if (!MakeRoom(1)) OutOfMemory();
 
         return *(new ((void *)&m_array[m_nObjects++]) TYPE);
     }
 
+    // Insert a default constructed object before index, keeping the order
+    // of all other objects
     TYPE &Insert(int index) {
-        New();
+        if (!MakeRoom(1)) OutOfMemory();
 
-        for (int i = (m_nObjects - 1); i > index; i--) {
-            m_array[i] = m_array[i - 1];
-        }
+        ShiftUp(index, ysIsTriviallyRelocatable<TYPE>());
+        m_nObjects++;
 
         return m_array[index];
     }
@@ -126,39 +253,62 @@ public:
         return m_array[index];
     }
 
-    TYPE operator[](int index) const {
+    const TYPE &operator[](int index) const {
         return m_array[index];
     }
 
-    void Copy(int index) {
-        TYPE &cpy = New();
-        cpy = m_array[index];
+    // Append a copy of the object at index
+    bool Copy(int index) {
+        if (!MakeRoom(1)) return false;
+
+        new ((void *)&m_array[m_nObjects]) TYPE(m_array[index]);
+        m_nObjects++;
+
+        return true;
     }
 
     int GetNumObjects() const {
         return m_nObjects;
     }
 
+    int GetCapacity() const {
+        return m_maxSize;
+    }
+
     bool IsActive() const {
         return (m_array != NULL);
     }
 
+    // --
+    // Remove the object at index. Unless the order is maintained the last
+    // object takes its place.
+    // --
     void Delete(int index, bool maintainOrder = false) {
         if (maintainOrder) {
-            for (int i = index; i < m_nObjects; i++) {
-                m_array[i] = m_array[i + 1];
-            }
+            Erase(index, 1);
+            return;
+        }
 
-            m_array[m_nObjects - 1] = NULL;
+        const int last = m_nObjects - 1;
+        if (index != last) {
+            MoveLast(index, ysIsTriviallyRelocatable<TYPE>());
         }
         else {
-            m_array[index] = m_array[m_nObjects - 1];
+            m_array[last].~TYPE();
         }
 
         m_nObjects--;
     }
 
-    int Find(TYPE &ref) const {
+    // Remove count objects starting at index, keeping the order of the rest
+    void Erase(int index, int count = 1) {
+        if (count <= 0) return;
+
+        ShiftDown(index, count, ysIsTriviallyRelocatable<TYPE>());
+        m_nObjects -= count;
+    }
+
+    int Find(const TYPE &ref) const {
         for (int i = 0; i < m_nObjects; i++) {
             if (m_array[i] == ref) return i;
         }
@@ -167,17 +317,124 @@ public:
     }
 
 private:
-    void Extend() {
-        TYPE *newArray = CreateArray(m_maxSize * 2 + 1);
+    // Make room for n more objects with amortized growth
+    bool MakeRoom(int n) {
+        if (n > INT_MAX - m_nObjects) return false;
+        if (m_nObjects + n <= m_maxSize) return true;
+
+        int newSize = (m_maxSize < INT_MAX / 2) ? m_maxSize * 2 + 1 : INT_MAX;
+        if (newSize < m_nObjects + n) newSize = m_nObjects + n;
+
+        return Relocate(newSize);
+    }
+
+    static void OutOfMemory() {
+        assert(!"ysExpandingArray: out of memory");
+        abort();
+    }
+
+    // The array is left as it was if the new block can't be allocated
+    bool Relocate(int newSize) {
+        // Sizes are passed to the allocator as int
+        if ((size_t)newSize > (size_t)INT_MAX / sizeof(TYPE)) return false;
+        if (!Relocate(newSize, ysIsTriviallyRelocatable<TYPE>())) return false;
+
+        m_maxSize = newSize;
+        return true;
+    }
+
+    // Trivially relocatable objects are moved with realloc/memcpy/memmove,
+    // everything else is moved one object at a time
+
+    bool Relocate(int newSize, std::true_type) {
+        void *block = ysAllocator::BlockReallocate(
+            reinterpret_cast<void *>(m_array),
+            sizeof(TYPE) * m_maxSize,
+            sizeof(TYPE) * newSize,
+            ALIGNMENT);
+        if (block == nullptr) return false;
+
+        m_array = reinterpret_cast<TYPE *>(block);
+        return true;
+    }
+
+    bool Relocate(int newSize, std::false_type) {
+        TYPE *newArray = CreateArray(newSize, false);
+        if (newArray == nullptr) return false;
+
         for (int i = 0; i < m_nObjects; i++) {
-            newArray[i] = m_array[i];
+            new ((void *)&newArray[i]) TYPE(std::move(m_array[i]));
         }
 
         DestroyArray(m_array);
-
         m_array = newArray;
-        m_maxSize *= 2;
-        m_maxSize += 1;
+        return true;
+    }
+
+    void ShiftUp(int index, std::true_type) {
+        memmove(
+            (void *)(m_array + index + 1),
+            (const void *)(m_array + index),
+            sizeof(TYPE) * (m_nObjects - index));
+        new ((void *)&m_array[index]) TYPE;
+    }
+
+    void ShiftUp(int index, std::false_type) {
+        if (index == m_nObjects) {
+            new ((void *)&m_array[index]) TYPE;
+            return;
+        }
+
+        new ((void *)&m_array[m_nObjects]) TYPE(std::move(m_array[m_nObjects - 1]));
+        for (int i = m_nObjects - 1; i > index; i--) {
+            m_array[i] = std::move(m_array[i - 1]);
+        }
+
+        m_array[index] = TYPE();
+    }
+
+    void ShiftDown(int index, int count, std::true_type) {
+        DestroyRange(index, index + count);
+        memmove(
+            (void *)(m_array + index),
+            (const void *)(m_array + index + count),
+            sizeof(TYPE) * (m_nObjects - index - count));
+    }
+
+    void ShiftDown(int index, int count, std::false_type) {
+        for (int i = index; i < m_nObjects - count; i++) {
+            m_array[i] = std::move(m_array[i + count]);
+        }
+
+        DestroyRange(m_nObjects - count, m_nObjects);
+    }
+
+    void MoveLast(int index, std::true_type) {
+        m_array[index].~TYPE();
+        memcpy((void *)(m_array + index), (const void *)(m_array + m_nObjects - 1), sizeof(TYPE));
+    }
+
+    void MoveLast(int index, std::false_type) {
+        m_array[index] = std::move(m_array[m_nObjects - 1]);
+        m_array[m_nObjects - 1].~TYPE();
+    }
+
+    static void CopyConstruct(TYPE *target, const TYPE *source, int n, std::true_type) {
+        memcpy((void *)target, (const void *)source, sizeof(TYPE) * n);
+    }
+
+    static void CopyConstruct(TYPE *target, const TYPE *source, int n, std::false_type) {
+        for (int i = 0; i < n; i++) {
+            new ((void *)&target[i]) TYPE(source[i]);
+        }
+    }
+
+    void DestroyRange(int begin, int end) {
+        if (std::is_trivially_destructible<TYPE>::value) return;
+
+        for (int i = begin; i < end; i++) {
+            m_array[i].~TYPE();
+        }
     }
 
     int m_maxSize;
@@ -185,4 +442,8 @@ private:
     TYPE *m_array;
 };
 
+// Arrays only refer to their storage through a pointer
+template<typename TYPE, int START_SIZE, int ALIGNMENT>
+struct ysIsTriviallyRelocatable<ysExpandingArray<TYPE, START_SIZE, ALIGNMENT>> : std::true_type { /* void */ };
+
 #endif /* YDS_EXPANDING_ARRAY_H */
@@ -0,0 +1,165 @@
+#ifndef YDS_FRAME_ARENA_H
+#define YDS_FRAME_ARENA_H
+
+#include "yds_memory_base.h"
+#include "yds_allocator.h"
+
+// --
+// Bump pointer allocator for data that only lives for a single frame.
+//
+// Allocations are never freed individually, the entire arena is reclaimed
+// in one step by Reset() at the end of the frame. Destructors are not
+// called so only types which do not own any resources should be
+// allocated from it.
+//
+// If double buffering is enabled, data allocated during a frame remains
+// valid until the end of the following frame.
+// --
+class ysFrameArena : public ysMemoryAllocator {
+public:
+    static const int DefaultSize = 1 * MB;
+
+    // All blocks are aligned for SSE types
+    static const int Alignment = 16;
+
+    // Pages at least this large are mapped directly and backed by huge pages
+    static const int HugePageThreshold = (int)ysAllocator::HugePageSize;
+
+protected:
+    struct Page {
+        Page *Next;
+        char *Data;
+        int Size;
+
+        // Size of the mapping if the page came from ysAllocator::PageAllocate()
+        size_t MappedSize;
+    };
+
+    struct Buffer {
+        Page *FirstPage;
+        Page *CurrentPage;
+        int Offset;
+        int Usage;
+    };
+
+public:
+    // --
+    // Position within the arena which can be returned to, freeing
+    // everything that was allocated after it was taken.
+    // --
+    struct Marker {
+        Page *CurrentPage;
+        int Offset;
+        int Usage;
+    };
+
+    // --
+    // Frees everything allocated from an arena within a C++ scope. When the
+    // outermost scope exits, spare pages beyond the retained size are
+    // released so that one large request doesn't pin its memory for the
+    // life of the arena.
+    // --
+    class Scope {
+    public:
+        Scope(ysFrameArena *arena) : m_arena(arena), m_marker(arena->GetMarker()) {
+            m_arena->m_scopeDepth++;
+        }
+
+        ~Scope() {
+            m_arena->FreeToMarker(m_marker);
+            if (--m_arena->m_scopeDepth == 0) m_arena->Trim(m_arena->m_retainedSize);
+        }
+
+    protected:
+        ysFrameArena *m_arena;
+        Marker m_marker;
+    };
+
+public:
+    ysFrameArena();
+    ~ysFrameArena();
+
+    // --
+    // Allocate the arena's buffer(s).
+    //
+    //   size: Initial size of each buffer (bytes), buffers are
+    //         enlarged automatically if a frame overflows
+    //   doubleBuffered: Keep the previous frame's data valid for one extra frame
+    //
+    // --
+    void Initialize(int size, bool doubleBuffered = false);
+
+    virtual void *AllocateBlock(int size, int numObjects = 1);
+
+    // Blocks can't be freed individually, always returns 0
+    virtual int FreeBlock(void *block);
+
+    virtual void Destroy();
+
+    // --
+    // Allocate an uninitialized array.
+    // --
+    template<typename TYPE>
+    TYPE *AllocateArray(int n) {
+        return reinterpret_cast<TYPE *>(AllocateBlock(sizeof(TYPE) * n, n));
+    }
+
+    // --
+    // Reclaim all memory allocated during the frame. If the arena
+    // is double buffered, only the frame before the current one is reclaimed.
+    // --
+    void Reset();
+
+    Marker GetMarker() const;
+    void FreeToMarker(const Marker &marker);
+
+    // Free pages past the current one that aren't in use, keeping up
+    // to retainedSize bytes of them for later allocations
+    void Trim(int retainedSize);
+
+    // Spare pages kept when the outermost Scope exits (bytes)
+    void SetRetainedSize(int size) { m_retainedSize = size; }
+    int GetRetainedSize() const { return m_retainedSize; }
+
+    bool IsInitialized() const { return m_buffers[0].FirstPage != nullptr; }
+    bool IsDoubleBuffered() const { return m_doubleBuffered; }
+
+    // Bytes allocated so far during this frame
+    int GetUsage() const { return m_buffers[m_activeBuffer].Usage; }
+
+    // Highest usage reached during the last completed frame
+    int GetLastFramePeak() const { return m_lastFramePeak; }
+
+    // Highest usage reached during any frame
+    int GetPeakUsage() const { return m_peakUsage; }
+
+    // Bytes reserved by the active buffer
+    int GetCapacity() const;
+
+    // --
+    // Returns an arena owned by the calling thread. Each thread is
+    // responsible for resetting its own arena.
+    // --
+    static ysFrameArena *GetThreadArena();
+
+protected:
+    Page *NewPage(int size);
+    void FreePages(Page *page);
+    void *AllocateFromNewPage(int size);
+
+    void ResetBuffer(Buffer *buffer);
+
+    Buffer m_buffers[2];
+    int m_activeBuffer;
+    bool m_doubleBuffered;
+
+    int m_pageSize;
+    int m_retainedSize;
+    int m_scopeDepth;
+
+    int m_framePeak;
+    int m_lastFramePeak;
+    int m_peakUsage;
+};
+
+#endif /* YDS_FRAME_ARENA_H */
@@ -4,9 +4,27 @@
 #include "yds_base.h"
 
 #include "yds_object_data.h"
+#include "yds_expanding_array.h"
 
 #include <fstream>
 
+class ysCompiledSceneFile;
+
+// --
+// Writer for compiled scene files (.ysce).
+//
+// Objects are buffered as they are written and the file is laid out in one
+// go by Close(): a FileHeader, the custom data, a table of contents with one
+// ObjectTableEntry per object, bone maps and primitive data, then a single
+// vertex block and a single index block for the whole scene. Every section
+// and every object's vertex and index data starts on a PayloadAlignment
+// boundary so that a reader can map the file and hand the blocks straight
+// to the GPU.
+//
+// Indices are 16 bit unless the object has more vertices than that can
+// address, in which case they are 32 bit and MDF_32BIT_INDICES is set. Both
+// widths share the index block.
+// --
 class ysGeometryExportFile : public ysObject {
 public:
     // Flags
@@ -16,6 +34,26 @@ public:
     static const unsigned int MDF_TANGENTS = 0x04;
     static const unsigned int MDF_TEXTURE_DATA = 0x08;
     static const unsigned int MDF_ANIMATION_DATA = 0x10;
+    static const unsigned int MDF_COMPRESSED = 0x20;
+    static const unsigned int MDF_32BIT_INDICES = 0x40;
+
+    // --
+    // Compressed vertex layout (MDF_COMPRESSED), in the same order as the
+    // full float layout:
+    //
+    //  Position    4 x unorm16, xyz relative to MinExtreme/MaxExtreme, w is 1
+    //              for a right handed tangent frame and 0 otherwise
+    //  UV          2 x float16 per channel
+    //  Normal      2 x snorm16, octahedral
+    //  Bones       4 x uint8 indices (255 if unused), 4 x unorm8 weights
+    //  Tangent     2 x snorm16, octahedral
+    // --
+    static const int CompressedUnusedBone = 255;
+
+    // File layout
+    static const unsigned int FileMagic = 0x45435359; // 'YSCE'
+    static const unsigned int FileVersion = 3;
+    static const int PayloadAlignment = 16;
 
     struct ObjectOutputHeader {
         char ObjectName[64];
@@ -42,30 +80,95 @@ public:
         int NumBones;
         int MaxBonesPerVertex;
 
+        int NumMeshlets;
+
         unsigned int Flags;
 
         int VertexDataSize;
     };
 
+    struct FileHeader {
+        unsigned int Magic;
+        unsigned int Version;
+
+        int ObjectCount;
+        int CustomDataSize;
+
+        // Offsets are from the start of the file
+        unsigned int CustomDataOffset;
+        unsigned int ObjectTableOffset;
+
+        unsigned int VertexDataOffset;
+        int VertexDataSize;
+
+        unsigned int IndexDataOffset;
+        int IndexDataSize;
+    };
+
+    struct ObjectTableEntry {
+        ObjectOutputHeader Header;
+
+        // Byte offset into the vertex block, a multiple of both the vertex
+        // stride and PayloadAlignment
+        int VertexOffset;
+
+        // Offset into the index block in units of the object's index size
+        int IndexOffset;
+
+        // Offsets from the start of the file, -1 if the object has none
+        int BoneMapOffset;
+        int PrimitiveDataOffset;
+        int MeshletOffset;
+    };
+
+    // Size in bytes of one of the object's indices
+    static int GetIndexSize(const ObjectOutputHeader &header) {
+        return (header.Flags & MDF_32BIT_INDICES) ? (int)sizeof(unsigned int) : (int)sizeof(unsigned short);
+    }
+
 public:
     ysGeometryExportFile();
     ~ysGeometryExportFile();
 
     ysError Open(const char *fname);
-    void Close();
+
+    // Lay out and write everything that was added since Open()
+    ysError Close();
 
     ysError WriteCustomData(void *data, int size);
-    ysError WriteObject(ysObjectData *object);
+    // Objects that can't be compressed (ie. too many bones) are written
+    // with full precision, check MDF_COMPRESSED in the header. Meshlets
+    // are written if the object has any.
+    ysError WriteObject(ysObjectData *object, bool compressVertices = false);
+
+    // Copies an object as is from a file written earlier, the result is the
+    // same as writing the object it was compiled from again
+    ysError WriteCompiledObject(const ysCompiledSceneFile &file, int index);
 
 protected:
     void WriteIntToBuffer(int value, char **buffer);
     void WriteFloatToBuffer(float value, char **buffer);
 
     int PackVertexData(ysObjectData *object, int maxBonesPerVertex, void **output);
+    int PackCompressedVertexData(ysObjectData *object, const ObjectOutputHeader &header, void **output);
+    bool CanCompress(ysObjectData *object);
     void FillOutputHeader(ysObjectData *object, ObjectOutputHeader *header);
 
+    // Space for an object's data in the scene wide blocks, offsets are in
+    // bytes from the start of the block
+    char *AppendVertexData(int size, int stride, int *offset);
+    char *AppendIndexData(int size, int *offset);
+
+    void Reset();
+
 protected:
     std::ofstream m_file;
+
+    ysExpandingArray<char> m_customData;
+    ysExpandingArray<ObjectTableEntry> m_objects;
+    ysExpandingArray<char> m_extraData;
+    ysExpandingArray<char, 0, PayloadAlignment> m_vertexData;
+    ysExpandingArray<char, 0, PayloadAlignment> m_indexData;
 };
 
 #endif /* YDS_GEOMETRY_EXPORT_FILE_H */
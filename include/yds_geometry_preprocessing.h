@@ -34,6 +34,44 @@ namespace ysGeometryPreprocessing {
 
     void UniformScale(ysObjectData *object, float scale);
 
+    // --
+    // Vertex cache optimization
+    //
+    // Run after all other stages, just before the object is packed. The
+    // passes only change the order of faces and vertices, not the mesh.
+    // --
+    struct VertexCacheStatistics {
+        int FaceCount;
+        int VertexCount;
+        int CacheMisses;
+
+        // Average cache miss ratio, transformed vertices per face
+        float GetACMR() const { return (FaceCount > 0) ? (float)CacheMisses / FaceCount : 0.0f; }
+
+        // Average transformed to vertex ratio, 1.0 is ideal
+        float GetATVR() const { return (VertexCount > 0) ? (float)CacheMisses / VertexCount : 0.0f; }
+    };
+
+    // Simulate a FIFO post-transform cache of the given size
+    VertexCacheStatistics AnalyzeVertexCache(ysObjectData *object, int cacheSize = 16);
+
+    // Reorder faces to reduce cache misses (Forsyth's linear-speed method)
+    void OptimizeVertexCache(ysObjectData *object);
+
+    // Reorder clusters of faces so that outward facing ones are drawn first.
+    // Clusters only break where the cache is cold anyway.
+    void OptimizeOverdraw(ysObjectData *object, int cacheSize = 16);
+
+    // Renumber vertices in the order they are first used by the faces
+    void OptimizeVertexFetch(ysObjectData *object);
+
+    // --
+    // Split the faces into meshlets in their current order, each with at
+    // most maxVertices unique vertices and maxFaces faces. Run after the
+    // passes above, reordering faces discards the meshlets.
+    // --
+    void BuildMeshlets(ysObjectData *object, int maxVertices = 64, int maxFaces = 124);
+
 };
 
 #endif /* YDS_GEOMETRY_PREPROCESSING_H */
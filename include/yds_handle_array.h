@@ -1,91 +1,187 @@
 #ifndef YDS_HANDLE_ARRAY_H
 #define YDS_HANDLE_ARRAY_H
 
-#include "yds_dynamic_array.h"
-#include "yds_linked_list.h"
+#include "yds_expanding_array.h"
 
-template<typename TYPE, int START_SIZE=0>
-class ysHandleArray : public ysDynamicArray<TYPE, START_SIZE>
-{
+#include <stdint.h>
 
-public:
-
-	ysHandleArray()
-	{
-	}
-
-	~ysHandleArray()
-	{
-	}
-
-	void Preallocate(int nObjects)
-	{
-
-		if (!nObjects) return;
-		if (m_array) return;
-
-		m_array = new TYPE[nObjects];
-
-	}
-	
-	int New()
-	{
-
-		if (m_nObjects >= m_maxSize) Extend();
-
-		m_array[m_nObjects] = new TYPE;
-		return m_nObjects++;
-
-	}
-
-	void Delete(int index)
-	{
+// --
+// Reference to an object stored in a ysHandleArray. The generation is
+// bumped every time a slot is reused so handles to removed objects are
+// detected instead of silently referring to whatever took their place.
+// --
+struct ysHandle {
+    uint32_t Index;
+    uint32_t Generation;
 
-		if (m_nObjects <= m_maxSize / 2) Condense();
+    bool IsNull() const { return Generation == 0; }
 
-		delete m_array[index];
-		m_array[index] = NULL;
-		m_nObjects--;
+    bool operator==(const ysHandle &handle) const {
+        return Index == handle.Index && Generation == handle.Generation;
+    }
 
-	}
+    bool operator!=(const ysHandle &handle) const {
+        return !(*this == handle);
+    }
 
-	TYPE *Get(int index)
-	{
-
-		return m_array[index];
-
-	}
+    static ysHandle Null() { return { 0, 0 }; }
+};
 
+// --
+// Table of object pointers addressed by generational handles. The array
+// does not own the objects.
+//
+// Pointers are packed densely (in no particular order) so that iterating
+// over every object is a linear walk. Each handle refers to a slot which
+// stores the object's position in the dense array. Adding, removing and
+// looking up objects are all O(1). Storage only ever grows, removing
+// objects never reallocates.
+// --
+template<typename TYPE, int START_SIZE = 0>
+class ysHandleArray {
 protected:
+    struct Slot {
+        uint32_t Generation;
 
-	void Extend()
-	{
-
-		TYPE **newArray = new TYPE *[m_maxSize * 2];
-		memcpy(newArray, m_array, sizeof(TYPE *) * m_nObjects);
-
-		delete [] m_array;
-
-		m_array = newArray;
+        // Position in the dense array, or the next free slot
+        int Dense;
+    };
 
-	}
-
-	void Condense()
-	{
-
-		TYPE **newArray = new TYPE *[m_maxSize / 2];
-		memcpy(newArray, m_array, sizeof(TYPE *) * m_nObjects);
+public:
+    ysHandleArray() {
+        m_freeSlot = -1;
+
+        Reserve(START_SIZE);
+    }
+
+    ~ysHandleArray() {
+        /* void */
+    }
+
+    // Make room for nObjects without any further allocation
+    void Reserve(int nObjects) {
+        m_slots.Reserve(nObjects);
+        m_objects.Reserve(nObjects);
+        m_denseToSlot.Reserve(nObjects);
+    }
+
+    ysHandle Add(TYPE *object) {
+        int slotIndex;
+        if (m_freeSlot != -1) {
+            slotIndex = m_freeSlot;
+            m_freeSlot = m_slots[slotIndex].Dense;
+        }
+        else {
+            slotIndex = m_slots.GetNumObjects();
+
+            Slot &newSlot = m_slots.New();
+            newSlot.Generation = 1;
+        }
+
+        Slot &slot = m_slots[slotIndex];
+        slot.Dense = m_objects.GetNumObjects();
+
+        m_objects.New() = object;
+        m_denseToSlot.New() = slotIndex;
+
+        return { (uint32_t)slotIndex, slot.Generation };
+    }
+
+    // --
+    // Remove the object referred to by the handle. The last object in the
+    // dense array takes its place.
+    //
+    // Returns the removed object, or nullptr if the handle is stale.
+    // --
+    TYPE *Remove(const ysHandle &handle) {
+        if (!IsValid(handle)) return nullptr;
+
+        Slot &slot = m_slots[handle.Index];
+        const int dense = slot.Dense;
+        const int last = m_objects.GetNumObjects() - 1;
+
+        TYPE *object = m_objects[dense];
+
+        if (dense != last) {
+            m_objects[dense] = m_objects[last];
+            m_denseToSlot[dense] = m_denseToSlot[last];
+            m_slots[m_denseToSlot[dense]].Dense = dense;
+        }
+
+        m_objects.Delete(last);
+        m_denseToSlot.Delete(last);
+
+        ReleaseSlot(handle.Index);
+
+        return object;
+    }
+
+    // Returns the object referred to by the handle, or nullptr if the handle is stale
+    inline TYPE *Get(const ysHandle &handle) const {
+        return IsValid(handle)
+            ? m_objects[m_slots[handle.Index].Dense]
+            : nullptr;
+    }
+
+    inline bool IsValid(const ysHandle &handle) const {
+        return handle.Index < (uint32_t)m_slots.GetNumObjects()
+            && handle.Generation != 0
+            && m_slots[handle.Index].Generation == handle.Generation;
+    }
+
+    // Position of the object in the dense array, or -1 if the handle is stale
+    int GetDenseIndex(const ysHandle &handle) const {
+        return IsValid(handle)
+            ? m_slots[handle.Index].Dense
+            : -1;
+    }
+
+    // Dense access, valid until the next removal
+    inline TYPE *Get(int index) const {
+        return m_objects[index];
+    }
+
+    ysHandle GetHandle(int index) const {
+        const int slotIndex = m_denseToSlot[index];
+        return { (uint32_t)slotIndex, m_slots[slotIndex].Generation };
+    }
+
+    inline TYPE **GetBuffer() {
+        return m_objects.GetBuffer();
+    }
+
+    int GetNumObjects() const {
+        return m_objects.GetNumObjects();
+    }
+
+    // Remove all objects, every outstanding handle becomes stale
+    void Clear() {
+        const int nObjects = m_objects.GetNumObjects();
+        for (int i = 0; i < nObjects; i++) {
+            ReleaseSlot(m_denseToSlot[i]);
+        }
+
+        m_objects.Clear();
+        m_denseToSlot.Clear();
+    }
 
-		delete [] m_array;
+protected:
+    void ReleaseSlot(int slotIndex) {
+        Slot &slot = m_slots[slotIndex];
 
-		m_array = newArray;
+        // Generation 0 is reserved for null handles
+        if (++slot.Generation == 0) slot.Generation = 1;
 
-	}
+        slot.Dense = m_freeSlot;
+        m_freeSlot = slotIndex;
+    }
 
 protected:
+    ysExpandingArray<Slot> m_slots;
+    ysExpandingArray<TYPE *> m_objects;
+    ysExpandingArray<int> m_denseToSlot;
 
-	ysLinkedList m_slots;
-
+    int m_freeSlot;
 };
 
-#endif
\ No newline at end of file
+#endif /* YDS_HANDLE_ARRAY_H */
@@ -0,0 +1,42 @@
+#ifndef YDS_HASH_H
+#define YDS_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --
+// Fast non-cryptographic hashing (XXH64).
+//
+// Results match the reference xxHash implementation, so keys written to
+// disk stay valid across builds and platforms. Not suitable for anything
+// that has to resist deliberate collisions.
+// --
+namespace ysHash {
+
+    uint64_t XXH64(const void *data, size_t size, uint64_t seed = 0);
+
+    // --
+    // Incremental version for data that isn't contiguous in memory. Feeding
+    // the data in any number of pieces gives the same result as XXH64().
+    // --
+    class XXH64State {
+    public:
+        XXH64State(uint64_t seed = 0);
+
+        void Reset(uint64_t seed = 0);
+        void Update(const void *data, size_t size);
+        uint64_t Digest() const;
+
+    protected:
+        uint64_t m_accumulators[4];
+        uint64_t m_seed;
+        uint64_t m_totalSize;
+
+        // Input that doesn't fill a whole stripe yet
+        unsigned char m_buffer[32];
+        int m_bufferSize;
+    };
+
+} /* namespace ysHash */
+
+#endif /* YDS_HASH_H */
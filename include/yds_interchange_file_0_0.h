@@ -7,6 +7,10 @@
 #include "yds_math.h"
 
 #include <fstream>
+#include <stdint.h>
+#include <vector>
+
+class ysFrameArena;
 
 class ysInterchangeFile0_0 : public ysObject {
 public:
@@ -73,10 +77,23 @@ public:
     unsigned int GetToolId() const { return m_toolId; }
     bool GetCompilationStatus() const { return m_objectCount; }
 
+    // Each array is read with a single call and all indices are checked
+    // against the sizes of the arrays they refer to
     ysError ReadObject(ysInterchangeObject *object);
 
+protected:
+    uint64_t GetRemainingSize();
+    bool ReadBlock(void *target, size_t size);
+
+    template <typename T>
+    bool ReadArray(std::vector<T> &target, unsigned int count);
+
+    static bool ValidateIndices(
+        const IndexSet *faceData, unsigned int faceCount, unsigned int setsPerFace, const unsigned int *limits, ysFrameArena *arena);
+
 protected:
     std::fstream m_file;
+    uint64_t m_fileSize;
 
     unsigned int m_minorVersion;
     unsigned int m_majorVersion;
@@ -50,6 +50,17 @@ public:
     void RipByNormals();
     void RipByTangents();
     void RipByUVs();
+
+    // --
+    // Same result as calling RipByTangents(), RipByNormals() and RipByUVs()
+    // but the vertex array is only grown once. Each distinct (position,
+    // normal, tangent, UVs) tuple becomes one vertex.
+    //
+    // The library never rips objects itself, ysInterchangeFile0_0 returns
+    // them as stored. Code that needs one vertex per attribute tuple should
+    // call this rather than the separate rips.
+    // --
+    void RipByAllAttributes();
 };
 
 #endif /* YDS_INTERCHANGE_OBJECT_H */
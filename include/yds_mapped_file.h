@@ -0,0 +1,45 @@
+#ifndef YDS_MAPPED_FILE_H
+#define YDS_MAPPED_FILE_H
+
+#include "yds_base.h"
+
+#include <stddef.h>
+
+// --
+// Read-only view of an entire file mapped into the address space.
+//
+// Pages are faulted in by the OS as they are touched, so reading a large
+// file costs a single open/map instead of one read call per block and the
+// contents can be handed to consumers without being copied into a
+// staging buffer first. The view stays valid until Close() is called.
+// --
+class ysMappedFile : public ysObject {
+public:
+    ysMappedFile();
+    ~ysMappedFile();
+
+    // Map the file. If sequential is set the OS is told that the file will
+    // be read front to back so that it can read ahead aggressively.
+    ysError Open(const char *fname, bool sequential = true);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+
+    const char *GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+    // Touch every page so that the file is read in on the calling thread
+    // instead of wherever the data is first used
+    void Prefetch() const;
+
+protected:
+    const char *m_data;
+    size_t m_size;
+
+#if defined(_WIN32)
+    void *m_fileHandle;
+    void *m_mappingHandle;
+#endif
+};
+
+#endif /* YDS_MAPPED_FILE_H */
@@ -1,10 +1,11 @@
 #ifndef YDS_MATH_H
 #define YDS_MATH_H
 
-#include <xmmintrin.h>
+#include <immintrin.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 
 // Extra Definitions
 
@@ -20,8 +21,13 @@
 #define _mm_replicate_w_ps(v) \
 	_mm_shuffle_ps((v), (v), _MM_SHUFFLE(3, 3, 3, 3))
 
+#if defined(__FMA__) || defined(__AVX2__)
 #define _mm_madd_ps(a, b, c) \
-	_mm_add_ps(_mm_mul_ps((a), (b)), (c));
+	_mm_fmadd_ps((a), (b), (c))
+#else
+#define _mm_madd_ps(a, b, c) \
+	_mm_add_ps(_mm_mul_ps((a), (b)), (c))
+#endif
 
 // Main Arithmetic Data Types
 typedef __m128 ysVector;
@@ -44,6 +50,12 @@ struct ysMatrix {
     ysVector rows[4];
 };
 
+// Affine transform with an implicit bottom row of (0, 0, 0, 1). Translation
+// is stored in the w component of each row, the same as in ysMatrix.
+struct ysAffineMatrix {
+    ysVector rows[3];
+};
+
 
 // Storage Data Types
 
@@ -117,7 +129,13 @@ struct ysMatrix33 {
     };
 };
 
-#define YS_MATH_CONST extern const __declspec(selectany)
+// Constants are constexpr so that they can be folded into the surrounding
+// code. Under C++17 they are also inline variables with a single address.
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define YS_MATH_CONST inline constexpr
+#else
+#define YS_MATH_CONST constexpr
+#endif
 
 namespace ysMath {
 
@@ -165,86 +183,1148 @@ namespace ysMath {
         // Quaternions
         YS_MATH_CONST ysQuaternion QuatIdentity = { 1.0f, 0.0f, 0.0f, 0.0f };
 
+        // Polynomial approximations (minimax coefficients from Cephes)
+        namespace Polynomial {
+
+            // Range reduction
+            YS_MATH_CONST float TwoOverPi = 0.636619772367581343f;
+            YS_MATH_CONST float PiOver2Hi = 1.5703125f;
+            YS_MATH_CONST float PiOver2Mid = 4.837512969970703125e-4f;
+            YS_MATH_CONST float PiOver2Lo = 7.54978995489188216e-8f;
+            YS_MATH_CONST float Log2E = 1.44269504088896341f;
+            YS_MATH_CONST float Ln2Hi = 0.693359375f;
+            YS_MATH_CONST float Ln2Lo = -2.12194440e-4f;
+            YS_MATH_CONST float SqrtHalf = 0.707106781186547524f;
+
+            // exp() is clamped to this range. Anything below ExpMin flushes
+            // to zero and anything above ExpMax saturates to infinity.
+            YS_MATH_CONST float ExpMin = -87.3365447504f;
+            YS_MATH_CONST float ExpMax = 88.0f;
+
+            // sin(r) on [-pi/4, pi/4]
+            YS_MATH_CONST float Sin0 = -1.9515295891e-4f;
+            YS_MATH_CONST float Sin1 = 8.3321608736e-3f;
+            YS_MATH_CONST float Sin2 = -1.6666654611e-1f;
+
+            // cos(r) on [-pi/4, pi/4]
+            YS_MATH_CONST float Cos0 = 2.443315711809948e-5f;
+            YS_MATH_CONST float Cos1 = -1.388731625493765e-3f;
+            YS_MATH_CONST float Cos2 = 4.166664568298827e-2f;
+
+            // exp(r) on [-ln(2)/2, ln(2)/2]
+            YS_MATH_CONST float Exp0 = 1.9875691500e-4f;
+            YS_MATH_CONST float Exp1 = 1.3981999507e-3f;
+            YS_MATH_CONST float Exp2 = 8.3334519073e-3f;
+            YS_MATH_CONST float Exp3 = 4.1665795894e-2f;
+            YS_MATH_CONST float Exp4 = 1.6666665459e-1f;
+            YS_MATH_CONST float Exp5 = 5.0000001201e-1f;
+
+            // log(1 + x) on [sqrt(1/2) - 1, sqrt(2) - 1]
+            YS_MATH_CONST float Log0 = 7.0376836292e-2f;
+            YS_MATH_CONST float Log1 = -1.1514610310e-1f;
+            YS_MATH_CONST float Log2 = 1.1676998740e-1f;
+            YS_MATH_CONST float Log3 = -1.2420140846e-1f;
+            YS_MATH_CONST float Log4 = 1.4249322787e-1f;
+            YS_MATH_CONST float Log5 = -1.6668057665e-1f;
+            YS_MATH_CONST float Log6 = 2.0000714765e-1f;
+            YS_MATH_CONST float Log7 = -2.4999993993e-1f;
+            YS_MATH_CONST float Log8 = 3.3333331174e-1f;
+
+        }
+
     }
 
     // ----------------------------------------------------
     // Math Functions
+    //
+    // All functions are defined inline at the bottom of this file
+    // so that they can be inlined across translation units.
     // ----------------------------------------------------
 
     // Vector/General Quaternion
-    ysGeneric LoadScalar(float s);
-    ysGeneric LoadVector(float x = 0.0f, float y = 0.0f, float z = 0.0f, float w = 0.0f);
-    ysGeneric LoadVector(const ysVector4 &v);
-    ysGeneric LoadVector(const ysVector3 &v, float w = 0.0f);
-    ysGeneric LoadVector(const ysVector2 &v1);
-    ysGeneric LoadVector(const ysVector2 &v1, const ysVector2 &v2);
-    ysQuaternion LoadQuaternion(float angle, const ysVector &axis);
-
-    ysVector4 GetVector4(const ysVector &v);
-    ysVector3 GetVector3(const ysVector &v);
-    ysVector2 GetVector2(const ysVector &v);
-    float GetScalar(const ysVector &v);
-
-    float GetX(const ysVector &v);
-    float GetY(const ysVector &v);
-    float GetZ(const ysVector &v);
-    float GetW(const ysVector &v);
-
-    float GetQuatX(const ysQuaternion &v);
-    float GetQuatY(const ysQuaternion &v);
-    float GetQuatZ(const ysQuaternion &v);
-    float GetQuatW(const ysQuaternion &v);
-
-    ysGeneric Add(const ysGeneric &v1, const ysGeneric &v2);
-    ysGeneric Sub(const ysGeneric &v1, const ysGeneric &v2);
-    ysGeneric Mul(const ysGeneric &v1, const ysGeneric &v2);
-    ysGeneric Div(const ysGeneric &v1, const ysGeneric &v2);
-
-    ysVector Dot(const ysVector &v1, const ysVector &v2);
-    ysVector Dot3(const ysVector &v1, const ysVector &v2);
-    ysVector Cross(const ysVector &v1, const ysVector &v2);
-    ysVector MagnitudeSquared3(const ysVector &v);
-    ysVector Magnitude(const ysVector &v);
-    ysVector Normalize(const ysVector &v);
-    ysVector Negate(const ysVector &v);
-    ysVector Negate3(const ysVector &v);
-
-    ysVector Mask(const ysVector &v, const ysVectorMask &mask);
-    ysVector Or(const ysVector &v1, const ysVector &v2);
+    inline ysGeneric LoadScalar(float s);
+    inline ysGeneric LoadVector(float x = 0.0f, float y = 0.0f, float z = 0.0f, float w = 0.0f);
+    inline ysGeneric LoadVector(const ysVector4 &v);
+    inline ysGeneric LoadVector(const ysVector3 &v, float w = 0.0f);
+    inline ysGeneric LoadVector(const ysVector2 &v1);
+    inline ysGeneric LoadVector(const ysVector2 &v1, const ysVector2 &v2);
+    inline ysQuaternion LoadQuaternion(float angle, const ysVector &axis);
+
+    inline ysVector4 GetVector4(const ysVector &v);
+    inline ysVector3 GetVector3(const ysVector &v);
+    inline ysVector2 GetVector2(const ysVector &v);
+    inline float GetScalar(const ysVector &v);
+
+    inline float GetX(const ysVector &v);
+    inline float GetY(const ysVector &v);
+    inline float GetZ(const ysVector &v);
+    inline float GetW(const ysVector &v);
+
+    inline float GetQuatX(const ysQuaternion &v);
+    inline float GetQuatY(const ysQuaternion &v);
+    inline float GetQuatZ(const ysQuaternion &v);
+    inline float GetQuatW(const ysQuaternion &v);
+
+    inline ysGeneric Add(const ysGeneric &v1, const ysGeneric &v2);
+    inline ysGeneric Sub(const ysGeneric &v1, const ysGeneric &v2);
+    inline ysGeneric Mul(const ysGeneric &v1, const ysGeneric &v2);
+    inline ysGeneric Div(const ysGeneric &v1, const ysGeneric &v2);
+
+    inline ysVector Dot(const ysVector &v1, const ysVector &v2);
+    inline ysVector Dot3(const ysVector &v1, const ysVector &v2);
+    inline ysVector Cross(const ysVector &v1, const ysVector &v2);
+    inline ysVector MagnitudeSquared3(const ysVector &v);
+    inline ysVector Magnitude(const ysVector &v);
+    inline ysVector Normalize(const ysVector &v);
+    inline ysVector Negate(const ysVector &v);
+    inline ysVector Negate3(const ysVector &v);
+
+    inline ysVector Mask(const ysVector &v, const ysVectorMask &mask);
+    inline ysVector Or(const ysVector &v1, const ysVector &v2);
+
+    // Per lane: mask ? v1 : v2
+    inline ysGeneric Select(const ysGeneric &mask, const ysGeneric &v1, const ysGeneric &v2);
+
+    // Reciprocals
+    //
+    // The Fast variants refine the hardware estimate with a single
+    // Newton-Raphson step (about 22 bits of precision). Good enough for
+    // directions and rotations but not for values that are accumulated
+    // over many frames. Zero inputs produce NaN.
+    inline ysGeneric Reciprocal(const ysGeneric &v);
+    inline ysGeneric ReciprocalFast(const ysGeneric &v);
+    inline ysGeneric ReciprocalSqrt(const ysGeneric &v);
+    inline ysGeneric ReciprocalSqrtFast(const ysGeneric &v);
+    inline ysVector NormalizeFast(const ysVector &v);
+
+    // Polynomial approximations evaluated on all four lanes at once.
+    // Maximum relative error is a few ulp over the useful range. SinCos
+    // is accurate for |v| < 8192 and Pow is only defined for base >= 0,
+    // Pow(x, 0) is 1 for any x.
+    inline void SinCos(const ysGeneric &v, ysGeneric *s, ysGeneric *c);
+    inline ysGeneric Exp(const ysGeneric &v);
+    inline ysGeneric Log(const ysGeneric &v);
+    inline ysGeneric Pow(const ysGeneric &base, const ysGeneric &exponent);
 
     // Quaternion
-    ysQuaternion QuatInvert(const ysQuaternion &q);
-    ysQuaternion QuatMultiply(const ysQuaternion &q1, const ysQuaternion &q2);
-    ysQuaternion QuatAddScaled(const ysQuaternion &q, const ysVector &vec, float scale);
+    inline ysQuaternion QuatInvert(const ysQuaternion &q);
+    inline ysQuaternion QuatMultiply(const ysQuaternion &q1, const ysQuaternion &q2);
+    inline ysQuaternion QuatAddScaled(const ysQuaternion &q, const ysVector &vec, float scale);
+    inline ysQuaternion QuatAddScaledFast(const ysQuaternion &q, const ysVector &vec, float scale);
+
+    // Interpolation
+    //
+    // q2 is negated if needed so that the shortest path is taken. Nlerp is
+    // cheaper but does not have constant angular velocity. Squad expects
+    // control points computed with QuatSquadControlPoint.
+    inline ysQuaternion QuatNlerp(const ysQuaternion &q1, const ysQuaternion &q2, float t);
+    inline ysQuaternion QuatSlerp(const ysQuaternion &q1, const ysQuaternion &q2, float t);
+    inline ysQuaternion QuatSquad(const ysQuaternion &q1, const ysQuaternion &q2, const ysQuaternion &s1, const ysQuaternion &s2, float t);
+    inline ysQuaternion QuatSquadControlPoint(const ysQuaternion &prev, const ysQuaternion &q, const ysQuaternion &next);
+
+    // Logarithm and exponential of unit/pure quaternions
+    inline ysQuaternion QuatLog(const ysQuaternion &q);
+    inline ysQuaternion QuatExp(const ysQuaternion &q);
 
     // Matrices
-    ysMatrix LoadIdentity();
-    ysMatrix LoadMatrix(const ysVector &r1, const ysVector &r2, const ysVector &r3, const ysVector &r4);
-    ysMatrix LoadMatrix(const ysQuaternion &quat);
-    ysMatrix LoadMatrix(const ysQuaternion &quat, const ysVector &origin);
-    void LoadMatrix(const ysQuaternion &quat, const ysVector &origin, ysMatrix *full, ysMatrix *orientation);
+    inline ysMatrix LoadIdentity();
+    inline ysMatrix LoadMatrix(const ysVector &r1, const ysVector &r2, const ysVector &r3, const ysVector &r4);
+    inline ysMatrix LoadMatrix(const ysQuaternion &quat);
+    inline ysMatrix LoadMatrix(const ysQuaternion &quat, const ysVector &origin);
+    inline void LoadMatrix(const ysQuaternion &quat, const ysVector &origin, ysMatrix *full, ysMatrix *orientation);
 
-    ysMatrix Transpose(const ysMatrix &m);
-    ysMatrix OrthogonalInverse(const ysMatrix &m);
+    inline ysMatrix Transpose(const ysMatrix &m);
+    inline ysMatrix OrthogonalInverse(const ysMatrix &m);
 
-    ysMatrix44 GetMatrix44(const ysMatrix &m);
-    ysMatrix33 GetMatrix33(const ysMatrix &m);
+    inline ysMatrix44 GetMatrix44(const ysMatrix &m);
+    inline ysMatrix33 GetMatrix33(const ysMatrix &m);
 
-    ysVector ExtendVector(const ysVector &v);
-    ysVector MatMult(const ysMatrix &m, const ysVector &v);
-    ysMatrix MatMult(const ysMatrix &m1, const ysMatrix &m2);
+    inline ysVector ExtendVector(const ysVector &v);
+    inline ysVector MatMult(const ysMatrix &m, const ysVector &v);
+    inline ysMatrix MatMult(const ysMatrix &m1, const ysMatrix &m2);
 
     // Common Matrix Calculations
-    ysMatrix FrustrumPerspective(float fovy, float aspect, float near, float far);
-    ysMatrix OrthographicProjection(float width, float height, float near, float far);
-    ysMatrix CameraTarget(const ysVector &eye, const ysVector &target, const ysVector &up);
+    inline ysMatrix FrustrumPerspective(float fovy, float aspect, float near, float far);
+    inline ysMatrix OrthographicProjection(float width, float height, float near, float far);
+    inline ysMatrix CameraTarget(const ysVector &eye, const ysVector &target, const ysVector &up);
+
+    inline ysMatrix TranslationTransform(const ysVector &translation);
+    inline ysMatrix ScaleTransform(const ysVector &scale);
+    inline ysMatrix RotationTransform(const ysVector &axis, float angle);
+
+    inline ysVector GetTranslationPart(const ysMatrix &mat);
+
+    // Affine Matrices
+    inline ysAffineMatrix LoadAffine(const ysMatrix &m);
+    inline ysAffineMatrix LoadAffine(const ysQuaternion &quat, const ysVector &origin);
+    inline ysMatrix LoadMatrix(const ysAffineMatrix &m);
+
+    inline ysAffineMatrix MatMult(const ysAffineMatrix &m1, const ysAffineMatrix &m2);
+    inline ysAffineMatrix AffineInverse(const ysAffineMatrix &m);
+    inline ysAffineMatrix OrthogonalInverse(const ysAffineMatrix &m);
+
+    // Points are transformed with w = 1 and directions with w = 0
+    inline ysVector TransformPoint(const ysAffineMatrix &m, const ysVector &p);
+    inline ysVector TransformDirection(const ysAffineMatrix &m, const ysVector &v);
+
+    // ----------------------------------------------------
+    // Batch Functions
+    //
+    // Operate on arrays of n elements. These are routed through
+    // a kernel table that is selected at startup based on the
+    // instruction sets supported by the CPU (see yds_math_kernels.h).
+    // Input and output arrays may alias.
+    // ----------------------------------------------------
+
+    enum class InstructionSet {
+        SSE2,
+        SSE4_1,
+        AVX2_FMA,
+        AVX512,
+
+        Count
+    };
+
+    // Highest instruction set supported by both the CPU and the OS
+    InstructionSet GetSupportedInstructionSet();
+
+    // Instruction set of the kernels currently in use
+    InstructionSet GetInstructionSet();
 
-    ysMatrix TranslationTransform(const ysVector &translation);
-    ysMatrix ScaleTransform(const ysVector &scale);
-    ysMatrix RotationTransform(const ysVector &axis, float angle);
+    // Force a specific kernel variant (returns false if unsupported)
+    bool SetInstructionSet(InstructionSet set);
 
-    ysVector GetTranslationPart(const ysMatrix &mat);
+    void DotBatch(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+    void CrossBatch(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+    void NormalizeBatch(const ysVector *v, ysVector *result, int n);
+    void MatMultBatch(const ysMatrix &m, const ysVector *v, ysVector *result, int n);
+    void MatMultBatch(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n);
+    void QuatMultiplyBatch(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n);
+    void LoadMatrixBatch(const ysQuaternion *quats, ysMatrix *result, int n);
+    void QuatNlerpBatch(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n);
+
+    // Scalar arrays, 4 or 8 lanes per iteration depending on the kernels in use
+    void SinCosBatch(const float *v, float *s, float *c, int n);
+    void ExpBatch(const float *v, float *result, int n);
+    void PowBatch(const float *base, const float *exponent, float *result, int n);
 
 };
 
+// ----------------------------------------------------
+// Implementation
+// ----------------------------------------------------
+
+inline ysGeneric ysMath::LoadScalar(float s) {
+    return _mm_set1_ps(s);
+}
+
+inline ysGeneric ysMath::LoadVector(float x, float y, float z, float w) {
+    return _mm_set_ps(w, z, y, x);
+}
+
+inline ysGeneric ysMath::LoadVector(const ysVector4 &v) {
+    return _mm_set_ps(v.w, v.z, v.y, v.x);
+}
+
+inline ysGeneric ysMath::LoadVector(const ysVector3 &v, float w) {
+    return _mm_set_ps(w, v.z, v.y, v.x);
+}
+
+inline ysGeneric ysMath::LoadVector(const ysVector2 &v1) {
+    return _mm_set_ps(0.0f, 0.0f, v1.y, v1.x);
+}
+
+inline ysGeneric ysMath::LoadVector(const ysVector2 &v1, const ysVector2 &v2) {
+    return _mm_set_ps(v2.y, v2.x, v1.y, v1.x);
+}
+
+inline ysQuaternion ysMath::LoadQuaternion(float angle, const ysVector &axis) {
+    float sinAngle = (float)sin(angle / 2.0f);
+    float cosAngle = (float)cos(angle / 2.0f);
+
+    ysVector newAxis = _mm_shuffle_ps(axis, axis, _MM_SHUFFLE(2, 1, 0, 3));
+    newAxis = _mm_and_ps(newAxis, ysMath::Constants::MaskOffX);
+    newAxis = _mm_mul_ps(newAxis, ysMath::LoadScalar(sinAngle));
+    newAxis = _mm_or_ps(newAxis, ysMath::LoadVector(cosAngle));
+
+    newAxis = ysMath::Normalize(newAxis);
+
+    return newAxis;
+}
+
+inline ysVector4 ysMath::GetVector4(const ysVector &v) {
+    ysVector4 r;
+    _mm_storeu_ps(r.vec, v);
+
+    return r;
+}
+
+inline ysVector3 ysMath::GetVector3(const ysVector &v) {
+    float r[4];
+    _mm_storeu_ps(r, v);
+
+    return ysVector3(r[0], r[1], r[2]);
+}
+
+inline ysVector2 ysMath::GetVector2(const ysVector &v) {
+    float r[4];
+    _mm_storeu_ps(r, v);
+
+    return ysVector2(r[0], r[1]);
+}
+
+// Component access uses shuffles rather than the MSVC-only m128_f32
+// field so that it compiles on every compiler
+
+inline float ysMath::GetScalar(const ysVector &v) {
+    return _mm_cvtss_f32(v);
+}
+
+inline float ysMath::GetX(const ysVector &v) {
+    return _mm_cvtss_f32(v);
+}
+
+inline float ysMath::GetY(const ysVector &v) {
+    return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+}
+
+inline float ysMath::GetZ(const ysVector &v) {
+    return _mm_cvtss_f32(_mm_movehl_ps(v, v));
+}
+
+inline float ysMath::GetW(const ysVector &v) {
+    return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+inline float ysMath::GetQuatX(const ysQuaternion &v) {
+    return ysMath::GetY(v);
+}
+
+inline float ysMath::GetQuatY(const ysQuaternion &v) {
+    return ysMath::GetZ(v);
+}
+
+inline float ysMath::GetQuatZ(const ysQuaternion &v) {
+    return ysMath::GetW(v);
+}
+
+inline float ysMath::GetQuatW(const ysQuaternion &v) {
+    return ysMath::GetX(v);
+}
+
+inline ysGeneric ysMath::Add(const ysGeneric &v1, const ysGeneric &v2) {
+    return _mm_add_ps(v1, v2);
+}
+
+inline ysGeneric ysMath::Sub(const ysGeneric &v1, const ysGeneric &v2) {
+    return _mm_sub_ps(v1, v2);
+}
+
+inline ysGeneric ysMath::Mul(const ysGeneric &v1, const ysGeneric &v2) {
+    return _mm_mul_ps(v1, v2);
+}
+
+inline ysGeneric ysMath::Div(const ysGeneric &v1, const ysGeneric &v2) {
+    return _mm_div_ps(v1, v2);
+}
+
+inline ysVector ysMath::Dot(const ysVector &v1, const ysVector &v2) {
+    ysVector t0 = _mm_mul_ps(v1, v2);
+    ysVector t1 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1, 0, 3, 2));
+    ysVector t2 = _mm_add_ps(t0, t1);
+    ysVector t3 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_add_ps(t3, t2);
+}
+
+inline ysVector ysMath::Dot3(const ysVector &v1, const ysVector &v2) {
+    ysVector t0 = _mm_mul_ps(v1, v2);
+    t0 = _mm_and_ps(t0, ysMath::Constants::MaskOffW);
+
+    ysVector t1 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1, 0, 3, 2));
+    ysVector t2 = _mm_add_ps(t0, t1);
+    ysVector t3 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_add_ps(t3, t2);
+}
+
+inline ysVector ysMath::Cross(const ysVector &v1, const ysVector &v2) {
+    // STOLEN FROM XNA MATH
+
+    // y1, z1, x1, w1
+    ysVector t1 = _mm_shuffle_ps(v1, v1, _MM_SHUFFLE(3, 0, 2, 1));
+
+    // z2, x2, y2, w2
+    ysVector t2 = _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 1, 0, 2));
+
+    ysVector vResult = _mm_mul_ps(t1, t2);
+
+    // z1, x1, y1, w1
+    t1 = _mm_shuffle_ps(t1, t1, _MM_SHUFFLE(3, 0, 2, 1));
+
+    // y2, z2, x2, w2
+    t2 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(3, 1, 0, 2));
+
+    // Perform the right operation
+    t1 = _mm_mul_ps(t1, t2);
+
+    // Subract the right from left, and return answer
+    vResult = _mm_sub_ps(vResult, t1);
+
+    // Set w to zero
+    return _mm_and_ps(vResult, ysMath::Constants::MaskOffW);
+}
+
+inline ysVector ysMath::MagnitudeSquared3(const ysVector &v) {
+    return ysMath::Dot3(v, v);
+}
+
+inline ysVector ysMath::Magnitude(const ysVector &v) {
+    return _mm_sqrt_ps(ysMath::Dot(v, v));
+}
+
+inline ysVector ysMath::Normalize(const ysVector &v) {
+    return _mm_div_ps(v, ysMath::Magnitude(v));
+}
+
+inline ysVector ysMath::Negate(const ysVector &v) {
+    return _mm_mul_ps(v, ysMath::Constants::Negate);
+}
+
+inline ysVector ysMath::Negate3(const ysVector &v) {
+    return _mm_mul_ps(v, ysMath::Constants::Negate3);
+}
+
+inline ysVector ysMath::Mask(const ysVector &v, const ysVectorMask &mask) {
+    return _mm_and_ps(v, mask.vector);
+}
+
+inline ysVector ysMath::Or(const ysVector &v1, const ysVector &v2) {
+    return _mm_or_ps(v1, v2);
+}
+
+inline ysGeneric ysMath::Select(const ysGeneric &mask, const ysGeneric &v1, const ysGeneric &v2) {
+    return _mm_or_ps(_mm_and_ps(mask, v1), _mm_andnot_ps(mask, v2));
+}
+
+// Reciprocals
+
+inline ysGeneric ysMath::Reciprocal(const ysGeneric &v) {
+    return _mm_div_ps(ysMath::Constants::One, v);
+}
+
+inline ysGeneric ysMath::ReciprocalFast(const ysGeneric &v) {
+    // r' = r * (2 - v * r)
+    const ysGeneric r = _mm_rcp_ps(v);
+    return _mm_mul_ps(r, _mm_sub_ps(ysMath::Constants::Double, _mm_mul_ps(v, r)));
+}
+
+inline ysGeneric ysMath::ReciprocalSqrt(const ysGeneric &v) {
+    return _mm_div_ps(ysMath::Constants::One, _mm_sqrt_ps(v));
+}
+
+inline ysGeneric ysMath::ReciprocalSqrtFast(const ysGeneric &v) {
+    // r' = 0.5 * r * (3 - v * r^2)
+    const ysGeneric r = _mm_rsqrt_ps(v);
+    const ysGeneric vr2 = _mm_mul_ps(_mm_mul_ps(v, r), r);
+    return _mm_mul_ps(_mm_mul_ps(ysMath::Constants::Half, r), _mm_sub_ps(_mm_set1_ps(3.0f), vr2));
+}
+
+inline ysVector ysMath::NormalizeFast(const ysVector &v) {
+    return _mm_mul_ps(v, ysMath::ReciprocalSqrtFast(ysMath::Dot(v, v)));
+}
+
+// Transcendentals
+
+inline void ysMath::SinCos(const ysGeneric &v, ysGeneric *s, ysGeneric *c) {
+    namespace P = ysMath::Constants::Polynomial;
+
+    // v = q * pi/2 + r with r in [-pi/4, pi/4]. pi/2 is split into three
+    // parts so that q * PiOver2Hi is exact.
+    const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(P::TwoOverPi)));
+    const ysGeneric qf = _mm_cvtepi32_ps(q);
+
+    ysGeneric r = _mm_sub_ps(v, _mm_mul_ps(qf, _mm_set1_ps(P::PiOver2Hi)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(P::PiOver2Mid)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(P::PiOver2Lo)));
+    const ysGeneric r2 = _mm_mul_ps(r, r);
+
+    // sin(r) = r + r^3 * (Sin2 + r^2 * (Sin1 + r^2 * Sin0))
+    ysGeneric ps = _mm_madd_ps(_mm_set1_ps(P::Sin0), r2, _mm_set1_ps(P::Sin1));
+    ps = _mm_madd_ps(ps, r2, _mm_set1_ps(P::Sin2));
+    ps = _mm_madd_ps(_mm_mul_ps(ps, r2), r, r);
+
+    // cos(r) = 1 - r^2 / 2 + r^4 * (Cos2 + r^2 * (Cos1 + r^2 * Cos0))
+    ysGeneric pc = _mm_madd_ps(_mm_set1_ps(P::Cos0), r2, _mm_set1_ps(P::Cos1));
+    pc = _mm_madd_ps(pc, r2, _mm_set1_ps(P::Cos2));
+    pc = _mm_mul_ps(_mm_mul_ps(pc, r2), r2);
+    pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(r2, ysMath::Constants::Half)), ysMath::Constants::One);
+
+    // Odd quadrants swap sin and cos, sin is negated in quadrants 2 and 3
+    // and cos is negated in quadrants 1 and 2
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    const ysGeneric swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    const ysGeneric sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    const ysGeneric cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+
+    *s = _mm_xor_ps(ysMath::Select(swap, pc, ps), sinSign);
+    *c = _mm_xor_ps(ysMath::Select(swap, ps, pc), cosSign);
+}
+
+inline ysGeneric ysMath::Exp(const ysGeneric &v) {
+    namespace P = ysMath::Constants::Polynomial;
+
+    const ysGeneric expMin = _mm_set1_ps(P::ExpMin);
+    const ysGeneric expMax = _mm_set1_ps(P::ExpMax);
+
+    // Operand order keeps NaN inputs as NaN
+    const ysGeneric x = _mm_min_ps(expMax, _mm_max_ps(expMin, v));
+
+    // exp(x) = 2^n * exp(r) with r in [-ln(2)/2, ln(2)/2]
+    const __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(P::Log2E)));
+    const ysGeneric nf = _mm_cvtepi32_ps(n);
+
+    ysGeneric r = _mm_sub_ps(x, _mm_mul_ps(nf, _mm_set1_ps(P::Ln2Hi)));
+    r = _mm_sub_ps(r, _mm_mul_ps(nf, _mm_set1_ps(P::Ln2Lo)));
+    const ysGeneric r2 = _mm_mul_ps(r, r);
+
+    ysGeneric p = _mm_madd_ps(_mm_set1_ps(P::Exp0), r, _mm_set1_ps(P::Exp1));
+    p = _mm_madd_ps(p, r, _mm_set1_ps(P::Exp2));
+    p = _mm_madd_ps(p, r, _mm_set1_ps(P::Exp3));
+    p = _mm_madd_ps(p, r, _mm_set1_ps(P::Exp4));
+    p = _mm_madd_ps(p, r, _mm_set1_ps(P::Exp5));
+    p = _mm_add_ps(_mm_madd_ps(p, r2, r), ysMath::Constants::One);
+
+    // Build 2^n directly in the exponent field
+    const ysGeneric pow2n = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    ysGeneric result = _mm_mul_ps(p, pow2n);
+
+    result = _mm_andnot_ps(_mm_cmplt_ps(v, expMin), result);
+    result = ysMath::Select(_mm_cmpgt_ps(v, expMax), _mm_set1_ps(INFINITY), result);
+
+    return result;
+}
+
+inline ysGeneric ysMath::Log(const ysGeneric &v) {
+    namespace P = ysMath::Constants::Polynomial;
+
+    // Split v into 2^e * m with m in [0.5, 1). Denormals are treated as the
+    // smallest normal number.
+    const __m128i bits = _mm_castps_si128(_mm_max_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x00800000))));
+    const __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126));
+    const ysGeneric m = _mm_castsi128_ps(
+        _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x807FFFFF)), _mm_set1_epi32(0x3F000000)));
+
+    // Move m into [sqrt(1/2), sqrt(2)) and let x = m - 1
+    const ysGeneric small = _mm_cmplt_ps(m, _mm_set1_ps(P::SqrtHalf));
+    const ysGeneric ef = _mm_sub_ps(_mm_cvtepi32_ps(e), _mm_and_ps(small, ysMath::Constants::One));
+    ysGeneric x = _mm_add_ps(_mm_sub_ps(m, ysMath::Constants::One), _mm_and_ps(small, m));
+    const ysGeneric x2 = _mm_mul_ps(x, x);
+
+    ysGeneric p = _mm_madd_ps(_mm_set1_ps(P::Log0), x, _mm_set1_ps(P::Log1));
+    p = _mm_madd_ps(p, x, _mm_set1_ps(P::Log2));
+    p = _mm_madd_ps(p, x, _mm_set1_ps(P::Log3));
+    p = _mm_madd_ps(p, x, _mm_set1_ps(P::Log4));
+    p = _mm_madd_ps(p, x, _mm_set1_ps(P::Log5));
+    p = _mm_madd_ps(p, x, _mm_set1_ps(P::Log6));
+    p = _mm_madd_ps(p, x, _mm_set1_ps(P::Log7));
+    p = _mm_madd_ps(p, x, _mm_set1_ps(P::Log8));
+    p = _mm_mul_ps(_mm_mul_ps(p, x), x2);
+
+    p = _mm_madd_ps(ef, _mm_set1_ps(P::Ln2Lo), p);
+    p = _mm_sub_ps(p, _mm_mul_ps(x2, ysMath::Constants::Half));
+    x = _mm_add_ps(x, p);
+    x = _mm_madd_ps(ef, _mm_set1_ps(P::Ln2Hi), x);
+
+    // log(0) = -inf, log(inf) = inf, log(v < 0) = log(NaN) = NaN
+    x = ysMath::Select(_mm_cmpeq_ps(v, _mm_setzero_ps()), _mm_set1_ps(-INFINITY), x);
+    x = ysMath::Select(_mm_cmpeq_ps(v, _mm_set1_ps(INFINITY)), v, x);
+    x = _mm_or_ps(x, _mm_cmpnge_ps(v, _mm_setzero_ps()));
+
+    return x;
+}
+
+inline ysGeneric ysMath::Pow(const ysGeneric &base, const ysGeneric &exponent) {
+    const ysGeneric zero = _mm_setzero_ps();
+    ysGeneric r = ysMath::Exp(_mm_mul_ps(exponent, ysMath::Log(base)));
+
+    // pow(x, 0) = 1 and pow(0, y > 0) = 0, 0 * log(0) would give NaN
+    r = ysMath::Select(_mm_and_ps(_mm_cmpeq_ps(base, zero), _mm_cmpgt_ps(exponent, zero)), zero, r);
+    r = ysMath::Select(_mm_cmpeq_ps(exponent, zero), ysMath::Constants::One, r);
+
+    return r;
+}
+
+// Quaternion
+
+inline ysQuaternion ysMath::QuatInvert(const ysQuaternion &q) {
+    return _mm_mul_ps(q, _mm_set_ps(-1.0f, -1.0f, -1.0f, 1.0f));
+}
+
+inline ysQuaternion ysMath::QuatMultiply(const ysQuaternion &q1, const ysQuaternion &q2) {
+    ysGeneric w1 = _mm_replicate_x_ps(q1);
+    ysGeneric x1 = _mm_replicate_y_ps(q1);
+    ysGeneric y1 = _mm_replicate_z_ps(q1);
+    ysGeneric z1 = _mm_replicate_w_ps(q1);
+
+    ysGeneric m1 = q2;
+    ysGeneric m2 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(2, 3, 0, 1)); // xwzy
+    ysGeneric m3 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(1, 0, 3, 2)); // yzwx
+    ysGeneric m4 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 1, 2, 3)); // zyxw
+
+    ysGeneric sgn2 = _mm_set_ps(1, -1, 1, -1);
+    ysGeneric sgn3 = _mm_set_ps(-1, 1, 1, -1);
+    ysGeneric sgn4 = _mm_set_ps(1, 1, -1, -1);
+
+    ysGeneric prod1 = _mm_mul_ps(w1, m1);
+    ysGeneric prod2 = _mm_mul_ps(_mm_mul_ps(x1, sgn2), m2);
+    ysGeneric prod3 = _mm_mul_ps(_mm_mul_ps(y1, sgn3), m3);
+    ysGeneric prod4 = _mm_mul_ps(_mm_mul_ps(z1, sgn4), m4);
+
+    ysGeneric result = _mm_add_ps(_mm_add_ps(prod1, prod2), _mm_add_ps(prod3, prod4));
+
+    return (ysQuaternion)result;
+}
+
+inline ysQuaternion ysMath::QuatAddScaled(const ysQuaternion &q, const ysVector &vec, float scale) {
+    ysGeneric n = _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 1, 0, 3));
+    n = _mm_and_ps(n, ysMath::Constants::MaskOffX);
+
+    n = _mm_mul_ps(n, ysMath::LoadScalar(scale));
+
+    ysQuaternion q2 = n;
+    ysQuaternion m1 = ysMath::QuatMultiply(q2, q);
+
+    ysQuaternion ret = _mm_add_ps(q, _mm_mul_ps(m1, ysMath::Constants::Half));
+
+    return ysMath::Normalize(ret);
+}
+
+inline ysQuaternion ysMath::QuatAddScaledFast(const ysQuaternion &q, const ysVector &vec, float scale) {
+    ysGeneric n = _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 1, 0, 3));
+    n = _mm_and_ps(n, ysMath::Constants::MaskOffX);
+    n = _mm_mul_ps(n, ysMath::LoadScalar(scale));
+
+    ysQuaternion m1 = ysMath::QuatMultiply(n, q);
+    ysQuaternion ret = _mm_madd_ps(m1, ysMath::Constants::Half, q);
+
+    return ysMath::NormalizeFast(ret);
+}
+
+inline ysQuaternion ysMath::QuatNlerp(const ysQuaternion &q1, const ysQuaternion &q2, float t) {
+    // Flip q2 into the same hemisphere as q1 by copying the sign of the dot product
+    const ysGeneric sign = _mm_and_ps(ysMath::Dot(q1, q2), _mm_set1_ps(-0.0f));
+    const ysQuaternion target = _mm_xor_ps(q2, sign);
+
+    return ysMath::Normalize(_mm_madd_ps(_mm_sub_ps(target, q1), ysMath::LoadScalar(t), q1));
+}
+
+inline ysQuaternion ysMath::QuatSlerp(const ysQuaternion &q1, const ysQuaternion &q2, float t) {
+    const ysGeneric dot = ysMath::Dot(q1, q2);
+    const ysGeneric sign = _mm_and_ps(dot, _mm_set1_ps(-0.0f));
+    const ysQuaternion target = _mm_xor_ps(q2, sign);
+    const float cosTheta = fabsf(ysMath::GetX(dot));
+
+    // sin(theta) is too small to divide by, the two are close enough to lerp
+    if (cosTheta > 0.9995f) {
+        return ysMath::Normalize(_mm_madd_ps(_mm_sub_ps(target, q1), ysMath::LoadScalar(t), q1));
+    }
+
+    // sin(theta), sin((1 - t) * theta) and sin(t * theta) with a single call
+    const float theta = acosf(cosTheta);
+    ysGeneric s, c;
+    ysMath::SinCos(ysMath::LoadVector(theta, (1.0f - t) * theta, t * theta, 0.0f), &s, &c);
+
+    const ysGeneric w = _mm_mul_ps(s, ysMath::Reciprocal(_mm_replicate_x_ps(s)));
+    const ysQuaternion r = _mm_madd_ps(_mm_replicate_y_ps(w), q1, _mm_mul_ps(_mm_replicate_z_ps(w), target));
+
+    return ysMath::Normalize(r);
+}
+
+inline ysQuaternion ysMath::QuatSquad(
+    const ysQuaternion &q1, const ysQuaternion &q2, const ysQuaternion &s1, const ysQuaternion &s2, float t)
+{
+    return ysMath::QuatSlerp(
+        ysMath::QuatSlerp(q1, q2, t),
+        ysMath::QuatSlerp(s1, s2, t),
+        2.0f * t * (1.0f - t));
+}
+
+inline ysQuaternion ysMath::QuatSquadControlPoint(const ysQuaternion &prev, const ysQuaternion &q, const ysQuaternion &next) {
+    // s = q * exp(-(log(q^-1 * next) + log(q^-1 * prev)) / 4)
+    const ysQuaternion inv = ysMath::QuatInvert(q);
+    const ysGeneric prevSign = _mm_and_ps(ysMath::Dot(q, prev), _mm_set1_ps(-0.0f));
+    const ysGeneric nextSign = _mm_and_ps(ysMath::Dot(q, next), _mm_set1_ps(-0.0f));
+
+    const ysQuaternion l0 = ysMath::QuatLog(ysMath::QuatMultiply(inv, _mm_xor_ps(next, nextSign)));
+    const ysQuaternion l1 = ysMath::QuatLog(ysMath::QuatMultiply(inv, _mm_xor_ps(prev, prevSign)));
+
+    const ysQuaternion e = ysMath::QuatExp(_mm_mul_ps(_mm_add_ps(l0, l1), _mm_set1_ps(-0.25f)));
+    return ysMath::Normalize(ysMath::QuatMultiply(q, e));
+}
+
+inline ysQuaternion ysMath::QuatLog(const ysQuaternion &q) {
+    // log(q) = (0, v * theta / sin(theta)) for q = (cos(theta), v)
+    const float w = fminf(fmaxf(ysMath::GetQuatW(q), -1.0f), 1.0f);
+    const float theta = acosf(w);
+    const float sinTheta = sinf(theta);
+
+    const float scale = (sinTheta > 1E-6f) ? theta / sinTheta : 1.0f;
+    return _mm_and_ps(_mm_mul_ps(q, ysMath::LoadScalar(scale)), ysMath::Constants::MaskOffX);
+}
+
+inline ysQuaternion ysMath::QuatExp(const ysQuaternion &q) {
+    // exp((0, v)) = (cos(|v|), v * sin(|v|) / |v|)
+    const ysGeneric v = _mm_and_ps(q, ysMath::Constants::MaskOffX);
+    const float theta = ysMath::GetX(_mm_sqrt_ps(ysMath::Dot(v, v)));
+
+    ysGeneric s, c;
+    ysMath::SinCos(ysMath::LoadScalar(theta), &s, &c);
+
+    const float scale = (theta > 1E-6f) ? ysMath::GetX(s) / theta : 1.0f;
+    return _mm_or_ps(_mm_mul_ps(v, ysMath::LoadScalar(scale)), _mm_and_ps(c, ysMath::Constants::MaskKeepX));
+}
+
+// Matrices
+
+inline ysMatrix ysMath::LoadIdentity() {
+    return ysMath::LoadMatrix(
+        ysMath::Constants::IdentityRow1,
+        ysMath::Constants::IdentityRow2,
+        ysMath::Constants::IdentityRow3,
+        ysMath::Constants::IdentityRow4);
+}
+
+inline ysMatrix ysMath::LoadMatrix(const ysVector &r1, const ysVector &r2, const ysVector &r3, const ysVector &r4) {
+    ysMatrix r;
+    r.rows[0] = r1;
+    r.rows[1] = r2;
+    r.rows[2] = r3;
+    r.rows[3] = r4;
+
+    return r;
+}
+
+inline ysMatrix ysMath::LoadMatrix(const ysQuaternion &quat) {
+    // 21 instruction implementation
+
+    ysGeneric q = quat;
+    ysGeneric nq = _mm_sub_ps(ysMath::Constants::Zero, q);
+    ysGeneric qq = _mm_add_ps(q, q);
+    ysGeneric q2 = _mm_mul_ps(qq, q);
+
+    ysGeneric xyxx = _mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 1, 2, 1));
+    ysGeneric yzzy = _mm_shuffle_ps(qq, qq, _MM_SHUFFLE(2, 3, 3, 2));
+    ysGeneric zxyz = _mm_shuffle_ps(qq, qq, _MM_SHUFFLE(3, 2, 1, 3));
+    ysGeneric wwww = _mm_shuffle_ps(q, nq, _MM_SHUFFLE(0, 0, 0, 0));
+
+    ysGeneric i1 = _mm_mul_ps(xyxx, yzzy); // [2xy, 2yz, 2xz, 2xy]
+    ysGeneric i2 = _mm_mul_ps(zxyz, wwww); // [2zw, 2xw, -2yw, -2zw ]
+    ysGeneric calc1 = _mm_add_ps(i1, i2);
+
+    // Stage 2
+
+    ysGeneric y2_x2_x2_w2 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 1, 1, 2));
+    ysGeneric z2_z2_y2_w2 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 2, 3, 3));
+
+    ysGeneric calc2 = _mm_sub_ps(ysMath::Constants::One, _mm_add_ps(y2_x2_x2_w2, z2_z2_y2_w2));
+    calc2 = _mm_and_ps(calc2, ysMath::Constants::MaskOffW.vector);
+
+    // Stage 3
+
+    ysGeneric calc3 = _mm_sub_ps(i1, i2);
+
+    // Assembly
+
+    // 2xy - 2zw -> 3
+    // 2xz - 2yw -> 2
+    // 2xy + 2zw -> 0
+    // 2yz + 2xw -> 1
+
+    ysGeneric asm1 = _mm_shuffle_ps(calc2, calc1, _MM_SHUFFLE(2, 0, 3, 0));
+    asm1 = _mm_shuffle_ps(asm1, asm1, _MM_SHUFFLE(1, 3, 2, 0));
+
+    ysGeneric asm2 = _mm_shuffle_ps(calc2, calc1, _MM_SHUFFLE(1, 3, 3, 1));
+    asm2 = _mm_shuffle_ps(asm2, asm2, _MM_SHUFFLE(1, 3, 0, 2));
+
+    ysGeneric asm3 = _mm_shuffle_ps(calc3, calc2, _MM_SHUFFLE(3, 2, 1, 2));
+    // No need to shuffle this one
+
+    ysMatrix ret = ysMath::LoadMatrix(asm1, asm2, asm3, ysMath::Constants::IdentityRow4);
+
+    return ret;
+}
+
+inline ysMatrix ysMath::LoadMatrix(const ysQuaternion &quat, const ysVector &origin) {
+    ysGeneric q = quat;
+    ysGeneric nq = _mm_sub_ps(ysMath::Constants::Zero, q);
+    ysGeneric qq = _mm_add_ps(q, q);
+    ysGeneric q2 = _mm_mul_ps(qq, q);
+
+    ysGeneric xxxy = _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 1, 1));
+    ysGeneric zyyz = _mm_shuffle_ps(qq, qq, _MM_SHUFFLE(3, 2, 2, 3));
+    ysGeneric yzzx = _mm_shuffle_ps(qq, qq, _MM_SHUFFLE(1, 3, 3, 2));
+    ysGeneric wwww = _mm_shuffle_ps(q, nq, _MM_SHUFFLE(0, 0, 0, 0));
+
+    ysGeneric i1 = _mm_mul_ps(xxxy, zyyz);	// [2xz, 2xy, 2xy, 2yz]
+    ysGeneric i2 = _mm_mul_ps(yzzx, wwww); // [2yw, 2zw, -2zw, -2xw]
+    ysGeneric calc1 = _mm_add_ps(i1, i2);	// [2xz - 2yw, 2xy + 2zy, 2xy - 2zy, 2yz - 2xw]
+
+    // Stage 2
+
+    ysGeneric y2_x2_x2_w2 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 1, 1, 2));
+    ysGeneric z2_z2_y2_w2 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 2, 3, 3));
+
+    ysGeneric calc2 = _mm_sub_ps(ysMath::Constants::One, _mm_add_ps(y2_x2_x2_w2, z2_z2_y2_w2));
+    calc2 = _mm_and_ps(calc2, ysMath::Constants::MaskOffW.vector);
+
+    // Stage 3
+
+    ysGeneric calc3 = _mm_sub_ps(i1, i2);	// [2xz + 2yw, 2xy - 2zy, 2xy + 2zy, 2yz + 2xw]
+
+    // Assembly
+
+    // 2xz + 2yw -> 0
+    // 2xy + 2zw -> 1
+    // 2xy - 2zw -> 2
+    // 2yz - 2xw -> 3
+
+    ysGeneric asm1 = _mm_shuffle_ps(calc2, calc1, _MM_SHUFFLE(0, 2, 3, 0));
+    asm1 = _mm_shuffle_ps(asm1, asm1, _MM_SHUFFLE(1, 3, 2, 0));
+
+    ysGeneric asm2 = _mm_shuffle_ps(calc2, calc1, _MM_SHUFFLE(3, 1, 3, 1));
+    asm2 = _mm_shuffle_ps(asm2, asm2, _MM_SHUFFLE(1, 3, 0, 2));
+
+    ysGeneric asm3 = _mm_shuffle_ps(calc3, calc2, _MM_SHUFFLE(3, 2, 3, 0));
+    // No need to shuffle this one
+
+    ysGeneric asm4 = _mm_and_ps(origin, ysMath::Constants::MaskOffW.vector);
+    asm4 = _mm_add_ps(asm4, ysMath::Constants::IdentityRow4);
+
+    ysMatrix ret = ysMath::Transpose(ysMath::LoadMatrix(asm1, asm2, asm3, asm4));
+
+    return ret;
+}
+
+inline void ysMath::LoadMatrix(const ysQuaternion &quat, const ysVector &origin, ysMatrix *full, ysMatrix *orientation) {
+    ysGeneric q = quat;
+    ysGeneric nq = _mm_sub_ps(ysMath::Constants::Zero, q);
+    ysGeneric qq = _mm_add_ps(q, q);
+    ysGeneric q2 = _mm_mul_ps(qq, q);
+
+    ysGeneric xxxy = _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 1, 1));
+    ysGeneric zyyz = _mm_shuffle_ps(qq, qq, _MM_SHUFFLE(3, 2, 2, 3));
+    ysGeneric yzzx = _mm_shuffle_ps(qq, qq, _MM_SHUFFLE(1, 3, 3, 2));
+    ysGeneric wwww = _mm_shuffle_ps(q, nq, _MM_SHUFFLE(0, 0, 0, 0));
+
+    ysGeneric i1 = _mm_mul_ps(xxxy, zyyz); // [2xz, 2xy, 2xy, 2yz]
+    ysGeneric i2 = _mm_mul_ps(yzzx, wwww); // [2yw, 2zw, -2zw, -2xw]
+    ysGeneric calc1 = _mm_add_ps(i1, i2);
+
+    // Stage 2
+
+    ysGeneric y2_x2_x2_w2 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 1, 1, 2));
+    ysGeneric z2_z2_y2_w2 = _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 2, 3, 3));
+
+    ysGeneric calc2 = _mm_sub_ps(ysMath::Constants::One, _mm_add_ps(y2_x2_x2_w2, z2_z2_y2_w2));
+    calc2 = _mm_and_ps(calc2, ysMath::Constants::MaskOffW.vector);
+
+    // Stage 3
+
+    ysGeneric calc3 = _mm_sub_ps(i1, i2);
+
+    // Assembly
+
+    // 2xz + 2yw -> 0
+    // 2xy + 2zw -> 1
+    // 2xy - 2zw -> 2
+    // 2yz - 2xw -> 3
+
+    ysGeneric asm1 = _mm_shuffle_ps(calc2, calc1, _MM_SHUFFLE(0, 2, 3, 0));
+    asm1 = _mm_shuffle_ps(asm1, asm1, _MM_SHUFFLE(1, 3, 2, 0));
+
+    ysGeneric asm2 = _mm_shuffle_ps(calc2, calc1, _MM_SHUFFLE(3, 1, 3, 1));
+    asm2 = _mm_shuffle_ps(asm2, asm2, _MM_SHUFFLE(1, 3, 0, 2));
+
+    ysGeneric asm3 = _mm_shuffle_ps(calc3, calc2, _MM_SHUFFLE(3, 2, 3, 0));
+    // No need to shuffle this one
+
+    *orientation = ysMath::Transpose(ysMath::LoadMatrix(asm1, asm2, asm3, ysMath::Constants::IdentityRow4));
+
+    ysGeneric asm4 = _mm_and_ps(origin, ysMath::Constants::MaskOffW.vector);
+    asm4 = _mm_add_ps(asm4, ysMath::Constants::IdentityRow4);
+
+    *full = ysMath::Transpose(ysMath::LoadMatrix(asm1, asm2, asm3, asm4));
+}
+
+inline ysMatrix ysMath::Transpose(const ysMatrix &m) {
+    ysMatrix r = m;
+
+    _MM_TRANSPOSE4_PS(r.rows[0], r.rows[1], r.rows[2], r.rows[3]);
+
+    return r;
+}
+
+inline ysMatrix ysMath::OrthogonalInverse(const ysMatrix &m) {
+    // The bottom row of a rigid transform is always (0, 0, 0, 1)
+    return ysMath::LoadMatrix(ysMath::OrthogonalInverse(ysMath::LoadAffine(m)));
+}
+
+inline ysMatrix44 ysMath::GetMatrix44(const ysMatrix &m) {
+    ysMatrix44 r;
+    r.rows[0] = ysMath::GetVector4(m.rows[0]);
+    r.rows[1] = ysMath::GetVector4(m.rows[1]);
+    r.rows[2] = ysMath::GetVector4(m.rows[2]);
+    r.rows[3] = ysMath::GetVector4(m.rows[3]);
+
+    return r;
+}
+
+inline ysMatrix33 ysMath::GetMatrix33(const ysMatrix &m) {
+    ysMatrix33 r;
+    r.rows[0] = ysMath::GetVector3(m.rows[0]);
+    r.rows[1] = ysMath::GetVector3(m.rows[1]);
+    r.rows[2] = ysMath::GetVector3(m.rows[2]);
+
+    return r;
+}
+
+inline ysVector ysMath::ExtendVector(const ysVector &v) {
+    return _mm_or_ps(_mm_and_ps(v, ysMath::Constants::MaskOffW), ysMath::Constants::IdentityRow4);
+}
+
+inline ysVector ysMath::MatMult(const ysMatrix &m, const ysVector &v) {
+    ysMatrix t = m;
+    _MM_TRANSPOSE4_PS(t.rows[0], t.rows[1], t.rows[2], t.rows[3]);
+
+    //ysVector exV = ExtendVector(v);
+
+    ysVector r;
+    r = _mm_mul_ps(_mm_replicate_x_ps(v), t.rows[0]);
+    r = _mm_madd_ps(_mm_replicate_y_ps(v), t.rows[1], r);
+    r = _mm_madd_ps(_mm_replicate_z_ps(v), t.rows[2], r);
+    r = _mm_madd_ps(_mm_replicate_w_ps(v), t.rows[3], r);
+
+    return r;
+}
+
+inline ysMatrix ysMath::MatMult(const ysMatrix &m1, const ysMatrix &m2) {
+    ysMatrix r;
+
+    for (int i = 0; i < 4; i++) {
+        r.rows[i] = _mm_mul_ps(_mm_replicate_x_ps(m1.rows[i]), m2.rows[0]);
+        r.rows[i] = _mm_madd_ps(_mm_replicate_y_ps(m1.rows[i]), m2.rows[1], r.rows[i]);
+        r.rows[i] = _mm_madd_ps(_mm_replicate_z_ps(m1.rows[i]), m2.rows[2], r.rows[i]);
+        r.rows[i] = _mm_madd_ps(_mm_replicate_w_ps(m1.rows[i]), m2.rows[3], r.rows[i]);
+    }
+
+    return r;
+}
+
+inline ysMatrix ysMath::FrustrumPerspective(float fovy, float aspect, float near, float far) {
+    float sinfov = ::sinf(fovy / 2.0f);
+    float cosfov = ::cosf(fovy / 2.0f);
+
+    float height = cosfov / sinfov;
+    float width = height / aspect;
+
+    ysVector row1 = ysMath::LoadVector(width, 0, 0, 0);
+    ysVector row2 = ysMath::LoadVector(0, height, 0, 0);
+    ysVector row3 = ysMath::LoadVector(0, 0, (far) / (far - near), 1.0);
+    ysVector row4 = ysMath::LoadVector(0, 0, -(far * near) / (far - near), 0);
+
+    return LoadMatrix(row1, row2, row3, row4);
+}
+
+inline ysMatrix ysMath::OrthographicProjection(float width, float height, float near, float far) {
+    float fRange = 1.0f / (far - near);
+
+    ysVector row1 = ysMath::LoadVector(2.0f / width, 0.0f, 0.0f, 0.0f);
+    ysVector row2 = ysMath::LoadVector(0.0f, 2.0f / height, 0.0f, 0.0f);
+    ysVector row3 = ysMath::LoadVector(0.0f, 0.0f, 2 * fRange, 0.0f);
+    ysVector row4 = ysMath::LoadVector(0.0f, 0.0f, -fRange * near, 1.0f);
+
+    return LoadMatrix(row1, row2, row3, row4);
+}
+
+inline ysMatrix ysMath::CameraTarget(const ysVector &eye, const ysVector &target, const ysVector &up) {
+    ysVector R2 = ysMath::Sub(target, eye);
+    R2 = ysMath::Normalize(R2);
+
+    ysVector R0 = ysMath::Cross(R2, up);
+    R0 = ysMath::Normalize(R0);
+
+    ysVector R1 = ysMath::Cross(R0, R2);
+
+    ysVector negEyePos = ysMath::Negate(eye);
+
+    ysVector D0 = ysMath::Dot(R0, negEyePos);
+    ysVector D1 = ysMath::Dot(R1, negEyePos);
+    ysVector D2 = ysMath::Dot(R2, negEyePos);
+
+    R0 = ysMath::Mask(R0, ysMath::Constants::MaskOffW);
+    R1 = ysMath::Mask(R1, ysMath::Constants::MaskOffW);
+    R2 = ysMath::Mask(R2, ysMath::Constants::MaskOffW);
+
+    D0 = ysMath::Mask(D0, ysMath::Constants::MaskKeepW);
+    D1 = ysMath::Mask(D1, ysMath::Constants::MaskKeepW);
+    D2 = ysMath::Mask(D2, ysMath::Constants::MaskKeepW);
+
+    D0 = ysMath::Or(R0, D0);
+    D1 = ysMath::Or(R1, D1);
+    D2 = ysMath::Or(R2, D2);
+
+    ysMatrix r;
+    r.rows[0] = D0;
+    r.rows[1] = D1;
+    r.rows[2] = D2;
+    r.rows[3] = ysMath::Constants::IdentityRow4;
+
+    r = ysMath::Transpose(r);
+
+    return r;
+}
+
+inline ysMatrix ysMath::TranslationTransform(const ysVector &translation) {
+    ysMatrix r;
+    r.rows[0] = ysMath::Constants::IdentityRow1;
+    r.rows[1] = ysMath::Constants::IdentityRow2;
+    r.rows[2] = ysMath::Constants::IdentityRow3;
+
+    ysVector trans = ysMath::Mask(translation, ysMath::Constants::MaskOffW);
+    r.rows[3] = ysMath::Or(trans, ysMath::Constants::IdentityRow4);
+
+    r = ysMath::Transpose(r);
+
+    return r;
+}
+
+inline ysMatrix ysMath::ScaleTransform(const ysVector &scale) {
+    ysMatrix r;
+    r.rows[0] = ysMath::Mask(scale, ysMath::Constants::MaskKeepX);
+    r.rows[1] = ysMath::Mask(scale, ysMath::Constants::MaskKeepY);
+    r.rows[2] = ysMath::Mask(scale, ysMath::Constants::MaskKeepZ);
+    r.rows[3] = ysMath::Constants::IdentityRow4;
+
+    return r;
+}
+
+inline ysMatrix ysMath::RotationTransform(const ysVector &axis, float angle) {
+    // TEMP
+    // BAD IMPLEMENTATION
+    ysVector naxis = ysMath::Normalize(axis);
+
+    float ux = ysMath::GetX(naxis);
+    float uy = ysMath::GetY(naxis);
+    float uz = ysMath::GetZ(naxis);
+
+    float cos_a = cosf(angle);
+    float sin_a = sinf(angle);
+
+    ysMatrix r;
+    r.rows[0] = ysMath::LoadVector(cos_a + ux * ux * (1 - cos_a), ux * uy * (1 - cos_a) - uz * sin_a, ux * uz * (1 - cos_a) + uy * sin_a);
+    r.rows[1] = ysMath::LoadVector(uy * ux * (1 - cos_a) + uz * sin_a, cos_a + uy * uy * (1 - cos_a), uy * uz * (1 - cos_a) - ux * sin_a);
+    r.rows[2] = ysMath::LoadVector(uz * ux * (1 - cos_a) - uy * sin_a, uz * uy * (1 - cos_a) + ux * sin_a, cos_a + uz * uz * (1 - cos_a));
+    r.rows[3] = ysMath::Constants::IdentityRow4;
+
+    return r;
+}
+
+inline ysVector ysMath::GetTranslationPart(const ysMatrix &mat) {
+    ysMatrix r = ysMath::Transpose(mat);
+
+    return r.rows[3];
+}
+
+// Affine Matrices
+
+inline ysAffineMatrix ysMath::LoadAffine(const ysMatrix &m) {
+    return { m.rows[0], m.rows[1], m.rows[2] };
+}
+
+inline ysAffineMatrix ysMath::LoadAffine(const ysQuaternion &quat, const ysVector &origin) {
+    return ysMath::LoadAffine(ysMath::LoadMatrix(quat, origin));
+}
+
+inline ysMatrix ysMath::LoadMatrix(const ysAffineMatrix &m) {
+    return { m.rows[0], m.rows[1], m.rows[2], ysMath::Constants::IdentityRow4 };
+}
+
+inline ysAffineMatrix ysMath::MatMult(const ysAffineMatrix &m1, const ysAffineMatrix &m2) {
+    // The implicit row of m2 only contributes the translation of m1
+    ysAffineMatrix r;
+
+    for (int i = 0; i < 3; i++) {
+        r.rows[i] = _mm_and_ps(m1.rows[i], ysMath::Constants::MaskKeepW);
+        r.rows[i] = _mm_madd_ps(_mm_replicate_x_ps(m1.rows[i]), m2.rows[0], r.rows[i]);
+        r.rows[i] = _mm_madd_ps(_mm_replicate_y_ps(m1.rows[i]), m2.rows[1], r.rows[i]);
+        r.rows[i] = _mm_madd_ps(_mm_replicate_z_ps(m1.rows[i]), m2.rows[2], r.rows[i]);
+    }
+
+    return r;
+}
+
+inline ysAffineMatrix ysMath::AffineInverse(const ysAffineMatrix &m) {
+    const ysVector a = _mm_and_ps(m.rows[0], ysMath::Constants::MaskOffW);
+    const ysVector b = _mm_and_ps(m.rows[1], ysMath::Constants::MaskOffW);
+    const ysVector c = _mm_and_ps(m.rows[2], ysMath::Constants::MaskOffW);
+
+    // The columns of the inverse of the linear part are the cross products
+    // of its rows divided by the determinant
+    const ysVector bc = ysMath::Cross(b, c);
+    const ysVector invDet = ysMath::Reciprocal(ysMath::Dot3(a, bc));
+
+    ysVector c0 = _mm_mul_ps(bc, invDet);
+    ysVector c1 = _mm_mul_ps(ysMath::Cross(c, a), invDet);
+    ysVector c2 = _mm_mul_ps(ysMath::Cross(a, b), invDet);
+
+    // t' = -M^-1 * t
+    ysVector c3 = _mm_mul_ps(c0, _mm_replicate_w_ps(m.rows[0]));
+    c3 = _mm_madd_ps(c1, _mm_replicate_w_ps(m.rows[1]), c3);
+    c3 = _mm_madd_ps(c2, _mm_replicate_w_ps(m.rows[2]), c3);
+    c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    return { c0, c1, c2 };
+}
+
+inline ysAffineMatrix ysMath::OrthogonalInverse(const ysAffineMatrix &m) {
+    // The inverse of the rotation is its transpose and t' = -R^T * t. The
+    // columns of the inverse are the rows of R followed by t'.
+    ysVector c0 = _mm_and_ps(m.rows[0], ysMath::Constants::MaskOffW);
+    ysVector c1 = _mm_and_ps(m.rows[1], ysMath::Constants::MaskOffW);
+    ysVector c2 = _mm_and_ps(m.rows[2], ysMath::Constants::MaskOffW);
+
+    ysVector c3 = _mm_mul_ps(c0, _mm_replicate_w_ps(m.rows[0]));
+    c3 = _mm_madd_ps(c1, _mm_replicate_w_ps(m.rows[1]), c3);
+    c3 = _mm_madd_ps(c2, _mm_replicate_w_ps(m.rows[2]), c3);
+    c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    return { c0, c1, c2 };
+}
+
+inline ysVector ysMath::TransformPoint(const ysAffineMatrix &m, const ysVector &p) {
+    ysVector c0 = m.rows[0], c1 = m.rows[1], c2 = m.rows[2], c3 = ysMath::Constants::IdentityRow4;
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    ysVector r = _mm_madd_ps(_mm_replicate_x_ps(p), c0, c3);
+    r = _mm_madd_ps(_mm_replicate_y_ps(p), c1, r);
+    r = _mm_madd_ps(_mm_replicate_z_ps(p), c2, r);
+
+    return r;
+}
+
+inline ysVector ysMath::TransformDirection(const ysAffineMatrix &m, const ysVector &v) {
+    ysVector c0 = m.rows[0], c1 = m.rows[1], c2 = m.rows[2], c3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    ysVector r = _mm_mul_ps(_mm_replicate_x_ps(v), c0);
+    r = _mm_madd_ps(_mm_replicate_y_ps(v), c1, r);
+    r = _mm_madd_ps(_mm_replicate_z_ps(v), c2, r);
+
+    return r;
+}
+
 #endif /* YDS_MATH_H */
@@ -0,0 +1,91 @@
+#ifndef YDS_MATH_KERNELS_H
+#define YDS_MATH_KERNELS_H
+
+#include "yds_math.h"
+
+// Kernels that target a specific instruction set are compiled with
+// per-function target attributes on GCC/Clang so that the rest of the
+// library can still be built for the baseline architecture. MSVC allows
+// any intrinsic to be used without additional flags.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define YDS_MATH_TARGET(isa)
+#else
+#define YDS_MATH_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace ysMath {
+
+    namespace Kernels {
+
+        // --
+        // Table of batch kernels for a single instruction set.
+        // One of these is selected at startup by the dispatcher.
+        // --
+        struct Table {
+            InstructionSet Set;
+            const char *Name;
+
+            void (*Dot)(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+            void (*Cross)(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+            void (*Normalize)(const ysVector *v, ysVector *result, int n);
+            void (*Transform)(const ysMatrix &m, const ysVector *v, ysVector *result, int n);
+            void (*MatMult)(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n);
+            void (*QuatMultiply)(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n);
+            void (*LoadMatrix)(const ysQuaternion *quats, ysMatrix *result, int n);
+            void (*QuatNlerp)(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n);
+
+            void (*SinCos)(const float *v, float *s, float *c, int n);
+            void (*Exp)(const float *v, float *result, int n);
+            void (*Pow)(const float *base, const float *exponent, float *result, int n);
+        };
+
+        // Returns the kernel table for a given instruction set
+        const Table *GetTable(InstructionSet set);
+
+        // SSE2 (baseline)
+        void DotSse2(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+        void CrossSse2(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+        void NormalizeSse2(const ysVector *v, ysVector *result, int n);
+        void TransformSse2(const ysMatrix &m, const ysVector *v, ysVector *result, int n);
+        void MatMultSse2(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n);
+        void QuatMultiplySse2(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n);
+        void LoadMatrixSse2(const ysQuaternion *quats, ysMatrix *result, int n);
+        void QuatNlerpSse2(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n);
+        void SinCosSse2(const float *v, float *s, float *c, int n);
+        void ExpSse2(const float *v, float *result, int n);
+        void PowSse2(const float *base, const float *exponent, float *result, int n);
+
+        // SSE4.1
+        void DotSse41(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+        void NormalizeSse41(const ysVector *v, ysVector *result, int n);
+
+        // AVX2 + FMA (two elements per iteration)
+        void DotAvx2(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+        void CrossAvx2(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+        void NormalizeAvx2(const ysVector *v, ysVector *result, int n);
+        void TransformAvx2(const ysMatrix &m, const ysVector *v, ysVector *result, int n);
+        void MatMultAvx2(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n);
+        void QuatMultiplyAvx2(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n);
+        void LoadMatrixAvx2(const ysQuaternion *quats, ysMatrix *result, int n);
+        void QuatNlerpAvx2(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n);
+        void SinCosAvx2(const float *v, float *s, float *c, int n);
+        void ExpAvx2(const float *v, float *result, int n);
+        void PowAvx2(const float *base, const float *exponent, float *result, int n);
+
+        // AVX-512F (four elements per iteration). The AVX2 transcendental
+        // kernels are used as is since they are bound by the polynomial
+        // latency rather than the register width.
+        void DotAvx512(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+        void CrossAvx512(const ysVector *v1, const ysVector *v2, ysVector *result, int n);
+        void NormalizeAvx512(const ysVector *v, ysVector *result, int n);
+        void TransformAvx512(const ysMatrix &m, const ysVector *v, ysVector *result, int n);
+        void MatMultAvx512(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n);
+        void QuatMultiplyAvx512(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n);
+        void LoadMatrixAvx512(const ysQuaternion *quats, ysMatrix *result, int n);
+        void QuatNlerpAvx512(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n);
+
+    }
+
+}
+
+#endif /* YDS_MATH_KERNELS_H */
@@ -2,11 +2,13 @@
 #define YDS_MEMORY_BASE_H
 
 #include "yds_base.h"
+#include "yds_memory_tracker.h"
 
-#include <malloc.h>
+#include <stdlib.h>
 #include <new>
 #include <stddef.h>
 #include <assert.h>
+#include <type_traits>
 
 static const int KB = 1024;
 static const int MB = KB * KB;
@@ -44,13 +46,33 @@ public:
 		if (!block) return 0;
 
 		// Allocate each of the elements in the array
-		for(unsigned int i=0; i < n; i++) 
-			new((char *)block + i * sizeof(TYPE)) TYPE;
+		if (!std::is_trivially_default_constructible<TYPE>::value)
+		{
+			for(unsigned int i=0; i < n; i++) 
+				new((char *)block + i * sizeof(TYPE)) TYPE;
+		}
 
 		return (TYPE *)block;
 
 	}
 
+	// --
+	// Allocate a block for objects of a specific type without constructing them.
+	//
+	//   n: Number of objects to allocate (ie array length)
+	//
+	// The caller must construct every object (or fill it in with memcpy or
+	// a file read if the type is trivially copyable) before using it or
+	// passing the block to Free().
+	// --
+	template<typename TYPE>
+	TYPE *AllocateUninitialized(unsigned int n=1)
+	{
+
+		return (TYPE *)AllocateBlock(sizeof(TYPE) * n, n);
+
+	}
+
 	// --
 	// Free a block of memory with a specific type.
 	//
@@ -61,8 +83,25 @@ public:
 	void Free(TYPE * &data)
 	{
 
-		int nObjects = FreeBlock((void *)data);
-		for(int i=0; i < nObjects; i++) data[i].~TYPE();
+		if (std::is_trivially_destructible<TYPE>::value)
+		{
+			FreeBlock((void *)data);
+			data = 0;
+			return;
+		}
+
+		int nObjects = GetObjectCount((void *)data);
+		if (nObjects >= 0)
+		{
+			// Destroy the objects while the block is still valid
+			for(int i=0; i < nObjects; i++) data[i].~TYPE();
+			FreeBlock((void *)data);
+		}
+		else
+		{
+			nObjects = FreeBlock((void *)data);
+			for(int i=0; i < nObjects; i++) data[i].~TYPE();
+		}
 
 		data = 0;
 
@@ -89,6 +128,16 @@ public:
 	// --
 	virtual int FreeBlock(void *block) = 0;
 
+	// --
+	// Get the number of objects in a block without freeing it.
+	//
+	//   block: Pointer to target memory address.
+	//
+	// Returns -1 if the allocator doesn't support this, in which case
+	// objects are destroyed after their block has been freed.
+	// --
+	virtual int GetObjectCount(void *block) { return -1; }
+
 	// --
 	// Destroy all allocated memory used by the allocator.
 	//
@@ -98,6 +147,17 @@ public:
 	// --
 	virtual void Destroy() {}
 
+	// --
+	// Subsystem that memory taken from the system by this allocator is
+	// charged to. Must be set before the first allocation.
+	// --
+	void SetMemoryTag(ysMemoryTag tag) { m_memoryTag = tag; }
+	ysMemoryTag GetMemoryTag() const { return m_memoryTag; }
+
+protected:
+
+	ysMemoryTag m_memoryTag;
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef YDS_MEMORY_TRACKER_H
+#define YDS_MEMORY_TRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Subsystem that a block of memory is charged to
+enum class ysMemoryTag {
+    General,
+    Physics,
+    Assets,
+    Audio,
+    Render,
+    UI,
+
+    Count
+};
+
+// --
+// Per-subsystem memory accounting.
+//
+// Allocations are only recorded when the project is built with
+// YS_ENABLE_MEMORY_TRACKING defined (and it must then be defined for every
+// translation unit). Otherwise the recording macros compile to nothing,
+// ysTrackedAllocate()/ysTrackedFree() are plain malloc()/free() and all
+// statistics read as zero.
+// --
+class ysMemoryTracker {
+public:
+    static const int TagCount = (int)ysMemoryTag::Count;
+
+    struct TagStatistics {
+        // Bytes and blocks currently allocated
+        int64_t LiveBytes;
+        int64_t LiveAllocations;
+
+        // Highest value of LiveBytes observed
+        int64_t PeakBytes;
+
+        // Totals since the start of the program
+        int64_t TotalAllocations;
+        int64_t TotalBytes;
+
+        // Totals since the last call to ResetInterval()
+        int64_t IntervalAllocations;
+        int64_t IntervalBytes;
+
+        // 0 if the tag has no budget
+        int64_t Budget;
+    };
+
+    // Called from the allocating thread when a tag first goes over its budget
+    typedef void (*BudgetCallback)(ysMemoryTag tag, int64_t liveBytes, int64_t budget);
+
+public:
+    static void RecordAllocation(ysMemoryTag tag, size_t size);
+    static void RecordFree(ysMemoryTag tag, size_t size);
+
+    static void GetStatistics(ysMemoryTag tag, TagStatistics *statistics);
+
+    // Start a new interval for the allocation rate counters (ie. once per frame)
+    static void ResetInterval();
+
+    static void SetBudget(ysMemoryTag tag, int64_t bytes);
+    static bool IsOverBudget(ysMemoryTag tag);
+    static void SetBudgetCallback(BudgetCallback callback);
+
+    // Write a table of all statistics to the file
+    static void Dump(FILE *file);
+
+    static const char *GetTagName(ysMemoryTag tag);
+
+    static bool IsEnabled();
+};
+
+#ifdef YS_ENABLE_MEMORY_TRACKING
+
+#define YS_TRACK_ALLOCATION(tag, size) ysMemoryTracker::RecordAllocation((tag), (size_t)(size))
+#define YS_TRACK_FREE(tag, size) ysMemoryTracker::RecordFree((tag), (size_t)(size))
+
+#else
+
+#define YS_TRACK_ALLOCATION(tag, size) ((void)0)
+#define YS_TRACK_FREE(tag, size) ((void)0)
+
+#endif /* YS_ENABLE_MEMORY_TRACKING */
+
+// --
+// malloc()/free() replacements that charge the block to a tag. Blocks are
+// 16 byte aligned and must be released with ysTrackedFree().
+// --
+#ifdef YS_ENABLE_MEMORY_TRACKING
+
+void *ysTrackedAllocate(ysMemoryTag tag, size_t size);
+void ysTrackedFree(void *block);
+
+#else
+
+inline void *ysTrackedAllocate(ysMemoryTag tag, size_t size) { (void)tag; return ::malloc(size); }
+inline void ysTrackedFree(void *block) { ::free(block); }
+
+#endif /* YS_ENABLE_MEMORY_TRACKING */
+
+#endif /* YDS_MEMORY_TRACKER_H */
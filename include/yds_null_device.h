@@ -0,0 +1,58 @@
+#ifndef YDS_NULL_DEVICE_H
+#define YDS_NULL_DEVICE_H
+
+#include "yds_device.h"
+
+// --
+// Device that doesn't talk to any graphics API.
+//
+// Used to run tools, servers and tests without a window or a GPU. Buffers
+// are created and sized like on a real device (with a RAM mirror if one is
+// requested) so that assets can be loaded as usual, but there is nothing to
+// draw to: rendering contexts, render targets, shaders and textures can't
+// be created and drawing does nothing.
+// --
+class ysNullDevice : public ysDevice {
+public:
+    ysNullDevice();
+    ~ysNullDevice();
+
+    // Setup
+    virtual ysError InitializeDevice();
+    virtual ysError DestroyDevice();
+    virtual bool CheckSupport();
+
+    // Rendering Contexts
+    virtual ysError CreateRenderingContext(ysRenderingContext **renderingContext, ysWindow *window);
+    virtual ysError UpdateRenderingContext(ysRenderingContext *context);
+
+    virtual ysError CreateOnScreenRenderTarget(ysRenderTarget **newTarget, ysRenderingContext *context, bool depthBuffer);
+    virtual ysError CreateOffScreenRenderTarget(ysRenderTarget **newTarget, int width, int height, ysRenderTarget::RENDER_TARGET_FORMAT format, int sampleCount, bool depthBuffer);
+    virtual ysError CreateSubRenderTarget(ysRenderTarget **newTarget, ysRenderTarget *parent, int x, int y, int width, int height);
+
+    virtual ysError ClearBuffers(const float *clearColor);
+    virtual ysError Present();
+
+    // GPU Buffers
+    virtual ysError CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
+    virtual ysError CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
+    virtual ysError CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
+
+    // Shaders
+    virtual ysError CreateVertexShader(ysShader **newShader, const char *shaderFilename, const char *shaderName);
+    virtual ysError CreatePixelShader(ysShader **newShader, const char *shaderFilename, const char *shaderName);
+
+    // Shader Programs
+    virtual ysError CreateShaderProgram(ysShaderProgram **newProgram);
+
+    // Input Layouts
+    virtual ysError CreateInputLayout(ysInputLayout **newLayout, ysShader *shader, ysRenderGeometryFormat *format);
+
+    // Textures
+    virtual ysError CreateTexture(ysTexture **texture, const char *fname);
+
+protected:
+    ysError CreateBuffer(ysGPUBuffer **newBuffer, ysGPUBuffer::GPU_BUFFER_TYPE type, int size, char *data, bool mirrorToRam);
+};
+
+#endif /* YDS_NULL_DEVICE_H */
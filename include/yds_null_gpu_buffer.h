@@ -0,0 +1,14 @@
+#ifndef YDS_NULL_GPU_BUFFER_H
+#define YDS_NULL_GPU_BUFFER_H
+
+#include "yds_gpu_buffer.h"
+
+class ysNullGPUBuffer : public ysGPUBuffer {
+    friend class ysNullDevice;
+
+public:
+    ysNullGPUBuffer();
+    virtual ~ysNullGPUBuffer();
+};
+
+#endif /* YDS_NULL_GPU_BUFFER_H */
@@ -53,6 +53,16 @@ public:
         ysExpandingArray<IndexSet> UVIndexSets;
     };
 
+    // Run of consecutive faces that can be drawn and culled on its own
+    struct Meshlet {
+        int FirstFace;
+        int FaceCount;
+        int VertexCount;
+
+        ysVector3 MinExtreme;
+        ysVector3 MaxExtreme;
+    };
+
     struct AnimationKey {
         int Time;	// ie frame
         float Value;
@@ -121,6 +131,7 @@ public:
     // Calculated Values
     ysExpandingArray<ysVector3> m_normals;
     ysExpandingArray<ysVector4> m_tangents;
+    ysExpandingArray<Meshlet> m_meshlets;
 
     bool m_flipNormals;
 
@@ -39,7 +39,7 @@ public:
     virtual ysError CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
     virtual ysError CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
     virtual ysError UseVertexBuffer(ysGPUBuffer *buffer, int stride, int offset);
-    virtual ysError UseIndexBuffer(ysGPUBuffer *buffer, int offset);
+    virtual ysError UseIndexBuffer(ysGPUBuffer *buffer, int offset, int indexSize = sizeof(unsigned short));
     virtual ysError UseConstantBuffer(ysGPUBuffer *buffer, int slot);
     virtual ysError EditBufferDataRange(ysGPUBuffer *buffer, char *data, int size, int offset);
     virtual ysError EditBufferData(ysGPUBuffer *buffer, char *data);
@@ -89,6 +89,8 @@ protected:
 
     // Get a GL type from a geometry channel format
     static int GetFormatGLType(ysRenderGeometryChannel::CHANNEL_FORMAT format);
+    static bool IsIntegerFormat(ysRenderGeometryChannel::CHANNEL_FORMAT format);
+    static bool IsNormalizedFormat(ysRenderGeometryChannel::CHANNEL_FORMAT format);
 
 protected:
     ysOpenGLVirtualContext *m_realContext;
@@ -12,6 +12,11 @@ struct ysOpenGLLayoutChannel : public ysDynamicArrayElement {
     int m_size = 0;
     int m_offset = 0;
     int m_type = 0;
+
+    // Integer channels are not converted to floats, normalized channels are
+    // scaled to [0, 1] or [-1, 1]
+    bool m_integer = false;
+    bool m_normalized = false;
 };
 
 class ysOpenGLInputLayout : public ysInputLayout {
@@ -1,247 +1,278 @@
 #ifndef YDS_QUEUE_H
 #define YDS_QUEUE_H
 
-#include <stdlib.h>
-
-template<typename Type, int InitialSize=0, int Alignment=1>
-class ysQueue
-{
-
+#include "yds_allocator.h"
+
+#include <assert.h>
+#include <atomic>
+#include <new>
+#include <stddef.h>
+#include <utility>
+
+// --
+// Bounded lock-free queues.
+//
+// Both queues store their objects in a ring buffer whose capacity is
+// rounded up to a power of two so that positions wrap with a mask. The
+// producer and consumer positions are kept on separate cache lines so that
+// the two sides don't invalidate each other's cache when only one of them
+// is writing.
+//
+// TryPush() returns false if the queue is full and TryPop() returns false
+// if it is empty, neither ever blocks.
+// --
+namespace ysQueueInternal {
+
+    static const int CacheLineSize = 64;
+
+    inline int RoundUpCapacity(int capacity) {
+        int rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+
+        return rounded;
+    }
+
+} /* namespace ysQueueInternal */
+
+// --
+// Queue with exactly one producer thread and one consumer thread.
+// --
+template<typename TYPE>
+class ysSpscQueue {
 public:
-
-	ysQueue()
-	{
-
-		m_maxSize = InitialSize;
-		m_objectCount = 0;
-		m_start = 0;
-		m_array = NULL;
-
-	}
-
-	~ysQueue()
-	{
-	}
-
-	inline Type &Append()
-	{
-
-		if (m_objectCount >= m_maxSize) Extend();
-
-		Type *newObject = (new ((void *)&m_array[(m_start + m_objectCount) % m_objectCount]) Type);
-
-		m_objectCount++;
-
-		return newObject;
-
-	}
-
-	inline Type &Prepend()
-	{
-
-		if (m_objectCount >= m_maxSize) Extend();
-
-		Type *newObject = (new ((void *)&m_array[(m_start + m_objectCount) % m_objectCount]) Type);
-
-		m_objectCount++;
-
-		m_start += m_maxSize;
-		m_start--;
-		m_start %= m_maxSize;
-
-		return newObject;
-
-	}
-
-	Type *GetBuffer() { return m_array; }
-
-	__forceinline Type &operator[](int index)
-	{
-
-		return m_array[(index + m_start) % m_maxSize];
-
-	}
-
-	void DeleteFront()
-	{
-
-		m_start++;
-		m_start %= m_maxSize;
-		m_objectCount--;
-
-	}
-
-	void DeleteBack()
-	{
-
-		m_objectCount--;
-
-	}
-
-	void Clear()
-	{
-
-		m_objectCount = 0;
-		m_start = 0;
-
-	}
-
-	void Destroy()
-	{
-
-		DestroyArray(m_array);
-
-		m_maxSize = 0;
-		m_objectCount = 0;
-		m_array = NULL;
-		m_start = 0;
-
-	}
+    ysSpscQueue() {
+        m_buffer = nullptr;
+        m_mask = 0;
+
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        m_cachedHead = 0;
+        m_cachedTail = 0;
+    }
+
+    ~ysSpscQueue() {
+        Destroy();
+    }
+
+    // Capacity is rounded up to the next power of two
+    void Initialize(int capacity) {
+        assert(m_buffer == nullptr);
+
+        const int size = ysQueueInternal::RoundUpCapacity(capacity);
+        m_buffer = reinterpret_cast<TYPE *>(
+            ysAllocator::BlockAllocate((int)sizeof(TYPE) * size, ysQueueInternal::CacheLineSize));
+        m_mask = size - 1;
+    }
+
+    // Not thread safe, destroys any objects still in the queue
+    void Destroy() {
+        if (m_buffer == nullptr) return;
+
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (size_t i = m_head.load(std::memory_order_relaxed); i != tail; i++) {
+            m_buffer[i & m_mask].~TYPE();
+        }
+
+        ysAllocator::BlockFree(m_buffer, ysQueueInternal::CacheLineSize);
+        m_buffer = nullptr;
+        m_mask = 0;
+
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        m_cachedHead = 0;
+        m_cachedTail = 0;
+    }
+
+    // Producer only
+    template<typename T_Object>
+    bool TryPush(T_Object &&object) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) return false;
+        }
+
+        new (&m_buffer[tail & m_mask]) TYPE(std::forward<T_Object>(object));
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only
+    bool TryPop(TYPE &object) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+
+        TYPE *slot = &m_buffer[head & m_mask];
+        object = std::move(*slot);
+        slot->~TYPE();
+
+        m_head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Approximate when called while either side is active
+    int GetCount() const {
+        return (int)(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+    }
+
+    int GetCapacity() const { return (m_buffer != nullptr) ? (int)m_mask + 1 : 0; }
 
 protected:
+    TYPE *m_buffer;
+    size_t m_mask;
 
-	Type *CreateArray(int size)
-	{
-
-		Type *ret = NULL;
-
-		if (Alignment != 1)
-		{
-
-			void *memory = _aligned_malloc(sizeof(Type) * size, Alignment);
-			ret = (Type *)memory;
-
-		}
-
-		else ret = new Type[size];
-
-		return ret;
+    char m_padding0[ysQueueInternal::CacheLineSize];
 
-	}
+    // Consumer side
+    std::atomic<size_t> m_head;
+    size_t m_cachedTail;
 
-	void DestroyArray(Type *arr)
-	{
+    char m_padding1[ysQueueInternal::CacheLineSize];
 
-		if (Alignment == 1)
-		{
+    // Producer side
+    std::atomic<size_t> m_tail;
+    size_t m_cachedHead;
 
-			delete [] arr;
-
-		}
-
-		else
-		{
-
-			for (int i=0; i < m_maxSize; i++)
-			{
-
-				arr[i].~Type();
-
-			}
-
-			_aligned_free(arr);
-
-		}
-
-	}
-
-	void Allocate(int size)
-	{
-
-		if (size == 0) return;
-		if (m_array != NULL)
-		{
-
-			if (m_maxSize < size)
-			{
-
-				Destroy();
-
-			}
-
-			else
-			{
-
-				m_objectCount = size;
-				return;
-
-			}
-
-		}
-
-		m_array = CreateArray(size);
-		m_maxSize = size;
-		m_objectCount = size;
-		m_start = 0;
-
-	}
-
-	void Preallocate(int size)
-	{
-
-		if (size == 0) return;
-		if (m_array != NULL)
-		{
-
-			if (m_maxSize < size)
-			{
-
-				Destroy();
-
-			}
-
-			else
-			{
-
-				// Already allcoated
-				m_objectCount = 0;
-				return;
-
-			}
-
-		}
-
-		m_array = CreateArray(size);
-		m_maxSize = size;
-		m_objectCount = 0;
-		m_start = 0;
-
-	}
-
-	void Extend()
-	{
-
-		Type *newArray = CreateArray(m_maxSize * 2 + 1);
-
-		int modIndex=m_start;
-		for (int i=0; i < m_nObjects; i++)
-		{
-
-			newArray[i] = m_array[i];
-
-			modIndex++;
-			modIndex %= m_maxSize;
-
-		}
-
-		m_start = 0;
-
-		DestroyArray(m_array);
+    char m_padding2[ysQueueInternal::CacheLineSize];
+};
 
-		m_array = newAray;
-		m_maxSize *= 2;
-		m_maxSize += 1;
+// --
+// Queue with any number of producer and consumer threads.
+//
+// Every cell carries a sequence number which tells producers and consumers
+// whether the cell is ready for them, so claiming a position is a single
+// compare-exchange and no thread ever waits on another.
+// --
+template<typename TYPE>
+class ysMpmcQueue {
+protected:
+    struct Cell {
+        std::atomic<size_t> Sequence;
+        TYPE Data;
+    };
 
-	}
+public:
+    ysMpmcQueue() {
+        m_cells = nullptr;
+        m_mask = 0;
+
+        m_enqueuePosition.store(0, std::memory_order_relaxed);
+        m_dequeuePosition.store(0, std::memory_order_relaxed);
+    }
+
+    ~ysMpmcQueue() {
+        Destroy();
+    }
+
+    // Capacity is rounded up to the next power of two (minimum of 2)
+    void Initialize(int capacity) {
+        assert(m_cells == nullptr);
+
+        const int size = ysQueueInternal::RoundUpCapacity((capacity < 2) ? 2 : capacity);
+        m_cells = reinterpret_cast<Cell *>(
+            ysAllocator::BlockAllocate((int)sizeof(Cell) * size, ysQueueInternal::CacheLineSize));
+        m_mask = size - 1;
+
+        for (int i = 0; i < size; i++) {
+            new (&m_cells[i].Sequence) std::atomic<size_t>(i);
+        }
+
+        m_enqueuePosition.store(0, std::memory_order_relaxed);
+        m_dequeuePosition.store(0, std::memory_order_relaxed);
+    }
+
+    // Not thread safe, destroys any objects still in the queue
+    void Destroy() {
+        if (m_cells == nullptr) return;
+
+        const size_t end = m_enqueuePosition.load(std::memory_order_relaxed);
+        for (size_t i = m_dequeuePosition.load(std::memory_order_relaxed); i != end; i++) {
+            Cell &cell = m_cells[i & m_mask];
+            if (cell.Sequence.load(std::memory_order_relaxed) == i + 1) cell.Data.~TYPE();
+        }
+
+        ysAllocator::BlockFree(m_cells, ysQueueInternal::CacheLineSize);
+        m_cells = nullptr;
+        m_mask = 0;
+
+        m_enqueuePosition.store(0, std::memory_order_relaxed);
+        m_dequeuePosition.store(0, std::memory_order_relaxed);
+    }
+
+    template<typename T_Object>
+    bool TryPush(T_Object &&object) {
+        Cell *cell;
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &m_cells[position & m_mask];
+            const size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+            const ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+
+            if (difference == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (difference < 0) return false;
+            else position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+
+        new (&cell->Data) TYPE(std::forward<T_Object>(object));
+        cell->Sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool TryPop(TYPE &object) {
+        Cell *cell;
+        size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &m_cells[position & m_mask];
+            const size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+            const ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)(position + 1);
+
+            if (difference == 0) {
+                if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (difference < 0) return false;
+            else position = m_dequeuePosition.load(std::memory_order_relaxed);
+        }
+
+        object = std::move(cell->Data);
+        cell->Data.~TYPE();
+        cell->Sequence.store(position + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Approximate when called while other threads are active
+    int GetCount() const {
+        const size_t enqueued = m_enqueuePosition.load(std::memory_order_acquire);
+        const size_t dequeued = m_dequeuePosition.load(std::memory_order_acquire);
+
+        return (enqueued > dequeued) ? (int)(enqueued - dequeued) : 0;
+    }
+
+    int GetCapacity() const { return (m_cells != nullptr) ? (int)m_mask + 1 : 0; }
 
 protected:
+    Cell *m_cells;
+    size_t m_mask;
 
-	int m_maxSize;
-	int m_start;
-	int m_objectCount;
+    char m_padding0[ysQueueInternal::CacheLineSize];
+    std::atomic<size_t> m_enqueuePosition;
 
-	Type *m_array;
+    char m_padding1[ysQueueInternal::CacheLineSize];
+    std::atomic<size_t> m_dequeuePosition;
 
+    char m_padding2[ysQueueInternal::CacheLineSize];
 };
 
-#endif
\ No newline at end of file
+#endif /* YDS_QUEUE_H */
@@ -20,6 +20,15 @@ public:
 		CHANNEL_FORMAT_R32G32B32A32_FLOAT,
 		CHANNEL_FORMAT_R32G32B32A32_UINT,
 		CHANNEL_FORMAT_R32G32B32_UINT,
+
+		// Compressed formats, decoded to floats by the input assembler
+		// except for the UINT format
+		CHANNEL_FORMAT_R16G16B16A16_UNORM,
+		CHANNEL_FORMAT_R16G16_SNORM,
+		CHANNEL_FORMAT_R16G16_FLOAT,
+		CHANNEL_FORMAT_R8G8B8A8_UNORM,
+		CHANNEL_FORMAT_R8G8B8A8_UINT,
+
 		CHANNEL_FORMAT_UNDEFINED
 
 	};
@@ -56,6 +65,17 @@ public:
 		case CHANNEL_FORMAT_R32G32B32_UINT:
 			return 3 * sizeof(unsigned int);
 
+		case CHANNEL_FORMAT_R16G16B16A16_UNORM:
+			return 4 * sizeof(unsigned short);
+
+		case CHANNEL_FORMAT_R16G16_SNORM:
+		case CHANNEL_FORMAT_R16G16_FLOAT:
+			return 2 * sizeof(unsigned short);
+
+		case CHANNEL_FORMAT_R8G8B8A8_UNORM:
+		case CHANNEL_FORMAT_R8G8B8A8_UINT:
+			return 4 * sizeof(unsigned char);
+
 		case CHANNEL_FORMAT_UNDEFINED:
 		default:
 			return 0;
@@ -85,6 +105,15 @@ public:
 		case CHANNEL_FORMAT_R32G32B32_UINT:
 			return 3;
 
+		case CHANNEL_FORMAT_R16G16B16A16_UNORM:
+		case CHANNEL_FORMAT_R8G8B8A8_UNORM:
+		case CHANNEL_FORMAT_R8G8B8A8_UINT:
+			return 4;
+
+		case CHANNEL_FORMAT_R16G16_SNORM:
+		case CHANNEL_FORMAT_R16G16_FLOAT:
+			return 2;
+
 		case CHANNEL_FORMAT_UNDEFINED:
 		default:
 			return 0;
@@ -0,0 +1,175 @@
+#ifndef YDS_SLAB_ALLOCATOR_H
+#define YDS_SLAB_ALLOCATOR_H
+
+#include "yds_memory_base.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+// --
+// General purpose allocator which rounds every allocation up to a
+// power-of-two size class. Each class carves its blocks out of fixed size
+// slabs and keeps freed blocks on a free list, so both allocation and
+// freeing are O(1).
+//
+// Each thread keeps a small cache of free blocks per class so that most
+// operations don't need to lock. Caches are refilled from and drained
+// into a shared depot in batches.
+//
+// All blocks are 16 byte aligned.
+// --
+class ysSlabAllocator : public ysMemoryAllocator {
+    friend struct ysSlabAllocatorCacheRelease;
+
+public:
+    static const int Alignment = 16;
+
+    // Size classes are 32 bytes to 32 KB (including the block header),
+    // anything larger is allocated directly from the system
+    static const int MinClassShift = 5;
+    static const int MaxClassShift = 15;
+    static const int NumClasses = MaxClassShift - MinClassShift + 1;
+
+    static const int SlabSize = 64 * KB;
+
+    // Maximum number of allocators that can use thread caches at once,
+    // any further allocators always go through the depot
+    static const int MaxCachedAllocators = 32;
+
+    struct ClassStatistics {
+        int BlockSize;
+
+        // Blocks currently handed out
+        int64_t LiveBlocks;
+
+        // Total number of allocations made from this class
+        int64_t TotalAllocations;
+
+        // Number of slabs reserved for this class
+        int Slabs;
+    };
+
+    struct Statistics {
+        ClassStatistics Classes[NumClasses];
+
+        // Allocations too large for any size class
+        int64_t LargeAllocations;
+        int64_t LiveLargeBlocks;
+
+        // Bytes requested by live allocations
+        int64_t RequestedBytes;
+
+        // Bytes reserved from the system (slabs and large blocks)
+        int64_t ReservedBytes;
+
+        // Highest value of RequestedBytes observed. Thread caches report their
+        // usage in batches so short lived peaks may not be captured.
+        int64_t HighWaterMark;
+
+        // Portion of reserved memory not used by live allocations [0, 1]
+        float Fragmentation;
+    };
+
+public:
+    ysSlabAllocator();
+    ~ysSlabAllocator();
+
+    virtual void *AllocateBlock(int size, int numObjects = 1);
+    virtual int FreeBlock(void *block);
+    virtual int GetObjectCount(void *block);
+
+    // --
+    // Release all slabs back to the system.
+    //
+    // NOTE: All blocks allocated from size classes become invalid. Large
+    // blocks are not owned by a slab and still have to be freed.
+    // --
+    virtual void Destroy();
+
+    // --
+    // Collect allocation statistics. Counts from the calling thread are
+    // exact, other threads report theirs whenever they refill or drain their
+    // caches (and when they exit).
+    // --
+    void GetStatistics(Statistics *statistics);
+
+    // Returns the size class that an allocation of the given size falls into, or -1
+    static int GetSizeClass(int size);
+
+protected:
+    struct BlockHeader {
+        int SizeClass;
+        int NumObjects;
+        int Size;
+        int Padding;
+    };
+
+    // Free blocks are kept in batches. The first block of a batch
+    // stores the batch's size and the link to the next batch.
+    struct FreeBlockLink {
+        FreeBlockLink *Next;
+        FreeBlockLink *NextBatch;
+        int BatchCount;
+    };
+
+    struct Slab {
+        Slab *Next;
+    };
+
+    struct Depot {
+        std::mutex Lock;
+
+        FreeBlockLink *Batches;
+        int FreeCount;
+
+        Slab *Slabs;
+        int SlabCount;
+    };
+
+    struct ClassCounters {
+        std::atomic<int64_t> LiveBlocks;
+        std::atomic<int64_t> TotalAllocations;
+    };
+
+public:
+    struct ThreadCache;
+
+protected:
+    ThreadCache *GetThreadCache();
+
+    // Returns everything in a thread's cache to the depots
+    void ReleaseThreadCache(ThreadCache *cache);
+
+    // Removes a batch of free blocks from the depot, returns the number of blocks
+    int TakeFromDepot(int sizeClass, FreeBlockLink **batch);
+
+    // Adds a batch of free blocks to the depot
+    void ReturnToDepot(int sizeClass, FreeBlockLink *batch, int count);
+
+    void AddSlab(int sizeClass);
+
+    // Adds a thread cache's statistics to the allocator's counters
+    void FlushStatistics(ThreadCache *cache);
+
+    void UpdateRequested(int64_t delta);
+
+    static int GetBatchSize(int sizeClass);
+
+protected:
+    Depot m_depots[NumClasses];
+    ClassCounters m_counters[NumClasses];
+
+    std::atomic<int64_t> m_largeAllocations;
+    std::atomic<int64_t> m_liveLargeBlocks;
+    std::atomic<int64_t> m_largeBytes;
+
+    std::atomic<int64_t> m_requestedBytes;
+    std::atomic<int64_t> m_highWaterMark;
+
+    // Thread cache slot and the ID that identifies this allocator in it
+    int m_cacheSlot;
+    uint64_t m_id;
+};
+
+#endif /* YDS_SLAB_ALLOCATOR_H */
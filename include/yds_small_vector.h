@@ -0,0 +1,237 @@
+#ifndef YDS_SMALL_VECTOR_H
+#define YDS_SMALL_VECTOR_H
+
+#include "yds_expanding_array.h"
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// --
+// Array with room for INLINE_SIZE objects inside the object itself.
+//
+// Nothing is allocated until the array grows past INLINE_SIZE objects, at
+// which point the contents move to the heap and stay there until Destroy()
+// is called. Meant for short per-object lists (children, contacts,
+// occupied cells) which almost never exceed a handful of entries.
+//
+// The inline storage makes the array unsafe to relocate with memcpy, so
+// unlike ysExpandingArray it is not trivially relocatable.
+// --
+template<typename TYPE, int INLINE_SIZE = 4>
+class ysSmallVector {
+    static_assert(INLINE_SIZE > 0, "Inline size must be at least 1");
+
+public:
+    ysSmallVector() {
+        m_array = GetInlineBuffer();
+        m_maxSize = INLINE_SIZE;
+        m_nObjects = 0;
+    }
+
+    ysSmallVector(const ysSmallVector &ref) {
+        m_array = GetInlineBuffer();
+        m_maxSize = INLINE_SIZE;
+        m_nObjects = 0;
+
+        Append(ref.m_array, ref.m_nObjects);
+    }
+
+    ysSmallVector(ysSmallVector &&ref) noexcept {
+        m_array = GetInlineBuffer();
+        m_maxSize = INLINE_SIZE;
+        m_nObjects = 0;
+
+        Steal(ref);
+    }
+
+    ysSmallVector &operator=(const ysSmallVector &ref) {
+        if (this == &ref) return *this;
+
+        Clear();
+        Append(ref.m_array, ref.m_nObjects);
+
+        return *this;
+    }
+
+    ysSmallVector &operator=(ysSmallVector &&ref) noexcept {
+        if (this == &ref) return *this;
+
+        Destroy();
+        Steal(ref);
+
+        return *this;
+    }
+
+    ~ysSmallVector() {
+        Destroy();
+    }
+
+    // Destroys all objects but keeps the storage
+    void Clear() {
+        DestroyRange(0, m_nObjects);
+        m_nObjects = 0;
+    }
+
+    // Destroys all objects and returns to the inline storage
+    void Destroy() {
+        Clear();
+
+        if (!IsInline()) {
+            ysAllocator::BlockFree(reinterpret_cast<void *>(m_array), HeapAlignment);
+            m_array = GetInlineBuffer();
+            m_maxSize = INLINE_SIZE;
+        }
+    }
+
+    // Make sure there is room for at least nObjects without reallocating
+    void Reserve(int nObjects) {
+        if (nObjects > m_maxSize) Relocate(nObjects);
+    }
+
+    void Append(const TYPE *data, int n) {
+        if (n <= 0) return;
+
+        if (m_nObjects + n > m_maxSize) {
+            // The source may be part of this array
+            if (data >= m_array && data < m_array + m_nObjects) {
+                const int offset = (int)(data - m_array);
+                Grow(m_nObjects + n);
+                data = m_array + offset;
+            }
+            else Grow(m_nObjects + n);
+        }
+
+        for (int i = 0; i < n; i++) {
+            new ((void *)&m_array[m_nObjects + i]) TYPE(data[i]);
+        }
+
+        m_nObjects += n;
+    }
+
+    inline TYPE &New() {
+        if (m_nObjects >= m_maxSize) Grow(m_nObjects + 1);
+
+        return *(new ((void *)&m_array[m_nObjects++]) TYPE);
+    }
+
+    TYPE *GetBuffer() { return m_array; }
+    const TYPE *GetBuffer() const { return m_array; }
+
+    __forceinline TYPE &operator[](int index) {
+        return m_array[index];
+    }
+
+    const TYPE &operator[](int index) const {
+        return m_array[index];
+    }
+
+    int GetNumObjects() const { return m_nObjects; }
+    int GetCapacity() const { return m_maxSize; }
+
+    // True while the objects are stored in the object itself
+    bool IsInline() const { return m_array == GetInlineBuffer(); }
+
+    // --
+    // Remove the object at index. Unless the order is maintained the last
+    // object takes its place.
+    // --
+    void Delete(int index, bool maintainOrder = false) {
+        const int last = m_nObjects - 1;
+
+        if (maintainOrder) {
+            for (int i = index; i < last; i++) {
+                m_array[i] = std::move(m_array[i + 1]);
+            }
+        }
+        else if (index != last) {
+            m_array[index] = std::move(m_array[last]);
+        }
+
+        m_array[last].~TYPE();
+        m_nObjects--;
+    }
+
+    int Find(const TYPE &ref) const {
+        for (int i = 0; i < m_nObjects; i++) {
+            if (m_array[i] == ref) return i;
+        }
+
+        return -1;
+    }
+
+private:
+    static const int HeapAlignment = (alignof(TYPE) > alignof(max_align_t)) ? (int)alignof(TYPE) : 1;
+
+    TYPE *GetInlineBuffer() { return reinterpret_cast<TYPE *>(&m_inline); }
+    const TYPE *GetInlineBuffer() const { return reinterpret_cast<const TYPE *>(&m_inline); }
+
+    void Grow(int nObjects) {
+        int newSize = m_maxSize * 2;
+        if (newSize < nObjects) newSize = nObjects;
+
+        Relocate(newSize);
+    }
+
+    void Relocate(int newSize) {
+        TYPE *newArray = reinterpret_cast<TYPE *>(
+            ysAllocator::BlockAllocate((int)sizeof(TYPE) * newSize, HeapAlignment));
+        MoveConstruct(newArray, m_array, m_nObjects, ysIsTriviallyRelocatable<TYPE>());
+
+        if (!IsInline()) {
+            ysAllocator::BlockFree(reinterpret_cast<void *>(m_array), HeapAlignment);
+        }
+
+        m_array = newArray;
+        m_maxSize = newSize;
+    }
+
+    // Take the contents of an array, ref is left empty. Heap storage is
+    // handed over, inline objects are moved.
+    void Steal(ysSmallVector &ref) {
+        if (ref.IsInline()) {
+            MoveConstruct(m_array, ref.m_array, ref.m_nObjects, ysIsTriviallyRelocatable<TYPE>());
+            m_nObjects = ref.m_nObjects;
+        }
+        else {
+            m_array = ref.m_array;
+            m_maxSize = ref.m_maxSize;
+            m_nObjects = ref.m_nObjects;
+
+            ref.m_array = ref.GetInlineBuffer();
+            ref.m_maxSize = INLINE_SIZE;
+        }
+
+        ref.m_nObjects = 0;
+    }
+
+    // Move n objects to uninitialized storage, the sources are destroyed
+
+    static void MoveConstruct(TYPE *target, TYPE *source, int n, std::true_type) {
+        if (n > 0) memcpy((void *)target, (const void *)source, sizeof(TYPE) * n);
+    }
+
+    static void MoveConstruct(TYPE *target, TYPE *source, int n, std::false_type) {
+        for (int i = 0; i < n; i++) {
+            new ((void *)&target[i]) TYPE(std::move(source[i]));
+            source[i].~TYPE();
+        }
+    }
+
+    void DestroyRange(int begin, int end) {
+        if (std::is_trivially_destructible<TYPE>::value) return;
+
+        for (int i = begin; i < end; i++) {
+            m_array[i].~TYPE();
+        }
+    }
+
+    TYPE *m_array;
+    int m_maxSize;
+    int m_nObjects;
+
+    typename std::aligned_storage<sizeof(TYPE) * INLINE_SIZE, alignof(TYPE)>::type m_inline;
+};
+
+#endif /* YDS_SMALL_VECTOR_H */
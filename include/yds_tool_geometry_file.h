@@ -4,8 +4,11 @@
 #include "yds_base.h"
 
 #include "yds_object_data.h"
+#include "yds_memory_tracker.h"
 
 #include <fstream>
+#include <stdint.h>
+#include <type_traits>
 
 class ysToolGeometryFile : public ysObject {
 public:
@@ -108,12 +111,19 @@ public:
     bool MaterialData() const;
     bool SmoothingData() const;
 
-    ysError ReadObject(ysObjectData **object);
+    // If sourceHash is given it receives a hash of the object's bytes in
+    // the file, which changes whenever anything about the object does
+    ysError ReadObject(ysObjectData **object, uint64_t *sourceHash = nullptr);
     ysError UpdateCompilationStatus(CompilationStatus status);
 
+    // Hash of the entire file except for the compilation status, which
+    // isn't part of the scene. Returns false if the file can't be read.
+    static bool HashFile(const char *fname, uint64_t *hash);
+
 protected:
     ysError ReadHeader(int fileVersion);
     ysError ReadString(char *dest);
+    ysError HashRange(std::streampos start, std::streampos end, uint64_t *hash);
 
     ysError ReadObjectVersion000(ysObjectData *object);
     ysError ReadObjectVersion001(ysObjectData *object);
@@ -124,9 +134,14 @@ protected:
 
     ysError ReadObjectDataVersion000_005(ysObjectData *object);
 
+    // Only the block is released by DestroyMemory(), destructors are not called
     template<typename Type>
     Type *Allocate(int count) {
-        Type *ret = new Type[count];
+        static_assert(std::is_trivially_destructible<Type>::value, "Type must be trivially destructible");
+
+        Type *ret = reinterpret_cast<Type *>(ysTrackedAllocate(ysMemoryTag::Assets, sizeof(Type) * count));
+        for (int i = 0; i < count; i++) new (&ret[i]) Type;
+
         Allocation *track = m_allocationTracker.New();
         track->m_allocation = (void *)ret;
 
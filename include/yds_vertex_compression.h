@@ -0,0 +1,39 @@
+#ifndef YDS_VERTEX_COMPRESSION_H
+#define YDS_VERTEX_COMPRESSION_H
+
+#include "yds_math.h"
+
+// --
+// Encoding helpers for compressed vertex formats.
+//
+// Each encoding matches what the input assembler decodes for the
+// corresponding ysRenderGeometryChannel format (UNORM/SNORM/FLOAT16), the
+// decoders are there for tools and tests.
+// --
+namespace ysVertexCompression {
+
+    // Value in [minimum, maximum] to/from a 16 bit unsigned normalized integer
+    unsigned short QuantizeUnorm16(float value, float minimum, float maximum);
+    float DequantizeUnorm16(unsigned short value, float minimum, float maximum);
+
+    // Value in [-1, 1] to/from a 16 bit signed normalized integer
+    short QuantizeSnorm16(float value);
+    float DequantizeSnorm16(short value);
+
+    // Value in [0, 1] to an 8 bit unsigned normalized integer
+    unsigned char QuantizeUnorm8(float value);
+
+    // --
+    // Unit vector to/from two signed normalized components. The direction is
+    // projected onto an octahedron which is then unfolded onto a square.
+    // --
+    void EncodeOctahedral(const ysVector3 &direction, short *x, short *y);
+    ysVector3 DecodeOctahedral(short x, short y);
+
+    // IEEE 754 half precision, rounded to nearest even
+    unsigned short FloatToHalf(float value);
+    float HalfToFloat(unsigned short value);
+
+} /* namespace ysVertexCompression */
+
+#endif /* YDS_VERTEX_COMPRESSION_H */
@@ -0,0 +1,73 @@
+#include "../include/yds_allocator.h"
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32)
+namespace {
+
+    // munmap() only takes whole pages, so trimming and freeing have to
+    // work on the same rounded size
+    size_t RoundToPages(size_t size) {
+        const size_t pageSize = (size_t)::sysconf(_SC_PAGESIZE);
+        return (size + pageSize - 1) & ~(pageSize - 1);
+    }
+
+} /* namespace */
+#endif
+
+void *ysAllocator::PageAllocate(size_t size, bool hugePages) {
+    if (size == 0) return nullptr;
+
+#if defined(_WIN32)
+    // Large pages on Windows need the SeLockMemoryPrivilege, which
+    // applications normally don't have, so regular pages are always used
+    (void)hugePages;
+
+    return ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    size = RoundToPages(size);
+
+    if (!hugePages || size < HugePageSize) {
+        void *block = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return (block != MAP_FAILED) ? block : nullptr;
+    }
+
+    // Over-allocate and trim so that the block starts on a huge page
+    // boundary, otherwise the kernel can only use huge pages for part of it
+    const size_t mappedSize = size + HugePageSize;
+    void *mapping = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return nullptr;
+
+    const uintptr_t start = reinterpret_cast<uintptr_t>(mapping);
+    const uintptr_t aligned = (start + HugePageSize - 1) & ~(uintptr_t)(HugePageSize - 1);
+    const size_t head = aligned - start;
+    const size_t tail = mappedSize - head - size;
+
+    if (head > 0) ::munmap(mapping, head);
+    if (tail > 0) ::munmap(reinterpret_cast<void *>(aligned + size), tail);
+
+#if defined(MADV_HUGEPAGE)
+    ::madvise(reinterpret_cast<void *>(aligned), size, MADV_HUGEPAGE);
+#endif
+
+    return reinterpret_cast<void *>(aligned);
+#endif
+}
+
+void ysAllocator::PageFree(void *block, size_t size) {
+    if (block == nullptr) return;
+
+#if defined(_WIN32)
+    (void)size;
+    ::VirtualFree(block, 0, MEM_RELEASE);
+#else
+    ::munmap(block, RoundToPages(size));
+#endif
+}
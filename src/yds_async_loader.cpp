@@ -0,0 +1,330 @@
+#include "../include/yds_async_loader.h"
+
+#include <chrono>
+#include <float.h>
+
+ysAsyncLoader::ysAsyncLoader() : ysObject("ysAsyncLoader") {
+    m_nextTicket = 1;
+    m_pendingCount = 0;
+    m_processOnIoThreads = false;
+    m_stop = false;
+}
+
+ysAsyncLoader::~ysAsyncLoader() {
+    Shutdown();
+
+    while (m_jobs.GetNumObjects() > 0) {
+        Free(m_jobs.GetHandle(0));
+    }
+}
+
+ysError ysAsyncLoader::Initialize(int ioThreadCount, int workerCount) {
+    YDS_ERROR_DECLARE("Initialize");
+
+    if (IsInitialized()) return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+    if (ioThreadCount < 1) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+
+    if (workerCount < 0) {
+        const int hardwareThreads = (int)std::thread::hardware_concurrency();
+        workerCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+    }
+
+    m_stop = false;
+    m_processOnIoThreads = (workerCount == 0);
+
+    m_threads.Reserve(ioThreadCount + workerCount);
+    for (int i = 0; i < ioThreadCount; i++) {
+        m_threads.New() = std::thread(&ysAsyncLoader::IoThread, this);
+    }
+
+    for (int i = 0; i < workerCount; i++) {
+        m_threads.New() = std::thread(&ysAsyncLoader::WorkerThread, this);
+    }
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+void ysAsyncLoader::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stop = true;
+    }
+
+    m_readAvailable.notify_all();
+    m_processAvailable.notify_all();
+
+    for (int i = 0; i < m_threads.GetNumObjects(); i++) {
+        if (m_threads[i].joinable()) m_threads[i].join();
+    }
+
+    m_threads.Clear();
+
+    // Requests that were still in flight are cancelled, their handles stay
+    // valid until they are released
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (int i = 0; i < m_jobs.GetNumObjects(); i++) {
+        Job *job = m_jobs.Get(i);
+        if (job->State < Status::Complete) Finish(job, Status::Cancelled, ysError::YDS_NO_ERROR);
+    }
+
+    m_readQueue = StageQueue();
+    m_processQueue = StageQueue();
+    m_finalizeQueue = StageQueue();
+}
+
+ysLoadHandle ysAsyncLoader::Submit(const Request &request) {
+    if (!IsInitialized()) return ysLoadHandle::Null();
+
+    Job *job = new Job;
+    job->Stages = request;
+    job->State = Status::Queued;
+    job->Error = ysError::YDS_NO_ERROR;
+    job->Ticket = 0;
+    job->Running = false;
+    job->Released = false;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    const ysLoadHandle handle = m_jobs.Add(job);
+    m_pendingCount++;
+
+    Enqueue(handle, job, Status::Queued);
+
+    return handle;
+}
+
+int ysAsyncLoader::Update(double budget) {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    int steps = 0;
+    while (true) {
+        if (steps > 0) {
+            const std::chrono::duration<double> elapsed = Clock::now() - start;
+            if (elapsed.count() >= budget) break;
+        }
+
+        ysLoadHandle handle;
+        Job *job = PopJob(m_finalizeQueue, &handle);
+        if (job == nullptr) break;
+
+        job->Running = true;
+        lock.unlock();
+
+        bool done = true;
+        const ysError error = (job->Stages.Finalize)
+            ? job->Stages.Finalize(&done)
+            : ysError::YDS_NO_ERROR;
+
+        lock.lock();
+        job->Running = false;
+        steps++;
+
+        if (job->Released) Delete(job);
+        else if (error != ysError::YDS_NO_ERROR) Finish(job, Status::Failed, error);
+        else if (done) Finish(job, Status::Complete, ysError::YDS_NO_ERROR);
+        else Enqueue(handle, job, Status::Finalizing);
+    }
+
+    return steps;
+}
+
+void ysAsyncLoader::Flush() {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (m_pendingCount > 0) {
+        m_stateChanged.wait(lock, [this] { return m_pendingCount == 0 || !m_finalizeQueue.empty(); });
+
+        lock.unlock();
+        Update(DBL_MAX);
+        lock.lock();
+    }
+}
+
+ysAsyncLoader::Status ysAsyncLoader::GetStatus(ysLoadHandle handle) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Job *job = m_jobs.Get(handle);
+    return (job != nullptr) ? job->State : Status::Invalid;
+}
+
+ysError ysAsyncLoader::GetError(ysLoadHandle handle) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Job *job = m_jobs.Get(handle);
+    return (job != nullptr) ? job->Error : ysError::YDS_NO_ERROR;
+}
+
+bool ysAsyncLoader::Cancel(ysLoadHandle handle) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Job *job = m_jobs.Get(handle);
+    if (job == nullptr || job->Running || job->State >= Status::Complete) return false;
+
+    Finish(job, Status::Cancelled, ysError::YDS_NO_ERROR);
+
+    return true;
+}
+
+void ysAsyncLoader::SetPriority(ysLoadHandle handle, int priority) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Job *job = m_jobs.Get(handle);
+    if (job == nullptr) return;
+
+    job->Stages.Priority = priority;
+
+    // Queued again in the new position, the old entry is skipped
+    if (!job->Running && job->State < Status::Complete) Enqueue(handle, job, job->State);
+}
+
+void ysAsyncLoader::Release(ysLoadHandle handle) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Job *job = m_jobs.Get(handle);
+    if (job == nullptr) return;
+
+    // Deleted by whichever thread is running it once the stage returns
+    if (job->Running) {
+        m_jobs.Remove(handle);
+        job->Released = true;
+    }
+    else Free(handle);
+}
+
+int ysAsyncLoader::GetPendingCount() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_pendingCount;
+}
+
+void ysAsyncLoader::IoThread() {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true) {
+        m_readAvailable.wait(lock, [this] {
+            return m_stop || !m_readQueue.empty() || (m_processOnIoThreads && !m_processQueue.empty());
+        });
+
+        if (m_stop) return;
+
+        // Without a worker pool requests that were already read are
+        // finished before new ones are started
+        ysLoadHandle handle;
+        Job *job = nullptr;
+        Status stage = Status::Reading;
+
+        if (m_processOnIoThreads) {
+            job = PopJob(m_processQueue, &handle);
+            if (job != nullptr) stage = Status::Processing;
+        }
+
+        if (job == nullptr) job = PopJob(m_readQueue, &handle);
+        if (job != nullptr) RunStage(lock, handle, job, stage);
+    }
+}
+
+void ysAsyncLoader::WorkerThread() {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true) {
+        m_processAvailable.wait(lock, [this] { return m_stop || !m_processQueue.empty(); });
+
+        if (m_stop) return;
+
+        ysLoadHandle handle;
+        Job *job = PopJob(m_processQueue, &handle);
+        if (job != nullptr) RunStage(lock, handle, job, Status::Processing);
+    }
+}
+
+void ysAsyncLoader::RunStage(std::unique_lock<std::mutex> &lock, ysLoadHandle handle, Job *job, Status stage) {
+    job->State = stage;
+    job->Running = true;
+
+    // The job can't be freed while it's running so the stage is safe to
+    // use without the lock
+    const Stage &callback = (stage == Status::Reading)
+        ? job->Stages.Read
+        : job->Stages.Process;
+
+    lock.unlock();
+    const ysError error = (callback) ? callback() : ysError::YDS_NO_ERROR;
+    lock.lock();
+
+    job->Running = false;
+
+    if (job->Released) Delete(job);
+    else if (error != ysError::YDS_NO_ERROR) Finish(job, Status::Failed, error);
+    else Enqueue(handle, job, (stage == Status::Reading) ? Status::Processing : Status::Finalizing);
+}
+
+ysAsyncLoader::Job *ysAsyncLoader::PopJob(StageQueue &queue, ysLoadHandle *handle) {
+    while (!queue.empty()) {
+        const QueueEntry entry = queue.top();
+        queue.pop();
+
+        Job *job = m_jobs.Get(entry.Handle);
+        if (job != nullptr && job->Ticket == entry.Ticket) {
+            job->Ticket = 0;
+            *handle = entry.Handle;
+
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void ysAsyncLoader::Enqueue(ysLoadHandle handle, Job *job, Status state) {
+    job->State = state;
+    job->Ticket = m_nextTicket++;
+
+    QueueEntry entry;
+    entry.Priority = job->Stages.Priority;
+    entry.Ticket = job->Ticket;
+    entry.Handle = handle;
+
+    if (state == Status::Queued) {
+        m_readQueue.push(entry);
+        m_readAvailable.notify_one();
+    }
+    else if (state == Status::Processing) {
+        m_processQueue.push(entry);
+
+        if (m_processOnIoThreads) m_readAvailable.notify_one();
+        else m_processAvailable.notify_one();
+    }
+    else {
+        m_finalizeQueue.push(entry);
+        m_stateChanged.notify_all();
+    }
+}
+
+void ysAsyncLoader::Finish(Job *job, Status status, ysError error) {
+    job->State = status;
+    job->Error = error;
+    job->Ticket = 0;
+
+    // Frees whatever the stages were holding on to
+    job->Stages.Read = nullptr;
+    job->Stages.Process = nullptr;
+    job->Stages.Finalize = nullptr;
+
+    m_pendingCount--;
+    m_stateChanged.notify_all();
+}
+
+void ysAsyncLoader::Free(ysLoadHandle handle) {
+    Job *job = m_jobs.Remove(handle);
+    if (job != nullptr) Delete(job);
+}
+
+void ysAsyncLoader::Delete(Job *job) {
+    if (job->State < Status::Complete) {
+        m_pendingCount--;
+        m_stateChanged.notify_all();
+    }
+
+    delete job;
+}
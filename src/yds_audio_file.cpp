@@ -1,6 +1,7 @@
 #include "../include/yds_audio_file.h"
 
 #include "../include/yds_audio_buffer.h"
+#include "../include/yds_memory_tracker.h"
 
 ysAudioFile::ysAudioFile() {
     m_format = AudioFormat::Undefined;
@@ -31,7 +32,7 @@ ysAudioFile::ysAudioFile(Platform platform, AudioFormat format) : ysWindowSystem
 }
 
 ysAudioFile::~ysAudioFile() {
-    if (m_buffer) delete[] m_buffer;
+    ysTrackedFree(m_buffer);
 }
 
 ysAudioFile::Error ysAudioFile::OpenFile(const char *fname) {
@@ -93,7 +94,7 @@ ysAudioFile::Error ysAudioFile::InitializeInternalBuffer(SampleOffset samples, b
     if (!m_fileOpen) return Error::NoFileOpen;
 
     int newSize = m_audioParameters.GetSizeFromSamples(samples);
-    char *newBuffer = new char[newSize];
+    char *newBuffer = reinterpret_cast<char *>(ysTrackedAllocate(ysMemoryTag::Audio, newSize));
     if (!newBuffer) return Error::OutOfMemory;
 
     if (saveData && m_buffer) {
@@ -104,7 +105,7 @@ ysAudioFile::Error ysAudioFile::InitializeInternalBuffer(SampleOffset samples, b
     }
 
     // Delete original buffer
-    delete[] m_buffer;
+    ysTrackedFree(m_buffer);
 
     m_buffer = newBuffer;
     m_maxBufferSamples = samples;
@@ -115,7 +116,7 @@ ysAudioFile::Error ysAudioFile::InitializeInternalBuffer(SampleOffset samples, b
 }
 
 void ysAudioFile::DestroyInternalBuffer() {
-    delete[] m_buffer;
+    ysTrackedFree(m_buffer);
 
     m_maxBufferSamples = 0;
     m_bufferDataSamples = 0;
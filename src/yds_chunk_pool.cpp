@@ -0,0 +1,158 @@
+#include "../include/yds_chunk_pool.h"
+
+#include "../include/yds_allocator.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+ysChunkPool::ysChunkPool() {
+    m_chunks = nullptr;
+    m_freeList = nullptr;
+
+    m_lastChunk = nullptr;
+    m_nextUnused = 0;
+
+    m_slotSize = 0;
+    m_alignment = 0;
+    m_chunkSize = 0;
+    m_slotsPerChunk = 0;
+    m_headerSize = 0;
+
+    m_count = 0;
+    m_chunkCount = 0;
+}
+
+ysChunkPool::~ysChunkPool() {
+    Destroy();
+}
+
+void ysChunkPool::Initialize(int slotSize, int alignment) {
+    assert(m_chunks == nullptr);
+
+    if (alignment < (int)sizeof(void *)) alignment = (int)sizeof(void *);
+    if (slotSize < (int)sizeof(FreeSlot)) slotSize = (int)sizeof(FreeSlot);
+
+    m_alignment = alignment;
+    m_slotSize = (slotSize + alignment - 1) & ~(alignment - 1);
+    m_headerSize = ((int)sizeof(Chunk) + alignment - 1) & ~(alignment - 1);
+
+    // Chunks are a power of two in size so that they can be aligned to it,
+    // whatever is left over after the first 64 slots is filled with more slots
+    m_chunkSize = 1;
+    while (m_chunkSize < m_headerSize + MinChunkSlots * m_slotSize) m_chunkSize <<= 1;
+
+    m_slotsPerChunk = (m_chunkSize - m_headerSize) / m_slotSize;
+    if (m_slotsPerChunk > MaxChunkSlots) m_slotsPerChunk = MaxChunkSlots;
+}
+
+void *ysChunkPool::Allocate() {
+    Chunk *chunk;
+    char *slot;
+
+    if (m_freeList != nullptr) {
+        slot = reinterpret_cast<char *>(m_freeList);
+        m_freeList = m_freeList->Next;
+        chunk = GetChunk(slot);
+    }
+    else {
+        if (m_lastChunk == nullptr || m_nextUnused >= m_slotsPerChunk) {
+            chunk = NewChunk();
+            if (chunk == nullptr) return nullptr;
+        }
+        else chunk = m_lastChunk;
+
+        slot = chunk->Slots + m_nextUnused++ * m_slotSize;
+    }
+
+    const int index = (int)(slot - chunk->Slots) / m_slotSize;
+    chunk->Occupied[index / 64] |= (uint64_t)1 << (index % 64);
+
+    m_count++;
+
+    return reinterpret_cast<void *>(slot);
+}
+
+void ysChunkPool::Free(void *address) {
+    if (address == nullptr) return;
+
+    Chunk *chunk = GetChunk(address);
+    assert(chunk->Pool == this);
+
+    const int index = (int)(reinterpret_cast<char *>(address) - chunk->Slots) / m_slotSize;
+    assert((chunk->Occupied[index / 64] & ((uint64_t)1 << (index % 64))) != 0);
+
+    chunk->Occupied[index / 64] &= ~((uint64_t)1 << (index % 64));
+
+    FreeSlot *slot = reinterpret_cast<FreeSlot *>(chunk->Slots + index * m_slotSize);
+    slot->Next = m_freeList;
+    m_freeList = slot;
+
+    m_count--;
+}
+
+bool ysChunkPool::Owns(void *address) const {
+    const char *p = reinterpret_cast<const char *>(address);
+    for (Chunk *chunk = m_chunks; chunk != nullptr; chunk = chunk->Next) {
+        if (p >= chunk->Slots && p < chunk->Slots + m_slotsPerChunk * m_slotSize) return true;
+    }
+
+    return false;
+}
+
+void ysChunkPool::Destroy() {
+    Chunk *chunk = m_chunks;
+    while (chunk != nullptr) {
+        Chunk *next = chunk->Next;
+        ysAllocator::BlockFree(chunk, m_chunkSize);
+        chunk = next;
+    }
+
+    m_chunks = nullptr;
+    m_freeList = nullptr;
+    m_lastChunk = nullptr;
+    m_nextUnused = 0;
+
+    m_count = 0;
+    m_chunkCount = 0;
+}
+
+ysChunkPool::Chunk *ysChunkPool::NewChunk() {
+    void *block = ysAllocator::BlockAllocate(m_chunkSize, m_chunkSize);
+    if (block == nullptr) return nullptr;
+
+    Chunk *chunk = reinterpret_cast<Chunk *>(block);
+    chunk->Pool = this;
+    chunk->Next = nullptr;
+    chunk->Slots = reinterpret_cast<char *>(block) + m_headerSize;
+    chunk->SlotCount = m_slotsPerChunk;
+    memset(chunk->Occupied, 0, sizeof(chunk->Occupied));
+
+    // Chunks are kept in allocation order
+    if (m_lastChunk != nullptr) m_lastChunk->Next = chunk;
+    else m_chunks = chunk;
+
+    m_lastChunk = chunk;
+    m_nextUnused = 0;
+    m_chunkCount++;
+
+    return chunk;
+}
+
+ysChunkPool::Chunk *ysChunkPool::GetChunk(void *address) const {
+    const uintptr_t chunkMask = ~((uintptr_t)m_chunkSize - 1);
+    return reinterpret_cast<Chunk *>(reinterpret_cast<uintptr_t>(address) & chunkMask);
+}
+
+int ysChunkPool::LowestBit(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
@@ -0,0 +1,109 @@
+#include "../include/yds_compile_cache.h"
+
+#include <fstream>
+#include <string.h>
+
+ysCompileCache::ysCompileCache() : ysObject("ysCompileCache") {
+    m_sourceHash = 0;
+    m_optionsHash = 0;
+    m_outputSize = 0;
+}
+
+ysCompileCache::~ysCompileCache() {
+    /* void */
+}
+
+bool ysCompileCache::Load(const char *fname) {
+    Clear();
+
+    std::ifstream file(fname, std::ios::in | std::ios::binary);
+    if (!file.is_open()) return false;
+
+    FileHeader header;
+    file.read((char *)&header, sizeof(FileHeader));
+
+    if (file.gcount() != sizeof(FileHeader) ||
+        header.Magic != FileMagic ||
+        header.Version != FileVersion ||
+        header.EntryCount < 0)
+    {
+        return false;
+    }
+
+    // Check the size before allocating, the count could be anything
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    if (size != (std::streamoff)(sizeof(FileHeader) + sizeof(Entry) * (size_t)header.EntryCount)) return false;
+
+    file.seekg(sizeof(FileHeader));
+    m_entries.AllocateUninitialized(header.EntryCount);
+    file.read((char *)m_entries.GetBuffer(), sizeof(Entry) * header.EntryCount);
+
+    if (!file) {
+        Clear();
+        return false;
+    }
+
+    for (int i = 0; i < header.EntryCount; i++) {
+        m_entries[i].MaterialName[63] = '\0';
+        m_lookup.emplace(m_entries[i].Key, i);
+    }
+
+    m_sourceHash = header.SourceHash;
+    m_optionsHash = header.OptionsHash;
+    m_outputSize = header.OutputSize;
+
+    return true;
+}
+
+ysError ysCompileCache::Save(const char *fname) {
+    YDS_ERROR_DECLARE("Save");
+
+    std::ofstream file(fname, std::ios::out | std::ios::binary);
+    if (!file.is_open()) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+
+    FileHeader header;
+    memset(&header, 0, sizeof(FileHeader));
+
+    header.Magic = FileMagic;
+    header.Version = FileVersion;
+    header.EntryCount = m_entries.GetNumObjects();
+    header.SourceHash = m_sourceHash;
+    header.OptionsHash = m_optionsHash;
+    header.OutputSize = m_outputSize;
+
+    file.write((const char *)&header, sizeof(FileHeader));
+    file.write((const char *)m_entries.GetBuffer(), sizeof(Entry) * header.EntryCount);
+
+    if (!file.good()) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+void ysCompileCache::Clear() {
+    m_entries.Clear();
+    m_lookup.clear();
+
+    m_sourceHash = 0;
+    m_optionsHash = 0;
+    m_outputSize = 0;
+}
+
+void ysCompileCache::AddEntry(const Entry &entry) {
+    const int index = m_entries.GetNumObjects();
+
+    // Padding is written to the file as is
+    Entry &newEntry = m_entries.New();
+    memset(&newEntry, 0, sizeof(Entry));
+    newEntry.Key = entry.Key;
+    newEntry.MaterialFlags = entry.MaterialFlags;
+    memcpy(newEntry.MaterialName, entry.MaterialName, sizeof(newEntry.MaterialName));
+    newEntry.MaterialName[63] = '\0';
+
+    m_lookup.emplace(entry.Key, index);
+}
+
+int ysCompileCache::Find(uint64_t key) const {
+    auto it = m_lookup.find(key);
+    return (it == m_lookup.end()) ? -1 : it->second;
+}
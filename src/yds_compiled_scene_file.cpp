@@ -0,0 +1,141 @@
+#include "../include/yds_compiled_scene_file.h"
+
+#include <fstream>
+
+ysCompiledSceneFile::ysCompiledSceneFile() : ysObject("ysCompiledSceneFile") {
+    m_header = nullptr;
+    m_objects = nullptr;
+}
+
+ysCompiledSceneFile::~ysCompiledSceneFile() {
+    Close();
+}
+
+ysError ysCompiledSceneFile::Open(const char *fname) {
+    YDS_ERROR_DECLARE("Open");
+
+    if (m_header != nullptr) return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+
+    YDS_NESTED_ERROR_CALL(m_file.Open(fname));
+
+    if (m_file.GetSize() < sizeof(FileHeader)) {
+        m_file.Close();
+        return YDS_ERROR_RETURN(ysError::YDS_INVALID_FILE_TYPE);
+    }
+
+    m_header = reinterpret_cast<const FileHeader *>(m_file.GetData());
+    if (m_header->Magic != ysGeometryExportFile::FileMagic) {
+        Close();
+        return YDS_ERROR_RETURN(ysError::YDS_INVALID_FILE_TYPE);
+    }
+
+    if (m_header->Version != ysGeometryExportFile::FileVersion) {
+        Close();
+        return YDS_ERROR_RETURN(ysError::YDS_UNSUPPORTED_FILE_VERSION);
+    }
+
+    m_objects = reinterpret_cast<const ObjectTableEntry *>(m_file.GetData() + m_header->ObjectTableOffset);
+    if (!Validate()) {
+        Close();
+        return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+    }
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+void ysCompiledSceneFile::Close() {
+    m_file.Close();
+
+    m_header = nullptr;
+    m_objects = nullptr;
+}
+
+bool ysCompiledSceneFile::IsCurrentVersion(const char *fname) {
+    std::ifstream file(fname, std::ios::in | std::ios::binary);
+    if (!file.is_open()) return false;
+
+    FileHeader header;
+    file.read((char *)&header, sizeof(FileHeader));
+
+    return file.gcount() == sizeof(FileHeader) &&
+        header.Magic == ysGeometryExportFile::FileMagic &&
+        header.Version == ysGeometryExportFile::FileVersion;
+}
+
+const void *ysCompiledSceneFile::GetIndices(const ObjectTableEntry *entry) const {
+    return GetIndexData() + (int64_t)entry->IndexOffset * ysGeometryExportFile::GetIndexSize(entry->Header);
+}
+
+const int *ysCompiledSceneFile::GetBoneMap(const ObjectTableEntry *entry) const {
+    if (entry->BoneMapOffset < 0) return nullptr;
+    return reinterpret_cast<const int *>(m_file.GetData() + entry->BoneMapOffset);
+}
+
+const float *ysCompiledSceneFile::GetPrimitiveData(const ObjectTableEntry *entry) const {
+    if (entry->PrimitiveDataOffset < 0) return nullptr;
+    return reinterpret_cast<const float *>(m_file.GetData() + entry->PrimitiveDataOffset);
+}
+
+const ysObjectData::Meshlet *ysCompiledSceneFile::GetMeshlets(const ObjectTableEntry *entry) const {
+    if (entry->MeshletOffset < 0) return nullptr;
+    return reinterpret_cast<const ysObjectData::Meshlet *>(m_file.GetData() + entry->MeshletOffset);
+}
+
+bool ysCompiledSceneFile::InBounds(int64_t offset, int64_t size) const {
+    return offset >= 0 && size >= 0 && offset + size <= (int64_t)m_file.GetSize();
+}
+
+bool ysCompiledSceneFile::Validate() const {
+    const int alignment = ysGeometryExportFile::PayloadAlignment;
+
+    if (m_header->ObjectCount < 0) return false;
+    if (!InBounds(m_header->CustomDataOffset, m_header->CustomDataSize)) return false;
+    if (!InBounds(m_header->ObjectTableOffset, (int64_t)sizeof(ObjectTableEntry) * m_header->ObjectCount)) return false;
+    if (!InBounds(m_header->VertexDataOffset, m_header->VertexDataSize)) return false;
+    if (!InBounds(m_header->IndexDataOffset, m_header->IndexDataSize)) return false;
+
+    if ((m_header->ObjectTableOffset % alignment) != 0) return false;
+    if ((m_header->VertexDataOffset % alignment) != 0) return false;
+    if ((m_header->IndexDataOffset % alignment) != 0) return false;
+
+    // Every object must stay inside the sections it points into so that
+    // the loader doesn't have to check anything
+    for (int i = 0; i < m_header->ObjectCount; i++) {
+        const ObjectTableEntry &entry = m_objects[i];
+        const ObjectOutputHeader &header = entry.Header;
+
+        if (header.ObjectType == ysObjectData::TYPE_GEOMETRY) {
+            if (header.NumVertices < 0 || header.NumFaces < 0) return false;
+            if (entry.VertexOffset < 0) return false;
+
+            // Empty meshes are written without any vertex data
+            if (header.NumVertices == 0) {
+                if (header.VertexDataSize != 0) return false;
+            }
+            else {
+                if (header.VertexDataSize <= 0 || (header.VertexDataSize % header.NumVertices) != 0) return false;
+
+                const int stride = header.VertexDataSize / header.NumVertices;
+                if ((entry.VertexOffset % stride) != 0) return false;
+            }
+
+            if ((int64_t)entry.VertexOffset + header.VertexDataSize > m_header->VertexDataSize) return false;
+
+            const int64_t indexSize = ysGeometryExportFile::GetIndexSize(header);
+            const int64_t indexCount = (int64_t)header.NumFaces * 3;
+            if (entry.IndexOffset < 0 || (entry.IndexOffset + indexCount) * indexSize > m_header->IndexDataSize) return false;
+
+            if (header.NumMeshlets < 0 || (header.NumMeshlets > 0 && entry.MeshletOffset < 0)) return false;
+
+            if (header.NumBones > 0 && entry.BoneMapOffset < 0) return false;
+        }
+
+        if (entry.BoneMapOffset >= 0 && !InBounds(entry.BoneMapOffset, (int64_t)sizeof(int) * header.NumBones)) return false;
+        if (entry.PrimitiveDataOffset >= 0 && !InBounds(entry.PrimitiveDataOffset, 2 * sizeof(float))) return false;
+        if (entry.MeshletOffset >= 0 && !InBounds(entry.MeshletOffset, (int64_t)sizeof(ysObjectData::Meshlet) * header.NumMeshlets)) return false;
+
+        if (header.ObjectType == ysObjectData::TYPE_PLANE && entry.PrimitiveDataOffset < 0) return false;
+    }
+
+    return true;
+}
@@ -4,6 +4,7 @@ ysContextObject::ysContextObject() : ysObject("CONTEXT_OBJECT")
 {
 
 	m_api = API_UNKNOWN;
+	m_handle = ysHandle::Null();
 	YDS_ERROR_RAISE(ysError::YDS_NO_PLATFORM);
 
 }
@@ -12,6 +13,7 @@ ysContextObject::ysContextObject(const char *typeID, DEVICE_API API) : ysObject(
 {
 
 	m_api = API;
+	m_handle = ysHandle::Null();
 
 }
 
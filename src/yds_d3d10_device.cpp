@@ -92,7 +92,7 @@ ysError ysD3D10Device::CreateRenderingContext(ysRenderingContext **context, ysWi
 		return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OBTAIN_DEVICE);
 	}
 
-	ysD3D10Context *newContext = m_renderingContexts.NewGeneric<ysD3D10Context>();
+	ysD3D10Context *newContext = NewObject<ysD3D10Context>(m_renderingContexts);
 	newContext->m_targetWindow = window;
 
 	// Create the swap chain
@@ -122,7 +122,7 @@ ysError ysD3D10Device::CreateRenderingContext(ysRenderingContext **context, ysWi
 	pDXGIDevice->Release();
 
 	if (FAILED(result)) {
-		m_renderingContexts.Delete(newContext->GetIndex());
+		DeleteObject(m_renderingContexts, newContext);
 		*context = NULL;
 
 		return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_SWAP_CHAIN);
@@ -281,12 +281,12 @@ ysError ysD3D10Device::CreateOnScreenRenderTarget(ysRenderTarget **newTarget, ys
 	if (context == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 	if (context->GetAttachedRenderTarget() != NULL) return YDS_ERROR_RETURN(ysError::YDS_CONTEXT_ALREADY_HAS_RENDER_TARGET);
 
-	ysD3D10RenderTarget *newRenderTarget = m_renderTargets.NewGeneric<ysD3D10RenderTarget>();
+	ysD3D10RenderTarget *newRenderTarget = NewObject<ysD3D10RenderTarget>(m_renderTargets);
 
     ysError result = CreateD3D10OnScreenRenderTarget(newRenderTarget, context, depthBuffer);
 
 	if (result != ysError::YDS_NO_ERROR) {
-		m_renderTargets.Delete(newRenderTarget->GetIndex());
+		DeleteObject(m_renderTargets, newRenderTarget);
 		return YDS_ERROR_RETURN(result);
 	}
 
@@ -301,12 +301,12 @@ ysError ysD3D10Device::CreateOffScreenRenderTarget(ysRenderTarget **newTarget, i
 	if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 	*newTarget = NULL;
 
-	ysD3D10RenderTarget *d3d10Target = m_renderTargets.NewGeneric<ysD3D10RenderTarget>();
+	ysD3D10RenderTarget *d3d10Target = NewObject<ysD3D10RenderTarget>(m_renderTargets);
 
     ysError result = CreateD3D10OffScreenRenderTarget(d3d10Target, width, height, format, sampleCount, depthBuffer);
 
 	if (result != ysError::YDS_NO_ERROR) {
-		m_renderTargets.Delete(d3d10Target->GetIndex());
+		DeleteObject(m_renderTargets, d3d10Target);
 		return YDS_ERROR_RETURN(result);
 	}
 
@@ -321,7 +321,7 @@ ysError ysD3D10Device::CreateSubRenderTarget(ysRenderTarget **newTarget, ysRende
 	if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 	if (parent->GetType() == ysRenderTarget::RENDER_TARGET_SUBDIVISION) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-	ysD3D10RenderTarget *newRenderTarget = m_renderTargets.NewGeneric<ysD3D10RenderTarget>();
+	ysD3D10RenderTarget *newRenderTarget = NewObject<ysD3D10RenderTarget>(m_renderTargets);
 
 	newRenderTarget->m_type = ysRenderTarget::RENDER_TARGET_SUBDIVISION;
 	newRenderTarget->m_posX = x;
@@ -479,7 +479,7 @@ ysError ysD3D10Device::CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, cha
 		return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_GPU_BUFFER);
 	}
 
-	ysD3D10GPUBuffer *newD3D10Buffer = m_gpuBuffers.NewGeneric<ysD3D10GPUBuffer>();
+	ysD3D10GPUBuffer *newD3D10Buffer = NewObject<ysD3D10GPUBuffer>(m_gpuBuffers);
 
 	newD3D10Buffer->m_size = size;
 	newD3D10Buffer->m_mirrorToRAM = mirrorToRam;
@@ -524,7 +524,7 @@ ysError ysD3D10Device::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_GPU_BUFFER);
     }
 
-	ysD3D10GPUBuffer *newD3D10Buffer = m_gpuBuffers.NewGeneric<ysD3D10GPUBuffer>();
+	ysD3D10GPUBuffer *newD3D10Buffer = NewObject<ysD3D10GPUBuffer>(m_gpuBuffers);
 
 	newD3D10Buffer->m_size = size;
 	newD3D10Buffer->m_mirrorToRAM = mirrorToRam;
@@ -569,7 +569,7 @@ ysError ysD3D10Device::CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, c
 		return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_GPU_BUFFER);
 	}
 
-	ysD3D10GPUBuffer *newD3D10Buffer = m_gpuBuffers.NewGeneric<ysD3D10GPUBuffer>();
+	ysD3D10GPUBuffer *newD3D10Buffer = NewObject<ysD3D10GPUBuffer>(m_gpuBuffers);
 
 	newD3D10Buffer->m_size = size;
 	newD3D10Buffer->m_mirrorToRAM = mirrorToRam;
@@ -610,7 +610,7 @@ ysError ysD3D10Device::UseVertexBuffer(ysGPUBuffer *buffer, int stride, int offs
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
-ysError ysD3D10Device::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
+ysError ysD3D10Device::UseIndexBuffer(ysGPUBuffer *buffer, int offset, int indexSize) {
 	YDS_ERROR_DECLARE("UseIndexBuffer");
 
 	if (!CheckCompatibility(buffer)) return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_PLATFORMS);
@@ -620,15 +620,16 @@ ysError ysD3D10Device::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
 
 		ysD3D10GPUBuffer *d3d10Buffer = static_cast<ysD3D10GPUBuffer *>(buffer);
 
-		if (d3d10Buffer->m_bufferType == ysGPUBuffer::GPU_INDEX_BUFFER && buffer != m_activeIndexBuffer) {
-			GetDevice()->IASetIndexBuffer(d3d10Buffer->m_buffer, DXGI_FORMAT_R16_UINT, uoffset);
+		if (d3d10Buffer->m_bufferType == ysGPUBuffer::GPU_INDEX_BUFFER && (buffer != m_activeIndexBuffer || indexSize != d3d10Buffer->m_currentStride)) {
+			const DXGI_FORMAT format = (indexSize == sizeof(unsigned int)) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+			GetDevice()->IASetIndexBuffer(d3d10Buffer->m_buffer, format, uoffset);
 		}
 	}
 	else {
 		GetDevice()->IASetIndexBuffer(NULL, DXGI_FORMAT_UNKNOWN, NULL);
 	}
 
-	YDS_NESTED_ERROR_CALL( ysDevice::UseIndexBuffer(buffer, offset) );
+	YDS_NESTED_ERROR_CALL( ysDevice::UseIndexBuffer(buffer, offset, indexSize) );
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
@@ -766,7 +767,7 @@ ysError ysD3D10Device::CreateVertexShader(ysShader **newShader, const char *shad
 		return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_SHADER);
 	}
 
-	ysD3D10Shader *newD3D10Shader = m_shaders.NewGeneric<ysD3D10Shader>();
+	ysD3D10Shader *newD3D10Shader = NewObject<ysD3D10Shader>(m_shaders);
 	newD3D10Shader->m_vertexShader = vertexShader;
 	newD3D10Shader->m_shaderBlob = shaderBlob;
 
@@ -806,7 +807,7 @@ ysError ysD3D10Device::CreatePixelShader(ysShader **newShader, const char *shade
 		return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_SHADER);
 	}
 
-	ysD3D10Shader *newD3D10Shader = m_shaders.NewGeneric<ysD3D10Shader>();
+	ysD3D10Shader *newD3D10Shader = NewObject<ysD3D10Shader>(m_shaders);
 	newD3D10Shader->m_shaderBlob = shaderBlob;
 	newD3D10Shader->m_pixelShader = pixelShader;
 
@@ -864,7 +865,7 @@ ysError ysD3D10Device::CreateShaderProgram(ysShaderProgram **newProgram) {
 	if (newProgram == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 	*newProgram = NULL;
 
-	ysD3D10ShaderProgram *newD3D10Program = m_shaderPrograms.NewGeneric<ysD3D10ShaderProgram>();
+	ysD3D10ShaderProgram *newD3D10Program = NewObject<ysD3D10ShaderProgram>(m_shaderPrograms);
 	*newProgram = static_cast<ysShaderProgram *>(newD3D10Program);
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -954,7 +955,7 @@ ysError ysD3D10Device::CreateInputLayout(ysInputLayout **newInputLayout, ysShade
 		return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_INPUT_FORMAT);
 	}
 
-	ysD3D10InputLayout *newD3D10Layout = m_inputLayouts.NewGeneric<ysD3D10InputLayout>();
+	ysD3D10InputLayout *newD3D10Layout = NewObject<ysD3D10InputLayout>(m_inputLayouts);
 	newD3D10Layout->m_layout = layout;
 	
 	*newInputLayout = static_cast<ysInputLayout *>(newD3D10Layout);
@@ -1034,7 +1035,7 @@ ysError ysD3D10Device::CreateTexture(ysTexture **newTexture, const char *fname)
 		return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_MAKE_SHADER_RESOURCE_VIEW);
 	}
 
-	ysD3D10Texture *newD3D10Texture = m_textures.NewGeneric<ysD3D10Texture>();
+	ysD3D10Texture *newD3D10Texture = NewObject<ysD3D10Texture>(m_textures);
 	newD3D10Texture->m_resourceView = resourceView;
 	newD3D10Texture->m_width = desc.Width;
 	newD3D10Texture->m_height = desc.Height;
@@ -1123,6 +1124,16 @@ DXGI_FORMAT ysD3D10Device::ConvertInputLayoutFormat(ysRenderGeometryChannel::CHA
         return DXGI_FORMAT_R32G32B32A32_UINT;
     case ysRenderGeometryChannel::CHANNEL_FORMAT_R32G32B32_UINT:
         return DXGI_FORMAT_R32G32B32_UINT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16B16A16_UNORM:
+        return DXGI_FORMAT_R16G16B16A16_UNORM;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_SNORM:
+        return DXGI_FORMAT_R16G16_SNORM;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_FLOAT:
+        return DXGI_FORMAT_R16G16_FLOAT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UNORM:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UINT:
+        return DXGI_FORMAT_R8G8B8A8_UINT;
     case ysRenderGeometryChannel::CHANNEL_FORMAT_UNDEFINED:
     default:
         return DXGI_FORMAT_UNKNOWN;
@@ -99,7 +99,7 @@ ysError ysD3D11Device::CreateRenderingContext(ysRenderingContext **context, ysWi
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OBTAIN_DEVICE);
     }
 
-    ysD3D11Context *newContext = m_renderingContexts.NewGeneric<ysD3D11Context>();
+    ysD3D11Context *newContext = NewObject<ysD3D11Context>(m_renderingContexts);
     newContext->m_targetWindow = window;
 
     // Get max quality
@@ -136,7 +136,7 @@ ysError ysD3D11Device::CreateRenderingContext(ysRenderingContext **context, ysWi
     pDXGIDevice->Release();
 
     if (FAILED(result)) {
-        m_renderingContexts.Delete(newContext->GetIndex());
+        DeleteObject(m_renderingContexts, newContext);
         *context = NULL;
 
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_SWAP_CHAIN);
@@ -301,12 +301,12 @@ ysError ysD3D11Device::CreateOnScreenRenderTarget(ysRenderTarget **newTarget, ys
     if (context == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     if (context->GetAttachedRenderTarget() != NULL) return YDS_ERROR_RETURN(ysError::YDS_CONTEXT_ALREADY_HAS_RENDER_TARGET);
 
-    ysD3D11RenderTarget *newRenderTarget = m_renderTargets.NewGeneric<ysD3D11RenderTarget>();
+    ysD3D11RenderTarget *newRenderTarget = NewObject<ysD3D11RenderTarget>(m_renderTargets);
 
     ysError result = CreateD3D11OnScreenRenderTarget(newRenderTarget, context, depthBuffer);
 
     if (result != ysError::YDS_NO_ERROR) {
-        m_renderTargets.Delete(newRenderTarget->GetIndex());
+        DeleteObject(m_renderTargets, newRenderTarget);
         return YDS_ERROR_RETURN(result);
     }
 
@@ -321,12 +321,12 @@ ysError ysD3D11Device::CreateOffScreenRenderTarget(ysRenderTarget **newTarget, i
     if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     *newTarget = NULL;
 
-    ysD3D11RenderTarget *d3d11Target = m_renderTargets.NewGeneric<ysD3D11RenderTarget>();
+    ysD3D11RenderTarget *d3d11Target = NewObject<ysD3D11RenderTarget>(m_renderTargets);
 
     ysError result = CreateD3D11OffScreenRenderTarget(d3d11Target, width, height, format, sampleCount, depthBuffer);
 
     if (result != ysError::YDS_NO_ERROR) {
-        m_renderTargets.Delete(d3d11Target->GetIndex());
+        DeleteObject(m_renderTargets, d3d11Target);
         return YDS_ERROR_RETURN(result);
     }
 
@@ -341,7 +341,7 @@ ysError ysD3D11Device::CreateSubRenderTarget(ysRenderTarget **newTarget, ysRende
     if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     if (parent->GetType() == ysRenderTarget::RENDER_TARGET_SUBDIVISION) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-    ysD3D11RenderTarget *newRenderTarget = m_renderTargets.NewGeneric<ysD3D11RenderTarget>();
+    ysD3D11RenderTarget *newRenderTarget = NewObject<ysD3D11RenderTarget>(m_renderTargets);
 
     newRenderTarget->m_type = ysRenderTarget::RENDER_TARGET_SUBDIVISION;
     newRenderTarget->m_posX = x;
@@ -504,7 +504,7 @@ ysError ysD3D11Device::CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, cha
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_GPU_BUFFER);
     }
 
-    ysD3D11GPUBuffer *newD3D11Buffer = m_gpuBuffers.NewGeneric<ysD3D11GPUBuffer>();
+    ysD3D11GPUBuffer *newD3D11Buffer = NewObject<ysD3D11GPUBuffer>(m_gpuBuffers);
 
     newD3D11Buffer->m_size = size;
     newD3D11Buffer->m_mirrorToRAM = mirrorToRam;
@@ -551,7 +551,7 @@ ysError ysD3D11Device::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_GPU_BUFFER);
     }
 
-    ysD3D11GPUBuffer *newD3D11Buffer = m_gpuBuffers.NewGeneric<ysD3D11GPUBuffer>();
+    ysD3D11GPUBuffer *newD3D11Buffer = NewObject<ysD3D11GPUBuffer>(m_gpuBuffers);
 
     newD3D11Buffer->m_size = size;
     newD3D11Buffer->m_mirrorToRAM = mirrorToRam;
@@ -598,7 +598,7 @@ ysError ysD3D11Device::CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, c
 
     }
 
-    ysD3D11GPUBuffer *newD3D11Buffer = m_gpuBuffers.NewGeneric<ysD3D11GPUBuffer>();
+    ysD3D11GPUBuffer *newD3D11Buffer = NewObject<ysD3D11GPUBuffer>(m_gpuBuffers);
 
     newD3D11Buffer->m_size = size;
     newD3D11Buffer->m_mirrorToRAM = mirrorToRam;
@@ -641,7 +641,7 @@ ysError ysD3D11Device::UseVertexBuffer(ysGPUBuffer *buffer, int stride, int offs
     return YDS_ERROR_RETURN(ysDevice::UseVertexBuffer(buffer, stride, offset));
 }
 
-ysError ysD3D11Device::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
+ysError ysD3D11Device::UseIndexBuffer(ysGPUBuffer *buffer, int offset, int indexSize) {
     YDS_ERROR_DECLARE("UseIndexBuffer");
 
     if (!CheckCompatibility(buffer)) return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_PLATFORMS);
@@ -651,15 +651,16 @@ ysError ysD3D11Device::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
 
         ysD3D11GPUBuffer *d3d11Buffer = static_cast<ysD3D11GPUBuffer *>(buffer);
 
-        if (d3d11Buffer->m_bufferType == ysGPUBuffer::GPU_INDEX_BUFFER && buffer != m_activeIndexBuffer) {
-            GetImmediateContext()->IASetIndexBuffer(d3d11Buffer->m_buffer, DXGI_FORMAT_R16_UINT, uoffset);
+        if (d3d11Buffer->m_bufferType == ysGPUBuffer::GPU_INDEX_BUFFER && (buffer != m_activeIndexBuffer || indexSize != d3d11Buffer->m_currentStride)) {
+            const DXGI_FORMAT format = (indexSize == sizeof(unsigned int)) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+            GetImmediateContext()->IASetIndexBuffer(d3d11Buffer->m_buffer, format, uoffset);
         }
     }
     else {
         GetImmediateContext()->IASetIndexBuffer(NULL, DXGI_FORMAT_UNKNOWN, NULL);
     }
 
-    YDS_NESTED_ERROR_CALL(ysDevice::UseIndexBuffer(buffer, offset));
+    YDS_NESTED_ERROR_CALL(ysDevice::UseIndexBuffer(buffer, offset, indexSize));
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
@@ -794,7 +795,7 @@ ysError ysD3D11Device::CreateVertexShader(ysShader **newShader, const char *shad
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_SHADER);
     }
 
-    ysD3D11Shader *newD3D11Shader = m_shaders.NewGeneric<ysD3D11Shader>();
+    ysD3D11Shader *newD3D11Shader = NewObject<ysD3D11Shader>(m_shaders);
     newD3D11Shader->m_vertexShader = vertexShader;
     newD3D11Shader->m_shaderBlob = shaderBlob;
 
@@ -833,7 +834,7 @@ ysError ysD3D11Device::CreatePixelShader(ysShader **newShader, const char *shade
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_CREATE_SHADER);
     }
 
-    ysD3D11Shader *newD3D11Shader = m_shaders.NewGeneric<ysD3D11Shader>();
+    ysD3D11Shader *newD3D11Shader = NewObject<ysD3D11Shader>(m_shaders);
     newD3D11Shader->m_shaderBlob = shaderBlob;
     newD3D11Shader->m_pixelShader = pixelShader;
 
@@ -913,7 +914,7 @@ ysError ysD3D11Device::CreateShaderProgram(ysShaderProgram **newProgram) {
     if (newProgram == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     *newProgram = NULL;
 
-    ysD3D11ShaderProgram *newD3D11Program = m_shaderPrograms.NewGeneric<ysD3D11ShaderProgram>();
+    ysD3D11ShaderProgram *newD3D11Program = NewObject<ysD3D11ShaderProgram>(m_shaderPrograms);
     *newProgram = static_cast<ysShaderProgram *>(newD3D11Program);
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -1003,7 +1004,7 @@ ysError ysD3D11Device::CreateInputLayout(ysInputLayout **newInputLayout, ysShade
         return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_INPUT_FORMAT);
     }
 
-    ysD3D11InputLayout *newD3D11Layout = m_inputLayouts.NewGeneric<ysD3D11InputLayout>();
+    ysD3D11InputLayout *newD3D11Layout = NewObject<ysD3D11InputLayout>(m_inputLayouts);
     newD3D11Layout->m_layout = layout;
 
     *newInputLayout = static_cast<ysInputLayout *>(newD3D11Layout);
@@ -1087,7 +1088,7 @@ ysError ysD3D11Device::CreateTexture(ysTexture **newTexture, const char *fname)
         return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_MAKE_SHADER_RESOURCE_VIEW);
     }
 
-    ysD3D11Texture *newD3D11Texture = m_textures.NewGeneric<ysD3D11Texture>();
+    ysD3D11Texture *newD3D11Texture = NewObject<ysD3D11Texture>(m_textures);
     newD3D11Texture->m_resourceView = resourceView;
     newD3D11Texture->m_width = desc.Width;
     newD3D11Texture->m_height = desc.Height;
@@ -1179,6 +1180,16 @@ DXGI_FORMAT ysD3D11Device::ConvertInputLayoutFormat(ysRenderGeometryChannel::CHA
         return DXGI_FORMAT_R32G32B32A32_UINT;
     case ysRenderGeometryChannel::CHANNEL_FORMAT_R32G32B32_UINT:
         return DXGI_FORMAT_R32G32B32_UINT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16B16A16_UNORM:
+        return DXGI_FORMAT_R16G16B16A16_UNORM;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_SNORM:
+        return DXGI_FORMAT_R16G16_SNORM;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_FLOAT:
+        return DXGI_FORMAT_R16G16_FLOAT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UNORM:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UINT:
+        return DXGI_FORMAT_R8G8B8A8_UINT;
     case ysRenderGeometryChannel::CHANNEL_FORMAT_UNDEFINED:
     default:
         return DXGI_FORMAT_UNKNOWN;
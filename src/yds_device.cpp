@@ -3,6 +3,7 @@
 #include "../include/yds_opengl_device.h"
 #include "../include/yds_d3d11_device.h"
 #include "../include/yds_d3d10_device.h"
+#include "../include/yds_null_device.h"
 
 ysDevice::ysDevice() : ysContextObject("API_DEVICE", API_UNKNOWN) {
 	m_activeRenderTarget =		NULL;
@@ -31,7 +32,14 @@ ysDevice::ysDevice(DEVICE_API API) : ysContextObject("API_DEVICE", API) {
 }
 
 ysDevice::~ysDevice() {
-    /* void */
+    // Same order the holders used to be destroyed in
+    DeleteAllObjects(m_textures);
+    DeleteAllObjects(m_inputLayouts);
+    DeleteAllObjects(m_shaderPrograms);
+    DeleteAllObjects(m_shaders);
+    DeleteAllObjects(m_gpuBuffers);
+    DeleteAllObjects(m_renderTargets);
+    DeleteAllObjects(m_renderingContexts);
 }
 
 ysError ysDevice::CreateDevice(ysDevice **newDevice, DEVICE_API API) {
@@ -52,6 +60,9 @@ ysError ysDevice::CreateDevice(ysDevice **newDevice, DEVICE_API API) {
 	case OPENGL4_0:
 		*newDevice = new ysOpenGLDevice;
 		break;
+	case NULL_DEVICE:
+		*newDevice = new ysNullDevice;
+		break;
 	}
 
     return YDS_ERROR_RETURN_STATIC(ysError::YDS_NO_ERROR);
@@ -62,7 +73,7 @@ ysError ysDevice::DestroyRenderingContext(ysRenderingContext *&context) {
 
 	if (context == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-	m_renderingContexts.Delete(context->GetIndex());
+	YDS_NESTED_ERROR_CALL( DeleteObject(m_renderingContexts, context) );
 	context = NULL;
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -146,7 +157,7 @@ ysError ysDevice::DestroyRenderTarget(ysRenderTarget *&renderTarget) {
 
 	if (!renderTarget) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-	YDS_NESTED_ERROR_CALL( m_renderTargets.Delete(renderTarget->GetIndex()) );
+	YDS_NESTED_ERROR_CALL( DeleteObject(m_renderTargets, renderTarget) );
 	renderTarget = NULL;
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -169,12 +180,18 @@ ysError ysDevice::UseVertexBuffer(ysGPUBuffer *buffer, int stride, int offset) {
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
-ysError ysDevice::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
+ysError ysDevice::UseIndexBuffer(ysGPUBuffer *buffer, int offset, int indexSize) {
 	YDS_ERROR_DECLARE("UseIndexBuffer");
 
     if (buffer) {
-        if (buffer->m_bufferType == ysGPUBuffer::GPU_INDEX_BUFFER)
+        if (indexSize != sizeof(unsigned short) && indexSize != sizeof(unsigned int)) {
+            return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+        }
+
+        if (buffer->m_bufferType == ysGPUBuffer::GPU_INDEX_BUFFER) {
             m_activeIndexBuffer = buffer;
+            m_activeIndexBuffer->m_currentStride = indexSize;
+        }
         else return YDS_ERROR_RETURN(ysError::YDS_INVALID_GPU_BUFFER_TYPE);
     }
 	else {
@@ -244,13 +261,14 @@ ysError ysDevice::DestroyGPUBuffer(ysGPUBuffer *&buffer) {
 	YDS_ERROR_DECLARE("DestroyGPUBuffer");
 
 	if (!buffer) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+	if (m_gpuBuffers.Get(buffer->GetHandle()) != buffer) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
 	if (buffer->m_mirrorToRAM) {
 		delete [] buffer->m_RAMMirror;
         buffer->m_RAMMirror = NULL;
 	}
 
-	YDS_NESTED_ERROR_CALL( m_gpuBuffers.Delete(buffer->GetIndex()) );
+	YDS_NESTED_ERROR_CALL( DeleteObject(m_gpuBuffers, buffer) );
 	buffer = NULL;
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR); 
@@ -262,7 +280,7 @@ ysError ysDevice::DestroyShader(ysShader *&shader) {
 	if (shader == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 	if (!CheckCompatibility(shader)) return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_PLATFORMS);
 
-	YDS_NESTED_ERROR_CALL( m_shaders.Delete(shader->GetIndex()) );
+	YDS_NESTED_ERROR_CALL( DeleteObject(m_shaders, shader) );
 	shader = NULL;
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -281,7 +299,7 @@ ysError ysDevice::DestroyShaderProgram(ysShaderProgram *&program, bool destroySh
 		}
 	}
 
-	YDS_NESTED_ERROR_CALL( m_shaderPrograms.Delete(program->GetIndex()) );
+	YDS_NESTED_ERROR_CALL( DeleteObject(m_shaderPrograms, program) );
 	program = NULL;
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -334,7 +352,7 @@ ysError ysDevice::DestroyInputLayout(ysInputLayout *&layout) {
 
 	if (!CheckCompatibility(layout)) return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_PLATFORMS);
 
-	YDS_NESTED_ERROR_CALL( m_inputLayouts.Delete(layout->GetIndex()) );
+	YDS_NESTED_ERROR_CALL( DeleteObject(m_inputLayouts, layout) );
 	layout = NULL;
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -369,7 +387,7 @@ ysError ysDevice::DestroyTexture(ysTexture *&texture) {
 
 	if (!CheckCompatibility(texture)) return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_PLATFORMS);
 
-	YDS_NESTED_ERROR_CALL( m_textures.Delete(texture->GetIndex()) );
+	YDS_NESTED_ERROR_CALL( DeleteObject(m_textures, texture) );
 	texture = NULL;
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
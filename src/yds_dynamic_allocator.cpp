@@ -140,16 +140,19 @@ void ysDynamicAllocator::CreateBuffer(int size) {
 	m_maxSize = size;
 
 	if (!m_parent) {
-		m_data = new char[size];
+		// Root buffers are mapped directly (already zero filled) and
+		// backed by huge pages if they are large enough
+		m_data = ysAllocator::PageAllocate(size, true);
+		YS_TRACK_ALLOCATION(m_memoryTag, size);
 	}
 	else {
 		m_data = m_parent->AllocateBlock(size);
-	}
 
 #ifdef _DEBUG
-	// To make the buffer easier to see while debugging
-	memset(m_data, 0, size);
+		// To make the buffer easier to see while debugging
+		memset(m_data, 0, size);
 #endif
+	}
 }
 
 void ysDynamicAllocator::CreateBlocks(int maxBlocks) {
@@ -188,7 +191,8 @@ void ysDynamicAllocator::CreateBlocks(int maxBlocks) {
 
 void ysDynamicAllocator::Destroy() {
 	if (!m_parent) {
-		delete [] m_data;
+		if (m_data != NULL) YS_TRACK_FREE(m_memoryTag, m_maxSize);
+		ysAllocator::PageFree(m_data, m_maxSize);
 		delete [] m_blockPool;
         delete[] m_blocks;
 	}
@@ -6,6 +6,17 @@
 
 #include "../include/yds_error_handler.h"
 
+namespace {
+
+	struct CallStack {
+		int Level;
+		const char *Calls[ysErrorSystem::MAX_STACK_LEVEL];
+	};
+
+	thread_local CallStack ThreadCallStack = { 0, { 0 } };
+
+} /* namespace */
+
 ysErrorSystem *ysErrorSystem::g_instance = NULL;
 
 ysErrorSystem::ysErrorSystem() {
@@ -13,9 +24,6 @@ ysErrorSystem::ysErrorSystem() {
 		YDS_ERROR_RAISE(ysError::YDS_MULTIPLE_ERROR_SYSTEMS);
 
 	g_instance = this;
-
-    memset((void *)m_callStack, 0, sizeof(m_callStack));
-	m_stackLevel = 0;
 }
 
 ysErrorSystem::~ysErrorSystem() {
@@ -33,27 +41,34 @@ void ysErrorSystem::Destroy() {
 
 ysError ysErrorSystem::RaiseError(ysError error, unsigned int line, ysObject *object, const char *file, const char *msg, bool affectStack) {
 	if (error != ysError::YDS_NO_ERROR) {
+		std::lock_guard<std::mutex> lock(m_handlerLock);
 		for(int i = 0; i < m_errorHandlers.GetNumObjects(); i++) {
 			m_errorHandlers.Get(i)->OnError(error, line, object, file);
 		}
 	}
 
 	if (affectStack) {
-		m_stackLevel--;
+		ThreadCallStack.Level--;
 	}
 
 	return error;
 }
 
+const char *ysErrorSystem::GetCall() const {
+	const CallStack &stack = ThreadCallStack;
+	return (stack.Level > 0) ? stack.Calls[stack.Level - 1] : "<NO CALL>";
+}
+
 void ysErrorSystem::StackRaise(const char *callName) {
-	if (m_stackLevel < 0) {
+	CallStack &stack = ThreadCallStack;
+	if (stack.Level < 0) {
 		return;
 	}
 
-	m_callStack[m_stackLevel] = callName;
-	m_stackLevel++;
+	stack.Calls[stack.Level] = callName;
+	stack.Level++;
 }
 
 void ysErrorSystem::StackDescend() {
-    m_stackLevel--;
+	ThreadCallStack.Level--;
 }
@@ -0,0 +1,246 @@
+#include "../include/yds_frame_arena.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+ysFrameArena::ysFrameArena() : ysMemoryAllocator("FRAME_ARENA") {
+    for (int i = 0; i < 2; i++) {
+        m_buffers[i].FirstPage = nullptr;
+        m_buffers[i].CurrentPage = nullptr;
+        m_buffers[i].Offset = 0;
+        m_buffers[i].Usage = 0;
+    }
+
+    m_activeBuffer = 0;
+    m_doubleBuffered = false;
+
+    m_pageSize = DefaultSize;
+    m_retainedSize = DefaultSize;
+    m_scopeDepth = 0;
+
+    m_framePeak = 0;
+    m_lastFramePeak = 0;
+    m_peakUsage = 0;
+}
+
+ysFrameArena::~ysFrameArena() {
+    Destroy();
+}
+
+void ysFrameArena::Initialize(int size, bool doubleBuffered) {
+    Destroy();
+
+    m_pageSize = (size + Alignment - 1) & ~(Alignment - 1);
+    m_doubleBuffered = doubleBuffered;
+
+    const int bufferCount = doubleBuffered ? 2 : 1;
+    for (int i = 0; i < bufferCount; i++) {
+        m_buffers[i].FirstPage = NewPage(m_pageSize);
+        m_buffers[i].CurrentPage = m_buffers[i].FirstPage;
+        m_buffers[i].Offset = 0;
+        m_buffers[i].Usage = 0;
+    }
+}
+
+void ysFrameArena::Destroy() {
+    for (int i = 0; i < 2; i++) {
+        FreePages(m_buffers[i].FirstPage);
+
+        m_buffers[i].FirstPage = nullptr;
+        m_buffers[i].CurrentPage = nullptr;
+        m_buffers[i].Offset = 0;
+        m_buffers[i].Usage = 0;
+    }
+
+    m_activeBuffer = 0;
+}
+
+void *ysFrameArena::AllocateBlock(int size, int numObjects) {
+    if (!IsInitialized()) Initialize(m_pageSize, m_doubleBuffered);
+
+    size = (size + Alignment - 1) & ~(Alignment - 1);
+
+    Buffer &buffer = m_buffers[m_activeBuffer];
+
+    void *block;
+    if (buffer.Offset + size <= buffer.CurrentPage->Size) {
+        block = buffer.CurrentPage->Data + buffer.Offset;
+        buffer.Offset += size;
+    }
+    else {
+        block = AllocateFromNewPage(size);
+        if (block == nullptr) return nullptr;
+    }
+
+    buffer.Usage += size;
+    if (buffer.Usage > m_framePeak) m_framePeak = buffer.Usage;
+
+    return block;
+}
+
+int ysFrameArena::FreeBlock(void *block) {
+    return 0;
+}
+
+void ysFrameArena::Reset() {
+    m_lastFramePeak = m_framePeak;
+    if (m_framePeak > m_peakUsage) m_peakUsage = m_framePeak;
+    m_framePeak = 0;
+
+    if (!IsInitialized()) return;
+
+    if (m_doubleBuffered) m_activeBuffer ^= 1;
+    ResetBuffer(&m_buffers[m_activeBuffer]);
+}
+
+ysFrameArena::Marker ysFrameArena::GetMarker() const {
+    const Buffer &buffer = m_buffers[m_activeBuffer];
+
+    Marker marker;
+    marker.CurrentPage = buffer.CurrentPage;
+    marker.Offset = buffer.Offset;
+    marker.Usage = buffer.Usage;
+
+    return marker;
+}
+
+void ysFrameArena::FreeToMarker(const Marker &marker) {
+    Buffer &buffer = m_buffers[m_activeBuffer];
+
+    if (marker.CurrentPage == nullptr) {
+        // Marker was taken before the arena was initialized
+        buffer.CurrentPage = buffer.FirstPage;
+        buffer.Offset = 0;
+        buffer.Usage = 0;
+    }
+    else {
+        buffer.CurrentPage = marker.CurrentPage;
+        buffer.Offset = marker.Offset;
+        buffer.Usage = marker.Usage;
+    }
+}
+
+void ysFrameArena::Trim(int retainedSize) {
+    Page *current = m_buffers[m_activeBuffer].CurrentPage;
+    if (current == nullptr) return;
+
+    int retained = 0;
+    Page **link = &current->Next;
+    while (*link != nullptr) {
+        Page *page = *link;
+        if (retained + page->Size <= retainedSize) {
+            retained += page->Size;
+            link = &page->Next;
+        }
+        else {
+            *link = page->Next;
+            page->Next = nullptr;
+            FreePages(page);
+        }
+    }
+}
+
+int ysFrameArena::GetCapacity() const {
+    int capacity = 0;
+    for (Page *page = m_buffers[m_activeBuffer].FirstPage; page != nullptr; page = page->Next) {
+        capacity += page->Size;
+    }
+
+    return capacity;
+}
+
+ysFrameArena *ysFrameArena::GetThreadArena() {
+    static thread_local ysFrameArena arena;
+    return &arena;
+}
+
+ysFrameArena::Page *ysFrameArena::NewPage(int size) {
+    // The page header and its data share a single allocation
+    const size_t blockSize = sizeof(Page) + size + Alignment - 1;
+
+    void *block;
+    size_t mappedSize = 0;
+    if (size >= HugePageThreshold) {
+        block = ysAllocator::PageAllocate(blockSize, true);
+        if (block == nullptr) return nullptr;
+
+        mappedSize = blockSize;
+        YS_TRACK_ALLOCATION(m_memoryTag, blockSize);
+    }
+    else {
+        block = ysTrackedAllocate(m_memoryTag, blockSize);
+        if (block == nullptr) return nullptr;
+    }
+
+    Page *page = reinterpret_cast<Page *>(block);
+    uintptr_t data = reinterpret_cast<uintptr_t>(page + 1);
+    data = (data + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+
+    page->Next = nullptr;
+    page->Data = reinterpret_cast<char *>(data);
+    page->Size = size;
+    page->MappedSize = mappedSize;
+
+    return page;
+}
+
+void ysFrameArena::FreePages(Page *page) {
+    while (page != nullptr) {
+        Page *next = page->Next;
+
+        if (page->MappedSize > 0) {
+            YS_TRACK_FREE(m_memoryTag, page->MappedSize);
+            ysAllocator::PageFree(page, page->MappedSize);
+        }
+        else {
+            ysTrackedFree(page);
+        }
+
+        page = next;
+    }
+}
+
+void *ysFrameArena::AllocateFromNewPage(int size) {
+    Buffer &buffer = m_buffers[m_activeBuffer];
+    Page *current = buffer.CurrentPage;
+
+    // Pages after the current one are left over from before a FreeToMarker()
+    // call and can be reused
+    Page *next = current->Next;
+    if (next == nullptr || next->Size < size) {
+        Page *newPage = NewPage((size > m_pageSize) ? size : m_pageSize);
+        if (newPage == nullptr) return nullptr;
+
+        newPage->Next = next;
+        current->Next = newPage;
+        next = newPage;
+    }
+
+    buffer.CurrentPage = next;
+    buffer.Offset = size;
+
+    return next->Data;
+}
+
+void ysFrameArena::ResetBuffer(Buffer *buffer) {
+    if (buffer->FirstPage->Next != nullptr) {
+        // The buffer overflowed, replace all of its pages with a single
+        // page large enough to hold everything so that the next frame
+        // doesn't have to chain pages
+        int totalSize = 0;
+        for (Page *page = buffer->FirstPage; page != nullptr; page = page->Next) {
+            totalSize += page->Size;
+        }
+
+        // Keep the old pages if the larger one can't be allocated
+        Page *newPage = NewPage(totalSize);
+        if (newPage != nullptr) {
+            FreePages(buffer->FirstPage);
+            buffer->FirstPage = newPage;
+        }
+    }
+
+    buffer->CurrentPage = buffer->FirstPage;
+    buffer->Offset = 0;
+    buffer->Usage = 0;
+}
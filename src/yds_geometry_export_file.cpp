@@ -1,7 +1,45 @@
 #include "../include/yds_geometry_export_file.h"
 
+#include "../include/yds_compiled_scene_file.h"
+#include "../include/yds_vertex_compression.h"
+
 #include <math.h>
 
+namespace {
+
+	int GreatestCommonDivisor(int a, int b) {
+		while (b != 0) {
+			const int r = a % b;
+			a = b;
+			b = r;
+		}
+
+		return a;
+	}
+
+	// Round offset up to the next multiple of alignment
+	int Align(int offset, int alignment) {
+		const int remainder = offset % alignment;
+		return (remainder == 0) ? offset : offset + (alignment - remainder);
+	}
+
+	void WritePadding(std::ofstream &file, int position, int alignedPosition) {
+		static const char Zeros[ysGeometryExportFile::PayloadAlignment] = {};
+		file.write(Zeros, alignedPosition - position);
+	}
+
+	template <typename T>
+	void WriteValue(T value, char **location) {
+		memcpy(*location, &value, sizeof(T));
+		(*location) += sizeof(T);
+	}
+
+	bool HasBones(ysObjectData *object) {
+		return object->m_boneWeights.IsActive() && object->m_boneIndices.GetNumObjects() > 0;
+	}
+
+} /* namespace */
+
 ysGeometryExportFile::ysGeometryExportFile() : ysObject("ysGeometryExportFile") {
     /* void */
 }
@@ -13,6 +51,7 @@ ysGeometryExportFile::~ysGeometryExportFile() {
 ysError ysGeometryExportFile::Open(const char *fname) {
 	YDS_ERROR_DECLARE("Open");
 
+	Reset();
 	m_file.open(fname, std::ios::binary);
 
 	if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
@@ -20,8 +59,112 @@ ysError ysGeometryExportFile::Open(const char *fname) {
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
-void ysGeometryExportFile::Close() {
-	if (m_file.is_open()) m_file.close();
+ysError ysGeometryExportFile::Close() {
+	YDS_ERROR_DECLARE("Close");
+
+	if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+
+	const int objectCount = m_objects.GetNumObjects();
+
+	// Layout
+	FileHeader header;
+	memset(&header, 0, sizeof(FileHeader));
+
+	header.Magic = FileMagic;
+	header.Version = FileVersion;
+	header.ObjectCount = objectCount;
+
+	int offset = Align((int)sizeof(FileHeader), PayloadAlignment);
+
+	header.CustomDataOffset = offset;
+	header.CustomDataSize = m_customData.GetNumObjects();
+	offset = Align(offset + header.CustomDataSize, PayloadAlignment);
+
+	header.ObjectTableOffset = offset;
+	offset = Align(offset + (int)sizeof(ObjectTableEntry) * objectCount, PayloadAlignment);
+
+	const int extraDataOffset = offset;
+	offset = Align(offset + m_extraData.GetNumObjects(), PayloadAlignment);
+
+	header.VertexDataOffset = offset;
+	header.VertexDataSize = m_vertexData.GetNumObjects();
+	offset = Align(offset + header.VertexDataSize, PayloadAlignment);
+
+	header.IndexDataOffset = offset;
+	header.IndexDataSize = m_indexData.GetNumObjects();
+
+	// Extra data offsets were recorded relative to the extra data block
+	for (int i = 0; i < objectCount; i++) {
+		ObjectTableEntry &entry = m_objects[i];
+		if (entry.BoneMapOffset >= 0) entry.BoneMapOffset += extraDataOffset;
+		if (entry.PrimitiveDataOffset >= 0) entry.PrimitiveDataOffset += extraDataOffset;
+		if (entry.MeshletOffset >= 0) entry.MeshletOffset += extraDataOffset;
+	}
+
+	// One write per section
+	int position = 0;
+	m_file.write((const char *)&header, sizeof(FileHeader));
+	position += (int)sizeof(FileHeader);
+
+	WritePadding(m_file, position, header.CustomDataOffset);
+	m_file.write(m_customData.GetBuffer(), header.CustomDataSize);
+	position = header.CustomDataOffset + header.CustomDataSize;
+
+	WritePadding(m_file, position, header.ObjectTableOffset);
+	m_file.write((const char *)m_objects.GetBuffer(), sizeof(ObjectTableEntry) * objectCount);
+	position = header.ObjectTableOffset + (int)sizeof(ObjectTableEntry) * objectCount;
+
+	WritePadding(m_file, position, extraDataOffset);
+	m_file.write(m_extraData.GetBuffer(), m_extraData.GetNumObjects());
+	position = extraDataOffset + m_extraData.GetNumObjects();
+
+	WritePadding(m_file, position, header.VertexDataOffset);
+	m_file.write(m_vertexData.GetBuffer(), header.VertexDataSize);
+	position = header.VertexDataOffset + header.VertexDataSize;
+
+	WritePadding(m_file, position, header.IndexDataOffset);
+	m_file.write(m_indexData.GetBuffer(), header.IndexDataSize);
+
+	const bool success = m_file.good();
+	m_file.close();
+
+	Reset();
+
+	if (!success) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+
+	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+void ysGeometryExportFile::Reset() {
+	m_customData.Destroy();
+	m_objects.Destroy();
+	m_extraData.Destroy();
+	m_vertexData.Destroy();
+	m_indexData.Destroy();
+}
+
+char *ysGeometryExportFile::AppendVertexData(int size, int stride, int *offset) {
+	// The object's first vertex has to be addressable as a base vertex
+	// index, so the offset must be a multiple of the stride as well
+	const int alignment = (stride / GreatestCommonDivisor(stride, PayloadAlignment)) * PayloadAlignment;
+
+	const int start = m_vertexData.GetNumObjects();
+	*offset = Align(start, alignment);
+
+	char *padding = m_vertexData.AppendUninitialized(*offset - start + size);
+	if (*offset > start) memset(padding, 0, *offset - start);
+
+	return m_vertexData.GetBuffer() + *offset;
+}
+
+char *ysGeometryExportFile::AppendIndexData(int size, int *offset) {
+	const int start = m_indexData.GetNumObjects();
+	*offset = Align(start, PayloadAlignment);
+
+	char *padding = m_indexData.AppendUninitialized(*offset - start + size);
+	if (*offset > start) memset(padding, 0, *offset - start);
+
+	return m_indexData.GetBuffer() + *offset;
 }
 
 void ysGeometryExportFile::FillOutputHeader(ysObjectData* object, ObjectOutputHeader* header) {
@@ -194,58 +337,255 @@ int ysGeometryExportFile::PackVertexData(ysObjectData *object, int maxBonesPerVe
 	return packedSize;
 }
 
+bool ysGeometryExportFile::CanCompress(ysObjectData *object) {
+	if (object->m_objectStatistics.NumVertices <= 0) return false;
+	if (!HasBones(object)) return true;
+
+	// Bone indices have to fit in a byte with one value left over for unused slots
+	for (int vert = 0; vert < object->m_objectStatistics.NumVertices; vert++) {
+		const ysObjectData::BoneWeights &weights = object->m_boneWeights[vert];
+		for (int b = 0; b < 4 && b < weights.m_boneIndices.GetNumObjects(); b++) {
+			const int boneIndex = weights.m_boneIndices[b];
+			if (boneIndex < 0 || boneIndex >= CompressedUnusedBone) return false;
+		}
+	}
+
+	return true;
+}
+
+int ysGeometryExportFile::PackCompressedVertexData(ysObjectData *object, const ObjectOutputHeader &header, void **output) {
+	const int nVertices = object->m_objectStatistics.NumVertices;
+	const int nChannels = object->m_channels.IsActive() ? object->m_objectStatistics.NumUVChannels : 0;
+	const bool bones = HasBones(object);
+
+	int vertexSize = 4 * sizeof(unsigned short);
+	vertexSize += nChannels * 2 * sizeof(unsigned short);
+	if (object->m_normals.IsActive()) vertexSize += 2 * sizeof(short);
+	if (bones) vertexSize += 8 * sizeof(unsigned char);
+	if (object->m_tangents.IsActive()) vertexSize += 2 * sizeof(short);
+
+	// UV coordinates are indexed per face corner, find one for each vertex
+	ysExpandingArray<int> UVCoordinates;
+	UVCoordinates.Allocate(nChannels * nVertices);
+	if (nChannels > 0) memset(UVCoordinates.GetBuffer(), 0, sizeof(int) * nChannels * nVertices);
+
+	for (int face = 0; face < object->m_objectStatistics.NumFaces; face++) {
+		for (int facevert = 0; facevert < 3; facevert++) {
+			for (int channel = 0; channel < nChannels; channel++) {
+				UVCoordinates[channel * nVertices + object->m_vertexIndexSet[face].indices[facevert]] =
+					object->m_UVIndexSets[channel].UVIndexSets[face].indices[facevert];
+			}
+		}
+	}
+
+	const int packedSize = vertexSize * nVertices;
+	char *data = (char *)malloc(packedSize);
+	char *location = data;
+
+	const ysVector3 &minimum = header.MinExtreme;
+	const ysVector3 &maximum = header.MaxExtreme;
+
+	for (int vert = 0; vert < nVertices; vert++) {
+		const ysVector3 &vertex = object->m_vertices[vert];
+		const bool rightHanded = !object->m_tangents.IsActive() || object->m_tangents[vert].w >= 0.0f;
+
+		WriteValue(ysVertexCompression::QuantizeUnorm16(vertex.x, minimum.x, maximum.x), &location);
+		WriteValue(ysVertexCompression::QuantizeUnorm16(vertex.y, minimum.y, maximum.y), &location);
+		WriteValue(ysVertexCompression::QuantizeUnorm16(vertex.z, minimum.z, maximum.z), &location);
+		WriteValue((unsigned short)(rightHanded ? 0xFFFF : 0), &location);
+
+		for (int channel = 0; channel < nChannels; channel++) {
+			const ysVector2 &uv = object->m_channels[channel].m_coordinates[UVCoordinates[channel * nVertices + vert]];
+
+			WriteValue(ysVertexCompression::FloatToHalf(uv.x), &location);
+			WriteValue(ysVertexCompression::FloatToHalf(uv.y), &location);
+		}
+
+		if (object->m_normals.IsActive()) {
+			short x, y;
+			ysVertexCompression::EncodeOctahedral(object->m_normals[vert], &x, &y);
+
+			WriteValue(x, &location);
+			WriteValue(y, &location);
+		}
+
+		if (bones) {
+			const ysObjectData::BoneWeights &weights = object->m_boneWeights[vert];
+			const int boneCount = weights.m_boneIndices.GetNumObjects();
+
+			for (int b = 0; b < 4; b++) {
+				const int boneIndex = (b < boneCount) ? weights.m_boneIndices[b] : CompressedUnusedBone;
+				WriteValue((unsigned char)boneIndex, &location);
+			}
+
+			for (int b = 0; b < 4; b++) {
+				const float weight = (b < boneCount) ? weights.m_boneWeights[b] : 0.0f;
+				WriteValue(ysVertexCompression::QuantizeUnorm8(weight), &location);
+			}
+		}
+
+		if (object->m_tangents.IsActive()) {
+			const ysVector4 &tangent = object->m_tangents[vert];
+
+			short x, y;
+			ysVertexCompression::EncodeOctahedral(ysVector3(tangent.x, tangent.y, tangent.z), &x, &y);
+
+			WriteValue(x, &location);
+			WriteValue(y, &location);
+		}
+	}
+
+	*output = data;
+	return packedSize;
+}
+
 ysError ysGeometryExportFile::WriteCustomData(void *data, int size) {
 	YDS_ERROR_DECLARE("WriteCustomData");
 
 	if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::YDS_NO_FILE);
 	if (data == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-	m_file.write((char *)data, size);
+	m_customData.Append((const char *)data, size);
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
-ysError ysGeometryExportFile::WriteObject(ysObjectData *object) {
+ysError ysGeometryExportFile::WriteObject(ysObjectData *object, bool compressVertices) {
 	YDS_ERROR_DECLARE("WriteObject");
 
 	if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::YDS_NO_FILE);
 	if (object == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-	ObjectOutputHeader header;
+	ObjectTableEntry &entry = m_objects.New();
+	ObjectOutputHeader &header = entry.Header;
 	FillOutputHeader(object, &header);
 
-	void *vertexData = nullptr;
-	int vertexDataSize = 0;
+	entry.VertexOffset = 0;
+	entry.IndexOffset = 0;
+	entry.BoneMapOffset = -1;
+	entry.PrimitiveDataOffset = -1;
+	entry.MeshletOffset = -1;
 
+	// Geometry Data
 	if (object->m_objectInformation.ObjectType == ysObjectData::TYPE_GEOMETRY) {
-		vertexDataSize = PackVertexData(object, 4 /*TEMP*/, &vertexData);
+		void *vertexData = nullptr;
+		int vertexDataSize;
+
+		if (compressVertices && CanCompress(object)) {
+			vertexDataSize = PackCompressedVertexData(object, header, &vertexData);
+			header.Flags |= MDF_COMPRESSED;
+		}
+		else {
+			vertexDataSize = PackVertexData(object, 4 /*TEMP*/, &vertexData);
+		}
+
 		header.VertexDataSize = vertexDataSize;
-	}
 
-	m_file.write((char *)&header, sizeof(ObjectOutputHeader));
+		const int stride = (header.NumVertices > 0) ? vertexDataSize / header.NumVertices : 1;
+		char *vertices = AppendVertexData(vertexDataSize, stride, &entry.VertexOffset);
+		if (vertexDataSize > 0) memcpy(vertices, vertexData, vertexDataSize);
 
-	// Geometry Data
-	if (object->m_objectInformation.ObjectType == ysObjectData::TYPE_GEOMETRY) {
-		m_file.write((char *)vertexData, vertexDataSize);
+		free(vertexData);
+
+		// 16 bit indices wherever they can address every vertex
+		if (header.NumVertices > 0xFFFF + 1) header.Flags |= MDF_32BIT_INDICES;
+		const int indexSize = GetIndexSize(header);
 
-		for (int i  =0; i < object->m_objectStatistics.NumFaces; i++) {
-			for (int facevert = 0; facevert < 3; facevert++) {
-				unsigned short reduced = object->m_vertexIndexSet[i].indices[facevert];
-				m_file.write((char *)&reduced, sizeof(unsigned short));
+		int indexOffset;
+		const int indexCount = object->m_objectStatistics.NumFaces * 3;
+		char *indices = AppendIndexData(indexCount * indexSize, &indexOffset);
+		entry.IndexOffset = indexOffset / indexSize;
+
+		if (indexSize == sizeof(unsigned short)) {
+			unsigned short *target = reinterpret_cast<unsigned short *>(indices);
+			for (int i = 0; i < object->m_objectStatistics.NumFaces; i++) {
+				for (int facevert = 0; facevert < 3; facevert++) {
+					*target++ = (unsigned short)object->m_vertexIndexSet[i].indices[facevert];
+				}
+			}
+		}
+		else {
+			unsigned int *target = reinterpret_cast<unsigned int *>(indices);
+			for (int i = 0; i < object->m_objectStatistics.NumFaces; i++) {
+				for (int facevert = 0; facevert < 3; facevert++) {
+					*target++ = (unsigned int)object->m_vertexIndexSet[i].indices[facevert];
+				}
 			}
 		}
 
+		// Meshlets
+		const int meshletCount = object->m_meshlets.GetNumObjects();
+		if (meshletCount > 0) {
+			header.NumMeshlets = meshletCount;
+			entry.MeshletOffset = m_extraData.GetNumObjects();
+			m_extraData.Append((const char *)object->m_meshlets.GetBuffer(), sizeof(ysObjectData::Meshlet) * meshletCount);
+		}
+
 		// Bone Map
-		for (int i = 0; i < object->m_boneIndices.GetNumObjects(); i++) {
-			int *add = &object->m_boneIndices[i];
-			m_file.write((char *)add, sizeof(int));
+		const int boneCount = object->m_boneIndices.GetNumObjects();
+		if (boneCount > 0) {
+			entry.BoneMapOffset = m_extraData.GetNumObjects();
+			m_extraData.Append((const char *)object->m_boneIndices.GetBuffer(), sizeof(int) * boneCount);
 		}
 	}
 
 	// Primitive Data
 	if (object->m_objectInformation.ObjectType == ysObjectData::TYPE_PLANE) {
-		m_file.write((char *)&object->m_length, sizeof(float));
-		m_file.write((char *)&object->m_width, sizeof(float));
+		entry.PrimitiveDataOffset = m_extraData.GetNumObjects();
+		m_extraData.Append((const char *)&object->m_length, sizeof(float));
+		m_extraData.Append((const char *)&object->m_width, sizeof(float));
+	}
+
+	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError ysGeometryExportFile::WriteCompiledObject(const ysCompiledSceneFile &file, int index) {
+	YDS_ERROR_DECLARE("WriteCompiledObject");
+
+	if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::YDS_NO_FILE);
+	if (index < 0 || index >= file.GetObjectCount()) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+
+	const ObjectTableEntry *source = file.GetObject(index);
+	const ObjectOutputHeader &header = source->Header;
+
+	ObjectTableEntry &entry = m_objects.New();
+	entry = *source;
+	entry.VertexOffset = 0;
+	entry.IndexOffset = 0;
+	entry.BoneMapOffset = -1;
+	entry.PrimitiveDataOffset = -1;
+	entry.MeshletOffset = -1;
+
+	// Same order as WriteObject() so that the layout comes out identical
+	if (header.ObjectType == ysObjectData::TYPE_GEOMETRY) {
+		const int stride = (header.NumVertices > 0) ? header.VertexDataSize / header.NumVertices : 1;
+		char *vertices = AppendVertexData(header.VertexDataSize, stride, &entry.VertexOffset);
+		if (header.VertexDataSize > 0) memcpy(vertices, file.GetVertexData() + source->VertexOffset, header.VertexDataSize);
+
+		const int indexSize = GetIndexSize(header);
+		const int indexDataSize = header.NumFaces * 3 * indexSize;
+
+		int indexOffset;
+		char *indices = AppendIndexData(indexDataSize, &indexOffset);
+		if (indexDataSize > 0) memcpy(indices, file.GetIndices(source), indexDataSize);
+		entry.IndexOffset = indexOffset / indexSize;
+
+		if (header.NumMeshlets > 0) {
+			entry.MeshletOffset = m_extraData.GetNumObjects();
+			m_extraData.Append((const char *)file.GetMeshlets(source), sizeof(ysObjectData::Meshlet) * header.NumMeshlets);
+		}
+
+		const int *boneMap = file.GetBoneMap(source);
+		if (boneMap != nullptr) {
+			entry.BoneMapOffset = m_extraData.GetNumObjects();
+			m_extraData.Append((const char *)boneMap, sizeof(int) * header.NumBones);
+		}
+	}
+
+	const float *primitiveData = file.GetPrimitiveData(source);
+	if (primitiveData != nullptr) {
+		entry.PrimitiveDataOffset = m_extraData.GetNumObjects();
+		m_extraData.Append((const char *)primitiveData, sizeof(float) * 2);
 	}
 
 	return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -1,10 +1,267 @@
 #include "../include/yds_geometry_preprocessing.h"
 
+#include "../include/yds_frame_arena.h"
+
+#include <algorithm>
 #include <limits>
+#include <math.h>
 #include <stdlib.h>
 #include <memory>
 #include <assert.h>
 #include <float.h>
+#include <limits.h>
+#include <string.h>
+
+namespace {
+
+    // --
+    // Lists of the faces which use each vertex, stored in one flat array.
+    // The faces using vertex i are Faces[Offsets[i]] to Faces[Offsets[i + 1] - 1].
+    // --
+    struct VertexFaceList {
+        int *Offsets;
+        int *Faces;
+    };
+
+    VertexFaceList BuildVertexFaceList(ysObjectData *object, ysFrameArena *arena) {
+        const int nVertices = object->m_objectStatistics.NumVertices;
+        const int nFaces = object->m_objectStatistics.NumFaces;
+
+        VertexFaceList list;
+        list.Offsets = arena->AllocateArray<int>(nVertices + 1);
+        list.Faces = arena->AllocateArray<int>(nFaces * 3);
+        int *cursor = arena->AllocateArray<int>(nVertices);
+
+        memset(list.Offsets, 0, sizeof(int) * (nVertices + 1));
+        for (int face = 0; face < nFaces; face++) {
+            for (int vertIndex = 0; vertIndex < 3; vertIndex++) {
+                list.Offsets[object->m_vertexIndexSet[face].indices[vertIndex] + 1]++;
+            }
+        }
+
+        for (int vert = 0; vert < nVertices; vert++) {
+            list.Offsets[vert + 1] += list.Offsets[vert];
+            cursor[vert] = list.Offsets[vert];
+        }
+
+        for (int face = 0; face < nFaces; face++) {
+            for (int vertIndex = 0; vertIndex < 3; vertIndex++) {
+                int vert = object->m_vertexIndexSet[face].indices[vertIndex];
+                list.Faces[cursor[vert]++] = face;
+            }
+        }
+
+        return list;
+    }
+
+    // --
+    // Faces which share at least one vertex with each face, without duplicates
+    // and without the face itself. Stored the same way as VertexFaceList, the
+    // neighbours of face i are Faces[Offsets[i]] to Faces[Offsets[i + 1] - 1].
+    // --
+    struct FaceNeighbourList {
+        int *Offsets;
+        int *Faces;
+    };
+
+    FaceNeighbourList BuildFaceNeighbourList(ysObjectData *object, const VertexFaceList &vertexFaces, ysFrameArena *arena) {
+        const int nFaces = object->m_objectStatistics.NumFaces;
+
+        FaceNeighbourList list;
+        list.Offsets = arena->AllocateArray<int>(nFaces + 1);
+        int *lastSeen = arena->AllocateArray<int>(nFaces);
+
+        // The first pass counts the neighbours, the second one writes them out
+        for (int pass = 0; pass < 2; pass++) {
+            for (int face = 0; face < nFaces; face++) lastSeen[face] = -1;
+
+            list.Offsets[0] = 0;
+            for (int face = 0; face < nFaces; face++) {
+                int count = list.Offsets[face];
+                lastSeen[face] = face;
+
+                for (int vertIndex = 0; vertIndex < 3; vertIndex++) {
+                    const int vert = object->m_vertexIndexSet[face].indices[vertIndex];
+                    for (int i = vertexFaces.Offsets[vert]; i < vertexFaces.Offsets[vert + 1]; i++) {
+                        const int neighbour = vertexFaces.Faces[i];
+                        if (lastSeen[neighbour] == face) continue;
+
+                        lastSeen[neighbour] = face;
+                        if (pass == 1) list.Faces[count] = neighbour;
+                        count++;
+                    }
+                }
+
+                list.Offsets[face + 1] = count;
+            }
+
+            if (pass == 0) list.Faces = arena->AllocateArray<int>(list.Offsets[nFaces]);
+        }
+
+        return list;
+    }
+
+    // --
+    // Gives vertex copies to the faces around each vertex so that only
+    // compatible faces keep sharing it. A face joins the first group which
+    // has a member it is compatible with.
+    // --
+    template <typename T_Compatible>
+    void SplitVertices(ysObjectData *object, const VertexFaceList &sharingCache, int nVertices, T_Compatible compatible) {
+        ysExpandingArray<ysExpandingArray<int, 4>, 16> groups;
+        for (int vert = 0; vert < nVertices; vert++) {
+            groups.Clear();
+
+            const int *vertexFaces = sharingCache.Faces + sharingCache.Offsets[vert];
+            const int vertexFaceCount = sharingCache.Offsets[vert + 1] - sharingCache.Offsets[vert];
+
+            for (int face = 0; face < vertexFaceCount; face++) {
+                // Find which group this face belongs to
+                int faceGroup = -1;
+                for (int l = 0; l < groups.GetNumObjects(); l++) {
+                    for (int i = 0; i < groups[l].GetNumObjects(); i++) {
+                        if (compatible(vertexFaces[face], groups[l][i])) {
+                            faceGroup = l;
+                            break;
+                        }
+                    }
+
+                    if (faceGroup != -1) {
+                        break;
+                    }
+                }
+
+                if (faceGroup == -1) groups.New().New() = vertexFaces[face];
+                else groups[faceGroup].New() = vertexFaces[face];
+            }
+
+            for (int l = 1; l < groups.GetNumObjects(); l++) {
+                // Create a copy of the vertex
+                int newVertex = ysGeometryPreprocessing::CreateVertexCopy(object, vert);
+
+                // Adjust indicies for faces
+                for (int face = 0; face < groups[l].GetNumObjects(); face++) {
+                    for (int facevert = 0; facevert < 3; facevert++) {
+                        if (object->m_vertexIndexSet[groups[l][face]].indices[facevert] == vert) {
+                            assert(groups[l][face] < object->m_objectStatistics.NumFaces);
+                            assert(groups[l][face] >= 0);
+
+                            object->m_vertexIndexSet[groups[l][face]].indices[facevert] = newVertex;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // --
+    // Iterative flood fill for SpreadSmoothingGroup(), uses an explicit stack
+    // so that large flat regions can't overflow the call stack.
+    // --
+    int FloodFillExtendedGroup(ysObjectData *object, const FaceNeighbourList &neighbours, int face, int group, ysVector *tempNormals) {
+        const float NormalThreshold = 1.0F - 10e-5F;
+
+        ysExpandingArray<int, 64> stack;
+        stack.New() = face;
+        object->m_extendedSmoothingGroups[face] = group;
+
+        int count = 0;
+        while (stack.GetNumObjects() > 0) {
+            const int current = stack[stack.GetNumObjects() - 1];
+            stack.Delete(stack.GetNumObjects() - 1);
+            count++;
+
+            for (int i = neighbours.Offsets[current]; i < neighbours.Offsets[current + 1]; i++) {
+                const int cmpFace = neighbours.Faces[i];
+
+                // Check to make sure the faces are in different smoothing groups
+                if (object->m_smoothingGroups[current] & object->m_smoothingGroups[cmpFace]) continue;
+                if (object->m_extendedSmoothingGroups[cmpFace] == group) continue;
+
+                ysVector dot = ysMath::Dot(tempNormals[current], tempNormals[cmpFace]);
+                float similarity = ysMath::GetScalar(dot);
+
+                if (similarity > NormalThreshold) {
+                    object->m_extendedSmoothingGroups[cmpFace] = group;
+                    stack.New() = cmpFace;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    // --
+    // Reorder the first n objects of an array so that object i is the one
+    // previously at order[i].
+    // --
+    template <typename TYPE, int START_SIZE, int ALIGNMENT>
+    void ApplyOrder(ysExpandingArray<TYPE, START_SIZE, ALIGNMENT> &target, const int *order, int n) {
+        if (target.GetNumObjects() < n) return;
+
+        ysExpandingArray<TYPE, START_SIZE, ALIGNMENT> reordered;
+        reordered.Reserve(target.GetNumObjects());
+        for (int i = 0; i < n; i++) reordered.New() = std::move(target[order[i]]);
+        for (int i = n; i < target.GetNumObjects(); i++) reordered.New() = std::move(target[i]);
+
+        target = std::move(reordered);
+    }
+
+    // Reorder all per-face data, face i becomes the face previously at order[i]
+    void ReorderFaces(ysObjectData *object, const int *order, ysFrameArena *arena) {
+        const int nFaces = object->m_objectStatistics.NumFaces;
+
+        ApplyOrder(object->m_vertexIndexSet, order, nFaces);
+        ApplyOrder(object->m_smoothingGroups, order, nFaces);
+        ApplyOrder(object->m_extendedSmoothingGroups, order, nFaces);
+
+        for (int channel = 0; channel < object->m_UVIndexSets.GetNumObjects(); channel++) {
+            ApplyOrder(object->m_UVIndexSets[channel].UVIndexSets, order, nFaces);
+        }
+
+        if (object->m_hardNormalCache != nullptr) {
+            ysVector *normals = arena->AllocateArray<ysVector>(nFaces);
+            for (int i = 0; i < nFaces; i++) normals[i] = object->m_hardNormalCache[order[i]];
+            memcpy(object->m_hardNormalCache, normals, sizeof(ysVector) * nFaces);
+        }
+
+        object->m_meshlets.Clear();
+    }
+
+    // --
+    // Scoring for the vertex cache optimizer, from Tom Forsyth's "Linear-Speed
+    // Vertex Cache Optimisation". Vertices used by the last face score a bit
+    // lower than the rest of the cache so that strips aren't favoured, and
+    // vertices with few faces left are boosted so that no lone faces are left
+    // behind.
+    // --
+    const int ForsythCacheSize = 32;
+
+    float ForsythVertexScore(int cachePosition, int remainingFaces) {
+        const float CacheDecayPower = 1.5f;
+        const float LastFaceScore = 0.75f;
+        const float ValenceBoostScale = 2.0f;
+        const float ValenceBoostPower = 0.5f;
+
+        if (remainingFaces == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) score = LastFaceScore;
+            else {
+                const float scaler = 1.0f / (ForsythCacheSize - 3);
+                score = powf(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+
+        return score + ValenceBoostScale * powf((float)remainingFaces, -ValenceBoostPower);
+    }
+
+    ysVector3 GetPosition(ysObjectData *object, int face, int facevert) {
+        return object->m_vertices[object->m_vertexIndexSet[face].indices[facevert]];
+    }
+
+} /* namespace */
 
 bool ysGeometryPreprocessing::ConnectedFaces(ysObjectData *object, int face1, int face2) {
     for (int i = 0; i < 3; i++) {
@@ -71,16 +328,17 @@ int ysGeometryPreprocessing::CreateVertexCopy(ysObjectData *object, int vertex)
 void ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(ysObjectData *object) {
     unsigned int groups;
 
+    // Cache face connections (temporary, freed when leaving this function)
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+    FaceNeighbourList neighbours = BuildFaceNeighbourList(object, BuildVertexFaceList(object, arena), arena);
+
     for (int face = 0; face < object->m_objectStatistics.NumFaces; face++) {
         if (!object->m_smoothingGroups[face]) {
             groups = UINT_MAX; // ie all groups available
 
-            for (int neighbour = 0; neighbour < object->m_objectStatistics.NumFaces; neighbour++) {
-                if (face == neighbour) continue;
-
-                if (ConnectedFaces(object, face, neighbour)) {
-                    groups = groups & (~object->m_smoothingGroups[neighbour]);
-                }
+            for (int i = neighbours.Offsets[face]; i < neighbours.Offsets[face + 1]; i++) {
+                groups = groups & (~object->m_smoothingGroups[neighbours.Faces[i]]);
             }
 
             for (int i = 0; i < 32; i++) {
@@ -95,126 +353,35 @@ void ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(ysObjectData *objec
 }
 
 void ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(ysObjectData *object) {
-    ysVector *tempNormals = CalculateHardNormals(object);
+    object->m_extendedSmoothingGroups.AllocateUninitialized(object->m_objectStatistics.NumFaces);
 
-    object->m_extendedSmoothingGroups.Allocate(object->m_objectStatistics.NumFaces);
-
-    // Temporary extended smoothing group designation
+    // Every face starts out in its own extended smoothing group. Faces are
+    // only joined across smoothing groups by SpreadSmoothingGroup()
     for (int i = 0; i < object->m_objectStatistics.NumFaces; i++) {
         object->m_extendedSmoothingGroups[i] = object->m_objectStatistics.NumFaces + i;
     }
 
-    const float NormalThreshold = 1.0F - 10e-5F;
-    int CurrentGroup = 0;
-    int count = 0;
-
-    for (int f1 = 0; f1 < object->m_objectStatistics.NumFaces; f1++) {
-        if (object->m_extendedSmoothingGroups[f1] < 0) {
-            for (int f2 = 0; f2 < object->m_objectStatistics.NumFaces; f2++) {
-                if (ysGeometryPreprocessing::SameSmoothingGroup(object, f1, f2)) {
-                    continue;
-                }
-
-                ysVector dot = ysMath::Dot(tempNormals[f1], tempNormals[f2]);
-                float similarity = ysMath::GetScalar(dot);
-
-                if (similarity > NormalThreshold) {
-                    object->m_extendedSmoothingGroups[f2] = CurrentGroup;
-                    object->m_extendedSmoothingGroups[f1] = CurrentGroup;
-                }
-            }
-        }
-
-        CurrentGroup++;
-    }
-
-    object->m_numExtendedSmoothingGroups = CurrentGroup;
+    object->m_numExtendedSmoothingGroups = object->m_objectStatistics.NumFaces;
 }
 
 void ysGeometryPreprocessing::SpreadSmoothingGroup(ysObjectData *object, int face, int group, ysVector *tempNormals, int *count) {
-    const float NormalThreshold = 1.0F - 10e-5F;
-
-    (*count)++;
-    if (face >= object->m_objectStatistics.NumFaces || face < 0) {
-        int breakHere = 0;
-    }
-    object->m_extendedSmoothingGroups[face] = group;
-
-    for (int cmpFace = 0; cmpFace < object->m_objectStatistics.NumFaces; cmpFace++) {
-        if (cmpFace == face) continue;
-
-        // Check to make sure the faces are in different smoothing groups
-        if (object->m_smoothingGroups[face] & object->m_smoothingGroups[cmpFace]) continue;
+    if (face >= object->m_objectStatistics.NumFaces || face < 0) return;
 
-        if (!ConnectedFaces(object, face, cmpFace)) continue;
-        if (object->m_extendedSmoothingGroups[face] == object->m_extendedSmoothingGroups[cmpFace]) continue;
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+    FaceNeighbourList neighbours = BuildFaceNeighbourList(object, BuildVertexFaceList(object, arena), arena);
 
-        ysVector dot = ysMath::Dot(tempNormals[face], tempNormals[cmpFace]);
-        float similarity = ysMath::GetScalar(dot);
-
-        if (similarity > NormalThreshold) {
-            SpreadSmoothingGroup(object, cmpFace, group, tempNormals, count);
-        }
-    }
+    (*count) += FloodFillExtendedGroup(object, neighbours, face, group, tempNormals);
 }
 
 void ysGeometryPreprocessing::SeparateBySmoothingGroups(ysObjectData *object) {
-    int faceIndex = 0;
-    int vertex = 0;
-
-    ysExpandingArray<ysExpandingArray<int, 4>> sharingCache;
-    sharingCache.Allocate(object->m_objectStatistics.NumVertices);
-
-    // Cache vertex connections
-    for (int face = 0; face < object->m_objectStatistics.NumFaces; face++) {
-        for (int vertIndex = 0; vertIndex < 3; vertIndex++) {
-            int vert = object->m_vertexIndexSet[face].indices[vertIndex];
-            sharingCache[vert].New() = face;
-        }
-    }
+    // Cache vertex connections (temporary, freed when leaving this function)
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+    VertexFaceList sharingCache = BuildVertexFaceList(object, arena);
 
-    ysExpandingArray<ysExpandingArray<int, 4>, 16> groups;
-    for (int vert = 0; vert < object->m_objectStatistics.NumVertices; vert++) {
-        groups.Destroy();
-        groups.Preallocate(16);
-
-        for (int face = 0; face < sharingCache[vert].GetNumObjects(); face++) {
-            // Find which group this face belongs to
-            int faceGroup = -1;
-            for (int l = 0; l < groups.GetNumObjects(); l++) {
-                for (int i = 0; i < groups[l].GetNumObjects(); i++) {
-                    if (SameSmoothingGroup(object, sharingCache[vert][face], groups[l][i])) {
-                        faceGroup = l;
-                        break;
-                    }
-                }
-
-                if (faceGroup != -1) {
-                    break;
-                }
-            }
-
-            if (faceGroup == -1) groups.New().New() = sharingCache[vert][face];
-            else groups[faceGroup].New() = sharingCache[vert][face];
-        }
-
-        for (int l = 1; l < groups.GetNumObjects(); l++) {
-            // Create a copy of the vertex
-            int newVertex = ysGeometryPreprocessing::CreateVertexCopy(object, vert);
-
-            // Adjust indicies for faces
-            for (int face = 0; face < groups[l].GetNumObjects(); face++) {
-                for (int facevert = 0; facevert < 3; facevert++) {
-                    if (object->m_vertexIndexSet[groups[l][face]].indices[facevert] == vert) {
-                        assert(groups[l][face] < object->m_objectStatistics.NumFaces);
-                        assert(groups[l][face] >= 0);
-
-                        object->m_vertexIndexSet[groups[l][face]].indices[facevert] = newVertex;
-                    }
-                }
-            }
-        }
-    }
+    SplitVertices(object, sharingCache, object->m_objectStatistics.NumVertices,
+        [object](int face1, int face2) { return SameSmoothingGroup(object, face1, face2); });
 
     object->m_objectStatistics.NumVertices = object->m_vertices.GetNumObjects();
 }
@@ -223,27 +390,23 @@ void ysGeometryPreprocessing::SeparateByUVGroups(ysObjectData *object, int mapCh
     int faceIndex = 0;
     int vertex = 0;
 
-    ysExpandingArray<ysExpandingArray<int, 4>> sharingCache;
-    sharingCache.Allocate(object->m_objectStatistics.NumVertices);
-
-    // Cache vertex connections
-    for (int face = 0; face < object->m_objectStatistics.NumFaces; face++) {
-        for (int vertIndex = 0; vertIndex < 3; vertIndex++) {
-            int vert = object->m_vertexIndexSet[face].indices[vertIndex];
-            sharingCache[vert].New() = face;
-        }
-    }
+    // Cache vertex connections (temporary, freed when leaving this function)
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+    VertexFaceList sharingCache = BuildVertexFaceList(object, arena);
 
     ysExpandingArray<ysExpandingArray<int, 4>, 16> leaders;
 
     for (int vert = 0; vert < object->m_objectStatistics.NumVertices; vert++) {
-        leaders.Destroy();
-        leaders.Preallocate(16);
+        leaders.Clear();
+
+        const int *vertexFaces = sharingCache.Faces + sharingCache.Offsets[vert];
+        const int vertexFaceCount = sharingCache.Offsets[vert + 1] - sharingCache.Offsets[vert];
 
-        for (int face = 0; face < sharingCache[vert].GetNumObjects(); face++) {
+        for (int face = 0; face < vertexFaceCount; face++) {
             int follows = -1;
             for (int l = 0; l < leaders.GetNumObjects(); l++) {
-                int f1 = sharingCache[vert][face];
+                int f1 = vertexFaces[face];
                 int f2 = leaders[l][0];
 
                 if (SameUVGroup(object, f1, f2, vert, mapChannel)) {
@@ -252,8 +415,8 @@ void ysGeometryPreprocessing::SeparateByUVGroups(ysObjectData *object, int mapCh
                 }
             }
 
-            if (follows == -1) leaders.New().New() = sharingCache[vert][face];
-            else leaders[follows].New() = sharingCache[vert][face];
+            if (follows == -1) leaders.New().New() = vertexFaces[face];
+            else leaders[follows].New() = vertexFaces[face];
         }
 
         for (int l = 1; l < leaders.GetNumObjects(); l++) {
@@ -280,7 +443,7 @@ void ysGeometryPreprocessing::SeparateByUVGroups(ysObjectData *object, int mapCh
 ysVector *ysGeometryPreprocessing::CalculateHardNormals(ysObjectData *object) {
     if (object->m_hardNormalCache) return object->m_hardNormalCache;
 
-    object->m_hardNormalCache = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumFaces, 16);
+    object->m_hardNormalCache = (ysVector *)ysAllocator::BlockAllocate<16>((int)(sizeof(__m128) * object->m_objectStatistics.NumFaces));
     ysVector *tempNormals = object->m_hardNormalCache;
 
     ysVector vert1, vert2, vert3;
@@ -307,9 +470,9 @@ ysVector *ysGeometryPreprocessing::CalculateHardNormals(ysObjectData *object) {
 }
 
 void ysGeometryPreprocessing::CalculateNormals(ysObjectData *object) {
-    object->m_normals.Allocate(object->m_objectStatistics.NumVertices);
+    object->m_normals.AllocateUninitialized(object->m_objectStatistics.NumVertices);
     ysVector *tempNormals = CalculateHardNormals(object);
-    ysVector *accum = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumVertices, 16);
+    ysVector *accum = (ysVector *)ysAllocator::BlockAllocate<16>((int)(sizeof(__m128) * object->m_objectStatistics.NumVertices));
 
     // Clear accum
     for (int i = 0; i < object->m_objectStatistics.NumVertices; i++) {
@@ -329,11 +492,11 @@ void ysGeometryPreprocessing::CalculateNormals(ysObjectData *object) {
         object->m_normals[i] = ysMath::GetVector3(normalSum);
     }
 
-    _aligned_free(accum);
+    ysAllocator::BlockFree(accum, 16);
 }
 
 ysVector *ysGeometryPreprocessing::CalculateHardTangents(ysObjectData *object, int mapChannel) {
-    ysVector *tempTangents = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumFaces, 16);
+    ysVector *tempTangents = (ysVector *)ysAllocator::BlockAllocate<16>((int)(sizeof(__m128) * object->m_objectStatistics.NumFaces));
     ysVector *hardNormals = CalculateHardNormals(object);
 
     ysVector vert1, vert2, vert3;
@@ -397,42 +560,25 @@ ysVector *ysGeometryPreprocessing::CalculateHardTangents(ysObjectData *object, i
 void ysGeometryPreprocessing::CalculateTangents(ysObjectData *object, int mapChannel) {
     ysVector *tempTangents = CalculateHardTangents(object, mapChannel);
 
-    // Separate Faces With Discontinuous Tangents
-    ysExpandingArray<int, 4> m_discontinuousFaces;
-
-    for (int f1 = 0; f1 < object->m_objectStatistics.NumFaces; f1++) {
-        m_discontinuousFaces.Clear();
-
-        for (int f2 = 0; f2 < object->m_objectStatistics.NumFaces; f2++) {
-            if (ysGeometryPreprocessing::ConnectedFaces(object, f1, f2)) {
-                if (ysMath::GetX(ysMath::Dot(tempTangents[f1], tempTangents[f2])) < 0 ||
-                    ((ysMath::GetW(tempTangents[f1]) > 0) != (ysMath::GetW(tempTangents[f2]) > 0))) {
-                    m_discontinuousFaces.New() = f2;
-                }
-            }
-        }
-
-        for (int facevert = 0; facevert < 3; facevert++) {
-            int vert = object->m_vertexIndexSet[f1].indices[facevert];
-            int copy = -1;
-
-            // Separate faces
-            for (int f2 = 0; f2 < m_discontinuousFaces.GetNumObjects(); f2++) {
-                if (ysGeometryPreprocessing::IncludesVertex(object, f2, vert)) {
-                    if (copy == -1) copy = ysGeometryPreprocessing::CreateVertexCopy(object, vert);
-                    SwapVertex(object, f2, vert, copy);
-                }
-            }
-        }
+    // Separate faces with discontinuous tangents. Only faces sharing a vertex
+    // can be discontinuous, so each vertex is split between its own faces.
+    {
+        ysFrameArena *arena = ysFrameArena::GetThreadArena();
+        ysFrameArena::Scope scope(arena);
+        VertexFaceList sharingCache = BuildVertexFaceList(object, arena);
+
+        SplitVertices(object, sharingCache, object->m_objectStatistics.NumVertices,
+            [tempTangents](int face1, int face2) {
+                return !(ysMath::GetX(ysMath::Dot(tempTangents[face1], tempTangents[face2])) < 0 ||
+                    ((ysMath::GetW(tempTangents[face1]) > 0) != (ysMath::GetW(tempTangents[face2]) > 0)));
+            });
     }
 
-    // FROM HERE
-
     object->m_objectStatistics.NumVertices = object->m_vertices.GetNumObjects();
 
     // Find smoothed tangents
-    object->m_tangents.Allocate(object->m_vertices.GetNumObjects());
-    ysVector *accum = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumVertices, 16);
+    object->m_tangents.AllocateUninitialized(object->m_vertices.GetNumObjects());
+    ysVector *accum = (ysVector *)ysAllocator::BlockAllocate<16>((int)(sizeof(__m128) * object->m_objectStatistics.NumVertices));
 
     // Clear accum
     for (int i = 0; i < object->m_objectStatistics.NumVertices; i++) {
@@ -458,8 +604,8 @@ void ysGeometryPreprocessing::CalculateTangents(ysObjectData *object, int mapCha
         object->m_tangents[i].w = ysMath::GetW(accum[i]);
     }
 
-    _aligned_free(accum);
-    _aligned_free(tempTangents);
+    ysAllocator::BlockFree(accum, 16);
+    ysAllocator::BlockFree(tempTangents, 16);
 }
 
 void ysGeometryPreprocessing::SortBoneWeights(ysObjectData *object, bool normalize, int maxBoneCount) {
@@ -515,3 +661,373 @@ void ysGeometryPreprocessing::UniformScale(ysObjectData *object, float scale) {
     object->m_objectTransformation.Position.y *= scale;
     object->m_objectTransformation.Position.z *= scale;
 }
+
+ysGeometryPreprocessing::VertexCacheStatistics ysGeometryPreprocessing::AnalyzeVertexCache(ysObjectData *object, int cacheSize) {
+    const int nVertices = object->m_objectStatistics.NumVertices;
+    const int nFaces = object->m_objectStatistics.NumFaces;
+
+    VertexCacheStatistics statistics;
+    statistics.FaceCount = nFaces;
+    statistics.VertexCount = nVertices;
+    statistics.CacheMisses = 0;
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+
+    // A vertex is cached if it was added within the last cacheSize misses
+    int *addedAt = arena->AllocateArray<int>(nVertices);
+    for (int i = 0; i < nVertices; i++) addedAt[i] = -1;
+
+    for (int face = 0; face < nFaces; face++) {
+        for (int facevert = 0; facevert < 3; facevert++) {
+            const int vert = object->m_vertexIndexSet[face].indices[facevert];
+            if (addedAt[vert] < 0 || statistics.CacheMisses - addedAt[vert] > cacheSize) {
+                addedAt[vert] = statistics.CacheMisses++;
+            }
+        }
+    }
+
+    return statistics;
+}
+
+void ysGeometryPreprocessing::OptimizeVertexCache(ysObjectData *object) {
+    const int nVertices = object->m_objectStatistics.NumVertices;
+    const int nFaces = object->m_objectStatistics.NumFaces;
+    if (nFaces == 0) return;
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+
+    // The faces of a vertex that haven't been added yet are kept at the front
+    // of its list, remaining[v] of them
+    VertexFaceList vertexFaces = BuildVertexFaceList(object, arena);
+    int *remaining = arena->AllocateArray<int>(nVertices);
+    int *cachePosition = arena->AllocateArray<int>(nVertices);
+    float *vertexScore = arena->AllocateArray<float>(nVertices);
+    float *faceScore = arena->AllocateArray<float>(nFaces);
+    bool *added = arena->AllocateArray<bool>(nFaces);
+    int *order = arena->AllocateArray<int>(nFaces);
+
+    for (int vert = 0; vert < nVertices; vert++) {
+        remaining[vert] = vertexFaces.Offsets[vert + 1] - vertexFaces.Offsets[vert];
+        cachePosition[vert] = -1;
+        vertexScore[vert] = ForsythVertexScore(-1, remaining[vert]);
+    }
+
+    for (int face = 0; face < nFaces; face++) {
+        const int *indices = object->m_vertexIndexSet[face].indices;
+        faceScore[face] = vertexScore[indices[0]] + vertexScore[indices[1]] + vertexScore[indices[2]];
+        added[face] = false;
+    }
+
+    int cache[ForsythCacheSize + 3];
+    int cacheCount = 0;
+
+    int bestFace = -1;
+    int nextUnadded = 0;
+
+    for (int i = 0; i < nFaces; i++) {
+        // Nothing left around the cached vertices, continue from the next
+        // face in the original order
+        if (bestFace == -1) {
+            while (added[nextUnadded]) nextUnadded++;
+            bestFace = nextUnadded;
+        }
+
+        added[bestFace] = true;
+        order[i] = bestFace;
+
+        const int *indices = object->m_vertexIndexSet[bestFace].indices;
+
+        // Remove the face from the lists of its vertices
+        for (int facevert = 0; facevert < 3; facevert++) {
+            const int vert = indices[facevert];
+            int *faces = vertexFaces.Faces + vertexFaces.Offsets[vert];
+
+            for (int j = 0; j < remaining[vert]; j++) {
+                if (faces[j] == bestFace) {
+                    faces[j] = faces[--remaining[vert]];
+                    faces[remaining[vert]] = bestFace;
+                    break;
+                }
+            }
+        }
+
+        // The face's vertices move to the front of the cache
+        int newCache[ForsythCacheSize + 3];
+        int newCount = 0;
+
+        for (int facevert = 0; facevert < 3; facevert++) {
+            const int vert = indices[facevert];
+            if (cachePosition[vert] == -2) continue;
+
+            cachePosition[vert] = -2;
+            newCache[newCount++] = vert;
+        }
+
+        for (int j = 0; j < cacheCount; j++) {
+            if (cachePosition[cache[j]] == -2) continue;
+            newCache[newCount++] = cache[j];
+        }
+
+        for (int j = 0; j < newCount; j++) {
+            const int vert = newCache[j];
+            cachePosition[vert] = (j < ForsythCacheSize) ? j : -1;
+            vertexScore[vert] = ForsythVertexScore(cachePosition[vert], remaining[vert]);
+        }
+
+        // Rescore the faces around everything that moved and pick the best
+        bestFace = -1;
+        float bestScore = -FLT_MAX;
+
+        for (int j = 0; j < newCount; j++) {
+            const int vert = newCache[j];
+            const int *faces = vertexFaces.Faces + vertexFaces.Offsets[vert];
+
+            for (int k = 0; k < remaining[vert]; k++) {
+                const int face = faces[k];
+                const int *faceIndices = object->m_vertexIndexSet[face].indices;
+
+                faceScore[face] =
+                    vertexScore[faceIndices[0]] + vertexScore[faceIndices[1]] + vertexScore[faceIndices[2]];
+
+                if (faceScore[face] > bestScore) {
+                    bestScore = faceScore[face];
+                    bestFace = face;
+                }
+            }
+        }
+
+        cacheCount = (newCount < ForsythCacheSize) ? newCount : ForsythCacheSize;
+        memcpy(cache, newCache, sizeof(int) * cacheCount);
+    }
+
+    ReorderFaces(object, order, arena);
+}
+
+void ysGeometryPreprocessing::OptimizeOverdraw(ysObjectData *object, int cacheSize) {
+    const int nVertices = object->m_objectStatistics.NumVertices;
+    const int nFaces = object->m_objectStatistics.NumFaces;
+    if (nFaces == 0) return;
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+
+    // Split the faces into clusters wherever the cache is cold, ie. none of
+    // the face's vertices are cached. Reordering the clusters then costs
+    // (almost) no extra cache misses.
+    int *clusterStart = arena->AllocateArray<int>(nFaces + 1);
+    int clusterCount = 0;
+
+    int *addedAt = arena->AllocateArray<int>(nVertices);
+    for (int i = 0; i < nVertices; i++) addedAt[i] = -1;
+
+    int misses = 0;
+    for (int face = 0; face < nFaces; face++) {
+        int faceMisses = 0;
+        for (int facevert = 0; facevert < 3; facevert++) {
+            const int vert = object->m_vertexIndexSet[face].indices[facevert];
+            if (addedAt[vert] < 0 || misses - addedAt[vert] > cacheSize) {
+                addedAt[vert] = misses++;
+                faceMisses++;
+            }
+        }
+
+        if (face == 0 || faceMisses == 3) clusterStart[clusterCount++] = face;
+    }
+
+    clusterStart[clusterCount] = nFaces;
+    if (clusterCount < 2) return;
+
+    // Area weighted centroid and normal of each cluster
+    ysVector3 *clusterCentroid = arena->AllocateArray<ysVector3>(clusterCount);
+    ysVector3 *clusterNormal = arena->AllocateArray<ysVector3>(clusterCount);
+    ysVector3 meshCentroid(0.0f, 0.0f, 0.0f);
+    float meshArea = 0.0f;
+
+    for (int cluster = 0; cluster < clusterCount; cluster++) {
+        ysVector3 centroid(0.0f, 0.0f, 0.0f);
+        ysVector3 normal(0.0f, 0.0f, 0.0f);
+        float clusterArea = 0.0f;
+
+        for (int face = clusterStart[cluster]; face < clusterStart[cluster + 1]; face++) {
+            const ysVector3 v1 = GetPosition(object, face, 0);
+            const ysVector3 v2 = GetPosition(object, face, 1);
+            const ysVector3 v3 = GetPosition(object, face, 2);
+
+            // Same winding as CalculateHardNormals()
+            const ysVector3 d1(v3.x - v1.x, v3.y - v1.y, v3.z - v1.z);
+            const ysVector3 d2(v2.x - v1.x, v2.y - v1.y, v2.z - v1.z);
+            ysVector3 n(d2.y * d1.z - d2.z * d1.y, d2.z * d1.x - d2.x * d1.z, d2.x * d1.y - d2.y * d1.x);
+            if (object->m_flipNormals) n = ysVector3(-n.x, -n.y, -n.z);
+
+            const float area = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+
+            centroid.x += (v1.x + v2.x + v3.x) * area / 3.0f;
+            centroid.y += (v1.y + v2.y + v3.y) * area / 3.0f;
+            centroid.z += (v1.z + v2.z + v3.z) * area / 3.0f;
+
+            normal.x += n.x;
+            normal.y += n.y;
+            normal.z += n.z;
+
+            clusterArea += area;
+        }
+
+        meshCentroid.x += centroid.x;
+        meshCentroid.y += centroid.y;
+        meshCentroid.z += centroid.z;
+        meshArea += clusterArea;
+
+        if (clusterArea > 0.0f) {
+            centroid.x /= clusterArea;
+            centroid.y /= clusterArea;
+            centroid.z /= clusterArea;
+        }
+
+        const float length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        if (length > 0.0f) {
+            normal.x /= length;
+            normal.y /= length;
+            normal.z /= length;
+        }
+
+        clusterCentroid[cluster] = centroid;
+        clusterNormal[cluster] = normal;
+    }
+
+    if (meshArea > 0.0f) {
+        meshCentroid.x /= meshArea;
+        meshCentroid.y /= meshArea;
+        meshCentroid.z /= meshArea;
+    }
+
+    // Clusters facing away from the center are more likely to occlude the
+    // rest of the mesh so they are drawn first
+    float *sortKey = arena->AllocateArray<float>(clusterCount);
+    int *clusterOrder = arena->AllocateArray<int>(clusterCount);
+
+    for (int cluster = 0; cluster < clusterCount; cluster++) {
+        const ysVector3 &c = clusterCentroid[cluster];
+        const ysVector3 &n = clusterNormal[cluster];
+
+        sortKey[cluster] =
+            (c.x - meshCentroid.x) * n.x + (c.y - meshCentroid.y) * n.y + (c.z - meshCentroid.z) * n.z;
+        clusterOrder[cluster] = cluster;
+    }
+
+    std::stable_sort(clusterOrder, clusterOrder + clusterCount,
+        [sortKey](int a, int b) { return sortKey[a] > sortKey[b]; });
+
+    int *order = arena->AllocateArray<int>(nFaces);
+    int faceCount = 0;
+    for (int i = 0; i < clusterCount; i++) {
+        const int cluster = clusterOrder[i];
+        for (int face = clusterStart[cluster]; face < clusterStart[cluster + 1]; face++) {
+            order[faceCount++] = face;
+        }
+    }
+
+    ReorderFaces(object, order, arena);
+}
+
+void ysGeometryPreprocessing::OptimizeVertexFetch(ysObjectData *object) {
+    const int nVertices = object->m_objectStatistics.NumVertices;
+    const int nFaces = object->m_objectStatistics.NumFaces;
+    if (nVertices == 0) return;
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+
+    int *remap = arena->AllocateArray<int>(nVertices);
+    int *order = arena->AllocateArray<int>(nVertices);
+    for (int i = 0; i < nVertices; i++) remap[i] = -1;
+
+    int vertexCount = 0;
+    for (int face = 0; face < nFaces; face++) {
+        for (int facevert = 0; facevert < 3; facevert++) {
+            int &vert = object->m_vertexIndexSet[face].indices[facevert];
+            if (remap[vert] == -1) {
+                order[vertexCount] = vert;
+                remap[vert] = vertexCount++;
+            }
+
+            vert = remap[vert];
+        }
+    }
+
+    // Unused vertices are kept at the end
+    for (int i = 0; i < nVertices; i++) {
+        if (remap[i] == -1) {
+            order[vertexCount] = i;
+            remap[i] = vertexCount++;
+        }
+    }
+
+    ApplyOrder(object->m_vertices, order, nVertices);
+    ApplyOrder(object->m_materialList, order, nVertices);
+    ApplyOrder(object->m_boneWeights, order, nVertices);
+    ApplyOrder(object->m_normals, order, nVertices);
+    ApplyOrder(object->m_tangents, order, nVertices);
+}
+
+void ysGeometryPreprocessing::BuildMeshlets(ysObjectData *object, int maxVertices, int maxFaces) {
+    const int nVertices = object->m_objectStatistics.NumVertices;
+    const int nFaces = object->m_objectStatistics.NumFaces;
+
+    object->m_meshlets.Clear();
+    if (nFaces == 0) return;
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+
+    // Index of the last meshlet that used each vertex
+    int *lastMeshlet = arena->AllocateArray<int>(nVertices);
+    for (int i = 0; i < nVertices; i++) lastMeshlet[i] = -1;
+
+    ysObjectData::Meshlet *meshlet = nullptr;
+    for (int face = 0; face < nFaces; face++) {
+        const int *indices = object->m_vertexIndexSet[face].indices;
+
+        if (meshlet != nullptr) {
+            const int current = object->m_meshlets.GetNumObjects() - 1;
+
+            int newVertices = 0;
+            for (int facevert = 0; facevert < 3; facevert++) {
+                if (lastMeshlet[indices[facevert]] != current) newVertices++;
+            }
+
+            if (meshlet->FaceCount >= maxFaces || meshlet->VertexCount + newVertices > maxVertices) {
+                meshlet = nullptr;
+            }
+        }
+
+        if (meshlet == nullptr) {
+            meshlet = &object->m_meshlets.New();
+            meshlet->FirstFace = face;
+            meshlet->FaceCount = 0;
+            meshlet->VertexCount = 0;
+            meshlet->MinExtreme = object->m_vertices[indices[0]];
+            meshlet->MaxExtreme = object->m_vertices[indices[0]];
+        }
+
+        const int current = object->m_meshlets.GetNumObjects() - 1;
+        for (int facevert = 0; facevert < 3; facevert++) {
+            const int vert = indices[facevert];
+            if (lastMeshlet[vert] == current) continue;
+
+            lastMeshlet[vert] = current;
+            meshlet->VertexCount++;
+
+            const ysVector3 &position = object->m_vertices[vert];
+            if (position.x < meshlet->MinExtreme.x) meshlet->MinExtreme.x = position.x;
+            if (position.y < meshlet->MinExtreme.y) meshlet->MinExtreme.y = position.y;
+            if (position.z < meshlet->MinExtreme.z) meshlet->MinExtreme.z = position.z;
+            if (position.x > meshlet->MaxExtreme.x) meshlet->MaxExtreme.x = position.x;
+            if (position.y > meshlet->MaxExtreme.y) meshlet->MaxExtreme.y = position.y;
+            if (position.z > meshlet->MaxExtreme.z) meshlet->MaxExtreme.z = position.z;
+        }
+
+        meshlet->FaceCount++;
+    }
+}
@@ -6,6 +6,8 @@ ysGPUBuffer::ysGPUBuffer() : ysContextObject("GPU_BUFFER", API_UNKNOWN) {
 	m_RAMMirror = NULL;
 	m_size = 0;
 
+	m_currentStride = 0;
+
 	m_mirrorToRAM = false;
 }
 
@@ -15,6 +17,8 @@ ysGPUBuffer::ysGPUBuffer(DEVICE_API API) : ysContextObject("GPU_BUFFER", API) {
 	m_RAMMirror = NULL;
 	m_size = 0;
 
+	m_currentStride = 0;
+
 	m_mirrorToRAM = false;
 }
 
@@ -0,0 +1,162 @@
+#include "../include/yds_hash.h"
+
+#include <string.h>
+
+namespace {
+
+    const uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t Prime3 = 0x165667B19E3779F9ULL;
+    const uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+    const int StripeSize = 32;
+
+    inline uint64_t RotateLeft(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // The format is defined in little endian, which is every target this
+    // library builds for
+    inline uint64_t Read64(const unsigned char *p) {
+        uint64_t value;
+        memcpy(&value, p, sizeof(uint64_t));
+        return value;
+    }
+
+    inline uint32_t Read32(const unsigned char *p) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(uint32_t));
+        return value;
+    }
+
+    inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+        accumulator += input * Prime2;
+        accumulator = RotateLeft(accumulator, 31);
+        return accumulator * Prime1;
+    }
+
+    inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator) {
+        hash ^= Round(0, accumulator);
+        return hash * Prime1 + Prime4;
+    }
+
+    void InitializeAccumulators(uint64_t *accumulators, uint64_t seed) {
+        accumulators[0] = seed + Prime1 + Prime2;
+        accumulators[1] = seed + Prime2;
+        accumulators[2] = seed;
+        accumulators[3] = seed - Prime1;
+    }
+
+    // Consumes as many whole stripes as there are, returns the rest
+    const unsigned char *ConsumeStripes(uint64_t *accumulators, const unsigned char *p, const unsigned char *end) {
+        while (end - p >= StripeSize) {
+            accumulators[0] = Round(accumulators[0], Read64(p + 0));
+            accumulators[1] = Round(accumulators[1], Read64(p + 8));
+            accumulators[2] = Round(accumulators[2], Read64(p + 16));
+            accumulators[3] = Round(accumulators[3], Read64(p + 24));
+            p += StripeSize;
+        }
+
+        return p;
+    }
+
+    uint64_t Finalize(uint64_t hash, const unsigned char *p, size_t remaining) {
+        while (remaining >= 8) {
+            hash ^= Round(0, Read64(p));
+            hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+            p += 8;
+            remaining -= 8;
+        }
+
+        if (remaining >= 4) {
+            hash ^= (uint64_t)Read32(p) * Prime1;
+            hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+            p += 4;
+            remaining -= 4;
+        }
+
+        while (remaining > 0) {
+            hash ^= (*p) * Prime5;
+            hash = RotateLeft(hash, 11) * Prime1;
+            p++;
+            remaining--;
+        }
+
+        // Avalanche
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+    uint64_t Converge(const uint64_t *accumulators, uint64_t totalSize, uint64_t seed) {
+        uint64_t hash;
+        if (totalSize >= (uint64_t)StripeSize) {
+            hash = RotateLeft(accumulators[0], 1) + RotateLeft(accumulators[1], 7) +
+                RotateLeft(accumulators[2], 12) + RotateLeft(accumulators[3], 18);
+
+            for (int i = 0; i < 4; i++) hash = MergeRound(hash, accumulators[i]);
+        }
+        else {
+            hash = seed + Prime5;
+        }
+
+        return hash + totalSize;
+    }
+
+} /* namespace */
+
+uint64_t ysHash::XXH64(const void *data, size_t size, uint64_t seed) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    const unsigned char *end = p + size;
+
+    uint64_t accumulators[4];
+    InitializeAccumulators(accumulators, seed);
+    p = ConsumeStripes(accumulators, p, end);
+
+    return Finalize(Converge(accumulators, size, seed), p, end - p);
+}
+
+ysHash::XXH64State::XXH64State(uint64_t seed) {
+    Reset(seed);
+}
+
+void ysHash::XXH64State::Reset(uint64_t seed) {
+    InitializeAccumulators(m_accumulators, seed);
+    m_seed = seed;
+    m_totalSize = 0;
+    m_bufferSize = 0;
+}
+
+void ysHash::XXH64State::Update(const void *data, size_t size) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    const unsigned char *end = p + size;
+
+    m_totalSize += size;
+
+    // Top up a partial stripe left over from the last call first
+    if (m_bufferSize > 0) {
+        const size_t fill = ((size_t)(StripeSize - m_bufferSize) < size) ? StripeSize - m_bufferSize : size;
+        memcpy(m_buffer + m_bufferSize, p, fill);
+        m_bufferSize += (int)fill;
+        p += fill;
+
+        if (m_bufferSize < StripeSize) return;
+
+        ConsumeStripes(m_accumulators, m_buffer, m_buffer + StripeSize);
+        m_bufferSize = 0;
+    }
+
+    p = ConsumeStripes(m_accumulators, p, end);
+
+    m_bufferSize = (int)(end - p);
+    memcpy(m_buffer, p, m_bufferSize);
+}
+
+uint64_t ysHash::XXH64State::Digest() const {
+    return Finalize(Converge(m_accumulators, m_totalSize, m_seed), m_buffer, m_bufferSize);
+}
@@ -1,5 +1,9 @@
 #include "../include/yds_interchange_file_0_0.h"
 
+#include "../include/yds_frame_arena.h"
+
+#include <string.h>
+
 ysInterchangeFile0_0::ysInterchangeFile0_0() {
     m_majorVersion = 0;
     m_minorVersion = 0;
@@ -7,6 +11,7 @@ ysInterchangeFile0_0::ysInterchangeFile0_0() {
     m_toolId = -1;
     m_compilationStatus = false;
     m_objectCount = 0;
+    m_fileSize = 0;
 }
 
 ysInterchangeFile0_0::~ysInterchangeFile0_0() {
@@ -19,6 +24,10 @@ ysError ysInterchangeFile0_0::Open(const char *fname) {
     m_file.open(fname, std::ios::binary | std::ios::in | std::ios::out);
     if (!m_file.is_open()) return YDS_ERROR_RETURN_MSG(ysError::YDS_COULD_NOT_OPEN_FILE, fname);
 
+    m_file.seekg(0, std::ios::end);
+    m_fileSize = (uint64_t)m_file.tellg();
+    m_file.seekg(0, std::ios::beg);
+
     IdHeader idHeader;
     m_file.read((char *)&idHeader, sizeof(IdHeader));
 
@@ -44,87 +53,155 @@ ysError ysInterchangeFile0_0::Open(const char *fname) {
 }
 
 ysError ysInterchangeFile0_0::ReadObject(ysInterchangeObject *object) {
+    YDS_ERROR_DECLARE("ReadObject");
+
     ObjectInformation info;
-    m_file.read((char *)&info, sizeof(ObjectInformation));
+    ObjectTransformation t;
+    GeometryInformation geometryInfo;
+    if (!ReadBlock(&info, sizeof(ObjectInformation))) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+    if (!ReadBlock(&t, sizeof(ObjectTransformation))) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+    if (!ReadBlock(&geometryInfo, sizeof(GeometryInformation))) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+
+    info.Name[sizeof(info.Name) - 1] = '\0';
+    info.MaterialName[sizeof(info.MaterialName) - 1] = '\0';
 
     object->MaterialName = info.MaterialName;
     object->Name = info.Name;
     object->ModelIndex = info.ModelIndex;
     object->ParentIndex = info.ParentIndex;
-    
-    ObjectTransformation t;
-    m_file.read((char *)&t, sizeof(ObjectTransformation));
 
     object->Orientation = t.Orientation;
     object->OrientationEuler = t.OrientationEuler;
     object->Position = t.Position;
     object->Scale = t.Scale;
 
-    GeometryInformation geometryInfo;
-    m_file.read((char *)&geometryInfo, sizeof(GeometryInformation));
-
-    int normalCount = geometryInfo.NormalCount;
-    int uvChannelCount = geometryInfo.UVChannelCount;
-    int vertexCount = geometryInfo.VertexCount;
-    int faceCount = geometryInfo.FaceCount;
-    int tangentCount = geometryInfo.TangentCount;
-
-    for (int i = 0; i < vertexCount; ++i) {
-        ysVector3 v;
-        m_file.read((char *)&v, sizeof(ysVector3));
-        object->Vertices.push_back(v);
-    }
+    const unsigned int uvChannelCount = geometryInfo.UVChannelCount;
+    const unsigned int faceCount = geometryInfo.FaceCount;
 
-    for (int i = 0; i < uvChannelCount; ++i) {
-        UVChannel channel;
-        m_file.read((char *)&channel, sizeof(UVChannel));
+    // Each array is stored contiguously and is read in one go
+    if (!ReadArray(object->Vertices, geometryInfo.VertexCount)) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
 
-        ysInterchangeObject::UVChannel objectChannel;
-        for (int j = 0; j < channel.UVCount; ++j) {
-            ysVector2 uv;
-            m_file.read((char *)&uv, sizeof(ysVector2));
-            objectChannel.Coordinates.push_back(uv);
-        }
+    // Every channel takes at least its header, check before allocating
+    if ((uint64_t)uvChannelCount * sizeof(UVChannel) > GetRemainingSize()) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
 
-        object->UVChannels.push_back(objectChannel);
+    object->UVChannels.clear();
+    object->UVChannels.resize(uvChannelCount);
+    for (unsigned int i = 0; i < uvChannelCount; ++i) {
+        UVChannel channel;
+        if (!ReadBlock(&channel, sizeof(UVChannel))) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+        if (!ReadArray(object->UVChannels[i].Coordinates, channel.UVCount)) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
     }
 
-    for (int i = 0; i < normalCount; ++i) {
-        ysVector3 v;
-        m_file.read((char *)&v, sizeof(ysVector3));
-        object->Normals.push_back(v);
+    if (!ReadArray(object->Normals, geometryInfo.NormalCount)) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+    if (!ReadArray(object->Tangents, geometryInfo.TangentCount)) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+
+    // --
+    // Faces are interleaved: vertex, normal and tangent indices followed by
+    // one set per UV channel. The whole block is read into scratch memory,
+    // validated and then split into the per-attribute arrays.
+    // --
+    const unsigned int setsPerFace = 3 + uvChannelCount;
+    const uint64_t faceDataSize = (uint64_t)faceCount * setsPerFace * sizeof(IndexSet);
+    if (faceDataSize > GetRemainingSize()) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+
+    IndexSet *faceData = arena->AllocateArray<IndexSet>((int)(faceCount * setsPerFace));
+    if (!ReadBlock(faceData, (size_t)faceDataSize)) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+
+    unsigned int *limits = arena->AllocateArray<unsigned int>(setsPerFace);
+    limits[0] = geometryInfo.VertexCount;
+    limits[1] = geometryInfo.NormalCount;
+    limits[2] = geometryInfo.TangentCount;
+    for (unsigned int i = 0; i < uvChannelCount; ++i) {
+        limits[3 + i] = (unsigned int)object->UVChannels[i].Coordinates.size();
     }
 
-    for (int i = 0; i < tangentCount; ++i) {
-        ysVector3 v;
-        m_file.read((char *)&v, sizeof(ysVector3));
-        object->Tangents.push_back(v);
+    if (!ValidateIndices(faceData, faceCount, setsPerFace, limits, arena)) {
+        return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
     }
 
-    for (int i = 0; i < uvChannelCount; ++i) {
-        object->UVIndices.push_back({});
-    }
+    object->VertexIndices.resize(faceCount);
+    object->NormalIndices.resize(faceCount);
+    object->TangentIndices.resize(faceCount);
+
+    object->UVIndices.clear();
+    object->UVIndices.resize(uvChannelCount);
+    for (unsigned int i = 0; i < uvChannelCount; ++i) object->UVIndices[i].resize(faceCount);
 
-    for (int i = 0; i < faceCount; ++i) {
-        IndexSet vi, ni, ti;
-        m_file.read((char *)&vi, sizeof(IndexSet));
-        m_file.read((char *)&ni, sizeof(IndexSet));
-        m_file.read((char *)&ti, sizeof(IndexSet));
+    static_assert(sizeof(IndexSet) == sizeof(ysInterchangeObject::IndexSet), "Index sets must match");
 
-        object->VertexIndices.push_back({ vi.u, vi.v, vi.w });
-        object->NormalIndices.push_back({ ni.u, ni.v, ni.w });
-        object->TangentIndices.push_back({ ti.u, ti.v, ti.w });
+    const IndexSet *record = faceData;
+    for (unsigned int i = 0; i < faceCount; ++i, record += setsPerFace) {
+        memcpy(&object->VertexIndices[i], &record[0], sizeof(IndexSet));
+        memcpy(&object->NormalIndices[i], &record[1], sizeof(IndexSet));
+        memcpy(&object->TangentIndices[i], &record[2], sizeof(IndexSet));
 
-        for (int j = 0; j < uvChannelCount; ++j) {
-            IndexSet u;
-            m_file.read((char *)&u, sizeof(IndexSet));
-            object->UVIndices[j].push_back({ u.u, u.v, u.w });
+        for (unsigned int j = 0; j < uvChannelCount; ++j) {
+            memcpy(&object->UVIndices[j][i], &record[3 + j], sizeof(IndexSet));
         }
     }
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
+uint64_t ysInterchangeFile0_0::GetRemainingSize() {
+    const std::streamoff position = m_file.tellg();
+    if (position < 0 || (uint64_t)position > m_fileSize) return 0;
+
+    return m_fileSize - (uint64_t)position;
+}
+
+bool ysInterchangeFile0_0::ReadBlock(void *target, size_t size) {
+    if (size == 0) return true;
+    if (size > GetRemainingSize()) return false;
+
+    m_file.read((char *)target, (std::streamsize)size);
+    return m_file.good();
+}
+
+template <typename T>
+bool ysInterchangeFile0_0::ReadArray(std::vector<T> &target, unsigned int count) {
+    // A corrupted count must not turn into a huge allocation
+    if ((uint64_t)count * sizeof(T) > GetRemainingSize()) return false;
+
+    target.resize(count);
+    return ReadBlock(target.data(), sizeof(T) * count);
+}
+
+bool ysInterchangeFile0_0::ValidateIndices(
+    const IndexSet *faceData, unsigned int faceCount, unsigned int setsPerFace, const unsigned int *limits, ysFrameArena *arena)
+{
+    // Largest index in each column, negative indices wrap around and come
+    // out larger than any count. The inner loop has no branches so that it
+    // can be vectorized.
+    const unsigned int columns = setsPerFace * 3;
+    unsigned int *maximum = arena->AllocateArray<unsigned int>(columns);
+    for (unsigned int c = 0; c < columns; ++c) maximum[c] = 0;
+
+    const int *indices = &faceData[0].u;
+    for (unsigned int i = 0; i < faceCount; ++i, indices += columns) {
+        for (unsigned int c = 0; c < columns; ++c) {
+            const unsigned int index = (unsigned int)indices[c];
+            maximum[c] = (index > maximum[c]) ? index : maximum[c];
+        }
+    }
+
+    if (faceCount == 0) return true;
+
+    for (unsigned int set = 0; set < setsPerFace; ++set) {
+        // Attributes that the exporter didn't write aren't referenced
+        if (set > 0 && limits[set] == 0) continue;
+
+        for (unsigned int c = 0; c < 3; ++c) {
+            if (maximum[set * 3 + c] >= limits[set]) return false;
+        }
+    }
+
+    return true;
+}
+
 ysError ysInterchangeFile0_0::Close() {
     YDS_ERROR_DECLARE("Close");
 
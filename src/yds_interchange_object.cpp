@@ -33,42 +33,81 @@ bool ysInterchangeObject::Validate() const {
     return true;
 }
 
-void ysInterchangeObject::RipByIndexSet(std::vector <IndexSet> &indices) {
-    int N = Vertices.size();
-    int faces = VertexIndices.size();
-
-    std::vector<int> vertexToIndex(N, -1);
-    std::vector<int> newVertex(N, -1);
-    for (int i = 0; i < faces; ++i) {
-        IndexSet &v = VertexIndices[i];
-        IndexSet &r = indices[i];
-
-        for (int j = 0; j < 3; ++j) {
-            if (vertexToIndex[v.indices[j]] == -1) vertexToIndex[v.indices[j]] = r.indices[j];
-            else if (vertexToIndex[v.indices[j]] != r.indices[j]) {
-                int next = newVertex[v.indices[j]];
-                int last = v.indices[j];
-                while (next != -1) {
-                    if (vertexToIndex[next] == r.indices[j]) break;
-                    last = next;
-                    next = newVertex[next];
+namespace {
+
+    // --
+    // Gives every vertex that is used with more than one index from the set
+    // its own copy. Only the face indices are rewritten, each new vertex
+    // records the original vertex it was copied from in origin.
+    // --
+    void RipIndices(
+        std::vector<ysInterchangeObject::IndexSet> &vertexIndices,
+        const std::vector<ysInterchangeObject::IndexSet> &indices,
+        std::vector<int> &origin)
+    {
+        int N = origin.size();
+        int faces = vertexIndices.size();
+
+        std::vector<int> vertexToIndex(N, -1);
+        std::vector<int> newVertex(N, -1);
+        for (int i = 0; i < faces; ++i) {
+            ysInterchangeObject::IndexSet &v = vertexIndices[i];
+            const ysInterchangeObject::IndexSet &r = indices[i];
+
+            for (int j = 0; j < 3; ++j) {
+                if (vertexToIndex[v.indices[j]] == -1) vertexToIndex[v.indices[j]] = r.indices[j];
+                else if (vertexToIndex[v.indices[j]] != r.indices[j]) {
+                    int next = newVertex[v.indices[j]];
+                    int last = v.indices[j];
+                    while (next != -1) {
+                        if (vertexToIndex[next] == r.indices[j]) break;
+                        last = next;
+                        next = newVertex[next];
+                    }
+
+                    int newVertexId = next;
+                    if (newVertexId == -1) {
+                        // Copy the vertex
+                        origin.push_back(origin[v.indices[j]]);
+
+                        vertexToIndex.push_back(r.indices[j]);
+                        newVertex.push_back(-1);
+                        newVertexId = N++;
+                    }
+
+                    newVertex[last] = newVertexId;
+                    v.indices[j] = newVertexId;
                 }
+            }
+        }
+    }
 
-                int newVertexId = next;
-                if (newVertexId == -1) {
-                    // Copy the vertex
-                    Vertices.push_back(Vertices[v.indices[j]]);
+    std::vector<int> IdentityOrigin(int vertexCount) {
+        std::vector<int> origin(vertexCount);
+        for (int i = 0; i < vertexCount; ++i) origin[i] = i;
 
-                    vertexToIndex.push_back(r.indices[j]);
-                    newVertex.push_back(-1);
-                    newVertexId = N++;
-                }
+        return origin;
+    }
 
-                newVertex[last] = newVertexId;
-                v.indices[j] = newVertexId;
-            }
+    // Appends the copies recorded by RipIndices()
+    template<typename T_Vertex>
+    void CopyRippedVertices(std::vector<T_Vertex> &vertices, const std::vector<int> &origin) {
+        const int originalCount = vertices.size();
+        const int newCount = origin.size();
+
+        vertices.resize(newCount);
+        for (int i = originalCount; i < newCount; ++i) {
+            vertices[i] = vertices[origin[i]];
         }
     }
+
+} /* namespace */
+
+void ysInterchangeObject::RipByIndexSet(std::vector <IndexSet> &indices) {
+    std::vector<int> origin = IdentityOrigin(Vertices.size());
+
+    RipIndices(VertexIndices, indices, origin);
+    CopyRippedVertices(Vertices, origin);
 }
 
 void ysInterchangeObject::RipByNormals() {
@@ -85,3 +124,23 @@ void ysInterchangeObject::RipByUVs() {
         RipByIndexSet(UVIndices[i]);
     }
 }
+
+void ysInterchangeObject::RipByAllAttributes() {
+    // --
+    // Every attribute is still split in its own pass since comparing one
+    // index per corner is much cheaper than comparing whole attribute
+    // tuples, but the passes only work on indices. Vertices is grown once
+    // at the end instead of being copied again for every attribute.
+    // --
+    std::vector<int> origin = IdentityOrigin(Vertices.size());
+
+    RipIndices(VertexIndices, TangentIndices, origin);
+    RipIndices(VertexIndices, NormalIndices, origin);
+
+    int channelCount = UVChannels.size();
+    for (int i = 0; i < channelCount; ++i) {
+        RipIndices(VertexIndices, UVIndices[i], origin);
+    }
+
+    CopyRippedVertices(Vertices, origin);
+}
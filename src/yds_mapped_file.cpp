@@ -0,0 +1,118 @@
+#include "../include/yds_mapped_file.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ysMappedFile::ysMappedFile() : ysObject("ysMappedFile") {
+    m_data = nullptr;
+    m_size = 0;
+
+#if defined(_WIN32)
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+#endif
+}
+
+ysMappedFile::~ysMappedFile() {
+    Close();
+}
+
+ysError ysMappedFile::Open(const char *fname, bool sequential) {
+    YDS_ERROR_DECLARE("Open");
+
+    if (fname == nullptr) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    if (IsOpen()) return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+
+#if defined(_WIN32)
+    HANDLE file = ::CreateFileA(
+        fname, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        ::CloseHandle(file);
+        return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+    }
+
+    HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        ::CloseHandle(file);
+        return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+    }
+
+    void *view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = reinterpret_cast<const char *>(view);
+    m_size = (size_t)size.QuadPart;
+#else
+    const int descriptor = ::open(fname, O_RDONLY);
+    if (descriptor < 0) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        ::close(descriptor);
+        return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+    }
+
+    void *view = ::mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    // The mapping keeps its own reference to the file
+    ::close(descriptor);
+
+    if (view == MAP_FAILED) return YDS_ERROR_RETURN(ysError::YDS_COULD_NOT_OPEN_FILE);
+
+    if (sequential) {
+        ::madvise(view, (size_t)status.st_size, MADV_SEQUENTIAL);
+        ::madvise(view, (size_t)status.st_size, MADV_WILLNEED);
+    }
+
+    m_data = reinterpret_cast<const char *>(view);
+    m_size = (size_t)status.st_size;
+#endif
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+void ysMappedFile::Close() {
+    if (m_data == nullptr) return;
+
+#if defined(_WIN32)
+    ::UnmapViewOfFile(m_data);
+    ::CloseHandle(m_mappingHandle);
+    ::CloseHandle(m_fileHandle);
+
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+#else
+    ::munmap(const_cast<char *>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void ysMappedFile::Prefetch() const {
+    // Smallest page size of any target, touching more often is harmless
+    const size_t PageSize = 4096;
+
+    volatile char sink = 0;
+    for (size_t offset = 0; offset < m_size; offset += PageSize) {
+        sink = m_data[offset];
+    }
+
+    (void)sink;
+}
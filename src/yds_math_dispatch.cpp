@@ -0,0 +1,195 @@
+#include "../include/yds_math_kernels.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace {
+
+    void Cpuid(int info[4], int leaf, int subleaf) {
+#if defined(_MSC_VER)
+        __cpuidex(info, leaf, subleaf);
+#else
+        unsigned int a, b, c, d;
+        __cpuid_count(leaf, subleaf, a, b, c, d);
+        info[0] = (int)a; info[1] = (int)b; info[2] = (int)c; info[3] = (int)d;
+#endif
+    }
+
+    unsigned long long Xgetbv() {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned int eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return ((unsigned long long)edx << 32) | eax;
+#endif
+    }
+
+    ysMath::InstructionSet DetectInstructionSet() {
+        int info[4];
+
+        Cpuid(info, 0, 0);
+        const int maxLeaf = info[0];
+
+        Cpuid(info, 1, 0);
+        const bool sse41 = (info[2] & (1 << 19)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+
+        if (!sse41) return ysMath::InstructionSet::SSE2;
+
+        // The OS must save the YMM/ZMM register state across context switches
+        // before any AVX instructions can be used
+        if (!osxsave || !avx || !fma || maxLeaf < 7) return ysMath::InstructionSet::SSE4_1;
+
+        const unsigned long long xcr0 = Xgetbv();
+        if ((xcr0 & 0x6) != 0x6) return ysMath::InstructionSet::SSE4_1;
+
+        Cpuid(info, 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0;
+        const bool avx512f = (info[1] & (1 << 16)) != 0;
+
+        if (!avx2) return ysMath::InstructionSet::SSE4_1;
+        if (!avx512f || (xcr0 & 0xE6) != 0xE6) return ysMath::InstructionSet::AVX2_FMA;
+
+        return ysMath::InstructionSet::AVX512;
+    }
+
+    const ysMath::Kernels::Table Tables[] = {
+        {
+            ysMath::InstructionSet::SSE2, "SSE2",
+            ysMath::Kernels::DotSse2,
+            ysMath::Kernels::CrossSse2,
+            ysMath::Kernels::NormalizeSse2,
+            ysMath::Kernels::TransformSse2,
+            ysMath::Kernels::MatMultSse2,
+            ysMath::Kernels::QuatMultiplySse2,
+            ysMath::Kernels::LoadMatrixSse2,
+            ysMath::Kernels::QuatNlerpSse2,
+            ysMath::Kernels::SinCosSse2,
+            ysMath::Kernels::ExpSse2,
+            ysMath::Kernels::PowSse2
+        },
+        {
+            ysMath::InstructionSet::SSE4_1, "SSE4.1",
+            ysMath::Kernels::DotSse41,
+            ysMath::Kernels::CrossSse2,
+            ysMath::Kernels::NormalizeSse41,
+            ysMath::Kernels::TransformSse2,
+            ysMath::Kernels::MatMultSse2,
+            ysMath::Kernels::QuatMultiplySse2,
+            ysMath::Kernels::LoadMatrixSse2,
+            ysMath::Kernels::QuatNlerpSse2,
+            ysMath::Kernels::SinCosSse2,
+            ysMath::Kernels::ExpSse2,
+            ysMath::Kernels::PowSse2
+        },
+        {
+            ysMath::InstructionSet::AVX2_FMA, "AVX2+FMA",
+            ysMath::Kernels::DotAvx2,
+            ysMath::Kernels::CrossAvx2,
+            ysMath::Kernels::NormalizeAvx2,
+            ysMath::Kernels::TransformAvx2,
+            ysMath::Kernels::MatMultAvx2,
+            ysMath::Kernels::QuatMultiplyAvx2,
+            ysMath::Kernels::LoadMatrixAvx2,
+            ysMath::Kernels::QuatNlerpAvx2,
+            ysMath::Kernels::SinCosAvx2,
+            ysMath::Kernels::ExpAvx2,
+            ysMath::Kernels::PowAvx2
+        },
+        {
+            ysMath::InstructionSet::AVX512, "AVX-512",
+            ysMath::Kernels::DotAvx512,
+            ysMath::Kernels::CrossAvx512,
+            ysMath::Kernels::NormalizeAvx512,
+            ysMath::Kernels::TransformAvx512,
+            ysMath::Kernels::MatMultAvx512,
+            ysMath::Kernels::QuatMultiplyAvx512,
+            ysMath::Kernels::LoadMatrixAvx512,
+            ysMath::Kernels::QuatNlerpAvx512,
+            ysMath::Kernels::SinCosAvx2,
+            ysMath::Kernels::ExpAvx2,
+            ysMath::Kernels::PowAvx2
+        }
+    };
+
+    const ysMath::InstructionSet SupportedSet = DetectInstructionSet();
+
+    // Starts out pointing at the baseline table (constant initialized) so that
+    // batch functions are usable from other static initializers
+    const ysMath::Kernels::Table *ActiveKernels = &Tables[(int)ysMath::InstructionSet::SSE2];
+
+    struct KernelSelector {
+        KernelSelector() { ActiveKernels = &Tables[(int)SupportedSet]; }
+    } Selector;
+
+} /* namespace */
+
+const ysMath::Kernels::Table *ysMath::Kernels::GetTable(InstructionSet set) {
+    if (set >= InstructionSet::Count) return nullptr;
+    return &Tables[(int)set];
+}
+
+ysMath::InstructionSet ysMath::GetSupportedInstructionSet() {
+    return SupportedSet;
+}
+
+ysMath::InstructionSet ysMath::GetInstructionSet() {
+    return ActiveKernels->Set;
+}
+
+bool ysMath::SetInstructionSet(InstructionSet set) {
+    if (set >= InstructionSet::Count || set > SupportedSet) return false;
+
+    ActiveKernels = &Tables[(int)set];
+    return true;
+}
+
+void ysMath::DotBatch(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    ActiveKernels->Dot(v1, v2, result, n);
+}
+
+void ysMath::CrossBatch(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    ActiveKernels->Cross(v1, v2, result, n);
+}
+
+void ysMath::NormalizeBatch(const ysVector *v, ysVector *result, int n) {
+    ActiveKernels->Normalize(v, result, n);
+}
+
+void ysMath::MatMultBatch(const ysMatrix &m, const ysVector *v, ysVector *result, int n) {
+    ActiveKernels->Transform(m, v, result, n);
+}
+
+void ysMath::MatMultBatch(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n) {
+    ActiveKernels->MatMult(m1, m2, result, n);
+}
+
+void ysMath::QuatMultiplyBatch(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n) {
+    ActiveKernels->QuatMultiply(q1, q2, result, n);
+}
+
+void ysMath::LoadMatrixBatch(const ysQuaternion *quats, ysMatrix *result, int n) {
+    ActiveKernels->LoadMatrix(quats, result, n);
+}
+
+void ysMath::QuatNlerpBatch(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n) {
+    ActiveKernels->QuatNlerp(q1, q2, t, result, n);
+}
+
+void ysMath::SinCosBatch(const float *v, float *s, float *c, int n) {
+    ActiveKernels->SinCos(v, s, c, n);
+}
+
+void ysMath::ExpBatch(const float *v, float *result, int n) {
+    ActiveKernels->Exp(v, result, n);
+}
+
+void ysMath::PowBatch(const float *base, const float *exponent, float *result, int n) {
+    ActiveKernels->Pow(base, exponent, result, n);
+}
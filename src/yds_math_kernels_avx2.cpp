@@ -0,0 +1,386 @@
+#include "../include/yds_math_kernels.h"
+
+// AVX2 + FMA kernels
+//
+// A 256-bit register holds two ysVectors. The 128-bit algorithms map
+// directly onto it since _mm256_shuffle_ps operates on each 128-bit lane
+// independently. Odd remainders fall back to the SSE2 kernels.
+
+#define YDS_AVX2 YDS_MATH_TARGET("avx2,fma")
+
+namespace {
+
+    YDS_AVX2
+    inline __m256 Load2(const ysVector *v) {
+        return _mm256_loadu_ps(reinterpret_cast<const float *>(v));
+    }
+
+    YDS_AVX2
+    inline void Store2(ysVector *v, __m256 r) {
+        _mm256_storeu_ps(reinterpret_cast<float *>(v), r);
+    }
+
+    YDS_AVX2
+    inline __m256 Dot2(__m256 a, __m256 b) {
+        __m256 t0 = _mm256_mul_ps(a, b);
+        __m256 t1 = _mm256_shuffle_ps(t0, t0, _MM_SHUFFLE(1, 0, 3, 2));
+        __m256 t2 = _mm256_add_ps(t0, t1);
+        __m256 t3 = _mm256_shuffle_ps(t2, t2, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm256_add_ps(t3, t2);
+    }
+
+} /* namespace */
+
+YDS_AVX2
+void ysMath::Kernels::DotAvx2(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        Store2(result + i, Dot2(Load2(v1 + i), Load2(v2 + i)));
+    }
+
+    _mm256_zeroupper();
+    DotSse2(v1 + i, v2 + i, result + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::CrossAvx2(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    const __m256 maskOffW = _mm256_broadcast_ps(&ysMath::Constants::MaskOffW.vector);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m256 a = Load2(v1 + i);
+        __m256 b = Load2(v2 + i);
+
+        __m256 t1 = _mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m256 t2 = _mm256_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+        __m256 r = _mm256_mul_ps(t1, t2);
+
+        t1 = _mm256_shuffle_ps(t1, t1, _MM_SHUFFLE(3, 0, 2, 1));
+        t2 = _mm256_shuffle_ps(t2, t2, _MM_SHUFFLE(3, 1, 0, 2));
+        r = _mm256_fnmadd_ps(t1, t2, r);
+
+        Store2(result + i, _mm256_and_ps(r, maskOffW));
+    }
+
+    _mm256_zeroupper();
+    CrossSse2(v1 + i, v2 + i, result + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::NormalizeAvx2(const ysVector *v, ysVector *result, int n) {
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m256 a = Load2(v + i);
+        Store2(result + i, _mm256_div_ps(a, _mm256_sqrt_ps(Dot2(a, a))));
+    }
+
+    _mm256_zeroupper();
+    NormalizeSse2(v + i, result + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::TransformAvx2(const ysMatrix &m, const ysVector *v, ysVector *result, int n) {
+    const ysMatrix t = ysMath::Transpose(m);
+
+    const __m256 t0 = _mm256_broadcast_ps(&t.rows[0]);
+    const __m256 t1 = _mm256_broadcast_ps(&t.rows[1]);
+    const __m256 t2 = _mm256_broadcast_ps(&t.rows[2]);
+    const __m256 t3 = _mm256_broadcast_ps(&t.rows[3]);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m256 u = Load2(v + i);
+
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(u, u, _MM_SHUFFLE(0, 0, 0, 0)), t0);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(u, u, _MM_SHUFFLE(1, 1, 1, 1)), t1, r);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(u, u, _MM_SHUFFLE(2, 2, 2, 2)), t2, r);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(u, u, _MM_SHUFFLE(3, 3, 3, 3)), t3, r);
+
+        Store2(result + i, r);
+    }
+
+    _mm256_zeroupper();
+    TransformSse2(m, v + i, result + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::MatMultAvx2(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n) {
+    for (int i = 0; i < n; i++) {
+        // Load everything up front so that the result may alias either input
+        const __m256 b0 = _mm256_broadcast_ps(&m2[i].rows[0]);
+        const __m256 b1 = _mm256_broadcast_ps(&m2[i].rows[1]);
+        const __m256 b2 = _mm256_broadcast_ps(&m2[i].rows[2]);
+        const __m256 b3 = _mm256_broadcast_ps(&m2[i].rows[3]);
+
+        __m256 a01 = Load2(&m1[i].rows[0]);
+        __m256 a23 = Load2(&m1[i].rows[2]);
+
+        __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        __m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(1, 1, 1, 1)), b1, r01);
+        r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(1, 1, 1, 1)), b1, r23);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(2, 2, 2, 2)), b2, r01);
+        r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(2, 2, 2, 2)), b2, r23);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(3, 3, 3, 3)), b3, r01);
+        r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(3, 3, 3, 3)), b3, r23);
+
+        Store2(&result[i].rows[0], r01);
+        Store2(&result[i].rows[2], r23);
+    }
+
+    _mm256_zeroupper();
+}
+
+YDS_AVX2
+void ysMath::Kernels::QuatMultiplyAvx2(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n) {
+    const __m256 sgn2 = _mm256_set_ps(1, -1, 1, -1, 1, -1, 1, -1);
+    const __m256 sgn3 = _mm256_set_ps(-1, 1, 1, -1, -1, 1, 1, -1);
+    const __m256 sgn4 = _mm256_set_ps(1, 1, -1, -1, 1, 1, -1, -1);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m256 a = Load2(q1 + i);
+        __m256 b = Load2(q2 + i);
+
+        __m256 m2 = _mm256_mul_ps(_mm256_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), sgn2);
+        __m256 m3 = _mm256_mul_ps(_mm256_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), sgn3);
+        __m256 m4 = _mm256_mul_ps(_mm256_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), sgn4);
+
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), m2, r);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), m3, r);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), m4, r);
+
+        Store2(result + i, r);
+    }
+
+    _mm256_zeroupper();
+    QuatMultiplySse2(q1 + i, q2 + i, result + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::LoadMatrixAvx2(const ysQuaternion *quats, ysMatrix *result, int n) {
+    const __m256 one = _mm256_broadcast_ps(&ysMath::Constants::One);
+    const __m256 maskOffW = _mm256_broadcast_ps(&ysMath::Constants::MaskOffW.vector);
+    const __m256 identityRow4 = _mm256_broadcast_ps(&ysMath::Constants::IdentityRow4);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        // Same 21 instruction sequence as ysMath::LoadMatrix(quat), two quaternions at a time
+        __m256 q = Load2(quats + i);
+        __m256 nq = _mm256_sub_ps(_mm256_setzero_ps(), q);
+        __m256 qq = _mm256_add_ps(q, q);
+        __m256 q2 = _mm256_mul_ps(qq, q);
+
+        __m256 xyxx = _mm256_shuffle_ps(q, q, _MM_SHUFFLE(1, 1, 2, 1));
+        __m256 yzzy = _mm256_shuffle_ps(qq, qq, _MM_SHUFFLE(2, 3, 3, 2));
+        __m256 zxyz = _mm256_shuffle_ps(qq, qq, _MM_SHUFFLE(3, 2, 1, 3));
+        __m256 wwww = _mm256_shuffle_ps(q, nq, _MM_SHUFFLE(0, 0, 0, 0));
+
+        __m256 i1 = _mm256_mul_ps(xyxx, yzzy);
+        __m256 i2 = _mm256_mul_ps(zxyz, wwww);
+        __m256 calc1 = _mm256_add_ps(i1, i2);
+
+        __m256 y2_x2_x2_w2 = _mm256_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 1, 1, 2));
+        __m256 z2_z2_y2_w2 = _mm256_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 2, 3, 3));
+
+        __m256 calc2 = _mm256_sub_ps(one, _mm256_add_ps(y2_x2_x2_w2, z2_z2_y2_w2));
+        calc2 = _mm256_and_ps(calc2, maskOffW);
+
+        __m256 calc3 = _mm256_sub_ps(i1, i2);
+
+        __m256 asm1 = _mm256_shuffle_ps(calc2, calc1, _MM_SHUFFLE(2, 0, 3, 0));
+        asm1 = _mm256_shuffle_ps(asm1, asm1, _MM_SHUFFLE(1, 3, 2, 0));
+
+        __m256 asm2 = _mm256_shuffle_ps(calc2, calc1, _MM_SHUFFLE(1, 3, 3, 1));
+        asm2 = _mm256_shuffle_ps(asm2, asm2, _MM_SHUFFLE(1, 3, 0, 2));
+
+        __m256 asm3 = _mm256_shuffle_ps(calc3, calc2, _MM_SHUFFLE(3, 2, 1, 2));
+
+        // Lane 0 belongs to the first matrix and lane 1 to the second
+        Store2(&result[i].rows[0], _mm256_permute2f128_ps(asm1, asm2, 0x20));
+        Store2(&result[i].rows[2], _mm256_permute2f128_ps(asm3, identityRow4, 0x20));
+        Store2(&result[i + 1].rows[0], _mm256_permute2f128_ps(asm1, asm2, 0x31));
+        Store2(&result[i + 1].rows[2], _mm256_permute2f128_ps(asm3, identityRow4, 0x31));
+    }
+
+    _mm256_zeroupper();
+    LoadMatrixSse2(quats + i, result + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::QuatNlerpAvx2(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n) {
+    const __m256 vt = _mm256_set1_ps(t);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m256 a = Load2(q1 + i);
+        __m256 b = Load2(q2 + i);
+
+        // Shortest path
+        b = _mm256_xor_ps(b, _mm256_and_ps(Dot2(a, b), signBit));
+
+        __m256 r = _mm256_fmadd_ps(_mm256_sub_ps(b, a), vt, a);
+        Store2(result + i, _mm256_div_ps(r, _mm256_sqrt_ps(Dot2(r, r))));
+    }
+
+    _mm256_zeroupper();
+    QuatNlerpSse2(q1 + i, q2 + i, t, result + i, n - i);
+}
+
+// Transcendentals (eight lanes per iteration)
+//
+// Same polynomials and range reduction as ysMath::SinCos, ysMath::Exp and
+// ysMath::Log, widened to 256 bits.
+
+namespace {
+
+    namespace P = ysMath::Constants::Polynomial;
+
+    YDS_AVX2
+    inline __m256 Set1(float s) {
+        return _mm256_set1_ps(s);
+    }
+
+    YDS_AVX2
+    inline void SinCos8(__m256 v, __m256 *s, __m256 *c) {
+        const __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(v, Set1(P::TwoOverPi)));
+        const __m256 qf = _mm256_cvtepi32_ps(q);
+
+        __m256 r = _mm256_fnmadd_ps(qf, Set1(P::PiOver2Hi), v);
+        r = _mm256_fnmadd_ps(qf, Set1(P::PiOver2Mid), r);
+        r = _mm256_fnmadd_ps(qf, Set1(P::PiOver2Lo), r);
+        const __m256 r2 = _mm256_mul_ps(r, r);
+
+        __m256 ps = _mm256_fmadd_ps(Set1(P::Sin0), r2, Set1(P::Sin1));
+        ps = _mm256_fmadd_ps(ps, r2, Set1(P::Sin2));
+        ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, r2), r, r);
+
+        __m256 pc = _mm256_fmadd_ps(Set1(P::Cos0), r2, Set1(P::Cos1));
+        pc = _mm256_fmadd_ps(pc, r2, Set1(P::Cos2));
+        pc = _mm256_mul_ps(_mm256_mul_ps(pc, r2), r2);
+        pc = _mm256_add_ps(_mm256_fnmadd_ps(r2, Set1(0.5f), pc), Set1(1.0f));
+
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i two = _mm256_set1_epi32(2);
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+        const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+        const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+
+        *s = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap), sinSign);
+        *c = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap), cosSign);
+    }
+
+    YDS_AVX2
+    inline __m256 Exp8(__m256 v) {
+        const __m256 expMin = Set1(P::ExpMin);
+        const __m256 expMax = Set1(P::ExpMax);
+        const __m256 x = _mm256_min_ps(expMax, _mm256_max_ps(expMin, v));
+
+        const __m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(x, Set1(P::Log2E)));
+        const __m256 nf = _mm256_cvtepi32_ps(n);
+
+        __m256 r = _mm256_fnmadd_ps(nf, Set1(P::Ln2Hi), x);
+        r = _mm256_fnmadd_ps(nf, Set1(P::Ln2Lo), r);
+        const __m256 r2 = _mm256_mul_ps(r, r);
+
+        __m256 p = _mm256_fmadd_ps(Set1(P::Exp0), r, Set1(P::Exp1));
+        p = _mm256_fmadd_ps(p, r, Set1(P::Exp2));
+        p = _mm256_fmadd_ps(p, r, Set1(P::Exp3));
+        p = _mm256_fmadd_ps(p, r, Set1(P::Exp4));
+        p = _mm256_fmadd_ps(p, r, Set1(P::Exp5));
+        p = _mm256_add_ps(_mm256_fmadd_ps(p, r2, r), Set1(1.0f));
+
+        const __m256 pow2n = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+        __m256 result = _mm256_mul_ps(p, pow2n);
+
+        result = _mm256_andnot_ps(_mm256_cmp_ps(v, expMin, _CMP_LT_OQ), result);
+        result = _mm256_blendv_ps(result, Set1(INFINITY), _mm256_cmp_ps(v, expMax, _CMP_GT_OQ));
+
+        return result;
+    }
+
+    YDS_AVX2
+    inline __m256 Log8(__m256 v) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256i bits = _mm256_castps_si256(_mm256_max_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x00800000))));
+        const __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126));
+        const __m256 m = _mm256_castsi256_ps(
+            _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x807FFFFF)), _mm256_set1_epi32(0x3F000000)));
+
+        const __m256 small = _mm256_cmp_ps(m, Set1(P::SqrtHalf), _CMP_LT_OQ);
+        const __m256 ef = _mm256_sub_ps(_mm256_cvtepi32_ps(e), _mm256_and_ps(small, Set1(1.0f)));
+        __m256 x = _mm256_add_ps(_mm256_sub_ps(m, Set1(1.0f)), _mm256_and_ps(small, m));
+        const __m256 x2 = _mm256_mul_ps(x, x);
+
+        __m256 p = _mm256_fmadd_ps(Set1(P::Log0), x, Set1(P::Log1));
+        p = _mm256_fmadd_ps(p, x, Set1(P::Log2));
+        p = _mm256_fmadd_ps(p, x, Set1(P::Log3));
+        p = _mm256_fmadd_ps(p, x, Set1(P::Log4));
+        p = _mm256_fmadd_ps(p, x, Set1(P::Log5));
+        p = _mm256_fmadd_ps(p, x, Set1(P::Log6));
+        p = _mm256_fmadd_ps(p, x, Set1(P::Log7));
+        p = _mm256_fmadd_ps(p, x, Set1(P::Log8));
+        p = _mm256_mul_ps(_mm256_mul_ps(p, x), x2);
+
+        p = _mm256_fmadd_ps(ef, Set1(P::Ln2Lo), p);
+        p = _mm256_fnmadd_ps(x2, Set1(0.5f), p);
+        x = _mm256_add_ps(x, p);
+        x = _mm256_fmadd_ps(ef, Set1(P::Ln2Hi), x);
+
+        x = _mm256_blendv_ps(x, Set1(-INFINITY), _mm256_cmp_ps(v, zero, _CMP_EQ_OQ));
+        x = _mm256_blendv_ps(x, v, _mm256_cmp_ps(v, Set1(INFINITY), _CMP_EQ_OQ));
+        x = _mm256_or_ps(x, _mm256_cmp_ps(v, zero, _CMP_NGE_UQ));
+
+        return x;
+    }
+
+} /* namespace */
+
+YDS_AVX2
+void ysMath::Kernels::SinCosAvx2(const float *v, float *s, float *c, int n) {
+    __m256 rs, rc;
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        SinCos8(_mm256_loadu_ps(v + i), &rs, &rc);
+        _mm256_storeu_ps(s + i, rs);
+        _mm256_storeu_ps(c + i, rc);
+    }
+
+    _mm256_zeroupper();
+    SinCosSse2(v + i, s + i, c + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::ExpAvx2(const float *v, float *result, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(result + i, Exp8(_mm256_loadu_ps(v + i)));
+    }
+
+    _mm256_zeroupper();
+    ExpSse2(v + i, result + i, n - i);
+}
+
+YDS_AVX2
+void ysMath::Kernels::PowAvx2(const float *base, const float *exponent, float *result, int n) {
+    int i = 0;
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        const __m256 b = _mm256_loadu_ps(base + i);
+        const __m256 e = _mm256_loadu_ps(exponent + i);
+        __m256 r = Exp8(_mm256_mul_ps(e, Log8(b)));
+
+        // Same special cases as ysMath::Pow()
+        const __m256 zeroBase = _mm256_and_ps(_mm256_cmp_ps(b, zero, _CMP_EQ_OQ), _mm256_cmp_ps(e, zero, _CMP_GT_OQ));
+        r = _mm256_blendv_ps(r, zero, zeroBase);
+        r = _mm256_blendv_ps(r, Set1(1.0f), _mm256_cmp_ps(e, zero, _CMP_EQ_OQ));
+
+        _mm256_storeu_ps(result + i, r);
+    }
+
+    _mm256_zeroupper();
+    PowSse2(base + i, exponent + i, result + i, n - i);
+}
@@ -0,0 +1,230 @@
+#include "../include/yds_math_kernels.h"
+
+// AVX-512F kernels
+//
+// A 512-bit register holds four ysVectors, or one full ysMatrix. Only
+// AVX-512F is assumed so the w component is cleared with a zero-masked
+// move rather than _mm512_and_ps (which requires AVX-512DQ). Remainders
+// fall back to the AVX2 kernels.
+
+#define YDS_AVX512 YDS_MATH_TARGET("avx512f,avx2,fma")
+
+namespace {
+
+    // Clears the w component of every 128-bit lane
+    const __mmask16 MaskOffW = 0x7777;
+
+    YDS_AVX512
+    inline __m512 Load4(const ysVector *v) {
+        return _mm512_loadu_ps(reinterpret_cast<const float *>(v));
+    }
+
+    YDS_AVX512
+    inline void Store4(ysVector *v, __m512 r) {
+        _mm512_storeu_ps(reinterpret_cast<float *>(v), r);
+    }
+
+    YDS_AVX512
+    inline __m512 Broadcast(const ysVector &v) {
+        return _mm512_broadcast_f32x4(v);
+    }
+
+    YDS_AVX512
+    inline __m512 Dot4(__m512 a, __m512 b) {
+        __m512 t0 = _mm512_mul_ps(a, b);
+        __m512 t1 = _mm512_shuffle_ps(t0, t0, _MM_SHUFFLE(1, 0, 3, 2));
+        __m512 t2 = _mm512_add_ps(t0, t1);
+        __m512 t3 = _mm512_shuffle_ps(t2, t2, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm512_add_ps(t3, t2);
+    }
+
+} /* namespace */
+
+YDS_AVX512
+void ysMath::Kernels::DotAvx512(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        Store4(result + i, Dot4(Load4(v1 + i), Load4(v2 + i)));
+    }
+
+    DotAvx2(v1 + i, v2 + i, result + i, n - i);
+}
+
+YDS_AVX512
+void ysMath::Kernels::CrossAvx512(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m512 a = Load4(v1 + i);
+        __m512 b = Load4(v2 + i);
+
+        __m512 t1 = _mm512_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m512 t2 = _mm512_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+        __m512 r = _mm512_mul_ps(t1, t2);
+
+        t1 = _mm512_shuffle_ps(t1, t1, _MM_SHUFFLE(3, 0, 2, 1));
+        t2 = _mm512_shuffle_ps(t2, t2, _MM_SHUFFLE(3, 1, 0, 2));
+        r = _mm512_fnmadd_ps(t1, t2, r);
+
+        Store4(result + i, _mm512_maskz_mov_ps(MaskOffW, r));
+    }
+
+    CrossAvx2(v1 + i, v2 + i, result + i, n - i);
+}
+
+YDS_AVX512
+void ysMath::Kernels::NormalizeAvx512(const ysVector *v, ysVector *result, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m512 a = Load4(v + i);
+        Store4(result + i, _mm512_div_ps(a, _mm512_sqrt_ps(Dot4(a, a))));
+    }
+
+    NormalizeAvx2(v + i, result + i, n - i);
+}
+
+YDS_AVX512
+void ysMath::Kernels::TransformAvx512(const ysMatrix &m, const ysVector *v, ysVector *result, int n) {
+    const ysMatrix t = ysMath::Transpose(m);
+
+    const __m512 t0 = Broadcast(t.rows[0]);
+    const __m512 t1 = Broadcast(t.rows[1]);
+    const __m512 t2 = Broadcast(t.rows[2]);
+    const __m512 t3 = Broadcast(t.rows[3]);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m512 u = Load4(v + i);
+
+        __m512 r = _mm512_mul_ps(_mm512_shuffle_ps(u, u, _MM_SHUFFLE(0, 0, 0, 0)), t0);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(u, u, _MM_SHUFFLE(1, 1, 1, 1)), t1, r);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(u, u, _MM_SHUFFLE(2, 2, 2, 2)), t2, r);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(u, u, _MM_SHUFFLE(3, 3, 3, 3)), t3, r);
+
+        Store4(result + i, r);
+    }
+
+    TransformAvx2(m, v + i, result + i, n - i);
+}
+
+YDS_AVX512
+void ysMath::Kernels::MatMultAvx512(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n) {
+    for (int i = 0; i < n; i++) {
+        // The whole left-hand matrix fits in a single register
+        const __m512 b0 = Broadcast(m2[i].rows[0]);
+        const __m512 b1 = Broadcast(m2[i].rows[1]);
+        const __m512 b2 = Broadcast(m2[i].rows[2]);
+        const __m512 b3 = Broadcast(m2[i].rows[3]);
+
+        __m512 a = Load4(m1[i].rows);
+
+        __m512 r = _mm512_mul_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b1, r);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b2, r);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b3, r);
+
+        Store4(result[i].rows, r);
+    }
+
+    _mm256_zeroupper();
+}
+
+YDS_AVX512
+void ysMath::Kernels::QuatMultiplyAvx512(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n) {
+    const __m512 sgn2 = Broadcast(_mm_set_ps(1, -1, 1, -1));
+    const __m512 sgn3 = Broadcast(_mm_set_ps(-1, 1, 1, -1));
+    const __m512 sgn4 = Broadcast(_mm_set_ps(1, 1, -1, -1));
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m512 a = Load4(q1 + i);
+        __m512 b = Load4(q2 + i);
+
+        __m512 m2 = _mm512_mul_ps(_mm512_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), sgn2);
+        __m512 m3 = _mm512_mul_ps(_mm512_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), sgn3);
+        __m512 m4 = _mm512_mul_ps(_mm512_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), sgn4);
+
+        __m512 r = _mm512_mul_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), m2, r);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), m3, r);
+        r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), m4, r);
+
+        Store4(result + i, r);
+    }
+
+    QuatMultiplyAvx2(q1 + i, q2 + i, result + i, n - i);
+}
+
+YDS_AVX512
+void ysMath::Kernels::LoadMatrixAvx512(const ysQuaternion *quats, ysMatrix *result, int n) {
+    const __m512 one = Broadcast(ysMath::Constants::One);
+    const __m512 identityRow4 = Broadcast(ysMath::Constants::IdentityRow4);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        // Same 21 instruction sequence as ysMath::LoadMatrix(quat), four quaternions at a time
+        __m512 q = Load4(quats + i);
+        __m512 nq = _mm512_sub_ps(_mm512_setzero_ps(), q);
+        __m512 qq = _mm512_add_ps(q, q);
+        __m512 q2 = _mm512_mul_ps(qq, q);
+
+        __m512 xyxx = _mm512_shuffle_ps(q, q, _MM_SHUFFLE(1, 1, 2, 1));
+        __m512 yzzy = _mm512_shuffle_ps(qq, qq, _MM_SHUFFLE(2, 3, 3, 2));
+        __m512 zxyz = _mm512_shuffle_ps(qq, qq, _MM_SHUFFLE(3, 2, 1, 3));
+        __m512 wwww = _mm512_shuffle_ps(q, nq, _MM_SHUFFLE(0, 0, 0, 0));
+
+        __m512 i1 = _mm512_mul_ps(xyxx, yzzy);
+        __m512 i2 = _mm512_mul_ps(zxyz, wwww);
+        __m512 calc1 = _mm512_add_ps(i1, i2);
+
+        __m512 y2_x2_x2_w2 = _mm512_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 1, 1, 2));
+        __m512 z2_z2_y2_w2 = _mm512_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 2, 3, 3));
+
+        __m512 calc2 = _mm512_sub_ps(one, _mm512_add_ps(y2_x2_x2_w2, z2_z2_y2_w2));
+        calc2 = _mm512_maskz_mov_ps(MaskOffW, calc2);
+
+        __m512 calc3 = _mm512_sub_ps(i1, i2);
+
+        __m512 asm1 = _mm512_shuffle_ps(calc2, calc1, _MM_SHUFFLE(2, 0, 3, 0));
+        asm1 = _mm512_shuffle_ps(asm1, asm1, _MM_SHUFFLE(1, 3, 2, 0));
+
+        __m512 asm2 = _mm512_shuffle_ps(calc2, calc1, _MM_SHUFFLE(1, 3, 3, 1));
+        asm2 = _mm512_shuffle_ps(asm2, asm2, _MM_SHUFFLE(1, 3, 0, 2));
+
+        __m512 asm3 = _mm512_shuffle_ps(calc3, calc2, _MM_SHUFFLE(3, 2, 1, 2));
+
+        // Lane j of asm1/asm2/asm3 holds a row of matrix j. Transpose the
+        // 128-bit lanes so that each register holds one complete matrix.
+        __m512 t0 = _mm512_shuffle_f32x4(asm1, asm2, _MM_SHUFFLE(1, 0, 1, 0));
+        __m512 t1 = _mm512_shuffle_f32x4(asm1, asm2, _MM_SHUFFLE(3, 2, 3, 2));
+        __m512 t2 = _mm512_shuffle_f32x4(asm3, identityRow4, _MM_SHUFFLE(1, 0, 1, 0));
+        __m512 t3 = _mm512_shuffle_f32x4(asm3, identityRow4, _MM_SHUFFLE(3, 2, 3, 2));
+
+        Store4(result[i + 0].rows, _mm512_shuffle_f32x4(t0, t2, _MM_SHUFFLE(2, 0, 2, 0)));
+        Store4(result[i + 1].rows, _mm512_shuffle_f32x4(t0, t2, _MM_SHUFFLE(3, 1, 3, 1)));
+        Store4(result[i + 2].rows, _mm512_shuffle_f32x4(t1, t3, _MM_SHUFFLE(2, 0, 2, 0)));
+        Store4(result[i + 3].rows, _mm512_shuffle_f32x4(t1, t3, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    LoadMatrixAvx2(quats + i, result + i, n - i);
+}
+
+YDS_AVX512
+void ysMath::Kernels::QuatNlerpAvx512(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n) {
+    const __m512 vt = _mm512_set1_ps(t);
+    const __m512 zero = _mm512_setzero_ps();
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m512 a = Load4(q1 + i);
+        __m512 b = Load4(q2 + i);
+
+        // Shortest path, negate with a masked subtract since xor requires AVX-512DQ
+        const __mmask16 flip = _mm512_cmp_ps_mask(Dot4(a, b), zero, _CMP_LT_OQ);
+        b = _mm512_mask_sub_ps(b, flip, zero, b);
+
+        __m512 r = _mm512_fmadd_ps(_mm512_sub_ps(b, a), vt, a);
+        Store4(result + i, _mm512_div_ps(r, _mm512_sqrt_ps(Dot4(r, r))));
+    }
+
+    QuatNlerpAvx2(q1 + i, q2 + i, t, result + i, n - i);
+}
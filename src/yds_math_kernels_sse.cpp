@@ -0,0 +1,143 @@
+#include "../include/yds_math_kernels.h"
+
+// SSE2
+
+void ysMath::Kernels::DotSse2(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    for (int i = 0; i < n; i++) {
+        ysVector t0 = _mm_mul_ps(v1[i], v2[i]);
+        ysVector t1 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1, 0, 3, 2));
+        ysVector t2 = _mm_add_ps(t0, t1);
+        ysVector t3 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2, 3, 0, 1));
+        result[i] = _mm_add_ps(t3, t2);
+    }
+}
+
+void ysMath::Kernels::CrossSse2(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    for (int i = 0; i < n; i++) {
+        result[i] = ysMath::Cross(v1[i], v2[i]);
+    }
+}
+
+void ysMath::Kernels::NormalizeSse2(const ysVector *v, ysVector *result, int n) {
+    ysVector dot;
+    for (int i = 0; i < n; i++) {
+        DotSse2(v + i, v + i, &dot, 1);
+        result[i] = _mm_div_ps(v[i], _mm_sqrt_ps(dot));
+    }
+}
+
+void ysMath::Kernels::TransformSse2(const ysMatrix &m, const ysVector *v, ysVector *result, int n) {
+    // Transpose once for the whole batch rather than once per vector
+    const ysMatrix t = ysMath::Transpose(m);
+
+    for (int i = 0; i < n; i++) {
+        const ysVector u = v[i];
+
+        ysVector r = _mm_mul_ps(_mm_replicate_x_ps(u), t.rows[0]);
+        r = _mm_add_ps(_mm_mul_ps(_mm_replicate_y_ps(u), t.rows[1]), r);
+        r = _mm_add_ps(_mm_mul_ps(_mm_replicate_z_ps(u), t.rows[2]), r);
+        r = _mm_add_ps(_mm_mul_ps(_mm_replicate_w_ps(u), t.rows[3]), r);
+
+        result[i] = r;
+    }
+}
+
+void ysMath::Kernels::MatMultSse2(const ysMatrix *m1, const ysMatrix *m2, ysMatrix *result, int n) {
+    for (int i = 0; i < n; i++) {
+        result[i] = ysMath::MatMult(m1[i], m2[i]);
+    }
+}
+
+void ysMath::Kernels::QuatMultiplySse2(const ysQuaternion *q1, const ysQuaternion *q2, ysQuaternion *result, int n) {
+    for (int i = 0; i < n; i++) {
+        result[i] = ysMath::QuatMultiply(q1[i], q2[i]);
+    }
+}
+
+void ysMath::Kernels::LoadMatrixSse2(const ysQuaternion *quats, ysMatrix *result, int n) {
+    for (int i = 0; i < n; i++) {
+        result[i] = ysMath::LoadMatrix(quats[i]);
+    }
+}
+
+void ysMath::Kernels::QuatNlerpSse2(const ysQuaternion *q1, const ysQuaternion *q2, float t, ysQuaternion *result, int n) {
+    for (int i = 0; i < n; i++) {
+        result[i] = ysMath::QuatNlerp(q1[i], q2[i], t);
+    }
+}
+
+// SSE4.1
+
+YDS_MATH_TARGET("sse4.1")
+void ysMath::Kernels::DotSse41(const ysVector *v1, const ysVector *v2, ysVector *result, int n) {
+    for (int i = 0; i < n; i++) {
+        result[i] = _mm_dp_ps(v1[i], v2[i], 0xFF);
+    }
+}
+
+YDS_MATH_TARGET("sse4.1")
+void ysMath::Kernels::NormalizeSse41(const ysVector *v, ysVector *result, int n) {
+    for (int i = 0; i < n; i++) {
+        result[i] = _mm_div_ps(v[i], _mm_sqrt_ps(_mm_dp_ps(v[i], v[i], 0xFF)));
+    }
+}
+
+// Transcendentals (four lanes per iteration)
+
+namespace {
+
+    // Loads the last n < 4 elements padded with ones so that every
+    // function stays in its valid range
+    inline ysGeneric LoadPartial(const float *v, int n) {
+        float t[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for (int i = 0; i < n; i++) t[i] = v[i];
+        return _mm_loadu_ps(t);
+    }
+
+    inline void StorePartial(float *v, const ysGeneric &r, int n) {
+        float t[4];
+        _mm_storeu_ps(t, r);
+        for (int i = 0; i < n; i++) v[i] = t[i];
+    }
+
+} /* namespace */
+
+void ysMath::Kernels::SinCosSse2(const float *v, float *s, float *c, int n) {
+    ysGeneric rs, rc;
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        ysMath::SinCos(_mm_loadu_ps(v + i), &rs, &rc);
+        _mm_storeu_ps(s + i, rs);
+        _mm_storeu_ps(c + i, rc);
+    }
+
+    if (i < n) {
+        ysMath::SinCos(LoadPartial(v + i, n - i), &rs, &rc);
+        StorePartial(s + i, rs, n - i);
+        StorePartial(c + i, rc, n - i);
+    }
+}
+
+void ysMath::Kernels::ExpSse2(const float *v, float *result, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(result + i, ysMath::Exp(_mm_loadu_ps(v + i)));
+    }
+
+    if (i < n) {
+        StorePartial(result + i, ysMath::Exp(LoadPartial(v + i, n - i)), n - i);
+    }
+}
+
+void ysMath::Kernels::PowSse2(const float *base, const float *exponent, float *result, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(result + i, ysMath::Pow(_mm_loadu_ps(base + i), _mm_loadu_ps(exponent + i)));
+    }
+
+    if (i < n) {
+        const ysGeneric r = ysMath::Pow(LoadPartial(base + i, n - i), LoadPartial(exponent + i, n - i));
+        StorePartial(result + i, r, n - i);
+    }
+}
@@ -1,11 +1,11 @@
 #include "../include/yds_memory_base.h"
 
 ysMemoryAllocator::ysMemoryAllocator() : ysObject("MEMORY_ALLOCATOR") {
-    /* void */
+    m_memoryTag = ysMemoryTag::General;
 }
 
 ysMemoryAllocator::ysMemoryAllocator(const char *typeID) : ysObject(typeID) {
-    /* void */
+    m_memoryTag = ysMemoryTag::General;
 }
 
 ysMemoryAllocator::~ysMemoryAllocator() {
@@ -0,0 +1,170 @@
+#include "../include/yds_memory_tracker.h"
+
+#include <atomic>
+
+namespace {
+
+    struct TagCounters {
+        std::atomic<int64_t> LiveBytes;
+        std::atomic<int64_t> LiveAllocations;
+        std::atomic<int64_t> PeakBytes;
+        std::atomic<int64_t> TotalAllocations;
+        std::atomic<int64_t> TotalBytes;
+        std::atomic<int64_t> IntervalAllocations;
+        std::atomic<int64_t> IntervalBytes;
+        std::atomic<int64_t> Budget;
+    };
+
+    // Zero initialized before any dynamic initialization runs, so allocations
+    // made by other static constructors are counted correctly
+    TagCounters Counters[ysMemoryTracker::TagCount];
+    std::atomic<ysMemoryTracker::BudgetCallback> Callback;
+
+    const char *TagNames[ysMemoryTracker::TagCount] = {
+        "General",
+        "Physics",
+        "Assets",
+        "Audio",
+        "Render",
+        "UI"
+    };
+
+    // Prefix of every block from ysTrackedAllocate(), keeps the block 16 byte aligned
+    struct TrackedHeader {
+        uint64_t Size;
+        uint32_t Tag;
+        uint32_t Padding;
+    };
+
+} /* namespace */
+
+void ysMemoryTracker::RecordAllocation(ysMemoryTag tag, size_t size) {
+    TagCounters &counters = Counters[(int)tag];
+    const int64_t bytes = (int64_t)size;
+
+    const int64_t live = counters.LiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.LiveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.TotalBytes.fetch_add(bytes, std::memory_order_relaxed);
+    counters.IntervalAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.IntervalBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    int64_t peak = counters.PeakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.PeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        /* void */
+    }
+
+    // Only report the allocation that crosses the budget
+    const int64_t budget = counters.Budget.load(std::memory_order_relaxed);
+    if (budget > 0 && live > budget && live - bytes <= budget) {
+        BudgetCallback callback = Callback.load(std::memory_order_acquire);
+        if (callback != nullptr) callback(tag, live, budget);
+    }
+}
+
+void ysMemoryTracker::RecordFree(ysMemoryTag tag, size_t size) {
+    TagCounters &counters = Counters[(int)tag];
+
+    counters.LiveBytes.fetch_sub((int64_t)size, std::memory_order_relaxed);
+    counters.LiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ysMemoryTracker::GetStatistics(ysMemoryTag tag, TagStatistics *statistics) {
+    const TagCounters &counters = Counters[(int)tag];
+
+    statistics->LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+    statistics->LiveAllocations = counters.LiveAllocations.load(std::memory_order_relaxed);
+    statistics->PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed);
+    statistics->TotalAllocations = counters.TotalAllocations.load(std::memory_order_relaxed);
+    statistics->TotalBytes = counters.TotalBytes.load(std::memory_order_relaxed);
+    statistics->IntervalAllocations = counters.IntervalAllocations.load(std::memory_order_relaxed);
+    statistics->IntervalBytes = counters.IntervalBytes.load(std::memory_order_relaxed);
+    statistics->Budget = counters.Budget.load(std::memory_order_relaxed);
+}
+
+void ysMemoryTracker::ResetInterval() {
+    for (int i = 0; i < TagCount; i++) {
+        Counters[i].IntervalAllocations.store(0, std::memory_order_relaxed);
+        Counters[i].IntervalBytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ysMemoryTracker::SetBudget(ysMemoryTag tag, int64_t bytes) {
+    Counters[(int)tag].Budget.store(bytes, std::memory_order_relaxed);
+}
+
+bool ysMemoryTracker::IsOverBudget(ysMemoryTag tag) {
+    const TagCounters &counters = Counters[(int)tag];
+    const int64_t budget = counters.Budget.load(std::memory_order_relaxed);
+
+    return budget > 0 && counters.LiveBytes.load(std::memory_order_relaxed) > budget;
+}
+
+void ysMemoryTracker::SetBudgetCallback(BudgetCallback callback) {
+    Callback.store(callback, std::memory_order_release);
+}
+
+void ysMemoryTracker::Dump(FILE *file) {
+    if (!IsEnabled()) {
+        fprintf(file, "Memory tracking is disabled (YS_ENABLE_MEMORY_TRACKING)\n");
+        return;
+    }
+
+    fprintf(file, "%-10s %12s %12s %12s %10s %12s %12s %12s\n",
+        "Tag", "Live (KB)", "Peak (KB)", "Budget (KB)", "Blocks", "Total allocs", "Interval", "Interval (KB)");
+
+    for (int i = 0; i < TagCount; i++) {
+        TagStatistics statistics;
+        GetStatistics((ysMemoryTag)i, &statistics);
+
+        fprintf(file, "%-10s %12.1f %12.1f %12.1f %10lld %12lld %12lld %12.1f%s\n",
+            TagNames[i],
+            statistics.LiveBytes / 1024.0,
+            statistics.PeakBytes / 1024.0,
+            statistics.Budget / 1024.0,
+            (long long)statistics.LiveAllocations,
+            (long long)statistics.TotalAllocations,
+            (long long)statistics.IntervalAllocations,
+            statistics.IntervalBytes / 1024.0,
+            IsOverBudget((ysMemoryTag)i) ? "  OVER BUDGET" : "");
+    }
+}
+
+const char *ysMemoryTracker::GetTagName(ysMemoryTag tag) {
+    return TagNames[(int)tag];
+}
+
+bool ysMemoryTracker::IsEnabled() {
+#ifdef YS_ENABLE_MEMORY_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef YS_ENABLE_MEMORY_TRACKING
+
+void *ysTrackedAllocate(ysMemoryTag tag, size_t size) {
+    void *block = ::malloc(sizeof(TrackedHeader) + size);
+    if (block == nullptr) return nullptr;
+
+    TrackedHeader *header = reinterpret_cast<TrackedHeader *>(block);
+    header->Size = size;
+    header->Tag = (uint32_t)tag;
+    header->Padding = 0;
+
+    ysMemoryTracker::RecordAllocation(tag, size);
+
+    return reinterpret_cast<void *>(header + 1);
+}
+
+void ysTrackedFree(void *block) {
+    if (block == nullptr) return;
+
+    TrackedHeader *header = reinterpret_cast<TrackedHeader *>(block) - 1;
+    ysMemoryTracker::RecordFree((ysMemoryTag)header->Tag, (size_t)header->Size);
+
+    ::free(reinterpret_cast<void *>(header));
+}
+
+#endif /* YS_ENABLE_MEMORY_TRACKING */
@@ -0,0 +1,174 @@
+#include "../include/yds_null_device.h"
+
+#include "../include/yds_null_gpu_buffer.h"
+
+ysNullDevice::ysNullDevice() : ysDevice(NULL_DEVICE) {
+    /* void */
+}
+
+ysNullDevice::~ysNullDevice() {
+    /* void */
+}
+
+ysError ysNullDevice::InitializeDevice() {
+    YDS_ERROR_DECLARE("InitializeDevice");
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError ysNullDevice::DestroyDevice() {
+    YDS_ERROR_DECLARE("DestroyDevice");
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+bool ysNullDevice::CheckSupport() {
+    return true;
+}
+
+ysError ysNullDevice::CreateRenderingContext(ysRenderingContext **renderingContext, ysWindow *window) {
+    YDS_ERROR_DECLARE("CreateRenderingContext");
+
+    if (renderingContext == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *renderingContext = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::UpdateRenderingContext(ysRenderingContext *context) {
+    YDS_ERROR_DECLARE("UpdateRenderingContext");
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreateOnScreenRenderTarget(ysRenderTarget **newTarget, ysRenderingContext *context, bool depthBuffer) {
+    YDS_ERROR_DECLARE("CreateOnScreenRenderTarget");
+
+    if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newTarget = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreateOffScreenRenderTarget(ysRenderTarget **newTarget, int width, int height, ysRenderTarget::RENDER_TARGET_FORMAT format, int sampleCount, bool depthBuffer) {
+    YDS_ERROR_DECLARE("CreateOffScreenRenderTarget");
+
+    if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newTarget = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreateSubRenderTarget(ysRenderTarget **newTarget, ysRenderTarget *parent, int x, int y, int width, int height) {
+    YDS_ERROR_DECLARE("CreateSubRenderTarget");
+
+    if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newTarget = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::ClearBuffers(const float *clearColor) {
+    YDS_ERROR_DECLARE("ClearBuffers");
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError ysNullDevice::Present() {
+    YDS_ERROR_DECLARE("Present");
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError ysNullDevice::CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam) {
+    YDS_ERROR_DECLARE("CreateVertexBuffer");
+
+    YDS_NESTED_ERROR_CALL(CreateBuffer(newBuffer, ysGPUBuffer::GPU_DATA_BUFFER, size, data, mirrorToRam));
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError ysNullDevice::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam) {
+    YDS_ERROR_DECLARE("CreateIndexBuffer");
+
+    YDS_NESTED_ERROR_CALL(CreateBuffer(newBuffer, ysGPUBuffer::GPU_INDEX_BUFFER, size, data, mirrorToRam));
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError ysNullDevice::CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam) {
+    YDS_ERROR_DECLARE("CreateConstantBuffer");
+
+    YDS_NESTED_ERROR_CALL(CreateBuffer(newBuffer, ysGPUBuffer::GPU_CONSTANT_BUFFER, size, data, mirrorToRam));
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
+ysError ysNullDevice::CreateVertexShader(ysShader **newShader, const char *shaderFilename, const char *shaderName) {
+    YDS_ERROR_DECLARE("CreateVertexShader");
+
+    if (newShader == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newShader = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreatePixelShader(ysShader **newShader, const char *shaderFilename, const char *shaderName) {
+    YDS_ERROR_DECLARE("CreatePixelShader");
+
+    if (newShader == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newShader = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreateShaderProgram(ysShaderProgram **newProgram) {
+    YDS_ERROR_DECLARE("CreateShaderProgram");
+
+    if (newProgram == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newProgram = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreateInputLayout(ysInputLayout **newLayout, ysShader *shader, ysRenderGeometryFormat *format) {
+    YDS_ERROR_DECLARE("CreateInputLayout");
+
+    if (newLayout == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newLayout = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreateTexture(ysTexture **texture, const char *fname) {
+    YDS_ERROR_DECLARE("CreateTexture");
+
+    if (texture == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *texture = NULL;
+
+    return YDS_ERROR_RETURN(ysError::YDS_INVALID_OPERATION);
+}
+
+ysError ysNullDevice::CreateBuffer(ysGPUBuffer **newBuffer, ysGPUBuffer::GPU_BUFFER_TYPE type, int size, char *data, bool mirrorToRam) {
+    YDS_ERROR_DECLARE("CreateBuffer");
+
+    if (newBuffer == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+    *newBuffer = NULL;
+
+    if (size < 0) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
+
+    ysNullGPUBuffer *newNullBuffer = NewObject<ysNullGPUBuffer>(m_gpuBuffers);
+
+    newNullBuffer->m_size = size;
+    newNullBuffer->m_mirrorToRAM = mirrorToRam;
+    newNullBuffer->m_bufferType = type;
+
+    if (mirrorToRam) {
+        newNullBuffer->m_RAMMirror = new char[size];
+        if (data != NULL) memcpy(newNullBuffer->m_RAMMirror, data, size);
+    }
+
+    *newBuffer = static_cast<ysGPUBuffer *>(newNullBuffer);
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
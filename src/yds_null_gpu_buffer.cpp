@@ -0,0 +1,9 @@
+#include "../include/yds_null_gpu_buffer.h"
+
+ysNullGPUBuffer::ysNullGPUBuffer() : ysGPUBuffer(NULL_DEVICE) {
+    /* void */
+}
+
+ysNullGPUBuffer::~ysNullGPUBuffer() {
+    /* void */
+}
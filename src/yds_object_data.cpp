@@ -40,6 +40,7 @@ void ysObjectData::Clear() {
 
     m_normals.Clear();
     m_tangents.Clear();
+    m_meshlets.Clear();
 
     m_flipNormals = false;
 
@@ -56,7 +56,7 @@ ysError ysOpenGLDevice::CreateRenderingContext(ysRenderingContext **context, ysW
 
     if (window->GetPlatform() == ysWindowSystemObject::Platform::WINDOWS) {
         ysOpenGLWindowsContext *newContext;
-        newContext = m_renderingContexts.NewGeneric<ysOpenGLWindowsContext>();
+        newContext = NewObject<ysOpenGLWindowsContext>(m_renderingContexts);
         YDS_NESTED_ERROR_CALL(newContext->CreateRenderingContext(this, window, 4, 3));
 
         // TEMP
@@ -157,7 +157,7 @@ ysError ysOpenGLDevice::CreateOnScreenRenderTarget(ysRenderTarget **newTarget, y
     if (context == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     if (context->GetAttachedRenderTarget() != NULL) return YDS_ERROR_RETURN(ysError::YDS_CONTEXT_ALREADY_HAS_RENDER_TARGET);
 
-    ysOpenGLRenderTarget *newRenderTarget = m_renderTargets.NewGeneric<ysOpenGLRenderTarget>();
+    ysOpenGLRenderTarget *newRenderTarget = NewObject<ysOpenGLRenderTarget>(m_renderTargets);
     ysOpenGLVirtualContext *openglContext = static_cast<ysOpenGLVirtualContext *>(context);
 
     openglContext->m_attachedRenderTarget = newRenderTarget;
@@ -181,11 +181,11 @@ ysError ysOpenGLDevice::CreateOffScreenRenderTarget(ysRenderTarget **newTarget,
 
     if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-    ysOpenGLRenderTarget *newRenderTarget = m_renderTargets.NewGeneric<ysOpenGLRenderTarget>();
+    ysOpenGLRenderTarget *newRenderTarget = NewObject<ysOpenGLRenderTarget>(m_renderTargets);
 
     ysError result = CreateOpenGLOffScreenRenderTarget(newRenderTarget, width, height, format, sampleCount, depthBuffer);
     if (result != ysError::YDS_NO_ERROR) {
-        m_renderTargets.Delete(newRenderTarget->GetIndex());
+        DeleteObject(m_renderTargets, newRenderTarget);
         return result;
     }
 
@@ -200,7 +200,7 @@ ysError ysOpenGLDevice::CreateSubRenderTarget(ysRenderTarget **newTarget, ysRend
     if (newTarget == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     if (parent->GetType() == ysRenderTarget::RENDER_TARGET_SUBDIVISION) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-    ysOpenGLRenderTarget *newRenderTarget = m_renderTargets.NewGeneric<ysOpenGLRenderTarget>();
+    ysOpenGLRenderTarget *newRenderTarget = NewObject<ysOpenGLRenderTarget>(m_renderTargets);
 
     newRenderTarget->m_type = ysRenderTarget::RENDER_TARGET_SUBDIVISION;
     newRenderTarget->m_posX = x;
@@ -344,7 +344,7 @@ ysError ysOpenGLDevice::CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, ch
     if (newBuffer == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     *newBuffer = NULL;
 
-    ysOpenGLGPUBuffer *newOpenGLBuffer = m_gpuBuffers.NewGeneric<ysOpenGLGPUBuffer>();
+    ysOpenGLGPUBuffer *newOpenGLBuffer = NewObject<ysOpenGLGPUBuffer>(m_gpuBuffers);
 
     m_realContext->glGenVertexArrays(1, &newOpenGLBuffer->m_vertexArrayHandle);
     m_realContext->glBindVertexArray(newOpenGLBuffer->m_vertexArrayHandle);
@@ -373,7 +373,7 @@ ysError ysOpenGLDevice::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, cha
     if (newBuffer == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     *newBuffer = NULL;
 
-    ysOpenGLGPUBuffer *newOpenGLBuffer = m_gpuBuffers.NewGeneric<ysOpenGLGPUBuffer>();
+    ysOpenGLGPUBuffer *newOpenGLBuffer = NewObject<ysOpenGLGPUBuffer>(m_gpuBuffers);
 
     newOpenGLBuffer->m_size = size;
     newOpenGLBuffer->m_mirrorToRAM = mirrorToRam;
@@ -400,7 +400,7 @@ ysError ysOpenGLDevice::CreateConstantBuffer(ysGPUBuffer **newBuffer, int size,
     if (newBuffer == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
     *newBuffer = NULL;
 
-    ysOpenGLGPUBuffer *newOpenGLBuffer = m_gpuBuffers.NewGeneric<ysOpenGLGPUBuffer>();
+    ysOpenGLGPUBuffer *newOpenGLBuffer = NewObject<ysOpenGLGPUBuffer>(m_gpuBuffers);
 
     newOpenGLBuffer->m_size = size;
     newOpenGLBuffer->m_mirrorToRAM = mirrorToRam;
@@ -467,7 +467,7 @@ ysError ysOpenGLDevice::UseVertexBuffer(ysGPUBuffer *buffer, int stride, int off
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
-ysError ysOpenGLDevice::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
+ysError ysOpenGLDevice::UseIndexBuffer(ysGPUBuffer *buffer, int offset, int indexSize) {
     YDS_ERROR_DECLARE("UseIndexBuffer");
 
     if (!CheckCompatibility(buffer)) return YDS_ERROR_RETURN(ysError::YDS_INCOMPATIBLE_PLATFORMS);
@@ -486,7 +486,7 @@ ysError ysOpenGLDevice::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
             m_realContext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, openglBuffer->m_bufferHandle);
         }
 
-        YDS_NESTED_ERROR_CALL(ysDevice::UseIndexBuffer(buffer, offset));
+        YDS_NESTED_ERROR_CALL(ysDevice::UseIndexBuffer(buffer, offset, indexSize));
     }
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -615,7 +615,7 @@ ysError ysOpenGLDevice::CreateVertexShader(ysShader **newShader, const char *sha
         return YDS_ERROR_RETURN_MSG(ysError::YDS_VERTEX_SHADER_COMPILATION_ERROR, errorBuffer);
     }
 
-    ysOpenGLShader *newOpenGLShader = m_shaders.NewGeneric<ysOpenGLShader>();
+    ysOpenGLShader *newOpenGLShader = NewObject<ysOpenGLShader>(m_shaders);
     strcpy_s(newOpenGLShader->m_shaderName, 64, shaderName);
     strcpy_s(newOpenGLShader->m_filename, 64, shaderFilename);
     newOpenGLShader->m_shaderType = ysShader::SHADER_TYPE_VERTEX;
@@ -671,7 +671,7 @@ ysError ysOpenGLDevice::CreatePixelShader(ysShader **newShader, const char *shad
 
     }
 
-    ysOpenGLShader *newOpenGLShader = m_shaders.NewGeneric<ysOpenGLShader>();
+    ysOpenGLShader *newOpenGLShader = NewObject<ysOpenGLShader>(m_shaders);
     strcpy_s(newOpenGLShader->m_shaderName, 64, shaderName);
     strcpy_s(newOpenGLShader->m_filename, 64, shaderFilename);
     newOpenGLShader->m_shaderType = ysShader::SHADER_TYPE_PIXEL;
@@ -764,7 +764,7 @@ ysError ysOpenGLDevice::CreateShaderProgram(ysShaderProgram **program) {
 
     if (program == NULL) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
 
-    ysOpenGLShaderProgram *newProgram = m_shaderPrograms.NewGeneric<ysOpenGLShaderProgram>();
+    ysOpenGLShaderProgram *newProgram = NewObject<ysOpenGLShaderProgram>(m_shaderPrograms);
     newProgram->m_handle = m_realContext->glCreateProgram();
 
     *program = static_cast<ysShaderProgram *>(newProgram);
@@ -776,7 +776,7 @@ ysError ysOpenGLDevice::CreateShaderProgram(ysShaderProgram **program) {
 ysError ysOpenGLDevice::CreateInputLayout(ysInputLayout **newInputLayout, ysShader *shader, ysRenderGeometryFormat *format) {
     YDS_ERROR_DECLARE("CreateInputLayout");
 
-    ysOpenGLInputLayout *newLayout = m_inputLayouts.NewGeneric<ysOpenGLInputLayout>();
+    ysOpenGLInputLayout *newLayout = NewObject<ysOpenGLInputLayout>(m_inputLayouts);
     newLayout->m_size = 0;
     int nChannels = format->GetChannelCount();
 
@@ -786,6 +786,8 @@ ysError ysOpenGLDevice::CreateInputLayout(ysInputLayout **newInputLayout, ysShad
         ysOpenGLLayoutChannel *newChannel = newLayout->m_channels.New();
         newChannel->m_length = channel->GetLength();
         newChannel->m_type = GetFormatGLType(channel->GetFormat());
+        newChannel->m_integer = IsIntegerFormat(channel->GetFormat());
+        newChannel->m_normalized = IsNormalizedFormat(channel->GetFormat());
         newChannel->m_size = channel->GetSize();
         newChannel->m_offset = channel->GetOffset();
 
@@ -812,7 +814,14 @@ ysError ysOpenGLDevice::UseInputLayout(ysInputLayout *layout) {
 
     for (int i = 0; i < nChannels; i++) {
         ysOpenGLLayoutChannel *channel = openglLayout->m_channels.Get(i);
-        m_realContext->glVertexAttribPointer(i, channel->m_length, channel->m_type, GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
+
+        if (!channel->m_integer) {
+            m_realContext->glVertexAttribPointer(i, channel->m_length, channel->m_type, channel->m_normalized ? GL_TRUE : GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
+        }
+        else {
+            m_realContext->glVertexAttribIPointer(i, channel->m_length, channel->m_type, openglLayout->m_size, (void *)channel->m_offset);
+        }
+
         m_realContext->glEnableVertexAttribArray(i);
     }
 
@@ -877,7 +886,7 @@ ysError ysOpenGLDevice::CreateTexture(ysTexture **texture, const char *fname) {
         return YDS_ERROR_RETURN_MSG(ysError::YDS_COULD_NOT_OPEN_FILE, fname);
     }
 
-    ysOpenGLTexture *newTexture = m_textures.NewGeneric<ysOpenGLTexture>();
+    ysOpenGLTexture *newTexture = NewObject<ysOpenGLTexture>(m_textures);
     strcpy_s(newTexture->m_filename, 257, fname);
 
     glGenTextures(1, &newTexture->m_handle);
@@ -1004,8 +1013,8 @@ void ysOpenGLDevice::ResubmitInputLayout() {
     for (int i = 0; i < nChannels; i++) {
         ysOpenGLLayoutChannel *channel = openglLayout->m_channels.Get(i);
 
-        if (channel->m_type == GL_FLOAT) {
-            m_realContext->glVertexAttribPointer(i, channel->m_length, channel->m_type, GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
+        if (!channel->m_integer) {
+            m_realContext->glVertexAttribPointer(i, channel->m_length, channel->m_type, channel->m_normalized ? GL_TRUE : GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
         }
         else {
             m_realContext->glVertexAttribIPointer(i, channel->m_length, channel->m_type, openglLayout->m_size, (void *)channel->m_offset);
@@ -1049,16 +1058,49 @@ int ysOpenGLDevice::GetFormatGLType(ysRenderGeometryChannel::CHANNEL_FORMAT form
         return GL_UNSIGNED_INT;
     case ysRenderGeometryChannel::CHANNEL_FORMAT_R32G32B32_UINT:
         return GL_UNSIGNED_INT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16B16A16_UNORM:
+        return GL_UNSIGNED_SHORT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_SNORM:
+        return GL_SHORT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_FLOAT:
+        return GL_HALF_FLOAT;
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UNORM:
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UINT:
+        return GL_UNSIGNED_BYTE;
     default:
         // No real option here
         return GL_4_BYTES;
     }
 }
 
+bool ysOpenGLDevice::IsIntegerFormat(ysRenderGeometryChannel::CHANNEL_FORMAT format) {
+    switch (format) {
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R32G32B32A32_UINT:
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R32G32B32_UINT:
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ysOpenGLDevice::IsNormalizedFormat(ysRenderGeometryChannel::CHANNEL_FORMAT format) {
+    switch (format) {
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16B16A16_UNORM:
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R16G16_SNORM:
+    case ysRenderGeometryChannel::CHANNEL_FORMAT_R8G8B8A8_UNORM:
+        return true;
+    default:
+        return false;
+    }
+}
+
 // TEMP
 void ysOpenGLDevice::Draw(int numFaces, int indexOffset, int vertexOffset) {
-    if (m_activeVertexBuffer) {
-        m_realContext->glDrawElementsBaseVertex(GL_TRIANGLES, numFaces * 3, GL_UNSIGNED_SHORT, (void *)(indexOffset * 2), vertexOffset);
+    if (m_activeVertexBuffer && m_activeIndexBuffer) {
+        const int indexSize = static_cast<ysOpenGLGPUBuffer *>(m_activeIndexBuffer)->m_currentStride;
+        const GLenum indexType = (indexSize == sizeof(unsigned int)) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+        m_realContext->glDrawElementsBaseVertex(GL_TRIANGLES, numFaces * 3, indexType, (void *)((size_t)indexOffset * indexSize), vertexOffset);
     }
 }
 
@@ -0,0 +1,422 @@
+#include "../include/yds_slab_allocator.h"
+
+#include "../include/yds_allocator.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+struct ysSlabAllocator::ThreadCache {
+    ysSlabAllocator *Allocator;
+    uint64_t Owner;
+
+    // Two batches per class, the spare one absorbs alternating
+    // allocations and frees without going to the depot
+    FreeBlockLink *Current[NumClasses];
+    FreeBlockLink *Spare[NumClasses];
+    int CurrentCount[NumClasses];
+    int SpareCount[NumClasses];
+
+    // Statistics which haven't been added to the allocator's counters yet
+    int LiveBlocks[NumClasses];
+    int Allocations[NumClasses];
+    int64_t RequestedBytes;
+};
+
+namespace {
+
+    std::atomic<uint64_t> NextAllocatorId(1);
+
+    // ID of the allocator currently using each thread cache slot (0 if unused)
+    std::atomic<uint64_t> SlotOwners[ysSlabAllocator::MaxCachedAllocators];
+
+    // Plain data so that accessing it doesn't go through a TLS init guard
+    thread_local ysSlabAllocator::ThreadCache ThreadCaches[ysSlabAllocator::MaxCachedAllocators];
+
+} /* namespace */
+
+// Returns blocks left in a thread's caches to their allocators when the thread exits
+struct ysSlabAllocatorCacheRelease {
+    ~ysSlabAllocatorCacheRelease() {
+        for (int slot = 0; slot < ysSlabAllocator::MaxCachedAllocators; slot++) {
+            ysSlabAllocator::ThreadCache &cache = ThreadCaches[slot];
+            if (cache.Owner == 0 || SlotOwners[slot].load() != cache.Owner) continue;
+
+            cache.Allocator->ReleaseThreadCache(&cache);
+        }
+    }
+};
+
+namespace {
+
+    thread_local ysSlabAllocatorCacheRelease CacheRelease;
+
+} /* namespace */
+
+ysSlabAllocator::ysSlabAllocator() : ysMemoryAllocator("SLAB_ALLOCATOR") {
+    for (int i = 0; i < NumClasses; i++) {
+        m_depots[i].Batches = nullptr;
+        m_depots[i].FreeCount = 0;
+        m_depots[i].Slabs = nullptr;
+        m_depots[i].SlabCount = 0;
+
+        m_counters[i].LiveBlocks = 0;
+        m_counters[i].TotalAllocations = 0;
+    }
+
+    m_largeAllocations = 0;
+    m_liveLargeBlocks = 0;
+    m_largeBytes = 0;
+
+    m_requestedBytes = 0;
+    m_highWaterMark = 0;
+
+    m_id = NextAllocatorId++;
+
+    // Claim a thread cache slot if there is one left
+    m_cacheSlot = -1;
+    for (int slot = 0; slot < MaxCachedAllocators; slot++) {
+        uint64_t expected = 0;
+        if (SlotOwners[slot].compare_exchange_strong(expected, m_id)) {
+            m_cacheSlot = slot;
+            break;
+        }
+    }
+}
+
+ysSlabAllocator::~ysSlabAllocator() {
+    Destroy();
+
+    if (m_cacheSlot != -1) SlotOwners[m_cacheSlot].store(0);
+}
+
+void *ysSlabAllocator::AllocateBlock(int size, int numObjects) {
+    const int totalSize = size + (int)sizeof(BlockHeader);
+    const int sizeClass = GetSizeClass(totalSize);
+
+    BlockHeader *header = nullptr;
+    if (sizeClass == -1) {
+        header = reinterpret_cast<BlockHeader *>(ysAllocator::BlockAllocate<Alignment>(totalSize));
+        if (header == nullptr) return nullptr;
+
+        m_largeAllocations++;
+        m_liveLargeBlocks++;
+        m_largeBytes += totalSize;
+        YS_TRACK_ALLOCATION(m_memoryTag, totalSize);
+
+        UpdateRequested(size);
+    }
+    else {
+        FreeBlockLink *block = nullptr;
+
+        ThreadCache *cache = GetThreadCache();
+        if (cache != nullptr) {
+            if (cache->CurrentCount[sizeClass] == 0) {
+                if (cache->SpareCount[sizeClass] > 0) {
+                    cache->Current[sizeClass] = cache->Spare[sizeClass];
+                    cache->CurrentCount[sizeClass] = cache->SpareCount[sizeClass];
+                    cache->Spare[sizeClass] = nullptr;
+                    cache->SpareCount[sizeClass] = 0;
+                }
+                else {
+                    FlushStatistics(cache);
+
+                    cache->CurrentCount[sizeClass] = TakeFromDepot(sizeClass, &cache->Current[sizeClass]);
+                    if (cache->CurrentCount[sizeClass] == 0) return nullptr;
+                }
+            }
+
+            block = cache->Current[sizeClass];
+            cache->Current[sizeClass] = block->Next;
+            cache->CurrentCount[sizeClass]--;
+
+            cache->LiveBlocks[sizeClass]++;
+            cache->Allocations[sizeClass]++;
+            cache->RequestedBytes += size;
+        }
+        else {
+            const int count = TakeFromDepot(sizeClass, &block);
+            if (count == 0) return nullptr;
+            if (count > 1) ReturnToDepot(sizeClass, block->Next, count - 1);
+
+            m_counters[sizeClass].LiveBlocks++;
+            m_counters[sizeClass].TotalAllocations++;
+            UpdateRequested(size);
+        }
+
+        header = reinterpret_cast<BlockHeader *>(block);
+    }
+
+    header->SizeClass = sizeClass;
+    header->NumObjects = numObjects;
+    header->Size = size;
+
+    return reinterpret_cast<void *>(header + 1);
+}
+
+int ysSlabAllocator::FreeBlock(void *block) {
+    if (block == nullptr) return 0;
+
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(block) - 1;
+    const int sizeClass = header->SizeClass;
+    const int numObjects = header->NumObjects;
+    const int size = header->Size;
+
+    if (sizeClass == -1) {
+        m_liveLargeBlocks--;
+        m_largeBytes -= size + (int)sizeof(BlockHeader);
+        UpdateRequested(-(int64_t)size);
+        YS_TRACK_FREE(m_memoryTag, size + (int)sizeof(BlockHeader));
+
+        ysAllocator::BlockFree(header, Alignment);
+        return numObjects;
+    }
+
+    FreeBlockLink *link = reinterpret_cast<FreeBlockLink *>(header);
+
+    ThreadCache *cache = GetThreadCache();
+    if (cache != nullptr) {
+        const int batchSize = GetBatchSize(sizeClass);
+        if (cache->CurrentCount[sizeClass] == batchSize) {
+            // Keep the cache bounded, a full spare batch goes back to the depot
+            if (cache->SpareCount[sizeClass] > 0) {
+                FlushStatistics(cache);
+                ReturnToDepot(sizeClass, cache->Spare[sizeClass], cache->SpareCount[sizeClass]);
+            }
+
+            cache->Spare[sizeClass] = cache->Current[sizeClass];
+            cache->SpareCount[sizeClass] = cache->CurrentCount[sizeClass];
+            cache->Current[sizeClass] = nullptr;
+            cache->CurrentCount[sizeClass] = 0;
+        }
+
+        link->Next = cache->Current[sizeClass];
+        cache->Current[sizeClass] = link;
+        cache->CurrentCount[sizeClass]++;
+
+        cache->LiveBlocks[sizeClass]--;
+        cache->RequestedBytes -= size;
+    }
+    else {
+        m_counters[sizeClass].LiveBlocks--;
+        UpdateRequested(-(int64_t)size);
+
+        link->Next = nullptr;
+        ReturnToDepot(sizeClass, link, 1);
+    }
+
+    return numObjects;
+}
+
+int ysSlabAllocator::GetObjectCount(void *block) {
+    if (block == nullptr) return 0;
+    return (reinterpret_cast<BlockHeader *>(block) - 1)->NumObjects;
+}
+
+void ysSlabAllocator::Destroy() {
+    for (int i = 0; i < NumClasses; i++) {
+        Depot &depot = m_depots[i];
+        std::lock_guard<std::mutex> lock(depot.Lock);
+
+        Slab *slab = depot.Slabs;
+        while (slab != nullptr) {
+            Slab *next = slab->Next;
+            ysAllocator::BlockFree(slab, Alignment);
+            YS_TRACK_FREE(m_memoryTag, SlabSize + Alignment);
+            slab = next;
+        }
+
+        depot.Slabs = nullptr;
+        depot.SlabCount = 0;
+        depot.Batches = nullptr;
+        depot.FreeCount = 0;
+
+        m_counters[i].LiveBlocks = 0;
+    }
+
+    // Large blocks are not owned by any slab so they are left alone
+    m_requestedBytes = m_largeBytes - m_liveLargeBlocks * (int64_t)sizeof(BlockHeader);
+
+    // Blocks still sitting in thread caches belong to the freed slabs,
+    // switching to a new ID makes every thread discard them
+    m_id = NextAllocatorId++;
+    if (m_cacheSlot != -1) SlotOwners[m_cacheSlot].store(m_id);
+}
+
+void ysSlabAllocator::GetStatistics(Statistics *statistics) {
+    // Other threads' caches are only added in when they next exchange
+    // blocks with the depot
+    ThreadCache *cache = GetThreadCache();
+    if (cache != nullptr) FlushStatistics(cache);
+
+    int64_t reserved = 0;
+    for (int i = 0; i < NumClasses; i++) {
+        ClassStatistics &classStatistics = statistics->Classes[i];
+        classStatistics.BlockSize = 1 << (i + MinClassShift);
+        classStatistics.LiveBlocks = m_counters[i].LiveBlocks;
+        classStatistics.TotalAllocations = m_counters[i].TotalAllocations;
+        classStatistics.Slabs = m_depots[i].SlabCount;
+
+        reserved += (int64_t)classStatistics.Slabs * (SlabSize + Alignment);
+    }
+
+    statistics->LargeAllocations = m_largeAllocations;
+    statistics->LiveLargeBlocks = m_liveLargeBlocks;
+
+    statistics->RequestedBytes = m_requestedBytes;
+    statistics->ReservedBytes = reserved + m_largeBytes;
+    statistics->HighWaterMark = m_highWaterMark;
+
+    statistics->Fragmentation = (statistics->ReservedBytes > 0)
+        ? 1.0f - (float)statistics->RequestedBytes / statistics->ReservedBytes
+        : 0.0f;
+}
+
+int ysSlabAllocator::GetSizeClass(int size) {
+    if (size > (1 << MaxClassShift)) return -1;
+    if (size <= (1 << MinClassShift)) return 0;
+
+    // Index of the highest set bit of (size - 1), rounds up to the next power of two
+#if defined(_MSC_VER)
+    unsigned long highestBit;
+    _BitScanReverse(&highestBit, (unsigned long)(size - 1));
+#else
+    const int highestBit = 31 - __builtin_clz((unsigned int)(size - 1));
+#endif
+
+    return (int)highestBit + 1 - MinClassShift;
+}
+
+ysSlabAllocator::ThreadCache *ysSlabAllocator::GetThreadCache() {
+    if (m_cacheSlot == -1) return nullptr;
+
+    ThreadCache *cache = &ThreadCaches[m_cacheSlot];
+    if (cache->Owner != m_id) {
+        // Make sure that this thread's caches are released when it exits
+        (void)&CacheRelease;
+
+        // Anything in the cache belongs to an allocator that no longer exists
+        cache->Allocator = this;
+        cache->Owner = m_id;
+
+        for (int i = 0; i < NumClasses; i++) {
+            cache->Current[i] = cache->Spare[i] = nullptr;
+            cache->CurrentCount[i] = cache->SpareCount[i] = 0;
+            cache->LiveBlocks[i] = 0;
+            cache->Allocations[i] = 0;
+        }
+
+        cache->RequestedBytes = 0;
+    }
+
+    return cache;
+}
+
+void ysSlabAllocator::ReleaseThreadCache(ThreadCache *cache) {
+    FlushStatistics(cache);
+
+    for (int i = 0; i < NumClasses; i++) {
+        if (cache->CurrentCount[i] > 0) ReturnToDepot(i, cache->Current[i], cache->CurrentCount[i]);
+        if (cache->SpareCount[i] > 0) ReturnToDepot(i, cache->Spare[i], cache->SpareCount[i]);
+
+        cache->Current[i] = cache->Spare[i] = nullptr;
+        cache->CurrentCount[i] = cache->SpareCount[i] = 0;
+    }
+}
+
+int ysSlabAllocator::TakeFromDepot(int sizeClass, FreeBlockLink **batch) {
+    Depot &depot = m_depots[sizeClass];
+    std::lock_guard<std::mutex> lock(depot.Lock);
+
+    if (depot.Batches == nullptr) AddSlab(sizeClass);
+    if (depot.Batches == nullptr) return 0;
+
+    FreeBlockLink *first = depot.Batches;
+    depot.Batches = first->NextBatch;
+    depot.FreeCount -= first->BatchCount;
+
+    *batch = first;
+    return first->BatchCount;
+}
+
+void ysSlabAllocator::ReturnToDepot(int sizeClass, FreeBlockLink *batch, int count) {
+    Depot &depot = m_depots[sizeClass];
+    std::lock_guard<std::mutex> lock(depot.Lock);
+
+    batch->BatchCount = count;
+    batch->NextBatch = depot.Batches;
+    depot.Batches = batch;
+    depot.FreeCount += count;
+}
+
+void ysSlabAllocator::AddSlab(int sizeClass) {
+    Depot &depot = m_depots[sizeClass];
+
+    // The slab link is stored in front of the slab's blocks
+    void *memory = ysAllocator::BlockAllocate<Alignment>(SlabSize + Alignment);
+    if (memory == nullptr) return;
+
+    YS_TRACK_ALLOCATION(m_memoryTag, SlabSize + Alignment);
+
+    Slab *slab = reinterpret_cast<Slab *>(memory);
+    slab->Next = depot.Slabs;
+    depot.Slabs = slab;
+    depot.SlabCount++;
+
+    // Carve the slab into batches
+    const int blockSize = 1 << (sizeClass + MinClassShift);
+    const int blockCount = SlabSize / blockSize;
+    const int batchSize = GetBatchSize(sizeClass);
+    char *data = reinterpret_cast<char *>(memory) + Alignment;
+
+    for (int start = 0; start < blockCount; start += batchSize) {
+        const int end = (start + batchSize < blockCount) ? start + batchSize : blockCount;
+
+        FreeBlockLink *list = nullptr;
+        for (int i = end - 1; i >= start; i--) {
+            FreeBlockLink *link = reinterpret_cast<FreeBlockLink *>(data + i * blockSize);
+            link->Next = list;
+            list = link;
+        }
+
+        list->BatchCount = end - start;
+        list->NextBatch = depot.Batches;
+        depot.Batches = list;
+        depot.FreeCount += end - start;
+    }
+}
+
+void ysSlabAllocator::FlushStatistics(ThreadCache *cache) {
+    for (int i = 0; i < NumClasses; i++) {
+        if (cache->LiveBlocks[i] != 0) {
+            m_counters[i].LiveBlocks += cache->LiveBlocks[i];
+            cache->LiveBlocks[i] = 0;
+        }
+
+        if (cache->Allocations[i] != 0) {
+            m_counters[i].TotalAllocations += cache->Allocations[i];
+            cache->Allocations[i] = 0;
+        }
+    }
+
+    if (cache->RequestedBytes != 0) {
+        UpdateRequested(cache->RequestedBytes);
+        cache->RequestedBytes = 0;
+    }
+}
+
+void ysSlabAllocator::UpdateRequested(int64_t delta) {
+    const int64_t requested = m_requestedBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+
+    int64_t highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+    while (requested > highWaterMark &&
+        !m_highWaterMark.compare_exchange_weak(highWaterMark, requested, std::memory_order_relaxed)) {
+        /* void */
+    }
+}
+
+int ysSlabAllocator::GetBatchSize(int sizeClass) {
+    // Move roughly a quarter of a slab at a time
+    const int batchSize = (SlabSize / 4) >> (sizeClass + MinClassShift);
+    return (batchSize < 1) ? 1 : ((batchSize > 64) ? 64 : batchSize);
+}
@@ -164,7 +164,7 @@ ysError ysToolAnimationFile::ReadObjectAnimationVersion000(ysObjectAnimationData
     if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
 
     if (object->m_positionKeys.NumKeys > 0) {
-        object->m_positionKeys.Keys.Allocate(object->m_positionKeys.NumKeys);
+        object->m_positionKeys.Keys.AllocateUninitialized(object->m_positionKeys.NumKeys);
         m_file.read((char *)object->m_positionKeys.Keys.GetBuffer(), sizeof(ysObjectAnimationData::PositionKey) * object->m_positionKeys.NumKeys);
         if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
     }
@@ -178,7 +178,7 @@ ysError ysToolAnimationFile::ReadObjectAnimationVersion000(ysObjectAnimationData
     if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
 
     if (object->m_positionKeys.NumKeys > 0) {
-        object->m_rotationKeys.Keys.Allocate(object->m_rotationKeys.NumKeys);
+        object->m_rotationKeys.Keys.AllocateUninitialized(object->m_rotationKeys.NumKeys);
         m_file.read((char *)object->m_rotationKeys.Keys.GetBuffer(), sizeof(ysObjectAnimationData::RotationKey) * object->m_rotationKeys.NumKeys);
         if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
     }
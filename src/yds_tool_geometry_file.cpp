@@ -1,5 +1,9 @@
 #include "../include/yds_tool_geometry_file.h"
 
+#include "../include/yds_frame_arena.h"
+#include "../include/yds_hash.h"
+#include "../include/yds_mapped_file.h"
+
 ysToolGeometryFile::ysToolGeometryFile() : ysObject("ysToolGeometryFile") {
     m_header = NULL;
     m_fileVersion = -1;
@@ -151,7 +155,7 @@ bool ysToolGeometryFile::SmoothingData() const {
 }
 
 
-ysError ysToolGeometryFile::ReadObject(ysObjectData **newObject) {
+ysError ysToolGeometryFile::ReadObject(ysObjectData **newObject, uint64_t *sourceHash) {
     YDS_ERROR_DECLARE("ReadObject");
 
     if (newObject == nullptr) return YDS_ERROR_RETURN(ysError::YDS_INVALID_PARAMETER);
@@ -159,6 +163,8 @@ ysError ysToolGeometryFile::ReadObject(ysObjectData **newObject) {
 
     if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::YDS_NO_FILE);
 
+    const std::streampos start = m_file.tellg();
+
     ysObjectData *object = new ysObjectData;
     object->Clear();
 
@@ -191,6 +197,17 @@ ysError ysToolGeometryFile::ReadObject(ysObjectData **newObject) {
     }
 
     ReleaseMemory();
+
+    if (sourceHash != nullptr) {
+        error = HashRange(start, m_file.tellg(), sourceHash);
+        if (error != ysError::YDS_NO_ERROR) {
+            delete object;
+
+            YDS_ERROR_RETURN_MANUAL();
+            return error;
+        }
+    }
+
     *newObject = object;
 
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
@@ -213,6 +230,52 @@ ysError ysToolGeometryFile::UpdateCompilationStatus(CompilationStatus status) {
     return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
 }
 
+bool ysToolGeometryFile::HashFile(const char *fname, uint64_t *hash) {
+    // Magic number, version and last editor come before the status
+    static const size_t CompilationStatusOffset = 12;
+
+    ysMappedFile file;
+    if (file.Open(fname) != ysError::YDS_NO_ERROR) return false;
+    if (file.GetSize() < CompilationStatusOffset + sizeof(unsigned int)) return false;
+
+    const size_t rest = CompilationStatusOffset + sizeof(unsigned int);
+
+    ysHash::XXH64State state;
+    state.Update(file.GetData(), CompilationStatusOffset);
+    state.Update(file.GetData() + rest, file.GetSize() - rest);
+    *hash = state.Digest();
+
+    return true;
+}
+
+ysError ysToolGeometryFile::HashRange(std::streampos start, std::streampos end, uint64_t *hash) {
+    YDS_ERROR_DECLARE("HashRange");
+
+    static const int ChunkSize = 64 * 1024;
+
+    ysFrameArena *arena = ysFrameArena::GetThreadArena();
+    ysFrameArena::Scope scope(arena);
+    char *buffer = arena->AllocateArray<char>(ChunkSize);
+
+    // The object was just read so this comes straight from the cache
+    m_file.seekg(start);
+
+    ysHash::XXH64State state;
+    for (std::streamoff remaining = end - start; remaining > 0; ) {
+        const int size = (remaining < ChunkSize) ? (int)remaining : ChunkSize;
+
+        m_file.read(buffer, size);
+        if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
+
+        state.Update(buffer, size);
+        remaining -= size;
+    }
+
+    *hash = state.Digest();
+
+    return YDS_ERROR_RETURN(ysError::YDS_NO_ERROR);
+}
+
 ysError ysToolGeometryFile::ReadString(char *dest) {
     YDS_ERROR_DECLARE("ReadString");
 
@@ -244,14 +307,21 @@ ysError ysToolGeometryFile::ReadObjectDataVersion000_005(ysObjectData *object) {
         // Allocate Data
 
         int maxNumberOfBonesPerVertex = 3;
-        for (int i = 0; i < object->m_objectStatistics.NumVertices; i++) {
-            m_file.read((char *)&object->m_vertices.New(), sizeof(ysVector3));
+        const int nVertices = object->m_objectStatistics.NumVertices;
+        const bool materialData = MaterialData();
+
+        // Every vertex is read from the file, so the vertices are not constructed first
+        ysVector3 *vertices = object->m_vertices.AppendUninitialized(nVertices);
+        int *materials = (materialData) ? object->m_materialList.AppendUninitialized(nVertices) : nullptr;
+
+        for (int i = 0; i < nVertices; i++) {
+            m_file.read((char *)&vertices[i], sizeof(ysVector3));
             if (!m_file) {
                 return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
             }
 
-            if (MaterialData()) {
-                m_file.read((char *)&object->m_materialList.New(), sizeof(int));
+            if (materialData) {
+                m_file.read((char *)&materials[i], sizeof(int));
             }
         }
 
@@ -264,8 +334,8 @@ ysError ysToolGeometryFile::ReadObjectDataVersion000_005(ysObjectData *object) {
 
                 ysObjectData::BoneWeights *weights = &object->m_boneWeights[i];
 
-                weights->m_boneIndices.Allocate(nBones);
-                weights->m_boneWeights.Allocate(nBones);
+                weights->m_boneIndices.AllocateUninitialized(nBones);
+                weights->m_boneWeights.AllocateUninitialized(nBones);
 
                 m_file.read((char *)weights->m_boneIndices.GetBuffer(), sizeof(int) * nBones);
                 if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
@@ -286,7 +356,7 @@ ysError ysToolGeometryFile::ReadObjectDataVersion000_005(ysObjectData *object) {
                 m_file.read((char *)&nCoordinates, sizeof(int));
                 if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
 
-                object->m_channels[i].m_coordinates.Allocate(nCoordinates);
+                object->m_channels[i].m_coordinates.AllocateUninitialized(nCoordinates);
 
                 m_file.read((char *)object->m_channels[i].m_coordinates.GetBuffer(), sizeof(ysVector2) * nCoordinates);
                 if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
@@ -296,14 +366,14 @@ ysError ysToolGeometryFile::ReadObjectDataVersion000_005(ysObjectData *object) {
         // ====================================================
         // Read In Face Data
         // ====================================================
-        object->m_vertexIndexSet.Allocate(object->m_objectStatistics.NumFaces);
+        object->m_vertexIndexSet.AllocateUninitialized(object->m_objectStatistics.NumFaces);
 
-        if (SmoothingData()) object->m_smoothingGroups.Allocate(object->m_objectStatistics.NumFaces);
+        if (SmoothingData()) object->m_smoothingGroups.AllocateUninitialized(object->m_objectStatistics.NumFaces);
         if (object->m_objectStatistics.NumUVChannels > 0) {
             object->m_UVIndexSets.Allocate(object->m_objectStatistics.NumUVChannels);
 
             for (int i = 0; i < object->m_objectStatistics.NumUVChannels; i++) {
-                object->m_UVIndexSets[i].UVIndexSets.Allocate(object->m_objectStatistics.NumFaces);
+                object->m_UVIndexSets[i].UVIndexSets.AllocateUninitialized(object->m_objectStatistics.NumFaces);
             }
         }
 
@@ -333,7 +403,7 @@ ysError ysToolGeometryFile::ReadObjectDataVersion000_005(ysObjectData *object) {
             m_file.read((char *)&nBones, sizeof(int));
             if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
 
-            object->m_boneIndices.Allocate(nBones);
+            object->m_boneIndices.AllocateUninitialized(nBones);
             m_file.read((char *)object->m_boneIndices.GetBuffer(), sizeof(int) * nBones);
             if (!m_file) return YDS_ERROR_RETURN(ysError::YDS_CORRUPTED_FILE);
         }
@@ -614,7 +684,7 @@ ysError ysToolGeometryFile::ReadObjectVersion005(ysObjectData *object) {
 void ysToolGeometryFile::DestroyMemory() {
     int n = m_allocationTracker.GetNumObjects();
     for (int i = n - 1; i >= 0; i--) {
-        delete[] m_allocationTracker.Get(i)->m_allocation;
+        ysTrackedFree(m_allocationTracker.Get(i)->m_allocation);
         m_allocationTracker.Delete(i);
     }
 }
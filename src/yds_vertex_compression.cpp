@@ -0,0 +1,137 @@
+#include "../include/yds_vertex_compression.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace {
+
+    float Clamp(float value, float minimum, float maximum) {
+        if (!(value > minimum)) return minimum; // Also catches NaN
+        if (value > maximum) return maximum;
+        return value;
+    }
+
+    float SignNotZero(float value) {
+        return (value >= 0.0f) ? 1.0f : -1.0f;
+    }
+
+} /* namespace */
+
+unsigned short ysVertexCompression::QuantizeUnorm16(float value, float minimum, float maximum) {
+    const float range = maximum - minimum;
+    if (range <= 0.0f) return 0;
+
+    const float normalized = Clamp((value - minimum) / range, 0.0f, 1.0f);
+    return (unsigned short)(normalized * 65535.0f + 0.5f);
+}
+
+float ysVertexCompression::DequantizeUnorm16(unsigned short value, float minimum, float maximum) {
+    return minimum + (value / 65535.0f) * (maximum - minimum);
+}
+
+short ysVertexCompression::QuantizeSnorm16(float value) {
+    const float scaled = Clamp(value, -1.0f, 1.0f) * 32767.0f;
+    return (short)((scaled >= 0.0f) ? scaled + 0.5f : scaled - 0.5f);
+}
+
+float ysVertexCompression::DequantizeSnorm16(short value) {
+    // -32768 and -32767 both map to -1
+    const float result = value / 32767.0f;
+    return (result < -1.0f) ? -1.0f : result;
+}
+
+unsigned char ysVertexCompression::QuantizeUnorm8(float value) {
+    return (unsigned char)(Clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+void ysVertexCompression::EncodeOctahedral(const ysVector3 &direction, short *x, short *y) {
+    const float l1 = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+    if (l1 == 0.0f) {
+        *x = *y = 0;
+        return;
+    }
+
+    float u = direction.x / l1;
+    float v = direction.y / l1;
+
+    // Fold the lower hemisphere over the diagonals
+    if (direction.z < 0.0f) {
+        const float foldedU = (1.0f - fabsf(v)) * SignNotZero(u);
+        const float foldedV = (1.0f - fabsf(u)) * SignNotZero(v);
+        u = foldedU;
+        v = foldedV;
+    }
+
+    *x = QuantizeSnorm16(u);
+    *y = QuantizeSnorm16(v);
+}
+
+ysVector3 ysVertexCompression::DecodeOctahedral(short x, short y) {
+    float u = DequantizeSnorm16(x);
+    float v = DequantizeSnorm16(y);
+    const float z = 1.0f - fabsf(u) - fabsf(v);
+
+    if (z < 0.0f) {
+        u += (u >= 0.0f) ? z : -z;
+        v += (v >= 0.0f) ? z : -z;
+    }
+
+    const float length = sqrtf(u * u + v * v + z * z);
+    return ysVector3(u / length, v / length, z / length);
+}
+
+unsigned short ysVertexCompression::FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(float));
+
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const int biasedExponent = (int)((bits >> 23) & 0xFF);
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN
+    if (biasedExponent == 0xFF) return (unsigned short)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+    const int exponent = biasedExponent - 127 + 15;
+    if (exponent >= 31) return (unsigned short)(sign | 0x7C00);
+
+    if (exponent <= 0) {
+        // Too small even for a subnormal half
+        if (exponent < -10) return (unsigned short)sign;
+
+        mantissa |= 0x800000;
+        const int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+
+        return (unsigned short)(sign | half);
+    }
+
+    // A carry out of the mantissa correctly rounds up to the next exponent
+    uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+
+    return (unsigned short)(sign | half);
+}
+
+float ysVertexCompression::HalfToFloat(unsigned short value) {
+    const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1F;
+    const uint32_t mantissa = value & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        const float magnitude = ldexpf((float)mantissa, -24);
+        return sign ? -magnitude : magnitude;
+    }
+    else if (exponent == 31) bits = sign | 0x7F800000 | (mantissa << 13);
+    else bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+    float result;
+    memcpy(&result, &bits, sizeof(float));
+    return result;
+}
@@ -0,0 +1,71 @@
+#include <pch.h>
+
+#include "../include/yds_allocator.h"
+
+#include <stdint.h>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+TEST(Allocator, AlignedBlocks) {
+    const int alignments[] = { 1, 2, 4, 8, 16, 64, 4096 };
+
+    for (int alignment : alignments) {
+        void *block = ysAllocator::BlockAllocate(100, alignment);
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0);
+
+        memset(block, 0xFF, 100);
+
+        block = ysAllocator::BlockReallocate(block, 100, 1000, alignment);
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0);
+        EXPECT_EQ(reinterpret_cast<unsigned char *>(block)[99], 0xFF);
+
+        ysAllocator::BlockFree(block, alignment);
+    }
+
+    void *block = ysAllocator::BlockAllocate<32>(256);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 32, 0);
+    ysAllocator::BlockFree(block, 32);
+}
+
+TEST(Allocator, Pages) {
+    const size_t size = 64 * 1024;
+    unsigned char *block = reinterpret_cast<unsigned char *>(ysAllocator::PageAllocate(size));
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(block[0], 0);
+    EXPECT_EQ(block[size - 1], 0);
+    block[size - 1] = 1;
+    ysAllocator::PageFree(block, size);
+
+    // Huge page requests are aligned to the huge page size where supported
+    const size_t hugeSize = 3 * ysAllocator::HugePageSize;
+    block = reinterpret_cast<unsigned char *>(ysAllocator::PageAllocate(hugeSize, true));
+    ASSERT_NE(block, nullptr);
+#if !defined(_WIN32)
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % ysAllocator::HugePageSize, 0);
+#endif
+    memset(block, 1, hugeSize);
+    ysAllocator::PageFree(block, hugeSize);
+
+    // Sizes that aren't a whole number of pages
+    const size_t oddSize = ysAllocator::HugePageSize + 100;
+    block = reinterpret_cast<unsigned char *>(ysAllocator::PageAllocate(oddSize, true));
+    ASSERT_NE(block, nullptr);
+    block[oddSize - 1] = 1;
+    ysAllocator::PageFree(block, oddSize);
+
+#if !defined(_WIN32)
+    // Nothing past the block is left mapped
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t end = (oddSize + pageSize - 1) & ~(pageSize - 1);
+    unsigned char residency;
+    EXPECT_NE(mincore(block + end, pageSize, &residency), 0);
+#endif
+
+    EXPECT_EQ(ysAllocator::PageAllocate(0), nullptr);
+    ysAllocator::PageFree(nullptr, 0);
+}
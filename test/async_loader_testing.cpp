@@ -0,0 +1,285 @@
+#include <pch.h>
+
+#include "../include/yds_async_loader.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // Holds a stage until it's opened so that requests pile up behind it
+    class Gate {
+    public:
+        Gate() : m_open(false), m_entered(false) { /* void */ }
+
+        void Enter() {
+            m_entered = true;
+            while (!m_open) std::this_thread::yield();
+        }
+
+        void WaitEntered() {
+            while (!m_entered) std::this_thread::yield();
+        }
+
+        void Open() { m_open = true; }
+
+    protected:
+        std::atomic<bool> m_open;
+        std::atomic<bool> m_entered;
+    };
+
+    ysAsyncLoader::Request BlockingRequest(Gate *gate) {
+        ysAsyncLoader::Request request;
+        request.Priority = 0;
+        request.Read = [gate] { gate->Enter(); return ysError::YDS_NO_ERROR; };
+
+        return request;
+    }
+
+    void WaitForStatus(ysAsyncLoader *loader, ysLoadHandle handle, ysAsyncLoader::Status status) {
+        while (loader->GetStatus(handle) != status) std::this_thread::yield();
+    }
+
+} /* namespace */
+
+TEST(AsyncLoader, StagesRunOnTheirThreads) {
+    ysAsyncLoader loader;
+    ASSERT_EQ(loader.Initialize(1, 2), ysError::YDS_NO_ERROR);
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+    std::vector<std::thread::id> threads(3);
+    std::vector<int> order;
+
+    ysAsyncLoader::Request request;
+    request.Priority = 0;
+    request.Read = [&] { threads[0] = std::this_thread::get_id(); order.push_back(0); return ysError::YDS_NO_ERROR; };
+    request.Process = [&] { threads[1] = std::this_thread::get_id(); order.push_back(1); return ysError::YDS_NO_ERROR; };
+    request.Finalize = [&](bool *) { threads[2] = std::this_thread::get_id(); order.push_back(2); return ysError::YDS_NO_ERROR; };
+
+    const ysLoadHandle handle = loader.Submit(request);
+    EXPECT_FALSE(handle.IsNull());
+
+    loader.Flush();
+
+    EXPECT_EQ(loader.GetStatus(handle), ysAsyncLoader::Status::Complete);
+    EXPECT_EQ(loader.GetError(handle), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(loader.GetPendingCount(), 0);
+
+    ASSERT_EQ(order.size(), 3u);
+    for (int i = 0; i < 3; i++) EXPECT_EQ(order[i], i);
+
+    EXPECT_NE(threads[0], mainThread);
+    EXPECT_NE(threads[1], mainThread);
+    EXPECT_NE(threads[0], threads[1]);
+    EXPECT_EQ(threads[2], mainThread);
+
+    // Empty stages are passed through
+    ysAsyncLoader::Request empty;
+    empty.Priority = 0;
+    const ysLoadHandle emptyHandle = loader.Submit(empty);
+    loader.Flush();
+    EXPECT_EQ(loader.GetStatus(emptyHandle), ysAsyncLoader::Status::Complete);
+
+    // Stale handles
+    loader.Release(handle);
+    EXPECT_EQ(loader.GetStatus(handle), ysAsyncLoader::Status::Invalid);
+    EXPECT_EQ(loader.GetStatus(ysLoadHandle::Null()), ysAsyncLoader::Status::Invalid);
+
+    // Nothing runs without threads
+    ysAsyncLoader uninitialized;
+    EXPECT_TRUE(uninitialized.Submit(request).IsNull());
+}
+
+TEST(AsyncLoader, PriorityOrder) {
+    ysAsyncLoader loader;
+    ASSERT_EQ(loader.Initialize(1, 0), ysError::YDS_NO_ERROR);
+
+    Gate gate;
+    loader.Submit(BlockingRequest(&gate));
+    gate.WaitEntered();
+
+    std::mutex orderLock;
+    std::vector<int> readOrder;
+    std::vector<int> finalizeOrder;
+
+    const int priorities[] = { 1, 5, 3, 5, 2, 0 };
+    ysLoadHandle handles[6];
+    for (int i = 0; i < 6; i++) {
+        ysAsyncLoader::Request request;
+        request.Priority = priorities[i];
+        request.Read = [&, i] {
+            std::lock_guard<std::mutex> lock(orderLock);
+            readOrder.push_back(i);
+            return ysError::YDS_NO_ERROR;
+        };
+
+        request.Finalize = [&, i](bool *) { finalizeOrder.push_back(i); return ysError::YDS_NO_ERROR; };
+
+        handles[i] = loader.Submit(request);
+    }
+
+    // The last request is moved to the front while it's still waiting
+    loader.SetPriority(handles[5], 10);
+    EXPECT_EQ(loader.GetStatus(handles[5]), ysAsyncLoader::Status::Queued);
+
+    gate.Open();
+    loader.Flush();
+
+    // Highest first, in submission order for equal priorities
+    const int expected[] = { 5, 1, 3, 2, 4, 0 };
+    ASSERT_EQ(readOrder.size(), 6u);
+    ASSERT_EQ(finalizeOrder.size(), 6u);
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ(readOrder[i], expected[i]);
+        EXPECT_EQ(finalizeOrder[i], expected[i]);
+    }
+}
+
+TEST(AsyncLoader, FailureAndCancellation) {
+    ysAsyncLoader loader;
+    ASSERT_EQ(loader.Initialize(1, 1), ysError::YDS_NO_ERROR);
+
+    Gate gate;
+    const ysLoadHandle blocking = loader.Submit(BlockingRequest(&gate));
+    gate.WaitEntered();
+
+    EXPECT_EQ(loader.GetStatus(blocking), ysAsyncLoader::Status::Reading);
+    EXPECT_FALSE(loader.Cancel(blocking));
+
+    bool finalized = false;
+    bool cancelledRan = false;
+    std::shared_ptr<int> state = std::make_shared<int>(0);
+    std::weak_ptr<int> weakState = state;
+
+    ysAsyncLoader::Request failing;
+    failing.Priority = 0;
+    failing.Process = [] { return ysError::YDS_CORRUPTED_FILE; };
+    failing.Finalize = [&](bool *) { finalized = true; return ysError::YDS_NO_ERROR; };
+    const ysLoadHandle failingHandle = loader.Submit(failing);
+
+    ysAsyncLoader::Request cancelled;
+    cancelled.Priority = 0;
+    cancelled.Read = [&, state] { cancelledRan = true; return ysError::YDS_NO_ERROR; };
+    const ysLoadHandle cancelledHandle = loader.Submit(cancelled);
+    cancelled = ysAsyncLoader::Request();
+    state.reset();
+
+    // Cancelling frees the stages right away
+    EXPECT_FALSE(weakState.expired());
+    EXPECT_TRUE(loader.Cancel(cancelledHandle));
+    EXPECT_TRUE(weakState.expired());
+    EXPECT_EQ(loader.GetStatus(cancelledHandle), ysAsyncLoader::Status::Cancelled);
+    EXPECT_FALSE(loader.Cancel(cancelledHandle));
+
+    gate.Open();
+    loader.Flush();
+
+    EXPECT_EQ(loader.GetStatus(blocking), ysAsyncLoader::Status::Complete);
+    EXPECT_EQ(loader.GetStatus(failingHandle), ysAsyncLoader::Status::Failed);
+    EXPECT_EQ(loader.GetError(failingHandle), ysError::YDS_CORRUPTED_FILE);
+    EXPECT_FALSE(finalized);
+    EXPECT_FALSE(cancelledRan);
+    EXPECT_EQ(loader.GetPendingCount(), 0);
+}
+
+TEST(AsyncLoader, FinalizeBudget) {
+    ysAsyncLoader loader;
+    ASSERT_EQ(loader.Initialize(2, 2), ysError::YDS_NO_ERROR);
+
+    const int requestCount = 4;
+    const int stepsPerRequest = 3;
+    int steps[requestCount] = { 0 };
+
+    ysLoadHandle handles[requestCount];
+    for (int i = 0; i < requestCount; i++) {
+        ysAsyncLoader::Request request;
+        request.Priority = 0;
+        request.Finalize = [&steps, i](bool *done) {
+            *done = (++steps[i] == stepsPerRequest);
+            return ysError::YDS_NO_ERROR;
+        };
+
+        handles[i] = loader.Submit(request);
+    }
+
+    for (int i = 0; i < requestCount; i++) {
+        WaitForStatus(&loader, handles[i], ysAsyncLoader::Status::Finalizing);
+    }
+
+    // A spent budget still makes progress one step at a time, requests
+    // that need more steps take turns
+    for (int round = 0; round < stepsPerRequest; round++) {
+        for (int i = 0; i < requestCount; i++) EXPECT_EQ(loader.Update(0.0), 1);
+        for (int i = 0; i < requestCount; i++) EXPECT_EQ(steps[i], round + 1);
+    }
+
+    EXPECT_EQ(loader.Update(0.0), 0);
+    for (int i = 0; i < requestCount; i++) {
+        EXPECT_EQ(loader.GetStatus(handles[i]), ysAsyncLoader::Status::Complete);
+    }
+
+    // A slow step uses up the budget for the frame
+    ysAsyncLoader::Request slow;
+    slow.Priority = 0;
+    slow.Finalize = [](bool *) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return ysError::YDS_NO_ERROR;
+    };
+
+    const ysLoadHandle first = loader.Submit(slow);
+    const ysLoadHandle second = loader.Submit(slow);
+    WaitForStatus(&loader, first, ysAsyncLoader::Status::Finalizing);
+    WaitForStatus(&loader, second, ysAsyncLoader::Status::Finalizing);
+
+    EXPECT_EQ(loader.Update(0.002), 1);
+    EXPECT_EQ(loader.Update(1.0), 1);
+}
+
+TEST(AsyncLoader, ReleaseWhileRunning) {
+    std::weak_ptr<int> weakState;
+
+    {
+        ysAsyncLoader loader;
+        ASSERT_EQ(loader.Initialize(1, 1), ysError::YDS_NO_ERROR);
+
+        Gate gate;
+        std::shared_ptr<int> state = std::make_shared<int>(0);
+        weakState = state;
+
+        ysAsyncLoader::Request request = BlockingRequest(&gate);
+        request.Process = [state] { return ysError::YDS_NO_ERROR; };
+        state.reset();
+
+        const ysLoadHandle handle = loader.Submit(request);
+        request = ysAsyncLoader::Request();
+        gate.WaitEntered();
+
+        // The handle is stale right away, the request goes once its stage returns
+        loader.Release(handle);
+        EXPECT_EQ(loader.GetStatus(handle), ysAsyncLoader::Status::Invalid);
+        EXPECT_FALSE(weakState.expired());
+
+        gate.Open();
+        loader.Flush();
+
+        EXPECT_TRUE(weakState.expired());
+        EXPECT_EQ(loader.GetPendingCount(), 0);
+
+        // Shutting down cancels whatever is left
+        Gate secondGate;
+        const ysLoadHandle blocking = loader.Submit(BlockingRequest(&secondGate));
+        const ysLoadHandle waiting = loader.Submit(BlockingRequest(&secondGate));
+        secondGate.WaitEntered();
+        secondGate.Open();
+
+        loader.Shutdown();
+        EXPECT_FALSE(loader.IsInitialized());
+        EXPECT_EQ(loader.GetStatus(blocking), ysAsyncLoader::Status::Cancelled);
+        EXPECT_EQ(loader.GetStatus(waiting), ysAsyncLoader::Status::Cancelled);
+        EXPECT_EQ(loader.GetPendingCount(), 0);
+    }
+}
@@ -0,0 +1,212 @@
+#include <pch.h>
+
+#include "../include/yds_chunk_pool.h"
+#include "../include/yds_dynamic_array.h"
+
+#include <stdint.h>
+#include <vector>
+
+TEST(ChunkPool, LayoutAndAlignment) {
+    ysChunkPool pool;
+    pool.Initialize(40, 16);
+
+    EXPECT_EQ(pool.GetSlotSize(), 48);
+    EXPECT_EQ(pool.GetAlignment(), 16);
+
+    std::vector<void *> slots;
+    for (int i = 0; i < 200; i++) {
+        void *slot = pool.Allocate();
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(slot) % 16, 0);
+        EXPECT_TRUE(pool.Owns(slot));
+
+        slots.push_back(slot);
+    }
+
+    EXPECT_EQ(pool.GetCount(), 200);
+    EXPECT_GE(pool.GetChunkSize(), ysChunkPool::MinChunkSlots * 48);
+
+    // Slots within a chunk are contiguous
+    EXPECT_EQ(reinterpret_cast<char *>(slots[1]) - reinterpret_cast<char *>(slots[0]), 48);
+
+    int dummy;
+    EXPECT_FALSE(pool.Owns(&dummy));
+
+    pool.Destroy();
+    EXPECT_EQ(pool.GetCount(), 0);
+    EXPECT_EQ(pool.GetChunkCount(), 0);
+}
+
+TEST(ChunkPool, FreeListReuse) {
+    ysChunkPool pool;
+    pool.Initialize(32, 8);
+
+    void *a = pool.Allocate();
+    void *b = pool.Allocate();
+    const int chunks = pool.GetChunkCount();
+
+    pool.Free(a);
+    EXPECT_EQ(pool.GetCount(), 1);
+
+    // Freeing by an interior address returns the whole slot
+    pool.Free(reinterpret_cast<char *>(b) + 8);
+    EXPECT_EQ(pool.GetCount(), 0);
+
+    void *c = pool.Allocate();
+    void *d = pool.Allocate();
+    EXPECT_EQ(c, b);
+    EXPECT_EQ(d, a);
+    EXPECT_EQ(pool.GetChunkCount(), chunks);
+
+    pool.Destroy();
+}
+
+TEST(ChunkPool, ForEachVisitsLiveSlots) {
+    ysChunkPool pool;
+    pool.Initialize(sizeof(int), sizeof(int));
+
+    std::vector<int *> slots;
+    for (int i = 0; i < 1000; i++) {
+        int *slot = reinterpret_cast<int *>(pool.Allocate());
+        *slot = i;
+        slots.push_back(slot);
+    }
+
+    for (int i = 0; i < 1000; i += 3) pool.Free(slots[i]);
+
+    int visited = 0;
+    long long sum = 0;
+    pool.ForEach([&](void *slot) {
+        sum += *reinterpret_cast<int *>(slot);
+        visited++;
+    });
+
+    long long expected = 0;
+    for (int i = 0; i < 1000; i++) if (i % 3 != 0) expected += i;
+
+    EXPECT_EQ(visited, pool.GetCount());
+    EXPECT_EQ(sum, expected);
+
+    pool.Destroy();
+}
+
+namespace {
+
+    int LiveElements = 0;
+
+    class BaseElement : public ysDynamicArrayElement {
+    public:
+        BaseElement() { LiveElements++; Value = 0; }
+        virtual ~BaseElement() { LiveElements--; }
+
+        int Value;
+    };
+
+    class PaddedElement {
+    public:
+        char Padding[24];
+    };
+
+    // Base class is not at the start of the object
+    class DerivedElement : public PaddedElement, public BaseElement {
+    public:
+        DerivedElement() { Extra = 3; }
+
+        int Extra;
+    };
+
+} /* namespace */
+
+TEST(ChunkPool, DynamicArrayBackend) {
+    {
+        ysDynamicArray<BaseElement, 4, true> array;
+
+        for (int i = 0; i < 300; i++) {
+            BaseElement *element;
+            if (i % 2 == 0) element = array.New();
+            else {
+                DerivedElement *derived = array.NewGeneric<DerivedElement, 16>();
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(derived) % 16, 0);
+                EXPECT_EQ(derived->Extra, 3);
+
+                element = derived;
+            }
+
+            element->Value = i;
+        }
+
+        EXPECT_EQ(LiveElements, 300);
+
+        // Remove some objects through both pools
+        for (int i = 0; i < 50; i++) array.Delete(i * 3 % array.GetNumObjects());
+        EXPECT_EQ(LiveElements, 250);
+        EXPECT_EQ(array.GetNumObjects(), 250);
+
+        for (int i = 0; i < array.GetNumObjects(); i++) {
+            EXPECT_EQ(array.Get(i)->GetIndex(), i);
+        }
+
+        int visited = 0;
+        long long sum = 0;
+        array.ForEachLinear([&](BaseElement *element) {
+            visited++;
+            sum += element->Value;
+        });
+
+        long long expected = 0;
+        for (int i = 0; i < array.GetNumObjects(); i++) expected += array.Get(i)->Value;
+
+        EXPECT_EQ(visited, 250);
+        EXPECT_EQ(sum, expected);
+    }
+
+    EXPECT_EQ(LiveElements, 0);
+}
+
+TEST(ChunkPool, DynamicArrayPoolingIsOptIn) {
+    {
+        ysDynamicArray<BaseElement, 4> array;
+        BaseElement *element = array.New();
+        EXPECT_EQ(element->GetPool(), nullptr);
+
+        int visited = 0;
+        array.ForEachLinear([&](BaseElement *) { visited++; });
+        EXPECT_EQ(visited, 1);
+    }
+
+    EXPECT_EQ(LiveElements, 0);
+}
+
+TEST(ChunkPool, DynamicArrayForeignObjects) {
+    ysDynamicArray<BaseElement, 4> source;
+    BaseElement *foreign = source.New();
+    foreign->Value = 100;
+
+    // Objects that aren't from the array's pools are moved between arrays
+    // as before
+    source.Delete(foreign->GetIndex(), false);
+
+    {
+        ysDynamicArray<BaseElement, 4, true> array;
+        for (int i = 0; i < 3; i++) array.New()->Value = i;
+
+        array.Delete(1);
+        array.Add(foreign);
+
+        int visited = 0;
+        int sum = 0;
+        array.ForEachLinear([&](BaseElement *element) {
+            visited++;
+            sum += element->Value;
+        });
+
+        EXPECT_EQ(visited, 3);
+        EXPECT_EQ(sum, 102);
+
+        array.Delete(foreign->GetIndex(), false);
+    }
+
+    EXPECT_EQ(LiveElements, 1);
+    ysAllocator::TypeFree<BaseElement>(foreign, 1, true, foreign->GetAlignment());
+    EXPECT_EQ(LiveElements, 0);
+}
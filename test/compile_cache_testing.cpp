@@ -0,0 +1,109 @@
+#include <pch.h>
+
+#include "../include/yds_compile_cache.h"
+#include "../include/yds_tool_geometry_file.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+    ysCompileCache::Entry MakeEntry(uint64_t key, const char *material, unsigned int flags) {
+        ysCompileCache::Entry entry;
+        memset(&entry, 0, sizeof(ysCompileCache::Entry));
+        entry.Key = key;
+        entry.MaterialFlags = flags;
+        strcpy_s(entry.MaterialName, 64, material);
+
+        return entry;
+    }
+
+} /* namespace */
+
+TEST(CompileCache, SaveAndLoad) {
+    const char *fname = "test_cache.ysci";
+
+    ysCompileCache cache;
+    cache.SetSourceHash(0x1234);
+    cache.SetOptionsHash(0x5678);
+    cache.SetOutputSize(4096);
+    cache.AddEntry(MakeEntry(10, "Metal", 0x1));
+    cache.AddEntry(MakeEntry(20, "", 0x0));
+    cache.AddEntry(MakeEntry(10, "Wood", 0x4));
+    ASSERT_EQ(cache.Save(fname), ysError::YDS_NO_ERROR);
+
+    ysCompileCache loaded;
+    ASSERT_TRUE(loaded.Load(fname));
+    EXPECT_EQ(loaded.GetSourceHash(), 0x1234u);
+    EXPECT_EQ(loaded.GetOptionsHash(), 0x5678u);
+    EXPECT_EQ(loaded.GetOutputSize(), 4096u);
+    ASSERT_EQ(loaded.GetEntryCount(), 3);
+
+    EXPECT_STREQ(loaded.GetEntry(0).MaterialName, "Metal");
+    EXPECT_EQ(loaded.GetEntry(2).MaterialFlags, 0x4u);
+
+    // Duplicate keys resolve to the first object
+    EXPECT_EQ(loaded.Find(10), 0);
+    EXPECT_EQ(loaded.Find(20), 1);
+    EXPECT_EQ(loaded.Find(30), -1);
+
+    remove(fname);
+}
+
+TEST(CompileCache, RejectsInvalidFiles) {
+    const char *fname = "test_invalid_cache.ysci";
+
+    ysCompileCache cache;
+    EXPECT_FALSE(cache.Load("missing_file.ysci"));
+
+    cache.AddEntry(MakeEntry(10, "Metal", 0x1));
+    cache.AddEntry(MakeEntry(20, "Metal", 0x1));
+    ASSERT_EQ(cache.Save(fname), ysError::YDS_NO_ERROR);
+
+    // Cut off in the middle of the last entry
+    std::ifstream input(fname, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+
+    std::ofstream output(fname, std::ios::binary | std::ios::trunc);
+    output.write(data.data(), data.size() - 8);
+    output.close();
+
+    EXPECT_FALSE(cache.Load(fname));
+    EXPECT_EQ(cache.GetEntryCount(), 0);
+    EXPECT_EQ(cache.Find(10), -1);
+
+    remove(fname);
+}
+
+TEST(CompileCache, SourceHashIgnoresCompilationStatus) {
+    const char *fname = "test_source.ysc";
+
+    unsigned int contents[16];
+    for (int i = 0; i < 16; i++) contents[i] = i;
+
+    auto writeSource = [&]() {
+        std::ofstream file(fname, std::ios::binary | std::ios::trunc);
+        file.write((const char *)contents, sizeof(contents));
+    };
+
+    uint64_t original, hash;
+    writeSource();
+    ASSERT_TRUE(ysToolGeometryFile::HashFile(fname, &original));
+
+    // Written by the compiler itself
+    contents[3] = (unsigned int)ysToolGeometryFile::CompilationStatus::Compiled;
+    writeSource();
+    ASSERT_TRUE(ysToolGeometryFile::HashFile(fname, &hash));
+    EXPECT_EQ(hash, original);
+
+    contents[10] = 100;
+    writeSource();
+    ASSERT_TRUE(ysToolGeometryFile::HashFile(fname, &hash));
+    EXPECT_NE(hash, original);
+
+    remove(fname);
+}
@@ -0,0 +1,361 @@
+#include <pch.h>
+
+#include "../include/yds_compiled_scene_file.h"
+#include "../include/yds_geometry_export_file.h"
+#include "../include/yds_geometry_preprocessing.h"
+#include "../include/yds_null_device.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+    void MakeTriangle(ysObjectData *object, const char *name, int parent, bool normals) {
+        strcpy_s(object->m_name, 64, name);
+        strcpy_s(object->m_materialName, 64, "Material");
+
+        object->m_objectInformation.ObjectType = ysObjectData::TYPE_GEOMETRY;
+        object->m_objectInformation.ParentIndex = parent;
+        object->m_objectStatistics.NumVertices = 3;
+        object->m_objectStatistics.NumFaces = 1;
+        object->m_objectStatistics.NumUVChannels = 0;
+
+        object->m_vertices.New() = ysVector3(0.0f, 0.0f, 0.0f);
+        object->m_vertices.New() = ysVector3(1.0f, 0.0f, 0.0f);
+        object->m_vertices.New() = ysVector3(0.0f, 1.0f, 0.0f);
+
+        ysObjectData::IndexSet &face = object->m_vertexIndexSet.New();
+        face.x = 0; face.y = 1; face.z = 2;
+
+        if (normals) {
+            for (int i = 0; i < 3; i++) object->m_normals.New() = ysVector3(0.0f, 0.0f, 1.0f);
+        }
+
+        object->m_boneIndices.New() = 0;
+    }
+
+    std::vector<char> ReadFile(const char *fname) {
+        std::ifstream file(fname, std::ios::binary);
+        return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+} /* namespace */
+
+TEST(CompiledSceneFile, WriteAndMap) {
+    const char *fname = "test_compiled_scene.ysce";
+
+    ysObjectData group, small, large;
+    strcpy_s(group.m_name, 64, "Group");
+    group.m_materialName[0] = '\0';
+    group.m_objectInformation.ObjectType = ysObjectData::TYPE_GROUP;
+    group.m_objectInformation.ParentIndex = -1;
+
+    MakeTriangle(&small, "Small", 0, false);
+    MakeTriangle(&large, "Large", 0, true);
+
+    ysGeometryExportFile exportFile;
+    ASSERT_EQ(exportFile.Open(fname), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&group), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&small), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&large), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(exportFile.Close(), ysError::YDS_NO_ERROR);
+
+    EXPECT_TRUE(ysCompiledSceneFile::IsCurrentVersion(fname));
+
+    ysCompiledSceneFile file;
+    ASSERT_EQ(file.Open(fname), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(file.GetObjectCount(), 3);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(file.GetVertexData()) % ysGeometryExportFile::PayloadAlignment, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(file.GetIndexData()) % ysGeometryExportFile::PayloadAlignment, 0);
+
+    EXPECT_STREQ(file.GetObject(0)->Header.ObjectName, "Group");
+    EXPECT_EQ(file.GetBoneMap(file.GetObject(0)), nullptr);
+
+    // Each object starts on a boundary that is aligned and a multiple of its stride
+    const ysCompiledSceneFile::ObjectTableEntry *largeEntry = file.GetObject(2);
+    const int stride = largeEntry->Header.VertexDataSize / largeEntry->Header.NumVertices;
+    EXPECT_EQ(stride, 32);
+    EXPECT_EQ(largeEntry->VertexOffset % 32, 0);
+    EXPECT_GT(largeEntry->VertexOffset, 0);
+
+    const float *vertices = reinterpret_cast<const float *>(file.GetVertexData() + largeEntry->VertexOffset);
+    EXPECT_EQ(vertices[stride / 4 + 0], 1.0f);
+    EXPECT_EQ(vertices[stride / 4 + 3], 1.0f);
+
+    const unsigned short *indices = reinterpret_cast<const unsigned short *>(file.GetIndices(largeEntry));
+    EXPECT_EQ(ysGeometryExportFile::GetIndexSize(largeEntry->Header), (int)sizeof(unsigned short));
+    EXPECT_EQ(largeEntry->IndexOffset % (ysGeometryExportFile::PayloadAlignment / 2), 0);
+    EXPECT_EQ(indices[0], 0);
+    EXPECT_EQ(indices[2], 2);
+
+    const int *boneMap = file.GetBoneMap(largeEntry);
+    ASSERT_NE(boneMap, nullptr);
+    EXPECT_EQ(boneMap[0], 0);
+
+    // The mapped blocks go straight to the device
+    ysNullDevice device;
+    ysGPUBuffer *vertexBuffer = nullptr;
+    ASSERT_EQ(device.CreateVertexBuffer(&vertexBuffer, file.GetVertexDataSize(), (char *)file.GetVertexData(), true), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(vertexBuffer->GetSize(), file.GetVertexDataSize());
+    EXPECT_EQ(memcmp(vertexBuffer->GetRAMMirror(), file.GetVertexData(), file.GetVertexDataSize()), 0);
+    EXPECT_EQ(device.DestroyGPUBuffer(vertexBuffer), ysError::YDS_NO_ERROR);
+
+    file.Close();
+    remove(fname);
+}
+
+TEST(CompiledSceneFile, RejectsOldFiles) {
+    const char *fname = "test_legacy_scene.ysce";
+
+    // Files from before the versioned layout start with the object count
+    std::fstream legacyFile(fname, std::ios::out | std::ios::binary);
+    int legacyHeader[16] = { 1 };
+    legacyFile.write((const char *)legacyHeader, sizeof(legacyHeader));
+    legacyFile.close();
+
+    EXPECT_FALSE(ysCompiledSceneFile::IsCurrentVersion(fname));
+    EXPECT_FALSE(ysCompiledSceneFile::IsCurrentVersion("missing_file.ysce"));
+
+    ysCompiledSceneFile file;
+    EXPECT_EQ(file.Open(fname), ysError::YDS_INVALID_FILE_TYPE);
+    EXPECT_EQ(file.Open("missing_file.ysce"), ysError::YDS_COULD_NOT_OPEN_FILE);
+
+    remove(fname);
+}
+
+TEST(CompiledSceneFile, EmptyAndCorruptGeometry) {
+    const char *fname = "test_empty_geometry.ysce";
+
+    ysObjectData empty, triangle;
+    strcpy_s(empty.m_name, 64, "Empty");
+    strcpy_s(empty.m_materialName, 64, "Material");
+    empty.m_objectInformation.ObjectType = ysObjectData::TYPE_GEOMETRY;
+    empty.m_objectInformation.ParentIndex = -1;
+    empty.m_objectStatistics.NumVertices = 0;
+    empty.m_objectStatistics.NumFaces = 0;
+    empty.m_objectStatistics.NumUVChannels = 0;
+
+    MakeTriangle(&triangle, "Triangle", -1, false);
+
+    ysGeometryExportFile exportFile;
+    ASSERT_EQ(exportFile.Open(fname), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&empty), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&triangle), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(exportFile.Close(), ysError::YDS_NO_ERROR);
+
+    // An empty mesh doesn't stop the rest of the scene from loading
+    ysCompiledSceneFile file;
+    ASSERT_EQ(file.Open(fname), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(file.GetObjectCount(), 2);
+    EXPECT_EQ(file.GetObject(0)->Header.NumVertices, 0);
+    EXPECT_EQ(file.GetObject(0)->Header.VertexDataSize, 0);
+    EXPECT_EQ(file.GetObject(1)->Header.NumVertices, 3);
+
+    // Offset of the triangle's vertex data size within the object table
+    const ptrdiff_t sizeOffset =
+        reinterpret_cast<const char *>(&file.GetObject(1)->Header.VertexDataSize) -
+        reinterpret_cast<const char *>(file.GetObject(0));
+    file.Close();
+
+    // Vertices without any vertex data would give a stride of 0
+    std::vector<char> data = ReadFile(fname);
+    ysGeometryExportFile::FileHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    const int zero = 0;
+    memcpy(data.data() + header.ObjectTableOffset + sizeOffset, &zero, sizeof(int));
+
+    std::ofstream corrupted(fname, std::ios::binary | std::ios::trunc);
+    corrupted.write(data.data(), data.size());
+    corrupted.close();
+
+    EXPECT_EQ(file.Open(fname), ysError::YDS_CORRUPTED_FILE);
+
+    remove(fname);
+}
+
+TEST(CompiledSceneFile, CompressedVertices) {
+    const char *fname = "test_compressed_scene.ysce";
+
+    ysObjectData full, compressed;
+    MakeTriangle(&full, "Full", -1, true);
+    MakeTriangle(&compressed, "Compressed", -1, true);
+
+    ysGeometryExportFile exportFile;
+    ASSERT_EQ(exportFile.Open(fname), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&full), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&compressed, true), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(exportFile.Close(), ysError::YDS_NO_ERROR);
+
+    ysCompiledSceneFile file;
+    ASSERT_EQ(file.Open(fname), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(file.GetObjectCount(), 2);
+
+    const ysCompiledSceneFile::ObjectTableEntry *fullEntry = file.GetObject(0);
+    const ysCompiledSceneFile::ObjectTableEntry *entry = file.GetObject(1);
+    EXPECT_EQ(fullEntry->Header.Flags & ysGeometryExportFile::MDF_COMPRESSED, 0u);
+    EXPECT_NE(entry->Header.Flags & ysGeometryExportFile::MDF_COMPRESSED, 0u);
+
+    // Quantized position followed by an octahedral normal
+    const int stride = entry->Header.VertexDataSize / entry->Header.NumVertices;
+    EXPECT_EQ(stride, 12);
+    EXPECT_EQ(entry->VertexOffset % stride, 0);
+
+    const unsigned short *vertices = reinterpret_cast<const unsigned short *>(file.GetVertexData() + entry->VertexOffset);
+    EXPECT_EQ(vertices[0], 0);
+    EXPECT_EQ(vertices[6], 0xFFFF);
+    EXPECT_EQ(vertices[7], 0);
+    EXPECT_EQ(vertices[13], 0xFFFF);
+
+    file.Close();
+    remove(fname);
+}
+
+TEST(CompiledSceneFile, LargeMesh) {
+    const char *fname = "test_large_scene.ysce";
+
+    ysObjectData small, large;
+    MakeTriangle(&small, "Small", -1, false);
+
+    // Too many vertices for 16 bit indices
+    const int vertexCount = 70000;
+    strcpy_s(large.m_name, 64, "Large");
+    strcpy_s(large.m_materialName, 64, "Material");
+    large.m_objectInformation.ObjectType = ysObjectData::TYPE_GEOMETRY;
+    large.m_objectInformation.ParentIndex = -1;
+
+    for (int i = 0; i < vertexCount; i++) {
+        large.m_vertices.New() = ysVector3((float)(i / 2), (float)(i % 2), 0.0f);
+    }
+
+    for (int i = 0; i < vertexCount - 2; i++) {
+        ysObjectData::IndexSet &face = large.m_vertexIndexSet.New();
+        face.x = i; face.y = i + 1; face.z = i + 2;
+    }
+
+    large.m_objectStatistics.NumVertices = vertexCount;
+    large.m_objectStatistics.NumFaces = vertexCount - 2;
+    large.m_objectStatistics.NumUVChannels = 0;
+
+    ysGeometryPreprocessing::BuildMeshlets(&large);
+
+    ysGeometryExportFile exportFile;
+    ASSERT_EQ(exportFile.Open(fname), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&small), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&large), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&small), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(exportFile.Close(), ysError::YDS_NO_ERROR);
+
+    ysCompiledSceneFile file;
+    ASSERT_EQ(file.Open(fname), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(file.GetObjectCount(), 3);
+
+    const ysCompiledSceneFile::ObjectTableEntry *smallEntry = file.GetObject(2);
+    const ysCompiledSceneFile::ObjectTableEntry *largeEntry = file.GetObject(1);
+    EXPECT_EQ(ysGeometryExportFile::GetIndexSize(smallEntry->Header), 2);
+    EXPECT_EQ(ysGeometryExportFile::GetIndexSize(largeEntry->Header), 4);
+    EXPECT_EQ(file.GetMeshlets(smallEntry), nullptr);
+
+    const unsigned int *largeIndices = reinterpret_cast<const unsigned int *>(file.GetIndices(largeEntry));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(largeIndices) % ysGeometryExportFile::PayloadAlignment, 0);
+    EXPECT_EQ(largeIndices[0], 0u);
+    EXPECT_EQ(largeIndices[3 * (vertexCount - 3) + 2], (unsigned int)vertexCount - 1);
+
+    const unsigned short *smallIndices = reinterpret_cast<const unsigned short *>(file.GetIndices(smallEntry));
+    EXPECT_EQ(smallIndices[1], 1);
+    EXPECT_EQ(smallIndices[2], 2);
+
+    const ysObjectData::Meshlet *meshlets = file.GetMeshlets(largeEntry);
+    ASSERT_NE(meshlets, nullptr);
+    ASSERT_EQ(largeEntry->Header.NumMeshlets, large.m_meshlets.GetNumObjects());
+
+    const ysObjectData::Meshlet &last = meshlets[largeEntry->Header.NumMeshlets - 1];
+    EXPECT_EQ(last.FirstFace + last.FaceCount, vertexCount - 2);
+    EXPECT_EQ(last.MaxExtreme.x, (float)((vertexCount - 1) / 2));
+
+    file.Close();
+    remove(fname);
+}
+
+TEST(CompiledSceneFile, CopyObjects) {
+    const char *fname = "test_original_scene.ysce";
+    const char *copyName = "test_copied_scene.ysce";
+
+    ysObjectData group, triangle, compressed, plane;
+    strcpy_s(group.m_name, 64, "Group");
+    group.m_materialName[0] = '\0';
+    group.m_objectInformation.ObjectType = ysObjectData::TYPE_GROUP;
+    group.m_objectInformation.ParentIndex = -1;
+
+    MakeTriangle(&triangle, "Triangle", 0, true);
+    MakeTriangle(&compressed, "Compressed", 0, true);
+    ysGeometryPreprocessing::BuildMeshlets(&triangle);
+
+    strcpy_s(plane.m_name, 64, "Plane");
+    plane.m_materialName[0] = '\0';
+    plane.m_objectInformation.ObjectType = ysObjectData::TYPE_PLANE;
+    plane.m_objectInformation.ParentIndex = 0;
+    plane.m_length = 2.0f;
+    plane.m_width = 3.0f;
+
+    ysGeometryExportFile exportFile;
+    ASSERT_EQ(exportFile.Open(fname), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&group), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&triangle), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&plane), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&compressed, true), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(exportFile.Close(), ysError::YDS_NO_ERROR);
+
+    ysCompiledSceneFile original;
+    ASSERT_EQ(original.Open(fname), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(original.GetObjectCount(), 4);
+
+    // Copying every object gives the same file as compiling them again
+    ASSERT_EQ(exportFile.Open(copyName), ysError::YDS_NO_ERROR);
+    for (int i = 0; i < original.GetObjectCount(); i++) {
+        EXPECT_EQ(exportFile.WriteCompiledObject(original, i), ysError::YDS_NO_ERROR);
+    }
+
+    EXPECT_EQ(exportFile.WriteCompiledObject(original, 4), ysError::YDS_INVALID_PARAMETER);
+    ASSERT_EQ(exportFile.Close(), ysError::YDS_NO_ERROR);
+
+    EXPECT_TRUE(ReadFile(copyName) == ReadFile(fname));
+
+    // Copies can be mixed with newly compiled objects
+    ASSERT_EQ(exportFile.Open(copyName), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteObject(&compressed), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteCompiledObject(original, 2), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(exportFile.WriteCompiledObject(original, 1), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(exportFile.Close(), ysError::YDS_NO_ERROR);
+
+    ysCompiledSceneFile copy;
+    ASSERT_EQ(copy.Open(copyName), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(copy.GetObjectCount(), 3);
+
+    const float *primitiveData = copy.GetPrimitiveData(copy.GetObject(1));
+    ASSERT_NE(primitiveData, nullptr);
+    EXPECT_EQ(primitiveData[0], 2.0f);
+    EXPECT_EQ(primitiveData[1], 3.0f);
+
+    const ysCompiledSceneFile::ObjectTableEntry *source = original.GetObject(1);
+    const ysCompiledSceneFile::ObjectTableEntry *copied = copy.GetObject(2);
+    EXPECT_STREQ(copied->Header.ObjectName, "Triangle");
+    EXPECT_EQ(memcmp(
+        copy.GetVertexData() + copied->VertexOffset,
+        original.GetVertexData() + source->VertexOffset,
+        source->Header.VertexDataSize), 0);
+    EXPECT_EQ(memcmp(copy.GetIndices(copied), original.GetIndices(source), 3 * sizeof(unsigned short)), 0);
+    EXPECT_EQ(copy.GetBoneMap(copied)[0], 0);
+
+    ASSERT_NE(copy.GetMeshlets(copied), nullptr);
+    EXPECT_EQ(copy.GetMeshlets(copied)[0].FaceCount, 1);
+
+    copy.Close();
+    original.Close();
+    remove(copyName);
+    remove(fname);
+}
@@ -0,0 +1,215 @@
+#include <pch.h>
+
+#include "../include/yds_expanding_array.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+
+namespace {
+
+    int LiveObjects = 0;
+
+    // Not trivially copyable, counts constructions and destructions
+    struct TrackedObject {
+        TrackedObject() { LiveObjects++; Value = -1; }
+        TrackedObject(const TrackedObject &ref) { LiveObjects++; Value = ref.Value; }
+        ~TrackedObject() { LiveObjects--; }
+
+        TrackedObject &operator=(const TrackedObject &ref) { Value = ref.Value; return *this; }
+
+        int Value;
+    };
+
+} /* namespace */
+
+TEST(ExpandingArray, GrowthKeepsContents) {
+    ysExpandingArray<int> array;
+    for (int i = 0; i < 1000; i++) array.New() = i;
+
+    EXPECT_EQ(array.GetNumObjects(), 1000);
+    EXPECT_GE(array.GetCapacity(), 1000);
+    for (int i = 0; i < 1000; i++) EXPECT_EQ(array[i], i);
+
+    ysExpandingArray<int, 0, 16> aligned;
+    for (int i = 0; i < 100; i++) {
+        aligned.New() = i;
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned.GetBuffer()) % 16, 0);
+    }
+
+    for (int i = 0; i < 100; i++) EXPECT_EQ(aligned[i], i);
+}
+
+TEST(ExpandingArray, ReserveResizeAppend) {
+    ysExpandingArray<int> array;
+    array.Reserve(64);
+    EXPECT_EQ(array.GetCapacity(), 64);
+    EXPECT_EQ(array.GetNumObjects(), 0);
+
+    int *buffer = array.GetBuffer();
+    const int data[] = { 1, 2, 3, 4, 5 };
+    for (int i = 0; i < 10; i++) array.Append(data, 5);
+
+    // No reallocation within the reserved capacity
+    EXPECT_EQ(array.GetBuffer(), buffer);
+    EXPECT_EQ(array.GetNumObjects(), 50);
+    EXPECT_EQ(array[49], 5);
+
+    // Appending from the array itself while it grows
+    array.Append(array.GetBuffer(), 50);
+    EXPECT_EQ(array.GetNumObjects(), 100);
+    for (int i = 0; i < 100; i++) EXPECT_EQ(array[i], (i % 5) + 1);
+
+    array.Resize(10);
+    EXPECT_EQ(array.GetNumObjects(), 10);
+
+    array.Clear();
+    EXPECT_EQ(array.GetNumObjects(), 0);
+    EXPECT_TRUE(array.IsActive());
+}
+
+TEST(ExpandingArray, InsertEraseDelete) {
+    ysExpandingArray<int> array;
+    for (int i = 0; i < 10; i++) array.New() = i;
+
+    array.Insert(0) = 100;
+    array.Insert(5) = 200;
+    array.Insert(array.GetNumObjects()) = 300;
+
+    const int expected0[] = { 100, 0, 1, 2, 3, 200, 4, 5, 6, 7, 8, 9, 300 };
+    ASSERT_EQ(array.GetNumObjects(), 13);
+    for (int i = 0; i < 13; i++) EXPECT_EQ(array[i], expected0[i]);
+
+    array.Erase(1, 4);
+    array.Delete(0, true);
+
+    const int expected1[] = { 200, 4, 5, 6, 7, 8, 9, 300 };
+    ASSERT_EQ(array.GetNumObjects(), 8);
+    for (int i = 0; i < 8; i++) EXPECT_EQ(array[i], expected1[i]);
+
+    // Unordered delete moves the last element into the gap
+    array.Delete(1);
+    EXPECT_EQ(array[1], 300);
+    EXPECT_EQ(array.GetNumObjects(), 7);
+    EXPECT_EQ(array.Find(300), 1);
+    EXPECT_EQ(array.Find(4), -1);
+}
+
+TEST(ExpandingArray, ObjectLifetimes) {
+    {
+        ysExpandingArray<TrackedObject, 4> array;
+        EXPECT_EQ(LiveObjects, 0);
+
+        for (int i = 0; i < 100; i++) array.New().Value = i;
+        EXPECT_EQ(LiveObjects, 100);
+
+        array.Insert(50).Value = 1000;
+        array.Erase(10, 5);
+        array.Delete(0);
+        array.Copy(1);
+        EXPECT_EQ(LiveObjects, array.GetNumObjects());
+        EXPECT_EQ(array[45].Value, 1000);
+
+        ysExpandingArray<TrackedObject, 4> copy(array);
+        EXPECT_EQ(LiveObjects, 2 * array.GetNumObjects());
+        for (int i = 0; i < array.GetNumObjects(); i++) EXPECT_EQ(copy[i].Value, array[i].Value);
+
+        ysExpandingArray<TrackedObject, 4> moved(std::move(copy));
+        EXPECT_EQ(copy.GetNumObjects(), 0);
+        EXPECT_FALSE(copy.IsActive());
+        EXPECT_EQ(LiveObjects, 2 * array.GetNumObjects());
+
+        array.Clear();
+        EXPECT_EQ(LiveObjects, moved.GetNumObjects());
+
+        array.Allocate(20);
+        EXPECT_EQ(LiveObjects, moved.GetNumObjects() + 20);
+    }
+
+    EXPECT_EQ(LiveObjects, 0);
+}
+
+TEST(ExpandingArray, NestedArrays) {
+    ysExpandingArray<ysExpandingArray<int, 4>, 2> groups;
+    for (int i = 0; i < 50; i++) {
+        ysExpandingArray<int, 4> &group = groups.New();
+        for (int j = 0; j <= i; j++) group.New() = j;
+    }
+
+    groups.Erase(0, 10);
+    groups.Insert(0).New() = -1;
+
+    EXPECT_EQ(groups.GetNumObjects(), 41);
+    EXPECT_EQ(groups[0][0], -1);
+    EXPECT_EQ(groups[1].GetNumObjects(), 11);
+    EXPECT_EQ(groups[40][49], 49);
+}
+
+TEST(ExpandingArray, Uninitialized) {
+    struct Vector {
+        Vector() : x(0), y(0) { /* void */ }
+        float x, y;
+    };
+
+    static_assert(ysIsBulkReadable<Vector>::value, "Vector should be bulk readable");
+    static_assert(!ysIsBulkReadable<TrackedObject>::value, "TrackedObject should not be bulk readable");
+
+    const Vector source[3] = { Vector(), Vector(), Vector() };
+
+    ysExpandingArray<Vector> array;
+    array.AllocateUninitialized(3);
+    EXPECT_EQ(array.GetNumObjects(), 3);
+    memcpy(array.GetBuffer(), source, sizeof(source));
+
+    Vector *appended = array.AppendUninitialized(100);
+    EXPECT_EQ(appended, array.GetBuffer() + 3);
+    EXPECT_EQ(array.GetNumObjects(), 103);
+    for (int i = 0; i < 100; i++) appended[i].x = (float)i;
+
+    EXPECT_EQ(array[0].x, 0.0f);
+    EXPECT_EQ(array[102].x, 99.0f);
+
+    array.ResizeUninitialized(10);
+    EXPECT_EQ(array.GetNumObjects(), 10);
+    EXPECT_EQ(array[9].x, 6.0f);
+}
+
+TEST(ExpandingArray, FailedAllocation) {
+    // Sizes the allocator can't be asked for fail the same way as an
+    // allocation that returns nothing
+    ysExpandingArray<int> array;
+    for (int i = 0; i < 10; i++) array.New() = i;
+
+    const int *buffer = array.GetBuffer();
+    const int capacity = array.GetCapacity();
+
+    EXPECT_FALSE(array.Reserve(INT_MAX));
+    EXPECT_FALSE(array.Resize(INT_MAX / 2));
+    EXPECT_FALSE(array.ResizeUninitialized(INT_MAX / 2));
+    EXPECT_EQ(array.AppendUninitialized(INT_MAX / 2), nullptr);
+    EXPECT_EQ(array.AppendUninitialized(INT_MAX), nullptr);
+    EXPECT_FALSE(array.Append(array.GetBuffer(), INT_MAX / 2));
+
+    EXPECT_EQ(array.GetBuffer(), buffer);
+    EXPECT_EQ(array.GetCapacity(), capacity);
+    ASSERT_EQ(array.GetNumObjects(), 10);
+    for (int i = 0; i < 10; i++) EXPECT_EQ(array[i], i);
+
+    // Objects are neither constructed nor moved
+    {
+        ysExpandingArray<TrackedObject> objects;
+        for (int i = 0; i < 10; i++) objects.New().Value = i;
+
+        const TrackedObject *objectBuffer = objects.GetBuffer();
+        EXPECT_FALSE(objects.Resize(INT_MAX / 2));
+        EXPECT_FALSE(objects.Append(objects.GetBuffer(), INT_MAX / 2));
+
+        EXPECT_EQ(LiveObjects, 10);
+        EXPECT_EQ(objects.GetBuffer(), objectBuffer);
+        ASSERT_EQ(objects.GetNumObjects(), 10);
+        for (int i = 0; i < 10; i++) EXPECT_EQ(objects[i].Value, i);
+    }
+
+    EXPECT_EQ(LiveObjects, 0);
+}
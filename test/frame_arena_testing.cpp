@@ -0,0 +1,201 @@
+#include <pch.h>
+
+#include "../include/yds_frame_arena.h"
+
+#include <stdint.h>
+#include <thread>
+
+TEST(FrameArena, Alignment) {
+    ysFrameArena arena;
+    arena.Initialize(1 * KB);
+
+    for (int i = 1; i < 64; i++) {
+        void *block = arena.AllocateBlock(i);
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % ysFrameArena::Alignment, 0);
+    }
+
+    arena.Destroy();
+}
+
+TEST(FrameArena, ResetReusesMemory) {
+    ysFrameArena arena;
+    arena.Initialize(1 * KB);
+
+    void *first = arena.AllocateBlock(64);
+    arena.AllocateBlock(64);
+    EXPECT_EQ(arena.GetUsage(), 128);
+
+    arena.Reset();
+    EXPECT_EQ(arena.GetUsage(), 0);
+    EXPECT_EQ(arena.GetLastFramePeak(), 128);
+    EXPECT_EQ(arena.AllocateBlock(64), first);
+
+    arena.Reset();
+    EXPECT_EQ(arena.GetLastFramePeak(), 64);
+    EXPECT_EQ(arena.GetPeakUsage(), 128);
+
+    arena.Destroy();
+}
+
+TEST(FrameArena, Overflow) {
+    ysFrameArena arena;
+    arena.Initialize(256);
+
+    int *blocks[16];
+    for (int i = 0; i < 16; i++) {
+        blocks[i] = arena.AllocateArray<int>(16);
+        for (int j = 0; j < 16; j++) blocks[i][j] = i;
+    }
+
+    // Earlier blocks must not be touched when the arena runs out of space
+    for (int i = 0; i < 16; i++) {
+        for (int j = 0; j < 16; j++) EXPECT_EQ(blocks[i][j], i);
+    }
+
+    EXPECT_EQ(arena.GetUsage(), 16 * 16 * (int)sizeof(int));
+
+    // A single oversized allocation
+    EXPECT_NE(arena.AllocateBlock(4 * KB), nullptr);
+
+    // After the reset the whole frame fits in one page
+    arena.Reset();
+    EXPECT_GE(arena.GetCapacity(), arena.GetLastFramePeak());
+
+    arena.Destroy();
+}
+
+TEST(FrameArena, DoubleBuffering) {
+    ysFrameArena arena;
+    arena.Initialize(1 * KB, true);
+    EXPECT_TRUE(arena.IsDoubleBuffered());
+
+    int *frame0 = arena.AllocateArray<int>(4);
+    frame0[0] = 10;
+
+    arena.Reset();
+
+    // Data from the previous frame is still valid
+    int *frame1 = arena.AllocateArray<int>(4);
+    frame1[0] = 11;
+    EXPECT_NE(frame0, frame1);
+    EXPECT_EQ(frame0[0], 10);
+
+    arena.Reset();
+
+    // Frame 0's memory is reclaimed
+    int *frame2 = arena.AllocateArray<int>(4);
+    EXPECT_EQ(frame2, frame0);
+    EXPECT_EQ(frame1[0], 11);
+
+    arena.Destroy();
+}
+
+TEST(FrameArena, Markers) {
+    ysFrameArena arena;
+    arena.Initialize(128);
+
+    arena.AllocateBlock(32);
+    void *next = nullptr;
+
+    {
+        ysFrameArena::Scope scope(&arena);
+        next = arena.AllocateBlock(32);
+
+        // Spill over into a second page
+        arena.AllocateBlock(256);
+    }
+
+    EXPECT_EQ(arena.GetUsage(), 32);
+    EXPECT_EQ(arena.AllocateBlock(32), next);
+    EXPECT_EQ(arena.GetLastFramePeak(), 0);
+
+    arena.Reset();
+    EXPECT_EQ(arena.GetLastFramePeak(), 32 + 32 + 256);
+
+    arena.Destroy();
+}
+
+TEST(FrameArena, ScopeTrimsSparePages) {
+    ysFrameArena arena;
+    arena.Initialize(128);
+    arena.SetRetainedSize(512);
+
+    {
+        ysFrameArena::Scope outer(&arena);
+        arena.AllocateBlock(1 * KB);
+
+        {
+            ysFrameArena::Scope inner(&arena);
+            arena.AllocateBlock(256);
+        }
+
+        // Inner scopes leave the pages in place
+        EXPECT_EQ(arena.GetCapacity(), 128 + 1 * KB + 256);
+    }
+
+    // The 1 KB page goes, the 256 byte page fits in the retained size
+    EXPECT_EQ(arena.GetCapacity(), 128 + 256);
+    EXPECT_EQ(arena.GetUsage(), 0);
+    EXPECT_NE(arena.AllocateBlock(256), nullptr);
+    EXPECT_EQ(arena.GetCapacity(), 128 + 256);
+
+    arena.Trim(0);
+    EXPECT_EQ(arena.GetCapacity(), 128 + 256);
+
+    arena.Reset();
+    arena.Trim(0);
+    EXPECT_GE(arena.GetCapacity(), 128 + 256);
+
+    arena.Destroy();
+}
+
+TEST(FrameArena, TypedAllocation) {
+    struct Item {
+        Item() : Value(5) { /* void */ }
+        int Value;
+    };
+
+    ysFrameArena arena;
+    Item *items = arena.Allocate<Item>(8);
+    ASSERT_NE(items, nullptr);
+
+    for (int i = 0; i < 8; i++) EXPECT_EQ(items[i].Value, 5);
+
+    // Individual frees are a no-op
+    arena.Free(items);
+    EXPECT_EQ(items, nullptr);
+    EXPECT_GE(arena.GetUsage(), 8 * (int)sizeof(Item));
+    EXPECT_EQ(arena.GetUsage() % ysFrameArena::Alignment, 0);
+
+    arena.Destroy();
+}
+
+TEST(FrameArena, ThreadArenas) {
+    ysFrameArena *mainArena = ysFrameArena::GetThreadArena();
+    ysFrameArena *otherArena = nullptr;
+
+    std::thread t([&otherArena]() { otherArena = ysFrameArena::GetThreadArena(); });
+    t.join();
+
+    EXPECT_EQ(mainArena, ysFrameArena::GetThreadArena());
+    EXPECT_NE(mainArena, otherArena);
+}
+
+TEST(FrameArena, HugePages) {
+    ysFrameArena arena;
+    arena.Initialize(ysFrameArena::HugePageThreshold);
+
+    char *block = reinterpret_cast<char *>(arena.AllocateBlock(ysFrameArena::HugePageThreshold));
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % ysFrameArena::Alignment, 0);
+    memset(block, 1, ysFrameArena::HugePageThreshold);
+
+    // Overflow pages larger than the threshold are mapped as well
+    block = reinterpret_cast<char *>(arena.AllocateBlock(2 * ysFrameArena::HugePageThreshold));
+    ASSERT_NE(block, nullptr);
+    memset(block, 1, 2 * ysFrameArena::HugePageThreshold);
+
+    arena.Reset();
+    arena.Destroy();
+}
@@ -2,6 +2,75 @@
 
 #include "../include/yds_interchange_file_0_0.h"
 
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Single object, a strip of quads with one UV channel. If
+    // badIndex is set the last face points past the end of the normals.
+    void WriteStrip(const char *fname, int quads, bool badIndex, bool truncate = false) {
+        typedef ysInterchangeFile0_0 File;
+
+        std::fstream file(fname, std::ios::out | std::ios::binary);
+
+        File::IdHeader idHeader = { File::MAGIC_NUMBER, File::MAJOR_VERSION, File::MINOR_VERSION, 0, 0 };
+        File::SceneHeader sceneHeader = { 1 };
+        file.write((const char *)&idHeader, sizeof(idHeader));
+        file.write((const char *)&sceneHeader, sizeof(sceneHeader));
+
+        File::ObjectInformation info;
+        memset(&info, 0, sizeof(info));
+        strcpy_s(info.Name, 256, "Strip");
+        strcpy_s(info.MaterialName, 256, "Material");
+        file.write((const char *)&info, sizeof(info));
+
+        File::ObjectTransformation t;
+        file.write((const char *)&t, sizeof(t));
+
+        const unsigned int vertexCount = 2 * (quads + 1);
+        const unsigned int faceCount = 2 * quads;
+        File::GeometryInformation geometryInfo = { 1, vertexCount, 1, 1, faceCount };
+        file.write((const char *)&geometryInfo, sizeof(geometryInfo));
+
+        for (unsigned int i = 0; i < vertexCount; ++i) {
+            ysVector3 v((float)(i / 2), (float)(i % 2), 0.0f);
+            file.write((const char *)&v, sizeof(v));
+        }
+
+        File::UVChannel channel = { vertexCount };
+        file.write((const char *)&channel, sizeof(channel));
+        for (unsigned int i = 0; i < vertexCount; ++i) {
+            ysVector2 uv((float)(i / 2), (float)(i % 2));
+            file.write((const char *)&uv, sizeof(uv));
+        }
+
+        ysVector3 normal(0.0f, 0.0f, 1.0f), tangent(1.0f, 0.0f, 0.0f);
+        file.write((const char *)&normal, sizeof(normal));
+        file.write((const char *)&tangent, sizeof(tangent));
+
+        if (truncate) return;
+
+        for (unsigned int i = 0; i < faceCount; ++i) {
+            const int base = (int)(i / 2) * 2;
+            File::IndexSet vi = (i % 2 == 0)
+                ? File::IndexSet{ base, base + 2, base + 3 }
+                : File::IndexSet{ base, base + 3, base + 1 };
+            File::IndexSet ni = { 0, 0, (badIndex && i == faceCount - 1) ? 1 : 0 };
+            File::IndexSet ti = { 0, 0, 0 };
+
+            file.write((const char *)&vi, sizeof(vi));
+            file.write((const char *)&ni, sizeof(ni));
+            file.write((const char *)&ti, sizeof(ti));
+            file.write((const char *)&vi, sizeof(vi));
+        }
+    }
+
+} /* namespace */
+
 TEST(GeometryFile, SanityCheck) {
     ysInterchangeFile0_0 f;
 }
@@ -172,3 +241,153 @@ TEST(GeometryFile, ConnectedUVsRip) {
 
     f.Close();
 }
+
+TEST(GeometryFile, BulkRead) {
+    const char *fname = "test_strip.dia";
+    WriteStrip(fname, 5000, false);
+
+    ysInterchangeFile0_0 f;
+    ASSERT_EQ(f.Open(fname), ysError::YDS_NO_ERROR);
+
+    ysInterchangeObject obj;
+    EXPECT_EQ(f.ReadObject(&obj), ysError::YDS_NO_ERROR);
+    f.Close();
+
+    EXPECT_EQ(obj.Name, "Strip");
+    EXPECT_EQ(obj.Vertices.size(), 10002);
+    EXPECT_EQ(obj.VertexIndices.size(), 10000);
+    EXPECT_EQ(obj.UVIndices.size(), 1);
+    EXPECT_EQ(obj.UVIndices[0].size(), 10000);
+    EXPECT_EQ(obj.Tangents.size(), 1);
+
+    EXPECT_EQ(obj.Vertices[10001].x, 5000.0f);
+    EXPECT_EQ(obj.VertexIndices[9999].y, 10001);
+    EXPECT_EQ(obj.UVIndices[0][9999].y, 10001);
+    EXPECT_EQ(obj.UVChannels[0].Coordinates[10001].y, 1.0f);
+    EXPECT_TRUE(obj.Validate());
+
+    remove(fname);
+}
+
+TEST(GeometryFile, CorruptedObject) {
+    const char *fname = "test_corrupted_strip.dia";
+
+    WriteStrip(fname, 10, true);
+
+    ysInterchangeFile0_0 f;
+    ASSERT_EQ(f.Open(fname), ysError::YDS_NO_ERROR);
+
+    ysInterchangeObject obj;
+    EXPECT_EQ(f.ReadObject(&obj), ysError::YDS_CORRUPTED_FILE);
+    f.Close();
+
+    // Face data is missing entirely
+    WriteStrip(fname, 10, false, true);
+    ASSERT_EQ(f.Open(fname), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(f.ReadObject(&obj), ysError::YDS_CORRUPTED_FILE);
+    f.Close();
+
+    remove(fname);
+}
+
+TEST(GeometryFile, RipByAllAttributes) {
+    const char *files[] = { "cube.dia", "flat_cube.dia", "cube_connected_uvs.dia" };
+
+    for (const char *name : files) {
+        std::string path = std::string("../../../test/geometry_files/") + name;
+
+        ysInterchangeFile0_0 f;
+        ASSERT_EQ(f.Open(path.c_str()), ysError::YDS_NO_ERROR);
+
+        ysInterchangeObject separate;
+        ASSERT_EQ(f.ReadObject(&separate), ysError::YDS_NO_ERROR);
+        f.Close();
+
+        ysInterchangeObject combined = separate;
+
+        separate.RipByTangents();
+        separate.RipByNormals();
+        separate.RipByUVs();
+        combined.RipByAllAttributes();
+
+        EXPECT_EQ(combined.Vertices.size(), separate.Vertices.size());
+        EXPECT_TRUE(combined.Validate());
+
+        // Every vertex has exactly one set of attributes
+        std::vector<int> normal(combined.Vertices.size(), -1), uv(combined.Vertices.size(), -1);
+        for (size_t i = 0; i < combined.VertexIndices.size(); ++i) {
+            for (int j = 0; j < 3; ++j) {
+                const int v = combined.VertexIndices[i].indices[j];
+                if (normal[v] == -1) normal[v] = combined.NormalIndices[i].indices[j];
+                if (uv[v] == -1) uv[v] = combined.UVIndices[0][i].indices[j];
+
+                EXPECT_EQ(normal[v], combined.NormalIndices[i].indices[j]);
+                EXPECT_EQ(uv[v], combined.UVIndices[0][i].indices[j]);
+
+                const ysVector3 &a = combined.Vertices[v];
+                const ysVector3 &b = separate.Vertices[separate.VertexIndices[i].indices[j]];
+                EXPECT_EQ(a.x, b.x);
+                EXPECT_EQ(a.y, b.y);
+                EXPECT_EQ(a.z, b.z);
+            }
+        }
+    }
+}
+
+TEST(GeometryFile, DISABLED_RipBenchmark) {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // Grid with a UV seam every other column, hard edges every fourth
+    // column and a second UV channel with a seam every eighth row
+    const int size = 400;
+    ysInterchangeObject grid;
+    grid.ModelIndex = 0;
+    grid.UVChannels.resize(2);
+    grid.UVIndices.resize(2);
+
+    for (int y = 0; y <= size; ++y) {
+        for (int x = 0; x <= size; ++x) {
+            grid.Vertices.push_back(ysVector3((float)x, (float)y, 0.0f));
+            for (int k = 0; k < 4; ++k) grid.UVChannels[k / 2].Coordinates.push_back(ysVector2((float)x, (float)y));
+        }
+    }
+
+    for (int i = 0; i < size / 4 + 1; ++i) grid.Normals.push_back(ysVector3(0.0f, 0.0f, 1.0f));
+    grid.Tangents.push_back(ysVector3(1.0f, 0.0f, 0.0f));
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const int v0 = y * (size + 1) + x, v1 = v0 + 1, v2 = v0 + size + 1, v3 = v2 + 1;
+            const int n = x / 4, seam = x % 2, chart = (y / 8) % 2;
+
+            grid.VertexIndices.push_back({ v0, v1, v3 });
+            grid.VertexIndices.push_back({ v0, v3, v2 });
+            grid.NormalIndices.push_back({ n, n, n });
+            grid.NormalIndices.push_back({ n, n, n });
+            grid.TangentIndices.push_back({ 0, 0, 0 });
+            grid.TangentIndices.push_back({ 0, 0, 0 });
+            grid.UVIndices[0].push_back({ 2 * v0 + seam, 2 * v1 + seam, 2 * v3 + seam });
+            grid.UVIndices[0].push_back({ 2 * v0 + seam, 2 * v3 + seam, 2 * v2 + seam });
+            grid.UVIndices[1].push_back({ 2 * v0 + chart, 2 * v1 + chart, 2 * v3 + chart });
+            grid.UVIndices[1].push_back({ 2 * v0 + chart, 2 * v3 + chart, 2 * v2 + chart });
+        }
+    }
+
+    auto measure = [&](const char *name, auto rip) {
+        ysInterchangeObject object = grid;
+
+        auto start = Clock::now();
+        rip(object);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        printf("%-20s %8.2f ms, %d vertices\n", name, ms, (int)object.Vertices.size());
+    };
+
+    measure("Separate", [](ysInterchangeObject &object) {
+        object.RipByTangents();
+        object.RipByNormals();
+        object.RipByUVs();
+    });
+
+    measure("Combined", [](ysInterchangeObject &object) { object.RipByAllAttributes(); });
+}
@@ -0,0 +1,211 @@
+#include <pch.h>
+
+#include "../include/yds_geometry_preprocessing.h"
+#include "../include/yds_allocator.h"
+
+namespace {
+
+    // Flat grid of size x size quads, each split into two triangles. If fold
+    // is set the second half of the grid is bent upwards.
+    void CreateGrid(ysObjectData *object, int size, bool fold = false) {
+        object->Clear();
+
+        for (int y = 0; y <= size; y++) {
+            for (int x = 0; x <= size; x++) {
+                const float z = (fold && x > size / 2) ? (float)(x - size / 2) : 0.0f;
+                object->m_vertices.New() = ysVector3((float)x, (float)y, z);
+            }
+        }
+
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                const int v0 = y * (size + 1) + x;
+                const int v1 = v0 + 1;
+                const int v2 = v0 + size + 1;
+                const int v3 = v2 + 1;
+
+                ysObjectData::IndexSet &a = object->m_vertexIndexSet.New();
+                a.x = v0; a.y = v1; a.z = v3;
+
+                ysObjectData::IndexSet &b = object->m_vertexIndexSet.New();
+                b.x = v0; b.y = v3; b.z = v2;
+
+                object->m_smoothingGroups.New() = 0;
+                object->m_smoothingGroups.New() = 0;
+            }
+        }
+
+        object->m_objectStatistics.NumVertices = object->m_vertices.GetNumObjects();
+        object->m_objectStatistics.NumFaces = object->m_vertexIndexSet.GetNumObjects();
+    }
+
+    void ReleaseCache(ysObjectData *object) {
+        ysAllocator::BlockFree(object->m_hardNormalCache, 16);
+        object->m_hardNormalCache = nullptr;
+    }
+
+} /* namespace */
+
+TEST(GeometryPreprocessing, ResolveSmoothingGroupAmbiguity) {
+    ysObjectData object;
+    CreateGrid(&object, 8);
+    object.m_smoothingGroups[0] = 0x1;
+
+    ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(&object);
+
+    const int nFaces = object.m_objectStatistics.NumFaces;
+    for (int f1 = 0; f1 < nFaces; f1++) {
+        EXPECT_NE(object.m_smoothingGroups[f1], 0);
+
+        for (int f2 = f1 + 1; f2 < nFaces; f2++) {
+            if (!ysGeometryPreprocessing::ConnectedFaces(&object, f1, f2)) continue;
+            EXPECT_EQ(object.m_smoothingGroups[f1] & object.m_smoothingGroups[f2], 0);
+        }
+    }
+}
+
+TEST(GeometryPreprocessing, AutomaticSmoothingGroups) {
+    ysObjectData object;
+    CreateGrid(&object, 4);
+    ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(&object);
+
+    EXPECT_EQ(object.m_numExtendedSmoothingGroups, object.m_objectStatistics.NumFaces);
+    EXPECT_FALSE(ysGeometryPreprocessing::SameSmoothingGroup(&object, 0, 1));
+
+    // Faces in the same smoothing group share their vertices
+    for (int i = 0; i < object.m_objectStatistics.NumFaces; i++) object.m_smoothingGroups[i] = 0x1;
+    ysGeometryPreprocessing::SeparateBySmoothingGroups(&object);
+    EXPECT_EQ(object.m_objectStatistics.NumVertices, 25);
+
+    // Hard edges everywhere, every face corner gets its own vertex
+    for (int i = 0; i < object.m_objectStatistics.NumFaces; i++) object.m_smoothingGroups[i] = 0;
+    ysGeometryPreprocessing::SeparateBySmoothingGroups(&object);
+    EXPECT_EQ(object.m_objectStatistics.NumVertices, object.m_objectStatistics.NumFaces * 3);
+}
+
+TEST(GeometryPreprocessing, SpreadSmoothingGroup) {
+    ysObjectData object;
+
+    // Large enough to overflow the stack with a recursive fill
+    CreateGrid(&object, 200);
+    ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(&object);
+
+    int count = 0;
+    ysVector *normals = ysGeometryPreprocessing::CalculateHardNormals(&object);
+    ysGeometryPreprocessing::SpreadSmoothingGroup(&object, 0, 0, normals, &count);
+    EXPECT_EQ(count, object.m_objectStatistics.NumFaces);
+    EXPECT_TRUE(ysGeometryPreprocessing::SameSmoothingGroup(&object, 0, object.m_objectStatistics.NumFaces - 1));
+    ReleaseCache(&object);
+
+    // The fill stops at the fold
+    CreateGrid(&object, 8, true);
+    ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(&object);
+
+    count = 0;
+    normals = ysGeometryPreprocessing::CalculateHardNormals(&object);
+    ysGeometryPreprocessing::SpreadSmoothingGroup(&object, 0, 0, normals, &count);
+    EXPECT_EQ(count, object.m_objectStatistics.NumFaces / 2);
+    EXPECT_FALSE(ysGeometryPreprocessing::SameSmoothingGroup(&object, 0, 15));
+    ReleaseCache(&object);
+}
+
+TEST(GeometryPreprocessing, VertexCacheOptimization) {
+    ysObjectData object;
+    CreateGrid(&object, 40);
+
+    // Shuffle the faces and tag each one with its original index
+    const int nFaces = object.m_objectStatistics.NumFaces;
+    unsigned int seed = 12345;
+    for (int i = nFaces - 1; i > 0; i--) {
+        seed = seed * 1664525u + 1013904223u;
+        const int j = (int)(seed % (unsigned int)(i + 1));
+
+        ysObjectData::IndexSet temp = object.m_vertexIndexSet[i];
+        object.m_vertexIndexSet[i] = object.m_vertexIndexSet[j];
+        object.m_vertexIndexSet[j] = temp;
+    }
+
+    ysExpandingArray<ysObjectData::IndexSet> original;
+    for (int i = 0; i < nFaces; i++) {
+        object.m_smoothingGroups[i] = i;
+        original.New() = object.m_vertexIndexSet[i];
+    }
+
+    ysExpandingArray<ysVector3> originalVertices;
+    for (int i = 0; i < object.m_objectStatistics.NumVertices; i++) originalVertices.New() = object.m_vertices[i];
+
+    const ysGeometryPreprocessing::VertexCacheStatistics before = ysGeometryPreprocessing::AnalyzeVertexCache(&object);
+
+    ysGeometryPreprocessing::OptimizeVertexCache(&object);
+    const ysGeometryPreprocessing::VertexCacheStatistics optimized = ysGeometryPreprocessing::AnalyzeVertexCache(&object);
+
+    ysGeometryPreprocessing::OptimizeOverdraw(&object);
+    ysGeometryPreprocessing::OptimizeVertexFetch(&object);
+    const ysGeometryPreprocessing::VertexCacheStatistics after = ysGeometryPreprocessing::AnalyzeVertexCache(&object);
+
+    EXPECT_GT(before.GetACMR(), 2.0f);
+    EXPECT_LT(optimized.GetACMR(), 0.8f);
+    EXPECT_LT(after.GetACMR(), optimized.GetACMR() * 1.05f);
+    EXPECT_LT(after.GetATVR(), 1.6f);
+
+    // Same faces in a different order, vertices numbered by first use
+    int nextVertex = 0;
+    for (int i = 0; i < nFaces; i++) {
+        const ysObjectData::IndexSet &face = original[object.m_smoothingGroups[i]];
+
+        for (int facevert = 0; facevert < 3; facevert++) {
+            const int vert = object.m_vertexIndexSet[i].indices[facevert];
+            EXPECT_LE(vert, nextVertex);
+            if (vert == nextVertex) nextVertex++;
+
+            const ysVector3 &a = object.m_vertices[vert];
+            const ysVector3 &b = originalVertices[face.indices[facevert]];
+            EXPECT_EQ(a.x, b.x);
+            EXPECT_EQ(a.y, b.y);
+            EXPECT_EQ(a.z, b.z);
+        }
+    }
+
+    EXPECT_EQ(nextVertex, object.m_objectStatistics.NumVertices);
+}
+
+TEST(GeometryPreprocessing, BuildMeshlets) {
+    ysObjectData object;
+    CreateGrid(&object, 40);
+    ysGeometryPreprocessing::OptimizeVertexCache(&object);
+
+    ysGeometryPreprocessing::BuildMeshlets(&object, 64, 124);
+
+    const int meshletCount = object.m_meshlets.GetNumObjects();
+    ASSERT_GT(meshletCount, 0);
+
+    // Meshlets cover every face in order and stay within both limits
+    int nextFace = 0;
+    for (int i = 0; i < meshletCount; i++) {
+        const ysObjectData::Meshlet &meshlet = object.m_meshlets[i];
+        EXPECT_EQ(meshlet.FirstFace, nextFace);
+        EXPECT_GT(meshlet.FaceCount, 0);
+        EXPECT_LE(meshlet.FaceCount, 124);
+        EXPECT_LE(meshlet.VertexCount, 64);
+        nextFace += meshlet.FaceCount;
+
+        for (int face = meshlet.FirstFace; face < meshlet.FirstFace + meshlet.FaceCount; face++) {
+            for (int facevert = 0; facevert < 3; facevert++) {
+                const ysVector3 &p = object.m_vertices[object.m_vertexIndexSet[face].indices[facevert]];
+                EXPECT_GE(p.x, meshlet.MinExtreme.x);
+                EXPECT_GE(p.y, meshlet.MinExtreme.y);
+                EXPECT_LE(p.x, meshlet.MaxExtreme.x);
+                EXPECT_LE(p.y, meshlet.MaxExtreme.y);
+            }
+        }
+    }
+
+    EXPECT_EQ(nextFace, object.m_objectStatistics.NumFaces);
+
+    // A cache friendly order packs the meshlets densely
+    EXPECT_LT(meshletCount, object.m_objectStatistics.NumFaces / 60);
+
+    // Reordering the faces makes the meshlets stale
+    ysGeometryPreprocessing::OptimizeVertexCache(&object);
+    EXPECT_EQ(object.m_meshlets.GetNumObjects(), 0);
+}
@@ -0,0 +1,111 @@
+#include <pch.h>
+
+#include "../include/yds_handle_array.h"
+#include "../include/yds_null_device.h"
+
+#include <vector>
+
+TEST(HandleArray, AddGetRemove) {
+    int objects[3] = { 0, 1, 2 };
+
+    ysHandleArray<int> array;
+    ysHandle a = array.Add(&objects[0]);
+    ysHandle b = array.Add(&objects[1]);
+    ysHandle c = array.Add(&objects[2]);
+
+    EXPECT_EQ(array.GetNumObjects(), 3);
+    EXPECT_EQ(array.Get(a), &objects[0]);
+    EXPECT_EQ(array.Get(b), &objects[1]);
+    EXPECT_EQ(array.Get(c), &objects[2]);
+
+    EXPECT_EQ(array.Remove(a), &objects[0]);
+    EXPECT_EQ(array.GetNumObjects(), 2);
+
+    // Other handles survive the swap-remove
+    EXPECT_EQ(array.Get(b), &objects[1]);
+    EXPECT_EQ(array.Get(c), &objects[2]);
+    EXPECT_EQ(array.GetHandle(array.GetDenseIndex(c)), c);
+
+    EXPECT_FALSE(array.IsValid(ysHandle::Null()));
+    EXPECT_EQ(array.Get(ysHandle::Null()), nullptr);
+}
+
+TEST(HandleArray, StaleHandles) {
+    int x = 0, y = 1;
+
+    ysHandleArray<int> array;
+    ysHandle first = array.Add(&x);
+    array.Remove(first);
+
+    // The slot is reused with a new generation
+    ysHandle second = array.Add(&y);
+    EXPECT_EQ(second.Index, first.Index);
+    EXPECT_NE(second.Generation, first.Generation);
+
+    EXPECT_FALSE(array.IsValid(first));
+    EXPECT_EQ(array.Get(first), nullptr);
+    EXPECT_EQ(array.Remove(first), nullptr);
+    EXPECT_EQ(array.Get(second), &y);
+
+    array.Clear();
+    EXPECT_EQ(array.GetNumObjects(), 0);
+    EXPECT_FALSE(array.IsValid(second));
+}
+
+TEST(HandleArray, MassRemovalKeepsStorage) {
+    const int Count = 1000;
+    std::vector<int> objects(Count);
+    std::vector<ysHandle> handles(Count);
+
+    ysHandleArray<int> array;
+    array.Reserve(Count);
+    for (int i = 0; i < Count; i++) {
+        objects[i] = i;
+        handles[i] = array.Add(&objects[i]);
+    }
+
+    int **buffer = array.GetBuffer();
+    for (int i = 0; i < Count; i += 2) array.Remove(handles[i]);
+
+    EXPECT_EQ(array.GetBuffer(), buffer);
+    EXPECT_EQ(array.GetNumObjects(), Count / 2);
+
+    for (int i = 0; i < Count; i++) {
+        if (i % 2 == 0) EXPECT_EQ(array.Get(handles[i]), nullptr);
+        else EXPECT_EQ(*array.Get(handles[i]), i);
+    }
+
+    // Dense storage only contains live objects
+    for (int i = 0; i < array.GetNumObjects(); i++) {
+        EXPECT_EQ(*array.Get(i) % 2, 1);
+    }
+
+    for (int i = 1; i < Count; i += 2) array.Remove(handles[i]);
+    EXPECT_EQ(array.GetNumObjects(), 0);
+    EXPECT_EQ(array.GetBuffer(), buffer);
+}
+
+TEST(HandleArray, DeviceObjects) {
+    ysNullDevice device, otherDevice;
+
+    ysGPUBuffer *a, *b, *other;
+    ASSERT_EQ(device.CreateVertexBuffer(&a, 16, nullptr, true), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(device.CreateVertexBuffer(&b, 16, nullptr, true), ysError::YDS_NO_ERROR);
+    ASSERT_EQ(otherDevice.CreateVertexBuffer(&other, 16, nullptr, true), ysError::YDS_NO_ERROR);
+
+    // Both devices hand out the same first handle, only the pointer tells them apart
+    EXPECT_EQ(a->GetHandle(), other->GetHandle());
+
+    ysGPUBuffer *foreign = other;
+    EXPECT_EQ(device.DestroyGPUBuffer(foreign), ysError::YDS_INVALID_PARAMETER);
+    EXPECT_EQ(foreign, other);
+    EXPECT_NE(other->GetRAMMirror(), nullptr);
+
+    EXPECT_EQ(device.DestroyGPUBuffer(a), ysError::YDS_NO_ERROR);
+    EXPECT_EQ(a, nullptr);
+    EXPECT_EQ(otherDevice.DestroyGPUBuffer(other), ysError::YDS_NO_ERROR);
+
+    // Removing a doesn't disturb b
+    EXPECT_EQ(b->GetSize(), 16);
+    EXPECT_EQ(device.DestroyGPUBuffer(b), ysError::YDS_NO_ERROR);
+}
@@ -0,0 +1,39 @@
+#include <pch.h>
+
+#include "../include/yds_hash.h"
+
+#include <string.h>
+
+TEST(Hash, ReferenceValues) {
+    // From the reference implementation
+    EXPECT_EQ(ysHash::XXH64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(ysHash::XXH64("a", 1), 0xD24EC4F1A98C6E5BULL);
+    EXPECT_EQ(ysHash::XXH64("abc", 3), 0x44BC2CF5AD770999ULL);
+
+    // Long enough for the four lane loop
+    const char *text = "Nobody inspects the spammish repetition";
+    EXPECT_EQ(ysHash::XXH64(text, strlen(text)), 0xFBCEA83C8A378BF1ULL);
+
+    EXPECT_NE(ysHash::XXH64(text, strlen(text), 1), ysHash::XXH64(text, strlen(text)));
+}
+
+TEST(Hash, Incremental) {
+    unsigned char data[1000];
+    for (int i = 0; i < 1000; i++) data[i] = (unsigned char)(i * 7 + 3);
+
+    const uint64_t expected = ysHash::XXH64(data, sizeof(data), 42);
+
+    // Pieces that do and don't line up with the 32 byte stripes
+    for (int pieceSize = 1; pieceSize < 80; pieceSize += 3) {
+        ysHash::XXH64State state(42);
+        for (int offset = 0; offset < 1000; offset += pieceSize) {
+            const int size = (offset + pieceSize > 1000) ? 1000 - offset : pieceSize;
+            state.Update(data + offset, size);
+        }
+
+        EXPECT_EQ(state.Digest(), expected);
+    }
+
+    ysHash::XXH64State state;
+    EXPECT_EQ(state.Digest(), ysHash::XXH64("", 0));
+}
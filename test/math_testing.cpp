@@ -0,0 +1,462 @@
+#include <pch.h>
+
+#include "../include/yds_math.h"
+#include "../include/yds_math_kernels.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+namespace {
+
+    const int BatchSize = 37;
+    const float Epsilon = 1E-4f;
+
+    float Random() {
+        return (rand() % 2000 - 1000) / 500.0f;
+    }
+
+    ysVector RandomVector() {
+        return ysMath::LoadVector(Random(), Random(), Random(), Random());
+    }
+
+    void ExpectNear(const ysVector *a, const ysVector *b, int n) {
+        for (int i = 0; i < n; i++) {
+            ysVector4 u = ysMath::GetVector4(a[i]);
+            ysVector4 v = ysMath::GetVector4(b[i]);
+
+            for (int j = 0; j < 4; j++) {
+                EXPECT_NEAR(u.vec[j], v.vec[j], Epsilon);
+            }
+        }
+    }
+
+    struct BatchData {
+        BatchData() {
+            for (int i = 0; i < BatchSize; i++) {
+                v1[i] = RandomVector();
+                v2[i] = RandomVector();
+                q[i] = ysMath::Normalize(RandomVector());
+
+                for (int j = 0; j < 4; j++) {
+                    m1[i].rows[j] = RandomVector();
+                    m2[i].rows[j] = RandomVector();
+                }
+            }
+        }
+
+        ysVector v1[BatchSize];
+        ysVector v2[BatchSize];
+        ysQuaternion q[BatchSize];
+        ysMatrix m1[BatchSize];
+        ysMatrix m2[BatchSize];
+    };
+
+} /* namespace */
+
+TEST(MathTests, ComponentAccess) {
+    const ysVector v = ysMath::LoadVector(1.0f, 2.0f, 3.0f, 4.0f);
+
+    EXPECT_EQ(ysMath::GetX(v), 1.0f);
+    EXPECT_EQ(ysMath::GetY(v), 2.0f);
+    EXPECT_EQ(ysMath::GetZ(v), 3.0f);
+    EXPECT_EQ(ysMath::GetW(v), 4.0f);
+    EXPECT_EQ(ysMath::GetScalar(v), 1.0f);
+
+    EXPECT_EQ(ysMath::GetQuatW(v), 1.0f);
+    EXPECT_EQ(ysMath::GetQuatX(v), 2.0f);
+    EXPECT_EQ(ysMath::GetQuatY(v), 3.0f);
+    EXPECT_EQ(ysMath::GetQuatZ(v), 4.0f);
+
+    const ysVector4 v4 = ysMath::GetVector4(v);
+    EXPECT_EQ(v4.x, 1.0f);
+    EXPECT_EQ(v4.w, 4.0f);
+
+    const ysVector3 v3 = ysMath::GetVector3(v);
+    EXPECT_EQ(v3.z, 3.0f);
+
+    EXPECT_EQ(ysMath::GetX(ysMath::Constants::One), 1.0f);
+    EXPECT_EQ(ysMath::GetW(ysMath::Constants::MaskOffW), 0.0f);
+}
+
+TEST(MathTests, KernelVariantsMatchReference) {
+    BatchData data;
+    ysVector expected[BatchSize], actual[BatchSize];
+    ysMatrix expectedM[BatchSize], actualM[BatchSize];
+
+    const ysMath::Kernels::Table *ref = ysMath::Kernels::GetTable(ysMath::InstructionSet::SSE2);
+    const int supported = (int)ysMath::GetSupportedInstructionSet();
+
+    for (int s = 0; s <= supported; s++) {
+        const ysMath::Kernels::Table *k = ysMath::Kernels::GetTable((ysMath::InstructionSet)s);
+
+        ref->Dot(data.v1, data.v2, expected, BatchSize);
+        k->Dot(data.v1, data.v2, actual, BatchSize);
+        ExpectNear(expected, actual, BatchSize);
+
+        ref->Cross(data.v1, data.v2, expected, BatchSize);
+        k->Cross(data.v1, data.v2, actual, BatchSize);
+        ExpectNear(expected, actual, BatchSize);
+
+        ref->Normalize(data.v1, expected, BatchSize);
+        k->Normalize(data.v1, actual, BatchSize);
+        ExpectNear(expected, actual, BatchSize);
+
+        ref->Transform(data.m1[0], data.v1, expected, BatchSize);
+        k->Transform(data.m1[0], data.v1, actual, BatchSize);
+        ExpectNear(expected, actual, BatchSize);
+
+        ref->QuatMultiply(data.q, data.v2, expected, BatchSize);
+        k->QuatMultiply(data.q, data.v2, actual, BatchSize);
+        ExpectNear(expected, actual, BatchSize);
+
+        ref->MatMult(data.m1, data.m2, expectedM, BatchSize);
+        k->MatMult(data.m1, data.m2, actualM, BatchSize);
+        ExpectNear(expectedM[0].rows, actualM[0].rows, BatchSize * 4);
+
+        ref->LoadMatrix(data.q, expectedM, BatchSize);
+        k->LoadMatrix(data.q, actualM, BatchSize);
+        ExpectNear(expectedM[0].rows, actualM[0].rows, BatchSize * 4);
+
+        ref->QuatNlerp(data.q, data.v2, 0.3f, expected, BatchSize);
+        k->QuatNlerp(data.q, data.v2, 0.3f, actual, BatchSize);
+        ExpectNear(expected, actual, BatchSize);
+    }
+}
+
+TEST(MathTests, BatchMatchesSingle) {
+    BatchData data;
+    ysVector batch[BatchSize], single[BatchSize];
+    ysMatrix batchM[BatchSize], singleM[BatchSize];
+
+    ysMath::DotBatch(data.v1, data.v2, batch, BatchSize);
+    for (int i = 0; i < BatchSize; i++) single[i] = ysMath::Dot(data.v1[i], data.v2[i]);
+    ExpectNear(batch, single, BatchSize);
+
+    ysMath::MatMultBatch(data.m1[0], data.v1, batch, BatchSize);
+    for (int i = 0; i < BatchSize; i++) single[i] = ysMath::MatMult(data.m1[0], data.v1[i]);
+    ExpectNear(batch, single, BatchSize);
+
+    ysMath::LoadMatrixBatch(data.q, batchM, BatchSize);
+    for (int i = 0; i < BatchSize; i++) singleM[i] = ysMath::LoadMatrix(data.q[i]);
+    ExpectNear(batchM[0].rows, singleM[0].rows, BatchSize * 4);
+
+    ysMath::QuatNlerpBatch(data.q, data.v1, 0.75f, batch, BatchSize);
+    for (int i = 0; i < BatchSize; i++) single[i] = ysMath::QuatNlerp(data.q[i], data.v1[i], 0.75f);
+    ExpectNear(batch, single, BatchSize);
+
+    // In-place operation
+    for (int i = 0; i < BatchSize; i++) batchM[i] = data.m1[i];
+    ysMath::MatMultBatch(batchM, data.m2, batchM, BatchSize);
+    for (int i = 0; i < BatchSize; i++) singleM[i] = ysMath::MatMult(data.m1[i], data.m2[i]);
+    ExpectNear(batchM[0].rows, singleM[0].rows, BatchSize * 4);
+}
+
+TEST(MathTests, FastReciprocals) {
+    for (int i = 0; i < 1000; i++) {
+        const float x = 1E-3f + (rand() % 100000) / 10.0f;
+        const ysVector v = ysMath::LoadScalar(x);
+
+        EXPECT_NEAR(ysMath::GetX(ysMath::ReciprocalFast(v)) * x, 1.0f, 1E-6f);
+        EXPECT_NEAR(ysMath::GetX(ysMath::ReciprocalSqrtFast(v)) * sqrtf(x), 1.0f, 1E-6f);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        const ysVector v = RandomVector();
+        const ysVector n = ysMath::NormalizeFast(v);
+        const ysVector reference = ysMath::Normalize(v);
+
+        EXPECT_NEAR(ysMath::GetX(ysMath::Magnitude(n)), 1.0f, 1E-6f);
+        ExpectNear(&n, &reference, 1);
+    }
+}
+
+TEST(MathTests, TranscendentalAccuracy) {
+    float maxSin = 0, maxCos = 0, maxExp = 0, maxLog = 0, maxPow = 0;
+
+    for (int i = 0; i < 4000; i++) {
+        const float a = (i - 2000) * 0.01f;
+        const float e = (i - 2000) * 0.04f;
+        const float l = expf((i - 2000) * 0.04f);
+
+        ysVector s, c;
+        ysMath::SinCos(ysMath::LoadScalar(a), &s, &c);
+
+        maxSin = fmaxf(maxSin, fabsf(ysMath::GetX(s) - (float)sin((double)a)));
+        maxCos = fmaxf(maxCos, fabsf(ysMath::GetX(c) - (float)cos((double)a)));
+        maxExp = fmaxf(maxExp, fabsf(ysMath::GetX(ysMath::Exp(ysMath::LoadScalar(e))) / (float)exp((double)e) - 1.0f));
+        maxLog = fmaxf(maxLog, fabsf(ysMath::GetX(ysMath::Log(ysMath::LoadScalar(l))) - (float)log((double)l)));
+
+        const float b = 0.1f + i / 1000.0f;
+        const float p = (float)pow((double)b, (double)a);
+        maxPow = fmaxf(maxPow, fabsf(ysMath::GetX(ysMath::Pow(ysMath::LoadScalar(b), ysMath::LoadScalar(a))) / p - 1.0f));
+    }
+
+    EXPECT_LT(maxSin, 1E-6f);
+    EXPECT_LT(maxCos, 1E-6f);
+    EXPECT_LT(maxExp, 1E-6f);
+    EXPECT_LT(maxLog, 1E-6f);
+    EXPECT_LT(maxPow, 1E-5f);
+
+    // Special values
+    EXPECT_EQ(ysMath::GetX(ysMath::Exp(ysMath::LoadScalar(-100.0f))), 0.0f);
+    EXPECT_EQ(ysMath::GetX(ysMath::Exp(ysMath::LoadScalar(100.0f))), INFINITY);
+    EXPECT_EQ(ysMath::GetX(ysMath::Log(ysMath::LoadScalar(0.0f))), -INFINITY);
+    EXPECT_TRUE(isnan(ysMath::GetX(ysMath::Log(ysMath::LoadScalar(-1.0f)))));
+    EXPECT_EQ(ysMath::GetX(ysMath::Pow(ysMath::LoadScalar(0.0f), ysMath::LoadScalar(2.0f))), 0.0f);
+
+    // Zero damping over a zero time step, pow() gives 1 rather than 0 * -inf
+    const ysVector zeroPow = ysMath::Pow(ysMath::LoadVector(0.0f, 0.0f, 2.0f, 0.0f), ysMath::LoadVector(0.0f, 0.5f, 0.0f, 1E-3f));
+    EXPECT_EQ(ysMath::GetX(zeroPow), 1.0f);
+    EXPECT_EQ(ysMath::GetY(zeroPow), 0.0f);
+    EXPECT_EQ(ysMath::GetZ(zeroPow), 1.0f);
+    EXPECT_EQ(ysMath::GetW(zeroPow), 0.0f);
+}
+
+TEST(MathTests, TranscendentalKernelsMatchReference) {
+    float v[BatchSize], b[BatchSize];
+    float s[BatchSize], c[BatchSize], r[BatchSize];
+
+    for (int i = 0; i < BatchSize; i++) {
+        v[i] = Random() * 4;
+        b[i] = (rand() % 1000 + 1) / 100.0f;
+    }
+
+    const int supported = (int)ysMath::GetSupportedInstructionSet();
+    for (int set = 0; set <= supported; set++) {
+        const ysMath::Kernels::Table *k = ysMath::Kernels::GetTable((ysMath::InstructionSet)set);
+
+        k->SinCos(v, s, c, BatchSize);
+        for (int i = 0; i < BatchSize; i++) {
+            EXPECT_NEAR(s[i], sinf(v[i]), 1E-6f);
+            EXPECT_NEAR(c[i], cosf(v[i]), 1E-6f);
+        }
+
+        k->Exp(v, r, BatchSize);
+        for (int i = 0; i < BatchSize; i++) EXPECT_NEAR(r[i] / expf(v[i]), 1.0f, 1E-6f);
+
+        k->Pow(b, v, r, BatchSize);
+        for (int i = 0; i < BatchSize; i++) EXPECT_NEAR(r[i] / powf(b[i], v[i]), 1.0f, 1E-5f);
+
+        // Zero bases and exponents in both the wide and the remainder lanes
+        float zb[11], ze[11], zr[11];
+        for (int i = 0; i < 11; i++) {
+            zb[i] = (i % 2 == 0) ? 0.0f : 3.0f;
+            ze[i] = (i % 3 == 0) ? 0.0f : 2.0f;
+        }
+
+        k->Pow(zb, ze, zr, 11);
+        for (int i = 0; i < 11; i++) EXPECT_NEAR(zr[i], powf(zb[i], ze[i]), 1E-5f) << i;
+    }
+}
+
+TEST(MathTests, QuaternionInterpolation) {
+    const float angle = ysMath::Constants::PI / 2;
+    const ysQuaternion q0 = ysMath::Constants::QuatIdentity;
+    const ysQuaternion q1 = ysMath::LoadQuaternion(angle, ysMath::Constants::ZAxis);
+    const ysQuaternion q1Negated = ysMath::Negate(q1);
+
+    for (int i = 0; i <= 10; i++) {
+        const float t = i / 10.0f;
+        const ysQuaternion expected = ysMath::LoadQuaternion(angle * t, ysMath::Constants::ZAxis);
+
+        // Slerp has constant angular velocity and takes the shortest path
+        ysQuaternion r = ysMath::QuatSlerp(q0, q1, t);
+        ExpectNear(&r, &expected, 1);
+
+        r = ysMath::QuatSlerp(q0, q1Negated, t);
+        ExpectNear(&r, &expected, 1);
+
+        // Nlerp follows the same arc, just not at constant speed
+        r = ysMath::QuatNlerp(q0, q1Negated, t);
+        EXPECT_NEAR(ysMath::GetX(ysMath::Magnitude(r)), 1.0f, Epsilon);
+        EXPECT_NEAR(ysMath::GetQuatX(r), 0.0f, Epsilon);
+        EXPECT_NEAR(ysMath::GetQuatY(r), 0.0f, Epsilon);
+        EXPECT_GE(ysMath::GetQuatW(r), 0.0f);
+    }
+
+    // Nearly identical quaternions
+    const ysQuaternion q2 = ysMath::LoadQuaternion(1E-4f, ysMath::Constants::XAxis);
+    ysQuaternion r = ysMath::QuatSlerp(q0, q2, 0.5f);
+    EXPECT_NEAR(ysMath::GetX(ysMath::Magnitude(r)), 1.0f, Epsilon);
+
+    // exp(log(q)) = q
+    for (int i = 0; i < 10; i++) {
+        const ysQuaternion q = ysMath::Normalize(RandomVector());
+        const ysQuaternion e = ysMath::QuatExp(ysMath::QuatLog(q));
+        ExpectNear(&q, &e, 1);
+    }
+}
+
+TEST(MathTests, QuaternionSquad) {
+    ysQuaternion keys[4];
+    for (int i = 0; i < 4; i++) {
+        keys[i] = ysMath::LoadQuaternion(i * 0.5f, ysMath::Normalize(ysMath::LoadVector(1.0f, (float)i, 0.5f)));
+    }
+
+    const ysQuaternion s1 = ysMath::QuatSquadControlPoint(keys[0], keys[1], keys[2]);
+    const ysQuaternion s2 = ysMath::QuatSquadControlPoint(keys[1], keys[2], keys[3]);
+
+    ysQuaternion r = ysMath::QuatSquad(keys[1], keys[2], s1, s2, 0.0f);
+    ExpectNear(&r, &keys[1], 1);
+
+    r = ysMath::QuatSquad(keys[1], keys[2], s1, s2, 1.0f);
+    ExpectNear(&r, &keys[2], 1);
+
+    // Control points of evenly spaced rotations about one axis are the keys themselves
+    const ysQuaternion a = ysMath::LoadQuaternion(0.1f, ysMath::Constants::YAxis);
+    const ysQuaternion b = ysMath::LoadQuaternion(0.3f, ysMath::Constants::YAxis);
+    const ysQuaternion c = ysMath::LoadQuaternion(0.5f, ysMath::Constants::YAxis);
+    r = ysMath::QuatSquadControlPoint(a, b, c);
+    ExpectNear(&r, &b, 1);
+}
+
+TEST(MathTests, AffineMatrix) {
+    for (int i = 0; i < 20; i++) {
+        const ysQuaternion q1 = ysMath::Normalize(RandomVector());
+        const ysQuaternion q2 = ysMath::Normalize(RandomVector());
+        const ysMatrix m1 = ysMath::LoadMatrix(q1, RandomVector());
+        const ysMatrix m2 = ysMath::MatMult(
+            ysMath::LoadMatrix(q2, RandomVector()),
+            ysMath::ScaleTransform(ysMath::LoadVector(1.5f, 2.0f, 0.5f)));
+
+        const ysAffineMatrix a1 = ysMath::LoadAffine(m1);
+        const ysAffineMatrix a2 = ysMath::LoadAffine(m2);
+
+        // Multiplication matches the full 4x4 product
+        ysMatrix expected = ysMath::MatMult(m1, m2);
+        ysMatrix actual = ysMath::LoadMatrix(ysMath::MatMult(a1, a2));
+        ExpectNear(expected.rows, actual.rows, 4);
+
+        // Inverses
+        expected = ysMath::LoadIdentity();
+        actual = ysMath::LoadMatrix(ysMath::MatMult(a1, ysMath::OrthogonalInverse(a1)));
+        ExpectNear(expected.rows, actual.rows, 4);
+
+        actual = ysMath::LoadMatrix(ysMath::MatMult(a2, ysMath::AffineInverse(a2)));
+        ExpectNear(expected.rows, actual.rows, 4);
+
+        actual = ysMath::MatMult(m1, ysMath::OrthogonalInverse(m1));
+        ExpectNear(expected.rows, actual.rows, 4);
+
+        // Points and directions
+        const ysVector v = ysMath::Mask(RandomVector(), ysMath::Constants::MaskOffW);
+        ysVector e = ysMath::MatMult(m2, ysMath::ExtendVector(v));
+        ysVector r = ysMath::TransformPoint(a2, v);
+        ExpectNear(&e, &r, 1);
+
+        e = ysMath::MatMult(m2, v);
+        r = ysMath::TransformDirection(a2, v);
+        ExpectNear(&e, &r, 1);
+    }
+}
+
+TEST(MathTests, SetInstructionSet) {
+    const ysMath::InstructionSet supported = ysMath::GetSupportedInstructionSet();
+
+    EXPECT_TRUE(ysMath::SetInstructionSet(ysMath::InstructionSet::SSE2));
+    EXPECT_EQ(ysMath::GetInstructionSet(), ysMath::InstructionSet::SSE2);
+
+    EXPECT_FALSE(ysMath::SetInstructionSet(ysMath::InstructionSet::Count));
+
+    EXPECT_TRUE(ysMath::SetInstructionSet(supported));
+    EXPECT_EQ(ysMath::GetInstructionSet(), supported);
+}
+
+// Microbenchmark comparing each kernel variant. Disabled by default, run with
+// --gtest_also_run_disabled_tests --gtest_filter=MathTests.DISABLED_*
+TEST(MathTests, DISABLED_KernelBenchmark) {
+    const int n = 4096;
+    const int iterations = 1000;
+
+    ysVector *v1 = new ysVector[n], *v2 = new ysVector[n], *vr = new ysVector[n];
+    ysMatrix *m1 = new ysMatrix[n], *m2 = new ysMatrix[n], *mr = new ysMatrix[n];
+
+    for (int i = 0; i < n; i++) {
+        v1[i] = RandomVector();
+        v2[i] = ysMath::Normalize(RandomVector());
+        for (int j = 0; j < 4; j++) {
+            m1[i].rows[j] = RandomVector();
+            m2[i].rows[j] = RandomVector();
+        }
+    }
+
+    const int supported = (int)ysMath::GetSupportedInstructionSet();
+    for (int s = 0; s <= supported; s++) {
+        const ysMath::Kernels::Table *k = ysMath::Kernels::GetTable((ysMath::InstructionSet)s);
+
+        auto run = [&](const char *name, auto kernel) {
+            auto start = std::chrono::steady_clock::now();
+            for (int it = 0; it < iterations; it++) kernel();
+            auto end = std::chrono::steady_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            printf("%-10s %-14s %8.3f ns/element\n", k->Name, name, ns / ((double)n * iterations));
+        };
+
+        run("Dot", [&]() { k->Dot(v1, v2, vr, n); });
+        run("Cross", [&]() { k->Cross(v1, v2, vr, n); });
+        run("Normalize", [&]() { k->Normalize(v1, vr, n); });
+        run("Transform", [&]() { k->Transform(m1[0], v1, vr, n); });
+        run("MatMult", [&]() { k->MatMult(m1, m2, mr, n); });
+        run("QuatMultiply", [&]() { k->QuatMultiply(v2, v1, vr, n); });
+        run("LoadMatrix", [&]() { k->LoadMatrix(v2, mr, n); });
+    }
+
+    delete[] v1; delete[] v2; delete[] vr;
+    delete[] m1; delete[] m2; delete[] mr;
+}
+
+// Accuracy and throughput of the approximate functions against the C
+// runtime. Disabled by default, run with
+// --gtest_also_run_disabled_tests --gtest_filter=MathTests.DISABLED_*
+TEST(MathTests, DISABLED_ApproximationReport) {
+    const int n = 4096;
+    const int iterations = 1000;
+
+    float *v = new float[n], *b = new float[n], *r0 = new float[n], *r1 = new float[n];
+    for (int i = 0; i < n; i++) {
+        v[i] = (i - n / 2) * (20.0f / n);
+        b[i] = (i + 1) * (10.0f / n);
+    }
+
+    auto time = [&](auto kernel) {
+        auto start = std::chrono::steady_clock::now();
+        for (int it = 0; it < iterations; it++) kernel();
+        auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / ((double)n * iterations);
+    };
+
+    auto maxError = [&](auto reference) {
+        double err = 0;
+        for (int i = 0; i < n; i++) {
+            const double ref = reference(i);
+            err = fmax(err, fabs(r0[i] - ref) / fmax(fabs(ref), 1.0));
+        }
+
+        return err;
+    };
+
+    printf("%-10s %-8s %12s %12s\n", "Kernels", "Function", "ns/element", "max error");
+    printf("%-10s %-8s %12.3f\n", "libm", "sinf", time([&]() { for (int i = 0; i < n; i++) r0[i] = sinf(v[i]); }));
+    printf("%-10s %-8s %12.3f\n", "libm", "expf", time([&]() { for (int i = 0; i < n; i++) r0[i] = expf(v[i]); }));
+    printf("%-10s %-8s %12.3f\n", "libm", "powf", time([&]() { for (int i = 0; i < n; i++) r0[i] = powf(b[i], v[i]); }));
+
+    const int supported = (int)ysMath::GetSupportedInstructionSet();
+    for (int set = 0; set <= supported; set++) {
+        const ysMath::Kernels::Table *k = ysMath::Kernels::GetTable((ysMath::InstructionSet)set);
+
+        double t = time([&]() { k->SinCos(v, r0, r1, n); });
+        printf("%-10s %-8s %12.3f %12.3g\n", k->Name, "SinCos", t, maxError([&](int i) { return sin((double)v[i]); }));
+
+        t = time([&]() { k->Exp(v, r0, n); });
+        printf("%-10s %-8s %12.3f %12.3g\n", k->Name, "Exp", t, maxError([&](int i) { return exp((double)v[i]); }));
+
+        t = time([&]() { k->Pow(b, v, r0, n); });
+        printf("%-10s %-8s %12.3f %12.3g\n", k->Name, "Pow", t, maxError([&](int i) { return pow((double)b[i], (double)v[i]); }));
+    }
+
+    delete[] v; delete[] b; delete[] r0; delete[] r1;
+}
@@ -0,0 +1,128 @@
+#include <pch.h>
+
+#include "../include/yds_memory_tracker.h"
+#include "../include/yds_frame_arena.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    int BudgetCallbackCount = 0;
+    int64_t BudgetCallbackLive = 0;
+
+    void OnBudgetExceeded(ysMemoryTag tag, int64_t liveBytes, int64_t budget) {
+        BudgetCallbackCount++;
+        BudgetCallbackLive = liveBytes;
+    }
+
+} /* namespace */
+
+TEST(MemoryTracker, LivePeakAndInterval) {
+    ysMemoryTracker::TagStatistics before, after;
+    ysMemoryTracker::GetStatistics(ysMemoryTag::UI, &before);
+
+    ysMemoryTracker::ResetInterval();
+    ysMemoryTracker::RecordAllocation(ysMemoryTag::UI, 1000);
+    ysMemoryTracker::RecordAllocation(ysMemoryTag::UI, 500);
+    ysMemoryTracker::RecordFree(ysMemoryTag::UI, 1000);
+
+    ysMemoryTracker::GetStatistics(ysMemoryTag::UI, &after);
+    EXPECT_EQ(after.LiveBytes - before.LiveBytes, 500);
+    EXPECT_EQ(after.LiveAllocations - before.LiveAllocations, 1);
+    EXPECT_EQ(after.TotalAllocations - before.TotalAllocations, 2);
+    EXPECT_GE(after.PeakBytes, before.LiveBytes + 1500);
+    EXPECT_EQ(after.IntervalAllocations, 2);
+    EXPECT_EQ(after.IntervalBytes, 1500);
+
+    ysMemoryTracker::ResetInterval();
+    ysMemoryTracker::GetStatistics(ysMemoryTag::UI, &after);
+    EXPECT_EQ(after.IntervalAllocations, 0);
+    EXPECT_EQ(after.LiveBytes - before.LiveBytes, 500);
+
+    ysMemoryTracker::RecordFree(ysMemoryTag::UI, 500);
+}
+
+TEST(MemoryTracker, Budget) {
+    ysMemoryTracker::TagStatistics statistics;
+    ysMemoryTracker::GetStatistics(ysMemoryTag::UI, &statistics);
+    const int64_t base = statistics.LiveBytes;
+
+    BudgetCallbackCount = 0;
+    ysMemoryTracker::SetBudgetCallback(OnBudgetExceeded);
+    ysMemoryTracker::SetBudget(ysMemoryTag::UI, base + 1024);
+
+    ysMemoryTracker::RecordAllocation(ysMemoryTag::UI, 1024);
+    EXPECT_FALSE(ysMemoryTracker::IsOverBudget(ysMemoryTag::UI));
+    EXPECT_EQ(BudgetCallbackCount, 0);
+
+    // Only the allocation that crosses the budget is reported
+    ysMemoryTracker::RecordAllocation(ysMemoryTag::UI, 1);
+    ysMemoryTracker::RecordAllocation(ysMemoryTag::UI, 1);
+    EXPECT_TRUE(ysMemoryTracker::IsOverBudget(ysMemoryTag::UI));
+    EXPECT_EQ(BudgetCallbackCount, 1);
+    EXPECT_EQ(BudgetCallbackLive, base + 1025);
+
+    ysMemoryTracker::RecordFree(ysMemoryTag::UI, 1024);
+    ysMemoryTracker::RecordFree(ysMemoryTag::UI, 1);
+    ysMemoryTracker::RecordFree(ysMemoryTag::UI, 1);
+    EXPECT_FALSE(ysMemoryTracker::IsOverBudget(ysMemoryTag::UI));
+
+    ysMemoryTracker::SetBudget(ysMemoryTag::UI, 0);
+    ysMemoryTracker::SetBudgetCallback(nullptr);
+}
+
+TEST(MemoryTracker, ConcurrentRecording) {
+    const int Threads = 4;
+    const int PerThread = 10000;
+
+    ysMemoryTracker::TagStatistics before, after;
+    ysMemoryTracker::GetStatistics(ysMemoryTag::Audio, &before);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; t++) {
+        threads.push_back(std::thread([]() {
+            for (int i = 0; i < PerThread; i++) {
+                ysMemoryTracker::RecordAllocation(ysMemoryTag::Audio, 16);
+                ysMemoryTracker::RecordFree(ysMemoryTag::Audio, 16);
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+
+    ysMemoryTracker::GetStatistics(ysMemoryTag::Audio, &after);
+    EXPECT_EQ(after.LiveBytes, before.LiveBytes);
+    EXPECT_EQ(after.TotalAllocations - before.TotalAllocations, Threads * PerThread);
+}
+
+TEST(MemoryTracker, TaggedAllocator) {
+    ysMemoryTracker::TagStatistics before, during, after;
+    ysMemoryTracker::GetStatistics(ysMemoryTag::Physics, &before);
+
+    {
+        ysFrameArena arena;
+        arena.SetMemoryTag(ysMemoryTag::Physics);
+        arena.Initialize(4 * KB);
+
+        ysMemoryTracker::GetStatistics(ysMemoryTag::Physics, &during);
+        if (ysMemoryTracker::IsEnabled()) {
+            EXPECT_GE(during.LiveBytes - before.LiveBytes, 4 * KB);
+        }
+        else {
+            EXPECT_EQ(during.LiveBytes, before.LiveBytes);
+        }
+
+        arena.Destroy();
+    }
+
+    ysMemoryTracker::GetStatistics(ysMemoryTag::Physics, &after);
+    EXPECT_EQ(after.LiveBytes, before.LiveBytes);
+
+    void *block = ysTrackedAllocate(ysMemoryTag::Assets, 100);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 16, 0);
+    ysTrackedFree(block);
+    ysTrackedFree(nullptr);
+}
@@ -0,0 +1,218 @@
+#include <pch.h>
+
+#include "../include/yds_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+TEST(Queue, CapacityAndBounds) {
+    ysSpscQueue<int> spsc;
+    spsc.Initialize(5);
+    EXPECT_EQ(spsc.GetCapacity(), 8);
+
+    ysMpmcQueue<int> mpmc;
+    mpmc.Initialize(8);
+    EXPECT_EQ(mpmc.GetCapacity(), 8);
+
+    int value;
+    EXPECT_FALSE(spsc.TryPop(value));
+    EXPECT_FALSE(mpmc.TryPop(value));
+
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(spsc.TryPush(i));
+        EXPECT_TRUE(mpmc.TryPush(i));
+    }
+
+    EXPECT_FALSE(spsc.TryPush(8));
+    EXPECT_FALSE(mpmc.TryPush(8));
+    EXPECT_EQ(spsc.GetCount(), 8);
+    EXPECT_EQ(mpmc.GetCount(), 8);
+
+    // Wrap around several times
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(spsc.TryPop(value));
+        EXPECT_EQ(value, i);
+        ASSERT_TRUE(mpmc.TryPop(value));
+        EXPECT_EQ(value, i);
+
+        EXPECT_TRUE(spsc.TryPush(i + 8));
+        EXPECT_TRUE(mpmc.TryPush(i + 8));
+    }
+
+    spsc.Destroy();
+    mpmc.Destroy();
+}
+
+namespace {
+
+    int LiveObjects = 0;
+
+    struct TrackedObject {
+        TrackedObject() { LiveObjects++; }
+        TrackedObject(const TrackedObject &) { LiveObjects++; }
+        ~TrackedObject() { LiveObjects--; }
+
+        TrackedObject &operator=(const TrackedObject &) { return *this; }
+    };
+
+} /* namespace */
+
+TEST(Queue, DestroyReleasesObjects) {
+    {
+        ysSpscQueue<TrackedObject> spsc;
+        ysMpmcQueue<TrackedObject> mpmc;
+        spsc.Initialize(16);
+        mpmc.Initialize(16);
+
+        for (int i = 0; i < 10; i++) {
+            spsc.TryPush(TrackedObject());
+            mpmc.TryPush(TrackedObject());
+        }
+
+        EXPECT_EQ(LiveObjects, 20);
+
+        TrackedObject object;
+        spsc.TryPop(object);
+        mpmc.TryPop(object);
+        EXPECT_EQ(LiveObjects, 19);
+    }
+
+    EXPECT_EQ(LiveObjects, 0);
+}
+
+TEST(Queue, SpscOrdering) {
+    const int Count = 200000;
+
+    ysSpscQueue<int> queue;
+    queue.Initialize(64);
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < Count; i++) {
+            while (!queue.TryPush(i)) std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < Count) {
+        int value;
+        if (queue.TryPop(value)) {
+            if (value != expected) ordered = false;
+            expected++;
+        }
+        else std::this_thread::yield();
+    }
+
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(queue.GetCount(), 0);
+}
+
+TEST(Queue, MpmcProducersConsumers) {
+    const int Threads = 4;
+    const int PerThread = 50000;
+
+    ysMpmcQueue<int> queue;
+    queue.Initialize(128);
+
+    std::atomic<int64_t> sum(0);
+    std::atomic<int> consumed(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; t++) {
+        threads.push_back(std::thread([&queue, t]() {
+            for (int i = 0; i < PerThread; i++) {
+                while (!queue.TryPush(t * PerThread + i)) std::this_thread::yield();
+            }
+        }));
+
+        threads.push_back(std::thread([&]() {
+            while (consumed.load() < Threads * PerThread) {
+                int value;
+                if (queue.TryPop(value)) {
+                    sum += value;
+                    consumed++;
+                }
+                else std::this_thread::yield();
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+
+    const int64_t n = (int64_t)Threads * PerThread;
+    EXPECT_EQ(consumed.load(), n);
+    EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+}
+
+TEST(Queue, DISABLED_Benchmark) {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    const int Operations = 1000000;
+
+    auto measure = [&](const char *name, int producers, int consumers, auto push, auto pop) {
+        std::atomic<int> remaining(Operations);
+        const int perProducer = Operations / producers;
+
+        auto start = Clock::now();
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < producers; i++) {
+            threads.push_back(std::thread([&]() {
+                for (int j = 0; j < perProducer; j++) {
+                    while (!push(j)) std::this_thread::yield();
+                }
+            }));
+        }
+
+        for (int i = 0; i < consumers; i++) {
+            threads.push_back(std::thread([&]() {
+                int value;
+                while (remaining.load(std::memory_order_relaxed) > 0) {
+                    if (pop(value)) remaining--;
+                    else std::this_thread::yield();
+                }
+            }));
+        }
+
+        for (std::thread &thread : threads) thread.join();
+
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        printf("%-28s %2dP/%2dC %8.2f ns/op\n", name, producers, consumers, ns / Operations);
+    };
+
+    {
+        ysSpscQueue<int> queue;
+        queue.Initialize(1024);
+        measure("ysSpscQueue", 1, 1,
+            [&](int v) { return queue.TryPush(v); },
+            [&](int &v) { return queue.TryPop(v); });
+    }
+
+    const int configurations[][2] = { { 1, 1 }, { 2, 2 }, { 4, 4 } };
+    for (const auto &c : configurations) {
+        ysMpmcQueue<int> queue;
+        queue.Initialize(1024);
+        measure("ysMpmcQueue", c[0], c[1],
+            [&](int v) { return queue.TryPush(v); },
+            [&](int &v) { return queue.TryPop(v); });
+
+        std::mutex lock;
+        std::queue<int> lockedQueue;
+        measure("std::queue + std::mutex", c[0], c[1],
+            [&](int v) { std::lock_guard<std::mutex> guard(lock); lockedQueue.push(v); return true; },
+            [&](int &v) {
+                std::lock_guard<std::mutex> guard(lock);
+                if (lockedQueue.empty()) return false;
+                v = lockedQueue.front();
+                lockedQueue.pop();
+                return true;
+            });
+    }
+}
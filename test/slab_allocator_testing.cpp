@@ -0,0 +1,192 @@
+#include <pch.h>
+
+#include "../include/yds_slab_allocator.h"
+#include "../include/yds_dynamic_allocator.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+TEST(SlabAllocator, SizeClasses) {
+    EXPECT_EQ(ysSlabAllocator::GetSizeClass(1), 0);
+    EXPECT_EQ(ysSlabAllocator::GetSizeClass(32), 0);
+    EXPECT_EQ(ysSlabAllocator::GetSizeClass(33), 1);
+    EXPECT_EQ(ysSlabAllocator::GetSizeClass(64), 1);
+    EXPECT_EQ(ysSlabAllocator::GetSizeClass(32 * KB), ysSlabAllocator::NumClasses - 1);
+    EXPECT_EQ(ysSlabAllocator::GetSizeClass(32 * KB + 1), -1);
+}
+
+TEST(SlabAllocator, AlignmentAndReuse) {
+    ysSlabAllocator allocator;
+
+    for (int size = 1; size < 4 * KB; size = size * 3 + 1) {
+        void *block = allocator.AllocateBlock(size);
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % ysSlabAllocator::Alignment, 0);
+
+        allocator.FreeBlock(block);
+
+        // The block that was just freed is the first one handed out again
+        EXPECT_EQ(allocator.AllocateBlock(size), block);
+        allocator.FreeBlock(block);
+    }
+
+    void *large = allocator.AllocateBlock(100 * KB);
+    ASSERT_NE(large, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % ysSlabAllocator::Alignment, 0);
+    allocator.FreeBlock(large);
+
+    allocator.Destroy();
+}
+
+TEST(SlabAllocator, Statistics) {
+    ysSlabAllocator allocator;
+
+    void *blocks[100];
+    for (int i = 0; i < 100; i++) blocks[i] = allocator.AllocateBlock(48);
+    void *large = allocator.AllocateBlock(64 * KB);
+
+    ysSlabAllocator::Statistics statistics;
+    allocator.GetStatistics(&statistics);
+
+    const int sizeClass = ysSlabAllocator::GetSizeClass(48 + 16);
+    EXPECT_EQ(statistics.Classes[sizeClass].BlockSize, 64);
+    EXPECT_EQ(statistics.Classes[sizeClass].LiveBlocks, 100);
+    EXPECT_EQ(statistics.Classes[sizeClass].TotalAllocations, 100);
+    EXPECT_EQ(statistics.Classes[sizeClass].Slabs, 1);
+    EXPECT_EQ(statistics.LiveLargeBlocks, 1);
+    EXPECT_EQ(statistics.RequestedBytes, 100 * 48 + 64 * KB);
+    EXPECT_EQ(statistics.HighWaterMark, statistics.RequestedBytes);
+    EXPECT_GT(statistics.Fragmentation, 0.0f);
+    EXPECT_LT(statistics.Fragmentation, 1.0f);
+
+    for (int i = 0; i < 100; i++) allocator.FreeBlock(blocks[i]);
+    allocator.FreeBlock(large);
+
+    allocator.GetStatistics(&statistics);
+    EXPECT_EQ(statistics.Classes[sizeClass].LiveBlocks, 0);
+    EXPECT_EQ(statistics.LiveLargeBlocks, 0);
+    EXPECT_EQ(statistics.RequestedBytes, 0);
+    EXPECT_EQ(statistics.HighWaterMark, 100 * 48 + 64 * KB);
+
+    allocator.Destroy();
+}
+
+namespace {
+
+    int LiveObjects = 0;
+
+    struct TrackedObject {
+        TrackedObject() { LiveObjects++; Value = 7; }
+        ~TrackedObject() { LiveObjects--; }
+
+        int Value;
+    };
+
+} /* namespace */
+
+TEST(SlabAllocator, TypedAllocation) {
+    ysSlabAllocator allocator;
+
+    TrackedObject *small = allocator.Allocate<TrackedObject>(10);
+    TrackedObject *large = allocator.Allocate<TrackedObject>(20000);
+    EXPECT_EQ(LiveObjects, 20010);
+    EXPECT_EQ(small[9].Value, 7);
+    EXPECT_EQ(large[19999].Value, 7);
+
+    allocator.Free(small);
+    allocator.Free(large);
+    EXPECT_EQ(LiveObjects, 0);
+    EXPECT_EQ(small, nullptr);
+
+    allocator.Destroy();
+}
+
+TEST(SlabAllocator, Threads) {
+    ysSlabAllocator allocator;
+
+    const int ThreadCount = 4;
+    const int Iterations = 20000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; t++) {
+        threads.push_back(std::thread([&allocator, t]() {
+            int *live[64] = {};
+            for (int i = 0; i < Iterations; i++) {
+                int slot = (i * 7 + t) % 64;
+                if (live[slot] != nullptr) {
+                    EXPECT_EQ(live[slot][0], t);
+                    allocator.FreeBlock(live[slot]);
+                }
+
+                live[slot] = reinterpret_cast<int *>(allocator.AllocateBlock(sizeof(int) * (1 + (i % 200))));
+                live[slot][0] = t;
+            }
+
+            for (int slot = 0; slot < 64; slot++) allocator.FreeBlock(live[slot]);
+        }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+
+    ysSlabAllocator::Statistics statistics;
+    allocator.GetStatistics(&statistics);
+    EXPECT_EQ(statistics.RequestedBytes, 0);
+
+    for (int i = 0; i < ysSlabAllocator::NumClasses; i++) {
+        EXPECT_EQ(statistics.Classes[i].LiveBlocks, 0);
+    }
+
+    allocator.Destroy();
+}
+
+TEST(SlabAllocator, DISABLED_Benchmark) {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    const int BlockCount = 4096;
+    const int Rounds = 200;
+
+    int sizes[BlockCount];
+    for (int i = 0; i < BlockCount; i++) sizes[i] = 16 + ((i * 2654435761u) >> 16) % 500;
+
+    std::vector<void *> blocks(BlockCount);
+
+    auto measure = [&](const char *name, auto allocate, auto free) {
+        auto start = Clock::now();
+        for (int round = 0; round < Rounds; round++) {
+            for (int i = 0; i < BlockCount; i++) blocks[i] = allocate(sizes[i]);
+            for (int i = 0; i < BlockCount; i += 2) free(blocks[i]);
+            for (int i = 0; i < BlockCount; i += 2) blocks[i] = allocate(sizes[BlockCount - 1 - i]);
+            for (int i = 0; i < BlockCount; i++) free(blocks[i]);
+        }
+
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        printf("%-20s %8.2f ns/op\n", name, ns / (Rounds * BlockCount * 3.0));
+    };
+
+    measure("malloc",
+        [](int size) { return ::malloc(size); },
+        [](void *block) { ::free(block); });
+
+    ysDynamicAllocator dynamicAllocator;
+    dynamicAllocator.CreateBuffer(8 * MB);
+    dynamicAllocator.CreateBlocks(2 * BlockCount);
+    measure("ysDynamicAllocator",
+        [&](int size) { return dynamicAllocator.AllocateBlock(size); },
+        [&](void *block) { dynamicAllocator.FreeBlock(block); });
+    dynamicAllocator.Destroy();
+
+    ysSlabAllocator slabAllocator;
+    measure("ysSlabAllocator",
+        [&](int size) { return slabAllocator.AllocateBlock(size); },
+        [&](void *block) { slabAllocator.FreeBlock(block); });
+
+    ysSlabAllocator::Statistics statistics;
+    slabAllocator.GetStatistics(&statistics);
+    printf("High water mark: %lld bytes, reserved: %lld bytes\n",
+        (long long)statistics.HighWaterMark, (long long)statistics.ReservedBytes);
+
+    slabAllocator.Destroy();
+}
@@ -0,0 +1,73 @@
+#include <pch.h>
+
+#include "../include/yds_small_vector.h"
+
+#include <string>
+
+TEST(SmallVector, InlineUntilFull) {
+    ysSmallVector<int, 4> vector;
+    EXPECT_TRUE(vector.IsInline());
+    EXPECT_EQ(vector.GetCapacity(), 4);
+
+    for (int i = 0; i < 4; i++) vector.New() = i;
+    EXPECT_TRUE(vector.IsInline());
+
+    vector.New() = 4;
+    EXPECT_FALSE(vector.IsInline());
+    EXPECT_EQ(vector.GetNumObjects(), 5);
+    for (int i = 0; i < 5; i++) EXPECT_EQ(vector[i], i);
+
+    // Storage is kept after clearing, Destroy() returns to inline storage
+    vector.Clear();
+    EXPECT_FALSE(vector.IsInline());
+    vector.Destroy();
+    EXPECT_TRUE(vector.IsInline());
+    EXPECT_EQ(vector.GetNumObjects(), 0);
+}
+
+TEST(SmallVector, DeleteAndFind) {
+    ysSmallVector<int, 2> vector;
+    for (int i = 0; i < 6; i++) vector.New() = i;
+
+    vector.Delete(1);
+    EXPECT_EQ(vector.GetNumObjects(), 5);
+    EXPECT_EQ(vector[1], 5);
+
+    vector.Delete(0, true);
+    EXPECT_EQ(vector[0], 5);
+    EXPECT_EQ(vector[1], 2);
+    EXPECT_EQ(vector[3], 4);
+
+    EXPECT_EQ(vector.Find(4), 3);
+    EXPECT_EQ(vector.Find(1), -1);
+}
+
+TEST(SmallVector, CopyAndMove) {
+    ysSmallVector<std::string, 2> inlineVector;
+    inlineVector.New() = "a";
+    inlineVector.New() = "b";
+
+    ysSmallVector<std::string, 2> heapVector(inlineVector);
+    heapVector.New() = "c";
+    heapVector.Append(heapVector.GetBuffer(), heapVector.GetNumObjects());
+    ASSERT_EQ(heapVector.GetNumObjects(), 6);
+    EXPECT_EQ(heapVector[5], "c");
+
+    // Inline contents are moved object by object
+    ysSmallVector<std::string, 2> moved(std::move(inlineVector));
+    EXPECT_TRUE(moved.IsInline());
+    EXPECT_EQ(moved[1], "b");
+    EXPECT_EQ(inlineVector.GetNumObjects(), 0);
+
+    // Heap storage is handed over
+    const std::string *buffer = heapVector.GetBuffer();
+    moved = std::move(heapVector);
+    EXPECT_EQ(moved.GetBuffer(), buffer);
+    EXPECT_EQ(moved.GetNumObjects(), 6);
+    EXPECT_TRUE(heapVector.IsInline());
+    EXPECT_EQ(heapVector.GetNumObjects(), 0);
+
+    heapVector = moved;
+    EXPECT_EQ(heapVector.GetNumObjects(), 6);
+    EXPECT_EQ(heapVector[4], "b");
+}
@@ -0,0 +1,67 @@
+#include <pch.h>
+
+#include "../include/yds_vertex_compression.h"
+
+#include <math.h>
+
+TEST(VertexCompression, HalfFloat) {
+    const float exact[] = { 0.0f, 1.0f, -2.0f, 0.5f, 0.25f, 1024.0f, 65504.0f };
+    for (float value : exact) {
+        EXPECT_EQ(ysVertexCompression::HalfToFloat(ysVertexCompression::FloatToHalf(value)), value);
+    }
+
+    EXPECT_EQ(ysVertexCompression::FloatToHalf(1.0f), 0x3C00);
+    EXPECT_EQ(ysVertexCompression::FloatToHalf(-0.0f), 0x8000);
+    EXPECT_EQ(ysVertexCompression::FloatToHalf(1.0e6f), 0x7C00);
+
+    // Smallest subnormal and round to nearest even
+    EXPECT_EQ(ysVertexCompression::FloatToHalf(ldexpf(1.0f, -24)), 0x0001);
+    EXPECT_EQ(ysVertexCompression::FloatToHalf(1.0f + ldexpf(1.0f, -11)), 0x3C00);
+    EXPECT_EQ(ysVertexCompression::FloatToHalf(1.0f + 3 * ldexpf(1.0f, -11)), 0x3C02);
+
+    for (float uv = -4.0f; uv <= 4.0f; uv += 0.01f) {
+        const float decoded = ysVertexCompression::HalfToFloat(ysVertexCompression::FloatToHalf(uv));
+        EXPECT_NEAR(decoded, uv, 0.002f);
+    }
+}
+
+TEST(VertexCompression, Unorm16) {
+    EXPECT_EQ(ysVertexCompression::QuantizeUnorm16(-1.0f, -1.0f, 3.0f), 0);
+    EXPECT_EQ(ysVertexCompression::QuantizeUnorm16(3.0f, -1.0f, 3.0f), 0xFFFF);
+    EXPECT_EQ(ysVertexCompression::QuantizeUnorm16(5.0f, 5.0f, 5.0f), 0);
+
+    for (float x = -1.0f; x <= 3.0f; x += 0.137f) {
+        const unsigned short q = ysVertexCompression::QuantizeUnorm16(x, -1.0f, 3.0f);
+        EXPECT_NEAR(ysVertexCompression::DequantizeUnorm16(q, -1.0f, 3.0f), x, 4.0f / 65535.0f);
+    }
+}
+
+TEST(VertexCompression, Octahedral) {
+    float maxError = 0.0f;
+
+    for (int i = 0; i < 64; i++) {
+        for (int j = 0; j <= 32; j++) {
+            const float phi = i * (2 * 3.14159265f / 64);
+            const float theta = j * (3.14159265f / 32);
+
+            const ysVector3 n(sinf(theta) * cosf(phi), sinf(theta) * sinf(phi), cosf(theta));
+
+            short x, y;
+            ysVertexCompression::EncodeOctahedral(n, &x, &y);
+            const ysVector3 d = ysVertexCompression::DecodeOctahedral(x, y);
+
+            // Chord length, close to the angle in radians for small errors
+            const float dx = n.x - d.x, dy = n.y - d.y, dz = n.z - d.z;
+            const float error = sqrtf(dx * dx + dy * dy + dz * dz);
+            if (error > maxError) maxError = error;
+        }
+    }
+
+    // Well under a hundredth of a degree
+    EXPECT_LT(maxError, 0.0001f);
+
+    short x, y;
+    ysVertexCompression::EncodeOctahedral(ysVector3(0.0f, 0.0f, -1.0f), &x, &y);
+    const ysVector3 down = ysVertexCompression::DecodeOctahedral(x, y);
+    EXPECT_NEAR(down.z, -1.0f, 1.0e-6f);
+}